@@ -1,139 +1,151 @@
-// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
-//
-// Redistribution and use in source and binary forms, with or without
-// modification, are permitted provided that the following conditions are met:
-//
-//   1. Redistributions of source code must retain the above copyright notice,
-//      this list of conditions and the following disclaimer.
-//
-//   2. Redistributions in binary form must reproduce the above copyright notice,
-//      this list of conditions and the following disclaimer in the documentation
-//      and/or other materials provided with the distribution.
-//
-//   3. Neither the name of the copyright holder nor the names of its contributors
-//      may be used to endorse or promote products derived from this software
-//      without specific prior written permission.
-//
-// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
-// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
-// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
-// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
-// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
-// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
-// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
-// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
-// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
-// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
-// POSSIBILITY OF SUCH DAMAGE.
-
-using UnrealBuildTool;
-using System.IO;
-
-public class GrassPlugin : ModuleRules
-{
-
-    private string ModulePath
-    {
-        get { return ModuleDirectory; }
-    }
-
-    private string ThirdPartyPath
-    {
-        get { return Path.GetFullPath(Path.Combine(ModulePath, "../../ThirdParty/")); }
-    }
-
-    public GrassPlugin(ReadOnlyTargetRules Target) : base(Target)
-    {
-        PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
-        bEnableUndefinedIdentifierWarnings = false; //disable treating warnings as error
-        PublicIncludePaths.AddRange(
-            new string[] {
-                //"GrassPlugin/Public",
-                //"GrassPlugin/Shaders"
-                // ... add public include paths required here ...
-            }
-            );
-
-
-        PrivateIncludePaths.AddRange(
-            new string[] {
-                //"GrassPlugin/Private"
-				// ... add other private include paths required here ...
-			}
-            );
-
-
-        PublicDependencyModuleNames.AddRange(
-            new string[]
-            {
-                "Core"
-				// ... add other public dependencies that you statically link with here ...
-			}
-            );
-
-		if (Target.Type == TargetRules.TargetType.Editor)
-			{
-				PrivateDependencyModuleNames.AddRange(
-				new string[]
-				{
-					"UnrealEd",
-					"EditorStyle",
-                    "LevelEditor"
-                }
-				);
-			}
-        PrivateDependencyModuleNames.AddRange(
-            new string[]
-            {
-                "CoreUObject",
-                "Engine",
-                "Slate",
-                "SlateCore",
-                //"InputCore",
-                //"RenderCore",
-                "RHI"
-				// ... add private dependencies that you statically link with here ...	
-			}
-            );
-
-
-        DynamicallyLoadedModuleNames.AddRange(
-            new string[]
-            {
-				// ... add any modules that your module loads dynamically here ...
-			}
-            );
-
-        LoadPoissonSampl(Target);
-    }
-
-    public bool LoadPoissonSampl(ReadOnlyTargetRules Target)
-    {
-        bool isLibrarySupported = false;
-
-        if ((Target.Platform == UnrealTargetPlatform.Win64) || (Target.Platform == UnrealTargetPlatform.Win32))
-        {
-            isLibrarySupported = true;
-
-            string PlatformString = (Target.Platform == UnrealTargetPlatform.Win64) ? "x64" : "x86";
-            string LibrariesPath = Path.Combine(ThirdPartyPath, "PoissonDiskSampling", "Libraries");
-
-            PublicAdditionalLibraries.Add(Path.Combine(LibrariesPath, "poissonDiskLibrary." + PlatformString + ".lib"));
-        }
-
-        string cuda_path = "C:/Program Files/NVIDIA GPU Computing Toolkit/CUDA/v10.1";
-        string cuda_include = "include";
-        string cuda_library = "lib/x64";
-
-        PublicIncludePaths.Add(Path.Combine(cuda_path, cuda_include));
-        PublicAdditionalLibraries.Add(Path.Combine(cuda_path, cuda_library, "cudart_static.lib"));
-
-        if (isLibrarySupported)
-        {
-            PublicIncludePaths.Add(Path.Combine(ThirdPartyPath, "PoissonDiskSampling", "Includes"));
-        }
-
-        return isLibrarySupported;
-    }
-
-}
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+using UnrealBuildTool;
+using System.IO;
+
+public class GrassPlugin : ModuleRules
+{
+
+    private string ModulePath
+    {
+        get { return ModuleDirectory; }
+    }
+
+    private string ThirdPartyPath
+    {
+        get { return Path.GetFullPath(Path.Combine(ModulePath, "../../ThirdParty/")); }
+    }
+
+    public GrassPlugin(ReadOnlyTargetRules Target) : base(Target)
+    {
+        PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+        bEnableUndefinedIdentifierWarnings = false; //disable treating warnings as error
+        PublicIncludePaths.AddRange(
+            new string[] {
+                //"GrassPlugin/Public",
+                //"GrassPlugin/Shaders"
+                // ... add public include paths required here ...
+            }
+            );
+
+
+        PrivateIncludePaths.AddRange(
+            new string[] {
+                //"GrassPlugin/Private"
+				// ... add other private include paths required here ...
+			}
+            );
+
+
+        PublicDependencyModuleNames.AddRange(
+            new string[]
+            {
+                "Core"
+				// ... add other public dependencies that you statically link with here ...
+			}
+            );
+
+		if (Target.Type == TargetRules.TargetType.Editor)
+			{
+				PrivateDependencyModuleNames.AddRange(
+				new string[]
+				{
+					"UnrealEd",
+					"EditorStyle",
+                    "LevelEditor",
+                    "RawMesh",
+                    "AssetRegistry"
+                }
+				);
+			}
+        PrivateDependencyModuleNames.AddRange(
+            new string[]
+            {
+                "CoreUObject",
+                "Engine",
+                "Slate",
+                "SlateCore",
+                //"InputCore",
+                //"RenderCore",
+                "RHI",
+                "Landscape",
+                "ImageWrapper"
+				// ... add private dependencies that you statically link with here ...	
+			}
+            );
+
+
+        DynamicallyLoadedModuleNames.AddRange(
+            new string[]
+            {
+				// ... add any modules that your module loads dynamically here ...
+			}
+            );
+
+        LoadPoissonSampl(Target);
+        LoadGrassCore(Target);
+    }
+
+    // Engine independent generation core (samplers, density, turf layout, spatial indexes) from ThirdParty/GrassCore
+    // Its sources are compiled into the module by Private/GrassCore.cpp, so only the headers are added here
+    public void LoadGrassCore(ReadOnlyTargetRules Target)
+    {
+        PublicIncludePaths.Add(Path.Combine(ThirdPartyPath, "GrassCore", "Includes"));
+    }
+
+    public bool LoadPoissonSampl(ReadOnlyTargetRules Target)
+    {
+        bool isLibrarySupported = false;
+
+        if ((Target.Platform == UnrealTargetPlatform.Win64) || (Target.Platform == UnrealTargetPlatform.Win32))
+        {
+            isLibrarySupported = true;
+
+            string PlatformString = (Target.Platform == UnrealTargetPlatform.Win64) ? "x64" : "x86";
+            string LibrariesPath = Path.Combine(ThirdPartyPath, "PoissonDiskSampling", "Libraries");
+
+            PublicAdditionalLibraries.Add(Path.Combine(LibrariesPath, "poissonDiskLibrary." + PlatformString + ".lib"));
+        }
+
+        string cuda_path = "C:/Program Files/NVIDIA GPU Computing Toolkit/CUDA/v10.1";
+        string cuda_include = "include";
+        string cuda_library = "lib/x64";
+
+        PublicIncludePaths.Add(Path.Combine(cuda_path, cuda_include));
+        PublicAdditionalLibraries.Add(Path.Combine(cuda_path, cuda_library, "cudart_static.lib"));
+
+        if (isLibrarySupported)
+        {
+            PublicIncludePaths.Add(Path.Combine(ThirdPartyPath, "PoissonDiskSampling", "Includes"));
+        }
+
+        return isLibrarySupported;
+    }
+
+}
@@ -0,0 +1,246 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "GrassBakeCommandlet.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#if WITH_EDITOR
+#include "FileHelpers.h"
+#endif
+
+UGrassBakeCommandlet::UGrassBakeCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UGrassBakeCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	FString map;
+	if (!FParse::Value(*Params, TEXT("Map="), map))
+	{
+		UE_LOG(LogTemp, Error, TEXT("GrassBake: -Map=<map package> is required."));
+		return 1;
+	}
+
+	FString settingsPath = FGrassBakeShards::GetDefaultSettingsPath();
+	FString outputDir = FGrassBakeShards::GetDefaultOutputDir(map);
+	int shardCount = FPlatformMisc::NumberOfCoresIncludingHyperthreads();
+	int shard = INDEX_NONE;
+	FParse::Value(*Params, TEXT("Settings="), settingsPath);
+	FParse::Value(*Params, TEXT("Output="), outputDir);
+	FParse::Value(*Params, TEXT("Shards="), shardCount);
+	FParse::Value(*Params, TEXT("Shard="), shard);
+	shardCount = FMath::Max(shardCount, 1);
+	int workers = FMath::Min(shardCount, FPlatformMisc::NumberOfCores());
+	FParse::Value(*Params, TEXT("Workers="), workers);
+	settingsPath = FPaths::ConvertRelativePathToFull(settingsPath);
+	outputDir = FPaths::ConvertRelativePathToFull(outputDir);
+
+	FString settings;
+	if (!FFileHelper::LoadFileToString(settings, *settingsPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("GrassBake: settings %s could not be read. Export them in grass editor mode."), *settingsPath);
+		return 1;
+	}
+	uint32 settingsHash = FGrassBakeShards::GetSettingsHash(settings, map);
+
+	UWorld* world = LoadBakeWorld(map);
+	if (world == nullptr)
+	{
+		UE_LOG(LogTemp, Error, TEXT("GrassBake: map %s could not be loaded."), *map);
+		return 1;
+	}
+
+	UGrassRendering* grass = NewObject<UGrassRendering>(GetTransientPackage(), TEXT("GrassBake"));
+	grass->SetBakeWorld(world);
+	if (!grass->ImportBakeSettings(settings) || !grass->PrepareShardedBake())
+		return 1;
+
+	if (shard != INDEX_NONE)
+		return BakeShard(grass, shard, shardCount, settingsHash, outputDir);
+
+	if (!FParse::Param(*Params, TEXT("MergeOnly")))
+	{
+		//newly built clump meshes have to be on disk before workers load them (poisson tiles are already cached)
+		UEditorLoadingAndSavingUtils::SaveDirtyPackages(false, true);
+		if (!RunShards(map, settingsPath, outputDir, shardCount, workers, settingsHash))
+			return 1;
+	}
+	return MergeShards(grass, world, shardCount, settingsHash, outputDir);
+#else
+	return 1;
+#endif
+}
+
+UWorld* UGrassBakeCommandlet::LoadBakeWorld(const FString& map)
+{
+	UPackage* package = LoadPackage(nullptr, *map, LOAD_None);
+	UWorld* world = package != nullptr ? UWorld::FindWorldInPackage(package) : nullptr;
+	if (world == nullptr)
+		return nullptr;
+
+	world->AddToRoot();
+	world->WorldType = EWorldType::Editor;
+	if (!world->bIsWorldInitialized)
+	{
+		UWorld::InitializationValues values;
+		values.RequiresHitProxies(false).ShouldSimulatePhysics(false).EnableTraceCollision(true).CreateNavigation(false)
+			.CreateAISystem(false).AllowAudioPlayback(false).CreatePhysicsScene(true);
+		world->InitWorld(values);
+	}
+	world->UpdateWorldComponents(true, false);
+	return world;
+}
+
+int32 UGrassBakeCommandlet::BakeShard(UGrassRendering* grass, int shard, int shardCount, uint32 settingsHash, const FString& outputDir)
+{
+	TArray<FIntPoint> cells;
+	grass->GetBakeCells(cells);
+
+	FGrassBakeChunk chunk;
+	chunk.settingsHash = settingsHash;
+	chunk.shard = shard;
+	chunk.shardCount = shardCount;
+	for (const FIntPoint& cell : cells)
+	{
+		if (FGrassBakeShards::ShardOfCell(cell, shardCount) != shard)
+			continue;
+		if (!grass->BakeCell(cell, chunk.cells.AddDefaulted_GetRef()))
+			return 1;
+	}
+
+	FString chunkPath = FGrassBakeShards::GetChunkPath(outputDir, shard);
+	IFileManager::Get().MakeDirectory(*outputDir, true);
+	if (!chunk.SaveToFile(chunkPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("GrassBake: chunk %s could not be written."), *chunkPath);
+		return 1;
+	}
+	UE_LOG(LogTemp, Display, TEXT("GrassBake: shard %i of %i baked %i cells into %s"), shard, shardCount, chunk.cells.Num(), *chunkPath);
+	return 0;
+}
+
+int UGrassBakeCommandlet::RunShards(const FString& map, const FString& settingsPath, const FString& outputDir, int shardCount, int workers,
+	uint32 settingsHash)
+{
+	TArray<int> pending;
+	for (int shard = 0; shard < shardCount; shard++)
+		if (!FGrassBakeChunk::IsChunkValid(FGrassBakeShards::GetChunkPath(outputDir, shard), settingsHash, shard, shardCount))
+			pending.Add(shard);
+	UE_LOG(LogTemp, Display, TEXT("GrassBake: %i of %i shards to bake with %i workers."), pending.Num(), shardCount, workers);
+
+	struct FShardWorker {
+		FProcHandle process;
+		int shard;
+	};
+	TArray<FShardWorker> running;
+	FString projectPath = FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath());
+	int next = 0, failed = 0;
+	while (next < pending.Num() || running.Num() > 0)
+	{
+		while (next < pending.Num() && running.Num() < FMath::Max(workers, 1))
+		{
+			FString args = FString::Printf(TEXT("\"%s\" -run=GrassBake -Map=\"%s\" -Settings=\"%s\" -Output=\"%s\" -Shards=%i -Shard=%i -unattended -nopause -nosplash"),
+				*projectPath, *map, *settingsPath, *outputDir, shardCount, pending[next]);
+			FProcHandle process = FPlatformProcess::CreateProc(FPlatformProcess::ExecutablePath(), *args, true, true, true, nullptr, 0, nullptr, nullptr);
+			if (process.IsValid())
+				running.Add({ process, pending[next] });
+			else
+			{
+				UE_LOG(LogTemp, Error, TEXT("GrassBake: worker of shard %i could not be started."), pending[next]);
+				failed++;
+			}
+			next++;
+		}
+
+		for (int i = running.Num() - 1; i >= 0; i--)
+		{
+			if (FPlatformProcess::IsProcRunning(running[i].process))
+				continue;
+			int32 returnCode = 1;
+			FPlatformProcess::GetProcReturnCode(running[i].process, &returnCode);
+			FPlatformProcess::CloseProc(running[i].process);
+			if (returnCode != 0)
+			{
+				UE_LOG(LogTemp, Error, TEXT("GrassBake: shard %i failed with code %i."), running[i].shard, returnCode);
+				failed++;
+			}
+			else
+				UE_LOG(LogTemp, Display, TEXT("GrassBake: shard %i finished."), running[i].shard);
+			running.RemoveAt(i);
+		}
+		FPlatformProcess::Sleep(0.1f);
+	}
+
+	if (failed > 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("GrassBake: %i shards failed, rerun the same command to bake only them."), failed);
+		return 0;
+	}
+	return 1;
+}
+
+int32 UGrassBakeCommandlet::MergeShards(UGrassRendering* grass, UWorld* world, int shardCount, uint32 settingsHash, const FString& outputDir)
+{
+	TArray<FGrassBakeChunk> chunks;
+	chunks.SetNum(shardCount);
+	for (int shard = 0; shard < shardCount; shard++)
+	{
+		FString chunkPath = FGrassBakeShards::GetChunkPath(outputDir, shard);
+		if (!chunks[shard].LoadFromFile(chunkPath) || chunks[shard].settingsHash != settingsHash || chunks[shard].shard != shard ||
+			chunks[shard].shardCount != shardCount)
+		{
+			UE_LOG(LogTemp, Error, TEXT("GrassBake: chunk %s is missing or was baked with other settings."), *chunkPath);
+			return 1;
+		}
+	}
+
+	TArray<FIntPoint> order;
+	FGrassBakeShards::GetMergeOrder(chunks, order);
+	if (grass->overridePrevious)
+		grass->ClearGrass();
+	for (const FIntPoint& entry : order)
+		grass->CommitBakedCell(chunks[entry.X].cells[entry.Y]);
+	UE_LOG(LogTemp, Display, TEXT("GrassBake: %i cells of %i shards merged."), order.Num(), shardCount);
+
+	UPackage* package = world->GetOutermost();
+	FString fileName = FPackageName::LongPackageNameToFilename(package->GetName(), FPackageName::GetMapPackageExtension());
+	if (!UPackage::SavePackage(package, world, RF_Standalone, *fileName, GError, nullptr, false, true, SAVE_NoError))
+	{
+		UE_LOG(LogTemp, Error, TEXT("GrassBake: map %s could not be saved."), *fileName);
+		return 1;
+	}
+	UE_LOG(LogTemp, Display, TEXT("GrassBake: map %s saved."), *fileName);
+	return 0;
+}
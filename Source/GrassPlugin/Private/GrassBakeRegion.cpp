@@ -0,0 +1,89 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "GrassBakeRegion.h"
+#include "LandscapeProxy.h"
+#include "LandscapeInfo.h"
+#include "LandscapeComponent.h"
+#include "EngineUtils.h"
+
+AGrassBakeRegion::AGrassBakeRegion()
+{
+	spline = CreateDefaultSubobject<USplineComponent>(TEXT("spline"));
+	RootComponent = spline;
+	spline->SetSplinePoints({ FVector(-1000, -1000, 0), FVector(1000, -1000, 0), FVector(1000, 1000, 0), FVector(-1000, 1000, 0) },
+		ESplineCoordinateSpace::Local);
+	spline->SetClosedLoop(true);
+}
+
+void AGrassBakeRegion::GetPolygon(std::vector<float>& points) const
+{
+	float length = spline->GetSplineLength();
+	int pieces = FMath::Max(FMath::CeilToInt(length / polygonStep), spline->GetNumberOfSplinePoints());
+	for (int i = 0; i < pieces; i++)
+	{
+		FVector point = spline->GetLocationAtDistanceAlongSpline(length * i / pieces, ESplineCoordinateSpace::World);
+		points.push_back(point.X);
+		points.push_back(point.Y);
+	}
+}
+
+int AGrassBakeRegion::GatherRegions(UWorld* world, bool selectedLandscapeComponents, grassSampling::CoverageMask& mask)
+{
+	if (world == nullptr)
+		return 0;
+
+	int added = 0;
+	for (TActorIterator<AGrassBakeRegion> iterator(world); iterator; ++iterator)
+	{
+		std::vector<float> points;
+		iterator->GetPolygon(points);
+		mask.AddPolygon(points);
+		added++;
+	}
+
+#if WITH_EDITOR
+	if (!selectedLandscapeComponents)
+		return added;
+
+	TSet<ULandscapeInfo*> infos;
+	for (TActorIterator<ALandscapeProxy> iterator(world); iterator; ++iterator)
+		if (iterator->GetLandscapeInfo() != nullptr)
+			infos.Add(iterator->GetLandscapeInfo());
+
+	for (ULandscapeInfo* info : infos)
+	{
+		for (ULandscapeComponent* component : info->GetSelectedComponents())
+		{
+			FBox box = component->Bounds.GetBox();
+			mask.AddPolygon({ box.Min.X, box.Min.Y, box.Max.X, box.Min.Y, box.Max.X, box.Max.Y, box.Min.X, box.Max.Y });
+			added++;
+		}
+	}
+#endif
+	return added;
+}
@@ -0,0 +1,144 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "GrassBakeShards.h"
+#include "PoissonTileSet.h"
+#include "HAL/FileManager.h"
+#include "Misc/Crc.h"
+#include "Misc/PackageName.h"
+
+static const uint32 bakeChunkFileMagic = 0x43425047; //GPBC
+static const uint32 bakeChunkFileVersion = 1;
+
+static FArchive& operator<<(FArchive& ar, FGrassSpawnBatch& batch)
+{
+	for (int shape = 0; shape < GPGrassShapeCount; shape++)
+		ar << batch.bladeTransforms[shape];
+	ar << batch.turfCenters;
+	ar << batch.billboardTransforms;
+	for (int kind = 0; kind < GPFlowerKindCount; kind++)
+		ar << batch.flowerTransforms[kind];
+	ar << batch.clumpTransforms;
+	ar << batch.turfs;
+	return ar;
+}
+
+static FArchive& operator<<(FArchive& ar, FGrassBakeCell& bakedCell)
+{
+	ar << bakedCell.cell;
+	ar << bakedCell.turfCenters;
+	ar << bakedCell.batch;
+	return ar;
+}
+
+int FGrassBakeChunk::SaveToFile(const FString& fileName)
+{
+	FString tempFileName = fileName + TEXT(".tmp");
+	FArchive* writer = IFileManager::Get().CreateFileWriter(*tempFileName);
+	if (writer == nullptr)
+		return 0;
+
+	uint32 magic = bakeChunkFileMagic, version = bakeChunkFileVersion;
+	*writer << magic << version << settingsHash << shard << shardCount;
+	*writer << cells;
+	bool failed = writer->IsError();
+	delete writer;
+
+	if (failed || !IFileManager::Get().Move(*fileName, *tempFileName))
+	{
+		IFileManager::Get().Delete(*tempFileName);
+		return 0;
+	}
+	return 1;
+}
+
+int FGrassBakeChunk::LoadFromFile(const FString& fileName, bool headerOnly)
+{
+	FArchive* reader = IFileManager::Get().CreateFileReader(*fileName);
+	if (reader == nullptr)
+		return 0;
+
+	uint32 magic = 0, version = 0;
+	*reader << magic << version;
+	if (magic != bakeChunkFileMagic || version != bakeChunkFileVersion)
+	{
+		delete reader;
+		return 0;
+	}
+	*reader << settingsHash << shard << shardCount;
+	if (!headerOnly)
+		*reader << cells;
+	bool failed = reader->IsError();
+	delete reader;
+	return failed ? 0 : 1;
+}
+
+bool FGrassBakeChunk::IsChunkValid(const FString& fileName, uint32 settingsHash, int shard, int shardCount)
+{
+	FGrassBakeChunk header;
+	return header.LoadFromFile(fileName, true) && header.settingsHash == settingsHash && header.shard == shard &&
+		header.shardCount == shardCount;
+}
+
+int FGrassBakeShards::ShardOfCell(FIntPoint cell, int shardCount)
+{
+	return grassSampling::HashCoordinates(cell.X, cell.Y, 0) % (uint32)FMath::Max(shardCount, 1);
+}
+
+uint32 FGrassBakeShards::GetSettingsHash(const FString& settings, const FString& map)
+{
+	return FCrc::StrCrc32(*map, FCrc::StrCrc32(*settings));
+}
+
+void FGrassBakeShards::GetMergeOrder(const TArray<FGrassBakeChunk>& chunks, TArray<FIntPoint>& order)
+{
+	order.Reset();
+	for (int chunk = 0; chunk < chunks.Num(); chunk++)
+		for (int cell = 0; cell < chunks[chunk].cells.Num(); cell++)
+			order.Add(FIntPoint(chunk, cell));
+
+	order.Sort([&chunks](const FIntPoint& a, const FIntPoint& b) {
+		const FIntPoint& cellA = chunks[a.X].cells[a.Y].cell;
+		const FIntPoint& cellB = chunks[b.X].cells[b.Y].cell;
+		return cellA.Y != cellB.Y ? cellA.Y < cellB.Y : cellA.X < cellB.X;
+	});
+}
+
+FString FGrassBakeShards::GetChunkPath(const FString& outputDir, int shard)
+{
+	return outputDir / FString::Printf(TEXT("Shard_%i.bin"), shard);
+}
+
+FString FGrassBakeShards::GetDefaultSettingsPath()
+{
+	return FPaths::ProjectSavedDir() + FString("GrassPlugin/BakeSettings.ini");
+}
+
+FString FGrassBakeShards::GetDefaultOutputDir(const FString& map)
+{
+	return FPaths::ProjectSavedDir() + FString("GrassPlugin/Bake/") + FPackageName::GetShortName(map);
+}
@@ -1,405 +1,1211 @@
-// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
-//
-// Redistribution and use in source and binary forms, with or without
-// modification, are permitted provided that the following conditions are met:
-//
-//   1. Redistributions of source code must retain the above copyright notice,
-//      this list of conditions and the following disclaimer.
-//
-//   2. Redistributions in binary form must reproduce the above copyright notice,
-//      this list of conditions and the following disclaimer in the documentation
-//      and/or other materials provided with the distribution.
-//
-//   3. Neither the name of the copyright holder nor the names of its contributors
-//      may be used to endorse or promote products derived from this software
-//      without specific prior written permission.
-//
-// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
-// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
-// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
-// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
-// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
-// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
-// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
-// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
-// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
-// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
-// POSSIBILITY OF SUCH DAMAGE.
-
-#include "GrassBlade.h"
-
-
-AGrassBlade::AGrassBlade(const FObjectInitializer& objectInitializer) : Super(objectInitializer)
-{
-
-	grassBlades = objectInitializer.CreateDefaultSubobject<UHierarchicalInstancedStaticMeshComponent>(this, TEXT("grassInstances"));
-	triangleGrassBlades = objectInitializer.CreateDefaultSubobject<UHierarchicalInstancedStaticMeshComponent>(this, TEXT("triGrassInstances"));
-	triangleQuadGrassBlades = objectInitializer.CreateDefaultSubobject<UHierarchicalInstancedStaticMeshComponent>(this, TEXT("triQuadGrassInstances"));
-
-	billboardTurfInstances = objectInitializer.CreateDefaultSubobject<UHierarchicalInstancedStaticMeshComponent>(this, TEXT("billboardInstaces"));
-	RootComponent = grassBlades;
-	InitiateMesh();
-
-	InitAllInstancesSelectability();
-	InitCullDistance();
-	InitShadowCast();
-
-	InitAllInstancesCollision();
-	
-	SetActiveGrassBlades(EGPGrassShape::Quad);
-}
-
-
-void AGrassBlade::InitiateMesh()
-{
-	UGVar* configVars = UGVar::StaticClass()->GetDefaultObject<UGVar>();
-
-	InitiateHierarchicalInstanceMesh(grassBlades, configVars->quadMeshLocation);
-	InitiateHierarchicalInstanceMesh(triangleGrassBlades, configVars->triangleMeshLocation);
-	InitiateHierarchicalInstanceMesh(triangleQuadGrassBlades, configVars->triangleQuadMeshLocation);
-
-	InitiateHierarchicalInstanceMesh(billboardTurfInstances, configVars->billBoardMeshLocation);
-}
-
-
-
-void AGrassBlade::ClearInstances()
-{
-	ClearHierarchicalInstances(grassBlades);
-	ClearHierarchicalInstances(triangleGrassBlades);
-	ClearHierarchicalInstances(triangleQuadGrassBlades);
-
-	ClearHierarchicalInstances(billboardTurfInstances);
-}
-
-void AGrassBlade::SpawnGrassBlades(int amount, int startIndex, FVector4 bounds, FVector patchPosition, FVector textureCorner, int textureWidth, bool shouldSnapToTerrain)
-{
-	for (int i = startIndex; i < startIndex + amount; i++) {
-		uint16 randomAngle = FMath::RandRange(0, 359);
-		FRotator bladeRotation(0, randomAngle, 0);
-		FQuat bladeQ(bladeRotation);
-
-		FRotator cubeRotation(0, randomAngle, 90);
-		FQuat boxQ(cubeRotation);
-
-		int randomX = FMath::RandRange(bounds.X, bounds.Z);
-		int randomY = FMath::RandRange(bounds.Y, bounds.W);
-		FVector bladePosition = patchPosition + FVector(randomX, randomY, 0);
-		//setting index
-		
-		FTransform transform;
-		if (shouldSnapToTerrain) {
-			FQuat normalQuat;
-			if (!SnapingAdjustments(bladePosition, normalQuat))
-				continue;
-			transform.SetRotation(normalQuat * bladeQ);
-		}
-		else
-			transform.SetRotation(bladeQ);
-
-		transform.SetLocation(bladePosition);
-		
-		int32 index = activeGrassBladesInstances->AddInstance(transform);
-		int indexOfPos = 4*(i);
-		//encoding sign of vector into uint
-		int sign = HelperFunctions::CompressSignValues(bladePosition);
-		//put position within array
-	}
-}
-
-void AGrassBlade::SpawnGrassBladesAroundPosition(int amount, int radius, FVector position, bool shouldSnapToTerrain, FQuat normalQuat)
-{
-	//spawn of billboard garss turf
-	if(!experimentalLOD)
-		SpawnBillboardGrassTurf(position, radius, shouldSnapToTerrain, normalQuat);
-
-	float precision = 1000;
-	for (int i = 0; i < amount; i++) {
-		FVector pos = GenRandomPositionWithinRad(position, radius, precision);
-		uint16 randomAngle = FMath::RandRange(0, 359);
-		uint16 randomSize = FMath::RandRange(1,2);
-		FVector size = FVector(1,1,randomSize);
-		FRotator bladeRotation(0, randomAngle, 0);
-		FQuat bladeQ(bladeRotation);
-
-		FRotator cubeRotation(0, randomAngle, 90);
-		FQuat boxQ(cubeRotation);
-
-		FTransform transform;
-		
-		if (shouldSnapToTerrain) {
-			if (!SnapingAdjustments(pos, normalQuat))
-				continue;
-			transform.SetRotation(normalQuat * bladeQ);
-		}
-		else
-			transform.SetRotation(bladeQ);
-		if (pos == FVector::ZeroVector)
-			continue;
-		transform.SetLocation(pos);
-		transform.SetScale3D(size);
-		
-		activeGrassBladesInstances->AddInstance(transform);
-
-	}
-
-}
-
-void AGrassBlade::SpawnFlowersAroundPosition(FVector position, int minAmount, int maxAmount, float innerFlowerRadius, EGPFlower flowerKind, bool shouldSnapToTerrain, FQuat normalQuat, float spawnWeight)
-{
-	float weight = 2 - spawnWeight;
-	int amount = floor(minAmount + (maxAmount - minAmount) * (pow(FMath::RandRange(0.f,1.f), weight)));
-
-	float precision = 1000;
-	for (int i = 0; i < amount; i++)
-	{
-		FVector pos = GenRandomPositionWithinRad(position, innerFlowerRadius, precision); 
-		uint16 randomAngle = FMath::RandRange(0, 359);
-		FRotator bladeRotation(0, randomAngle, 0);
-		FQuat bladeQ(bladeRotation);
-		
-		FTransform transform;
-
-		if (shouldSnapToTerrain) {
-			if (!SnapingAdjustments(pos, normalQuat))
-				continue;
-			transform.SetRotation(normalQuat * bladeQ);
-		}
-		else
-			transform.SetRotation(bladeQ);
-		if (pos == FVector::ZeroVector)
-			continue;
-		transform.SetLocation(pos);
-		transform.SetScale3D(FVector(1,1,1));
-	}
-}
-
-void AGrassBlade::SpawnDefaultObject(int index)
-{
-	FTransform transform;
-	transform.SetLocation(FVector(-5500, 1060, 0));
-	activeGrassBladesInstances->AddInstance(transform);
-	
-}
-
-
-void AGrassBlade::InitializeMaterials(UMaterialInstanceDynamic* material, UMaterialInstanceDynamic* billboardMat)
-{
-	dynMaterial = material;
-	grassBlades->SetMaterial(0, material);
-	triangleGrassBlades->SetMaterial(0, material);
-	triangleQuadGrassBlades->SetMaterial(0, material);
-
-	bbMat = billboardMat;
-	billboardTurfInstances->SetMaterial(0, billboardMat);
-	
-}
-
-void AGrassBlade::SetMaterialTextureSize(int textureWidth, int textureHeight)
-{
-	dynMaterial->SetScalarParameterValue(FName("textureWidth"), textureWidth);
-	dynMaterial->SetScalarParameterValue(FName("textureHeight"), textureHeight);
-	activeGrassBladesInstances->SetMaterial(0, dynMaterial);
-}
-
-void AGrassBlade::SetMaterialMovementPosition(const FTransform &transform)
-{
-	dynMaterial->SetVectorParameterValue(FName("movementPosition"), transform.GetLocation());
-	activeGrassBladesInstances->SetMaterial(0, dynMaterial);
-}
-
-
-void AGrassBlade::SpawnBillboardGrassTurf(FVector position, int radius, bool shouldSnapToTerrain, FQuat normalQuat)
-{
-	uint16 randomAngle = FMath::RandRange(0, 359);
-	uint16 randomSize = FMath::RandRange(1, 2);
-	FVector size = FVector(1, 1, randomSize);
-	FRotator bladeRotation(0, randomAngle, 0);
-	FQuat bladeQ(bladeRotation);
-
-	FRotator cubeRotation(0, randomAngle, 90);
-	FQuat boxQ(cubeRotation);
-
-	FTransform transform;
-
-	if (shouldSnapToTerrain) {
-		if (!SnapingAdjustments(position, normalQuat))
-			return;
-		transform.SetRotation(normalQuat * bladeQ);
-	}
-	else
-		transform.SetRotation(bladeQ);
-	if (position == FVector::ZeroVector)
-		return;
-	transform.SetLocation(position);
-	transform.SetScale3D(size);
-
-	billboardTurfInstances->AddInstance(transform);
-
-}
-void AGrassBlade::SetupDefaultTexture(UTexture2D*& texture, int textureWidth, int textureHeight, EPixelFormat format)
-{
-	texture->AddToRoot();
-	texture->PlatformData = new FTexturePlatformData();
-	texture->PlatformData->SizeX = textureWidth;
-	texture->PlatformData->SizeY = textureHeight;
-	texture->PlatformData->SetNumSlices(1);
-	texture->PlatformData->PixelFormat = EPixelFormat::PF_R8G8B8A8;
-}
-
-
-void AGrassBlade::SetActiveGrassBlades(EGPGrassShape shape)
-{
-	switch (shape) {
-	case 0:
-		activeGrassBladesInstances = grassBlades;
-		break;
-	case 1:
-		activeGrassBladesInstances = triangleGrassBlades;
-		break;
-	case 2:
-		activeGrassBladesInstances = triangleQuadGrassBlades;
-		break;
-	}
-}
-
-void AGrassBlade::ClearHierarchicalInstances(UHierarchicalInstancedStaticMeshComponent* instances) {
-	if (instances != NULL)
-		if (instances->GetNumRenderInstances() > 1)
-			instances->ClearInstances();
-}
-
-void AGrassBlade::InitiateHierarchicalInstanceMesh(UHierarchicalInstancedStaticMeshComponent* instances, FString meshLocation) {
-	UStaticMesh* staticMeshOb = LoadObject<UStaticMesh>(nullptr, *meshLocation);
-	if (staticMeshOb == NULL)
-		staticMeshOb = Cast<UStaticMesh>(FSoftObjectPath(meshLocation).TryLoad());
-
-	instances->SetStaticMesh(staticMeshOb);
-}
-
-void AGrassBlade::FindLandScapeRayTrace(FVector start, FVector end, FHitResult & hitResult)
-{
-	ECollisionChannel colChannel = ECollisionChannel::ECC_WorldStatic;
-
-	FCollisionQueryParams TraceParams(FName(TEXT("landscape trace")), true);
-
-	TraceParams.bTraceComplex = true;
-	TraceParams.bReturnPhysicalMaterial = false;
-	TraceParams.bFindInitialOverlaps = false;
-
-	hitResult = FHitResult(ForceInit);
-
-	
-#if WITH_EDITOR
-	UEditorEngine* editor = GEditor;
-	UWorld* world = editor->GetLevelViewportClients()[0]->GetWorld();
-#else
-	UWorld* world = GetWorld();
-#endif
-
-	FVector st = start;
-
-	while (st.Z > end.Z) {
-		hitResult = FHitResult(ForceInit);
-		world->LineTraceSingleByChannel(hitResult, st, end, colChannel, TraceParams);
-		if (!hitResult.IsValidBlockingHit()) {
-			break;
-		}else if (GetNameSafe(hitResult.GetActor()).Contains(FString("Landscape"))) {
-			break;
-		}
-		else if (IsValid(hitResult.GetActor())) {
-			if (!hitResult.GetActor()->Tags.Contains(FName("grassEnable"))) {
-				hitResult.Reset();
-
-				break;
-			}
-			else
-			{
-				break;
-			}
-		}
-		else {
-			
-			st = hitResult.Location + FVector(0,0,-1);
-		}
-	}
-	
-}
-
-int AGrassBlade::AdjustPosition(FVector& position, FVector& impactNormal)
-{
-		FHitResult res;
-		position = position + FVector(0, 0, rayLength / 2);
-		FindLandScapeRayTrace(position, FVector(0, 0, -rayLength) + position, res);
-		position = res.Location;
-		impactNormal = res.Normal;
-		return res.IsValidBlockingHit();
-}
-
-FQuat AGrassBlade::FindQuatOfNormal(const FVector & upVector, const FVector & normal)
-{
-	FVector rotationAxis = FVector::CrossProduct(upVector, normal);
-	rotationAxis.Normalize();
-
-	float dotproduct = FVector::DotProduct(upVector, normal);
-	float rotationAngle = acosf(dotproduct);
-
-	FQuat resultQuat = FQuat(rotationAxis, rotationAngle);
-
-	return resultQuat;
-}
-
-FVector AGrassBlade::GenRandomPositionWithinRad(FVector position, int radius, float precision)
-{
-	float t = 2 * PI * (FMath::RandRange(0.f, precision) / precision);
-	float r = radius * FMath::Square(FMath::RandRange(-radius * precision, radius * precision) / precision);
-	return FVector(r * FMath::Cos(t), r * FMath::Sin(t), 0) + position;
-}
-
-void AGrassBlade::InitAllInstancesSelectability()
-{
-	billboardTurfInstances->bSelectable = false;
-	grassBlades->bSelectable = false;
-	triangleGrassBlades->bSelectable = false;
-	triangleQuadGrassBlades->bSelectable = false;
-}
-
-void AGrassBlade::InitAllInstancesCollision()
-{
-	grassBlades->bDisableCollision = true;
-	triangleGrassBlades->bDisableCollision = true;
-	triangleQuadGrassBlades->bDisableCollision = true;
-	billboardTurfInstances->bDisableCollision = true;
-}
-
-void AGrassBlade::InitShadowCast()
-{
-	grassBlades->SetCastShadow(false);
-	triangleGrassBlades->SetCastShadow(false);
-	triangleQuadGrassBlades->SetCastShadow(false);
-	billboardTurfInstances->SetCastShadow(false);
-}
-
-void AGrassBlade::InitCullDistance()
-{
-	UGVar* vars = (UGVar*)NewObject<UGVar>(UGVar::StaticClass());
-	int cullDistance = vars->detailedGrassCullDistance;
-
-	grassBlades->InstanceEndCullDistance = cullDistance;
-	triangleGrassBlades->InstanceEndCullDistance = cullDistance;
-	triangleQuadGrassBlades->InstanceEndCullDistance = cullDistance;
-
-	billboardTurfInstances->InstanceStartCullDistance = cullDistance;
-	billboardTurfInstances->InstanceEndCullDistance = vars->lodCullDistanceFar;
-}
-
-int AGrassBlade::SnapingAdjustments(FVector & position, FQuat& normalQuat)
-{
-	FVector upVector = FVector(0, 0, 1);
-	FVector normal = upVector;
-	int output = AdjustPosition(position, normal);
-	normalQuat = FindQuatOfNormal(upVector, normal);
-	normalQuat.Normalize();
-	return output;
-}
-
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include "GrassBlade.h"
+
+#include "GrassPatchRegistry.h"
+#include "LandscapeProxy.h"
+#include "Misc/PackageName.h"
+#include "PoissonTileSet.h"
+#include <algorithm>
+
+
+AGrassBlade::AGrassBlade(const FObjectInitializer& objectInitializer) : Super(objectInitializer)
+{
+
+	grassBlades = objectInitializer.CreateDefaultSubobject<UHierarchicalInstancedStaticMeshComponent>(this, TEXT("grassInstances"));
+	triangleGrassBlades = objectInitializer.CreateDefaultSubobject<UHierarchicalInstancedStaticMeshComponent>(this, TEXT("triGrassInstances"));
+	triangleQuadGrassBlades = objectInitializer.CreateDefaultSubobject<UHierarchicalInstancedStaticMeshComponent>(this, TEXT("triQuadGrassInstances"));
+
+	billboardTurfInstances = objectInitializer.CreateDefaultSubobject<UHierarchicalInstancedStaticMeshComponent>(this, TEXT("billboardInstaces"));
+
+	daisyFlowers = objectInitializer.CreateDefaultSubobject<UHierarchicalInstancedStaticMeshComponent>(this, TEXT("daisyInstances"));
+	violaFlowers = objectInitializer.CreateDefaultSubobject<UHierarchicalInstancedStaticMeshComponent>(this, TEXT("violaInstances"));
+	RootComponent = grassBlades;
+	InitiateMesh();
+
+	//ticks only while there are gameplay changes of instances waiting for upload
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+
+	UGVar* configVars = UGVar::StaticClass()->GetDefaultObject<UGVar>();
+	instanceIndex = FGrassInstanceIndex(configVars->instanceIndexCellSize);
+
+	InitAllInstancesSelectability();
+	InitCullDistance();
+	InitShadowCast();
+
+	InitAllInstancesCollision();
+	
+	SetActiveGrassBlades(EGPGrassShape::Quad);
+}
+
+
+void AGrassBlade::InitiateMesh()
+{
+	UGVar* configVars = UGVar::StaticClass()->GetDefaultObject<UGVar>();
+
+	InitiateHierarchicalInstanceMesh(grassBlades, configVars->quadMeshLocation);
+	InitiateHierarchicalInstanceMesh(triangleGrassBlades, configVars->triangleMeshLocation);
+	InitiateHierarchicalInstanceMesh(triangleQuadGrassBlades, configVars->triangleQuadMeshLocation);
+
+	InitiateHierarchicalInstanceMesh(billboardTurfInstances, configVars->billBoardMeshLocation);
+
+	InitiateHierarchicalInstanceMesh(daisyFlowers, configVars->flowerMeshLocation);
+	InitiateHierarchicalInstanceMesh(violaFlowers, configVars->flowerMeshLocation);
+	InitiateHierarchicalInstanceMaterial(daisyFlowers, configVars->daisyMatLocation);
+	InitiateHierarchicalInstanceMaterial(violaFlowers, configVars->violaMatLocation);
+}
+
+
+
+void AGrassBlade::ClearInstances()
+{
+	ClearHierarchicalInstances(grassBlades);
+	ClearHierarchicalInstances(triangleGrassBlades);
+	ClearHierarchicalInstances(triangleQuadGrassBlades);
+
+	ClearHierarchicalInstances(billboardTurfInstances);
+
+	ClearHierarchicalInstances(daisyFlowers);
+	ClearHierarchicalInstances(violaFlowers);
+
+	for (UHierarchicalInstancedStaticMeshComponent* clump : clumpInstances)
+		ClearHierarchicalInstances(clump);
+
+	grassBounds.Init();
+	UpdateRegistration();
+}
+
+void AGrassBlade::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+	FlushGrassStateUpdates();
+}
+
+void AGrassBlade::PostRegisterAllComponents()
+{
+	Super::PostRegisterAllComponents();
+
+	//patches saved before grass bounds were tracked take bounds of their instance managers
+	if (!grassBounds.IsValid)
+	{
+		TArray<UHierarchicalInstancedStaticMeshComponent*> managers;
+		GetAllInstanceManagers(managers);
+		for (UHierarchicalInstancedStaticMeshComponent* instances : managers)
+			if (instances->GetInstanceCount() > 0)
+				grassBounds += instances->Bounds.GetBox();
+	}
+	UpdateRegistration();
+}
+
+void AGrassBlade::PostUnregisterAllComponents()
+{
+	UWorld* world = GetWorld();
+	UGrassPatchRegistry* registry = world != nullptr ? world->GetSubsystem<UGrassPatchRegistry>() : nullptr;
+	if (registry != nullptr)
+		registry->UnregisterGrassPatch(this);
+
+	Super::PostUnregisterAllComponents();
+}
+
+void AGrassBlade::UpdateRegistration()
+{
+	UWorld* world = GetWorld();
+	UGrassPatchRegistry* registry = world != nullptr ? world->GetSubsystem<UGrassPatchRegistry>() : nullptr;
+	if (registry != nullptr && !IsPendingKill())
+		registry->RegisterGrassPatch(this);
+}
+
+void AGrassBlade::SpawnGrassBladesAroundPosition(int amount, int radius, FVector position, bool shouldSnapToTerrain, FQuat normalQuat)
+{
+	FGrassSpawnBatch batch;
+	FRandomStream stream(FMath::Rand());
+	AddTurfToBatch(batch, stream, activeShape, amount, radius, position, shouldSnapToTerrain, normalQuat);
+	CommitBatch(batch);
+}
+
+void AGrassBlade::AddTurfToBatch(FGrassSpawnBatch& batch, FRandomStream& stream, EGPGrassShape shape, int amount, int radius, FVector position, bool shouldSnapToTerrain, FQuat normalQuat)
+{
+	turfCenters.Add(FVector2D(position));
+	if (recordedDelta != nullptr)
+		recordedDelta->RecordAddedTurfCenters(1);
+	if (turfCenterGrid.Num() + 1 == turfCenters.Num())
+		turfCenterGrid.Add(position.X, position.Y);
+
+	//clump turf is one instance placed on the snapped turf center instead of separately snapped blades
+	int clump = useClumps ? ChooseClump(stream, shape) : INDEX_NONE;
+	if (clump == INDEX_NONE)
+		GenerateGrassBladesAroundPosition(stream, amount, radius, position, shouldSnapToTerrain, normalQuat, batch.bladeTransforms[(int)shape]);
+
+	//turf center is snapped only once and shared by clump, billboard and flowers
+	bool withFlowers = flowerSettings.enabled && stream.FRand() < flowerSettings.turfChance;
+	if (clump != INDEX_NONE || !experimentalLOD || withFlowers)
+	{
+		FVector center = position;
+		FQuat centerQuat = normalQuat;
+		if ((!shouldSnapToTerrain || SnapingAdjustments(center, centerQuat)) && center != FVector::ZeroVector)
+		{
+			if (clump != INDEX_NONE)
+			{
+				if (batch.clumpTransforms.Num() <= clump)
+					batch.clumpTransforms.SetNum(clumpInstances.Num());
+				FQuat clumpQ(FRotator(0, stream.RandRange(0, 359), 0));
+				batch.clumpTransforms[clump].Add(FTransform(centerQuat * clumpQ, center));
+			}
+			if (!experimentalLOD)
+				batch.turfCenters.Add(FTransform(centerQuat, center));
+			if (withFlowers)
+				GenerateFlowersAroundPosition(stream, center, flowerSettings.minAmount, flowerSettings.maxAmount, flowerSettings.innerFlowerRadius,
+					flowerSettings.flowerKind, centerQuat, flowerSettings.spawnWeight, batch);
+		}
+	}
+	batch.turfs++;
+}
+
+void AGrassBlade::GenerateBillboardPass(FGrassSpawnBatch& batch, int turfsPerBillboard)
+{
+	if (turfsPerBillboard <= 1 || billboardClusterSize <= 0)
+	{
+		for (const FTransform& center : batch.turfCenters)
+			batch.billboardTransforms.Add(GenerateBillboardTransform(center.GetLocation(), center.GetRotation(), 1));
+		batch.turfCenters.Reset();
+		return;
+	}
+
+	//turfs are clustered by world aligned squares, every square gets one billboard in the centroid of its turfs
+	struct FBillboardCluster {
+		FVector locationSum = FVector::ZeroVector;
+		FVector normalSum = FVector::ZeroVector;
+		int count = 0;
+	};
+	TMap<FIntPoint, FBillboardCluster> clusters;
+	for (const FTransform& center : batch.turfCenters)
+	{
+		FVector location = center.GetLocation();
+		FIntPoint key(FMath::FloorToInt(location.X / billboardClusterSize), FMath::FloorToInt(location.Y / billboardClusterSize));
+		FBillboardCluster& cluster = clusters.FindOrAdd(key);
+		cluster.locationSum += location;
+		cluster.normalSum += center.GetRotation().RotateVector(FVector(0, 0, 1));
+		cluster.count++;
+	}
+
+	FVector upVector = FVector(0, 0, 1);
+	for (const TPair<FIntPoint, FBillboardCluster>& clusterPair : clusters)
+	{
+		const FBillboardCluster& cluster = clusterPair.Value;
+		FVector normal = cluster.normalSum.GetSafeNormal();
+		FQuat normalQuat = normal.Equals(upVector) || normal.IsNearlyZero() ? FQuat::Identity : FindQuatOfNormal(upVector, normal);
+		batch.billboardTransforms.Add(GenerateBillboardTransform(cluster.locationSum / cluster.count, normalQuat,
+			FMath::Sqrt((float)cluster.count)));
+	}
+	batch.turfCenters.Reset();
+}
+
+void AGrassBlade::CommitBatch(FGrassSpawnBatch& batch)
+{
+	GenerateBillboardPass(batch, billboardTurfsPerBillboard);
+
+	for (int shape = 0; shape < GPGrassShapeCount; shape++)
+	{
+		AddIndexedInstances(GetGrassBladesInstances((EGPGrassShape)shape), batch.bladeTransforms[shape]);
+		batch.bladeTransforms[shape].Reset();
+	}
+	AddIndexedInstances(billboardTurfInstances, batch.billboardTransforms);
+	batch.billboardTransforms.Reset();
+
+	for (int kind = 0; kind < GPFlowerKindCount; kind++)
+	{
+		AddIndexedInstances(GetFlowerInstances((EGPFlower)kind), batch.flowerTransforms[kind]);
+		batch.flowerTransforms[kind].Reset();
+	}
+
+	for (int clump = 0; clump < batch.clumpTransforms.Num() && clump < clumpInstances.Num(); clump++)
+	{
+		AddIndexedInstances(clumpInstances[clump], batch.clumpTransforms[clump]);
+		batch.clumpTransforms[clump].Reset();
+	}
+	batch.turfs = 0;
+	UpdateRegistration();
+}
+
+void AGrassBlade::SetClumpMeshes(EGPGrassShape shape, const TArray<UStaticMesh*>& meshes)
+{
+	//instance managers of the model are reused in order, missing ones get created, extra ones lose their mesh
+	int variant = 0;
+	for (int i = 0; i < clumpInstances.Num(); i++)
+	{
+		if (clumpShapes[i] != shape)
+			continue;
+		if (variant >= meshes.Num())
+			ClearHierarchicalInstances(clumpInstances[i]);
+		clumpInstances[i]->SetStaticMesh(variant < meshes.Num() ? meshes[variant] : nullptr);
+		variant++;
+	}
+
+	for (; variant < meshes.Num(); variant++)
+	{
+		FName name = MakeUniqueObjectName(this, UHierarchicalInstancedStaticMeshComponent::StaticClass(), FName("clumpInstances"));
+		UHierarchicalInstancedStaticMeshComponent* instances = NewObject<UHierarchicalInstancedStaticMeshComponent>(this, name);
+		instances->SetupAttachment(RootComponent);
+		instances->SetStaticMesh(meshes[variant]);
+		InitClumpInstances(instances);
+		instances->RegisterComponent();
+		AddInstanceComponent(instances);
+
+		clumpInstances.Add(instances);
+		clumpShapes.Add(shape);
+	}
+}
+
+int AGrassBlade::ChooseClump(FRandomStream& stream, EGPGrassShape shape)
+{
+	TArray<int, TInlineAllocator<16>> candidates;
+	for (int i = 0; i < clumpInstances.Num(); i++)
+		if (clumpShapes[i] == shape && clumpInstances[i]->GetStaticMesh() != nullptr)
+			candidates.Add(i);
+
+	if (candidates.Num() == 0)
+		return INDEX_NONE;
+	return candidates[stream.RandRange(0, candidates.Num() - 1)];
+}
+
+void AGrassBlade::InitClumpInstances(UHierarchicalInstancedStaticMeshComponent* instances)
+{
+	if (dynMaterial != nullptr)
+		instances->SetMaterial(0, dynMaterial);
+	instances->bSelectable = false;
+	instances->bDisableCollision = true;
+	instances->SetCastShadow(false);
+	instances->InstanceEndCullDistance = grassBlades->InstanceEndCullDistance;
+}
+
+void AGrassBlade::GenerateGrassBladesAroundPosition(FRandomStream& stream, int amount, int radius, FVector position, bool shouldSnapToTerrain, FQuat normalQuat, TArray<FTransform>& bladeTransforms)
+{
+	float precision = 1000;
+	for (int i = 0; i < amount; i++) {
+		FVector pos = GenRandomPositionWithinRad(stream, position, radius, precision);
+		uint16 randomAngle = stream.RandRange(0, 359);
+		uint16 randomSize = stream.RandRange(1,2);
+		FVector size = FVector(1,1,randomSize);
+		FRotator bladeRotation(0, randomAngle, 0);
+		FQuat bladeQ(bladeRotation);
+
+		FRotator cubeRotation(0, randomAngle, 90);
+		FQuat boxQ(cubeRotation);
+
+		FTransform transform;
+		
+		if (shouldSnapToTerrain) {
+			if (!SnapingAdjustments(pos, normalQuat))
+				continue;
+			transform.SetRotation(normalQuat * bladeQ);
+		}
+		else
+			transform.SetRotation(bladeQ);
+		if (pos == FVector::ZeroVector)
+			continue;
+		transform.SetLocation(pos);
+		transform.SetScale3D(size);
+		
+		bladeTransforms.Add(transform);
+	}
+}
+
+void AGrassBlade::GenerateTurfLayout(grassSampling::RandomStream& stream, int amount, float radius, FVector position, FQuat normalQuat, TArray<FTransform>& bladeTransforms)
+{
+	//same distribution as GenRandomPositionWithinRad
+	FVector normal = normalQuat.RotateVector(FVector(0, 0, 1));
+	const float center[3] = { position.X, position.Y, position.Z };
+	const float normalValues[3] = { normal.X, normal.Y, normal.Z };
+	std::vector<grassSampling::TurfBlade> blades;
+	grassSampling::GenerateTurfLayout(blades, stream, amount, radius, center, normalValues);
+
+	bladeTransforms.Reserve(bladeTransforms.Num() + blades.size());
+	for (const grassSampling::TurfBlade& blade : blades)
+	{
+		FQuat bladeQ(FRotator(0, blade.yaw, 0));
+		bladeTransforms.Add(FTransform(normalQuat * bladeQ, FVector(blade.x, blade.y, blade.z), FVector(1, 1, blade.height)));
+	}
+}
+
+void AGrassBlade::AddProgressiveTurf(FIntPoint cell, FRandomStream& stream, EGPGrassShape shape, int amount, int radius, FVector position, bool shouldSnapToTerrain, FQuat normalQuat)
+{
+	FGrassProgressiveCell* existing = progressiveCells.Find(cell);
+	if (recordedDelta != nullptr)
+		recordedDelta->RecordProgressiveCell(cell, existing);
+	FGrassProgressiveCell& cellData = existing != nullptr ? *existing : progressiveCells.Add(cell);
+	//stored turfs are not spawned, cells stored before spawned turfs were tracked keep the amount they have
+	cellData.spawnedTurfs = GetSpawnedTurfs(cellData);
+
+	//progressive cells keep one billboard per turf, turfDensity thins them out together with the blades
+	FGrassSpawnBatch turfBatch;
+	AddTurfToBatch(turfBatch, stream, shape, amount, radius, position, shouldSnapToTerrain, normalQuat);
+	GenerateBillboardPass(turfBatch, 1);
+
+	int clump = INDEX_NONE;
+	for (int i = 0; i < turfBatch.clumpTransforms.Num() && clump == INDEX_NONE; i++)
+		if (turfBatch.clumpTransforms[i].Num() > 0)
+			clump = i;
+
+	cellData.bladeTransforms.Append(clump == INDEX_NONE ? turfBatch.bladeTransforms[(int)shape] : turfBatch.clumpTransforms[clump]);
+	cellData.turfBladeEnds.Add(cellData.bladeTransforms.Num());
+	cellData.turfShapes.Add(shape);
+	cellData.turfClumps.Add(clump);
+	cellData.turfCenters.Add(FVector2D(position));
+	cellData.turfBounds += FVector2D(position);
+
+	cellData.billboardTransforms.Append(turfBatch.billboardTransforms);
+	cellData.turfBillboardEnds.Add(cellData.billboardTransforms.Num());
+
+	for (int kind = 0; kind < GPFlowerKindCount; kind++)
+	{
+		cellData.flowerTransforms.Append(turfBatch.flowerTransforms[kind]);
+		for (int i = 0; i < turfBatch.flowerTransforms[kind].Num(); i++)
+			cellData.flowerKinds.Add((EGPFlower)kind);
+	}
+	cellData.turfFlowerEnds.Add(cellData.flowerTransforms.Num());
+}
+
+int32 AGrassBlade::GetSpawnedTurfs(const FGrassProgressiveCell& cell) const
+{
+	return cell.spawnedTurfs != INDEX_NONE ? cell.spawnedTurfs : FMath::CeilToInt(cell.NumTurfs() * turfDensity);
+}
+
+void AGrassBlade::GatherProgressiveTurf(const FGrassProgressiveCell& cell, int32 turf, FGrassSpawnBatch& batch)
+{
+	int bladeStart = turf > 0 ? cell.turfBladeEnds[turf - 1] : 0;
+	int bladeEnd = cell.turfBladeEnds[turf];
+	//cells stored before clumps existed have no turfClumps
+	int clump = cell.turfClumps.IsValidIndex(turf) ? cell.turfClumps[turf] : INDEX_NONE;
+	if (clump != INDEX_NONE && clump < clumpInstances.Num())
+	{
+		if (batch.clumpTransforms.Num() <= clump)
+			batch.clumpTransforms.SetNum(clumpInstances.Num());
+		batch.clumpTransforms[clump].Append(cell.bladeTransforms.GetData() + bladeStart, bladeEnd - bladeStart);
+	}
+	else if (clump == INDEX_NONE)
+		batch.bladeTransforms[(int)cell.turfShapes[turf]].Append(cell.bladeTransforms.GetData() + bladeStart, bladeEnd - bladeStart);
+
+	int billboardStart = turf > 0 ? cell.turfBillboardEnds[turf - 1] : 0;
+	batch.billboardTransforms.Append(cell.billboardTransforms.GetData() + billboardStart, cell.turfBillboardEnds[turf] - billboardStart);
+
+	for (int flower = turf > 0 ? cell.turfFlowerEnds[turf - 1] : 0; flower < cell.turfFlowerEnds[turf]; flower++)
+		batch.flowerTransforms[(int)cell.flowerKinds[flower]].Add(cell.flowerTransforms[flower]);
+	batch.turfs++;
+}
+
+void AGrassBlade::SetTurfDensity(float density)
+{
+	density = FMath::Clamp(density, 0.f, 1.f);
+
+	//every cell adds or removes only the turfs between its spawned and its new amount
+	FGrassSpawnBatch added, removed;
+	for (TPair<FIntPoint, FGrassProgressiveCell>& cellPair : progressiveCells)
+	{
+		FGrassProgressiveCell& cell = cellPair.Value;
+		int spawned = GetSpawnedTurfs(cell);
+		int turfs = FMath::CeilToInt(cell.NumTurfs() * density);
+		if (turfs == spawned)
+			continue;
+
+		for (int turf = FMath::Min(spawned, turfs); turf < FMath::Max(spawned, turfs); turf++)
+			if (!cell.IsTurfErased(turf))
+				GatherProgressiveTurf(cell, turf, turfs > spawned ? added : removed);
+		if (recordedDelta != nullptr)
+			recordedDelta->RecordSpawnedTurfs(cellPair.Key, cell.spawnedTurfs);
+		cell.spawnedTurfs = turfs;
+	}
+
+	if (recordedDelta != nullptr && density != turfDensity)
+		recordedDelta->RecordTurfDensity(turfDensity);
+	turfDensity = density;
+	RemoveBatch(removed);
+	CommitBatch(added);
+}
+
+void AGrassBlade::ClearProgressiveCells()
+{
+	if (recordedDelta != nullptr)
+		recordedDelta->RecordClearedProgressiveCells(progressiveCells);
+	progressiveCells.Empty();
+}
+
+void AGrassBlade::RemoveGrassWithinRadius(FVector location, float radius)
+{
+	TArray<UHierarchicalInstancedStaticMeshComponent*> managers;
+	GetAllInstanceManagers(managers);
+	for (UHierarchicalInstancedStaticMeshComponent* instances : managers)
+	{
+		TArray<int32> found;
+		instanceIndex.QueryRadius(instances, location, radius, found);
+		RemoveIndexedInstances(instances, found);
+	}
+	if (progressiveCells.Num() > 0)
+		EraseProgressiveTurfs(FVector2D(location), radius);
+
+	//turf centers and the grid are removed the same swap and pop way, so their indices stay aligned
+	std::vector<int> removed;
+	GetTurfCenterGrid().QueryRadius(location.X, location.Y, radius, removed);
+	std::sort(removed.begin(), removed.end());
+	for (int i = (int)removed.size() - 1; i >= 0; i--)
+	{
+		if (recordedDelta != nullptr)
+			recordedDelta->RecordRemovedTurfCenter(removed[i], turfCenters[removed[i]]);
+		turfCenterGrid.RemoveAtSwap(removed[i]);
+		turfCenters.RemoveAtSwap(removed[i], 1, false);
+	}
+}
+
+void AGrassBlade::EraseProgressiveTurfs(FVector2D location, float radius)
+{
+	FBox2D area(location - FVector2D(radius, radius), location + FVector2D(radius, radius));
+	float radiusSquared = radius * radius;
+	FGrassSpawnBatch erased;
+	TArray<FIntPoint> untracked;
+	for (TPair<FIntPoint, FGrassProgressiveCell>& cellPair : progressiveCells)
+	{
+		FGrassProgressiveCell& cell = cellPair.Value;
+		if (!cell.HasTurfCenters())
+		{
+			untracked.Add(cellPair.Key);
+			continue;
+		}
+		if (!cell.turfBounds.bIsValid || !cell.turfBounds.Intersect(area))
+			continue;
+
+		//instances of erased turfs reaching out of the radius are removed with the turf
+		int spawned = GetSpawnedTurfs(cell);
+		for (int turf = 0; turf < cell.NumTurfs(); turf++)
+		{
+			if (cell.IsTurfErased(turf) || FVector2D::DistSquared(cell.turfCenters[turf], location) > radiusSquared)
+				continue;
+			if (recordedDelta != nullptr)
+				recordedDelta->RecordProgressiveCell(cellPair.Key, &cell);
+			if (cell.turfErased.Num() < cell.NumTurfs())
+				cell.turfErased.SetNumZeroed(cell.NumTurfs());
+			cell.turfErased[turf] = true;
+			if (turf < spawned)
+				GatherProgressiveTurf(cell, turf, erased);
+		}
+	}
+	RemoveBatch(erased);
+
+	//cells without turf centers cannot be pruned, so they would spawn erased grass again
+	if (untracked.Num() > 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Grass got erased from progressive cells stored without turf centers, turfDensity will not be applicable to them anymore."));
+		for (const FIntPoint& key : untracked)
+		{
+			if (recordedDelta != nullptr)
+				recordedDelta->RecordProgressiveCell(key, progressiveCells.Find(key));
+			progressiveCells.Remove(key);
+		}
+	}
+}
+
+void AGrassBlade::RemoveBatch(FGrassSpawnBatch& batch)
+{
+	for (int shape = 0; shape < GPGrassShapeCount; shape++)
+		RemoveMatchingInstances(GetGrassBladesInstances((EGPGrassShape)shape), batch.bladeTransforms[shape]);
+	RemoveMatchingInstances(billboardTurfInstances, batch.billboardTransforms);
+
+	for (int kind = 0; kind < GPFlowerKindCount; kind++)
+		RemoveMatchingInstances(GetFlowerInstances((EGPFlower)kind), batch.flowerTransforms[kind]);
+
+	for (int clump = 0; clump < batch.clumpTransforms.Num() && clump < clumpInstances.Num(); clump++)
+		RemoveMatchingInstances(clumpInstances[clump], batch.clumpTransforms[clump]);
+	batch.turfs = 0;
+}
+
+void AGrassBlade::RemoveMatchingInstances(UHierarchicalInstancedStaticMeshComponent* instances, TArray<FTransform>& transforms)
+{
+	TArray<int32> found;
+	instanceIndex.FindInstances(instances, transforms, found);
+	RemoveIndexedInstances(instances, found);
+	transforms.Reset();
+}
+
+void AGrassBlade::HideGrassWithinRadius(FVector location, float radius)
+{
+	SetGrassStateWithinRadius(location, radius, EGPGrassInstanceState::Hidden, 0);
+}
+
+void AGrassBlade::FlattenGrassWithinRadius(FVector location, float radius, float heightScale)
+{
+	SetGrassStateWithinRadius(location, radius, EGPGrassInstanceState::Flattened, heightScale);
+}
+
+void AGrassBlade::RestoreGrassWithinRadius(FVector location, float radius)
+{
+	SetGrassStateWithinRadius(location, radius, EGPGrassInstanceState::Visible, 1);
+}
+
+void AGrassBlade::SetGrassStateWithinRadius(FVector location, float radius, EGPGrassInstanceState state, float heightScale)
+{
+	TArray<UHierarchicalInstancedStaticMeshComponent*> managers;
+	GetAllInstanceManagers(managers);
+	for (UHierarchicalInstancedStaticMeshComponent* instances : managers)
+	{
+		TArray<int32> found;
+		instanceIndex.QueryRadius(instances, location, radius, found);
+		if (found.Num() == 0)
+			continue;
+
+		FGrassInstanceStates& states = instanceStates.FindOrAdd(instances);
+		for (int32 index : found)
+		{
+			FGrassModifiedInstance* modified = states.modified.Find(index);
+			if (state == EGPGrassInstanceState::Visible)
+			{
+				if (modified == nullptr)
+					continue;
+				states.pending.Add(index, modified->original);
+				states.modified.Remove(index);
+				continue;
+			}
+
+			//original transform is kept from the first change, so flattening hidden grass and back does not accumulate
+			FTransform original;
+			if (modified != nullptr)
+				original = modified->original;
+			else
+				instances->GetInstanceTransform(index, original, false);
+
+			FTransform changed = original;
+			changed.SetScale3D(state == EGPGrassInstanceState::Hidden ? FVector::ZeroVector : original.GetScale3D() * FVector(1, 1, heightScale));
+			states.modified.Add(index, { original, state });
+			states.pending.Add(index, changed);
+		}
+	}
+	SetActorTickEnabled(true);
+}
+
+void AGrassBlade::FlushGrassStateUpdates()
+{
+	//small gaps between changed instances are filled with current transforms, so every dirty range is one batched update
+	//on 4.24 the update still rebuilds the cluster tree and the last range marks render state dirty, which uploads the whole
+	//instance buffer again, so the cost of a flush is the one of RemoveInstance paid once per instance manager and frame
+	const int maxGap = 16;
+
+	for (TPair<UHierarchicalInstancedStaticMeshComponent*, FGrassInstanceStates>& statesPair : instanceStates)
+	{
+		UHierarchicalInstancedStaticMeshComponent* instances = statesPair.Key;
+		FGrassInstanceStates& states = statesPair.Value;
+		if (states.pending.Num() == 0 || !IsValid(instances))
+			continue;
+
+		TArray<int32> dirty;
+		states.pending.GetKeys(dirty);
+		dirty.Sort();
+
+		int rangeStart = 0;
+		while (rangeStart < dirty.Num())
+		{
+			int rangeEnd = rangeStart;
+			while (rangeEnd + 1 < dirty.Num() && dirty[rangeEnd + 1] - dirty[rangeEnd] <= maxGap)
+				rangeEnd++;
+
+			TArray<FTransform> transforms;
+			transforms.Reserve(dirty[rangeEnd] - dirty[rangeStart] + 1);
+			for (int32 index = dirty[rangeStart]; index <= dirty[rangeEnd]; index++)
+			{
+				FTransform* pending = states.pending.Find(index);
+				if (pending != nullptr)
+					transforms.Add(*pending);
+				else
+				{
+					FTransform current;
+					instances->GetInstanceTransform(index, current, false);
+					transforms.Add(current);
+				}
+			}
+
+			bool lastRange = rangeEnd + 1 == dirty.Num();
+			instances->BatchUpdateInstancesTransforms(dirty[rangeStart], transforms, false, lastRange, false);
+			rangeStart = rangeEnd + 1;
+		}
+		states.pending.Empty();
+	}
+	SetActorTickEnabled(false);
+}
+
+int AGrassBlade::CompactHiddenGrass()
+{
+	FlushGrassStateUpdates();
+
+	int removed = 0;
+	TArray<UHierarchicalInstancedStaticMeshComponent*> managers;
+	instanceStates.GetKeys(managers);
+	for (UHierarchicalInstancedStaticMeshComponent* instances : managers)
+	{
+		TArray<int32> hidden;
+		for (const TPair<int32, FGrassModifiedInstance>& modified : instanceStates[instances].modified)
+			if (modified.Value.state == EGPGrassInstanceState::Hidden)
+				hidden.Add(modified.Key);
+
+		removed += hidden.Num();
+		RemoveIndexedInstances(instances, hidden);
+	}
+	return removed;
+}
+
+void AGrassBlade::AddIndexedInstances(UHierarchicalInstancedStaticMeshComponent* instances, const TArray<FTransform>& transforms)
+{
+	if (recordedDelta != nullptr)
+		recordedDelta->RecordAdded(instances, transforms.Num());
+	instanceIndex.AddInstances(instances, transforms);
+
+	const FTransform& actorTransform = GetActorTransform();
+	for (const FTransform& transform : transforms)
+		grassBounds += actorTransform.TransformPosition(transform.GetLocation());
+}
+
+void AGrassBlade::RemoveIndexedInstances(UHierarchicalInstancedStaticMeshComponent* instances, TArray<int32>& indices)
+{
+	if (indices.Num() == 0)
+		return;
+
+	//instance manager removes from the highest index, delta records the removals in the same order
+	indices.Sort(TGreater<int32>());
+	if (recordedDelta != nullptr)
+		recordedDelta->RecordRemoved(instances, indices);
+
+	//states follow the instances the same way as the spatial index, last instance moves into the removed slot
+	FGrassInstanceStates* states = instanceStates.Find(instances);
+	if (states != nullptr)
+	{
+		int32 last = instances->GetInstanceCount() - 1;
+		for (int32 index : indices)
+		{
+			states->modified.Remove(index);
+			states->pending.Remove(index);
+			if (index != last)
+			{
+				FGrassModifiedInstance modified;
+				if (states->modified.RemoveAndCopyValue(last, modified))
+					states->modified.Add(index, modified);
+				FTransform pending;
+				if (states->pending.RemoveAndCopyValue(last, pending))
+					states->pending.Add(index, pending);
+			}
+			last--;
+		}
+	}
+	instanceIndex.RemoveInstances(instances, indices);
+}
+
+void AGrassBlade::InsertIndexedInstancesAtSwap(UHierarchicalInstancedStaticMeshComponent* instances, const TArray<int32>& indices, const TArray<FTransform>& transforms)
+{
+	if (indices.Num() == 0)
+		return;
+
+	//states of instances moved to the end go with them, restored instances have no state
+	FGrassInstanceStates* states = instanceStates.Find(instances);
+	if (states != nullptr)
+	{
+		int32 last = instances->GetInstanceCount();
+		for (int32 index : indices)
+		{
+			FGrassModifiedInstance modified;
+			if (states->modified.RemoveAndCopyValue(index, modified))
+				states->modified.Add(last, modified);
+			FTransform pending;
+			if (states->pending.RemoveAndCopyValue(index, pending))
+				states->pending.Add(last, pending);
+			last++;
+		}
+	}
+	instanceIndex.InsertInstancesAtSwap(instances, indices, transforms);
+}
+
+void AGrassBlade::GetAllInstanceManagers(TArray<UHierarchicalInstancedStaticMeshComponent*>& managers) const
+{
+	managers.Add(grassBlades);
+	managers.Add(triangleGrassBlades);
+	managers.Add(triangleQuadGrassBlades);
+	managers.Append(clumpInstances);
+	managers.Add(billboardTurfInstances);
+	managers.Add(daisyFlowers);
+	managers.Add(violaFlowers);
+}
+
+void AGrassBlade::QueryInstancesWithinRadius(UHierarchicalInstancedStaticMeshComponent* instances, FVector location, float radius, TArray<int32>& result)
+{
+	instanceIndex.QueryRadius(instances, location, radius, result);
+}
+
+const grassSampling::PointHashGrid& AGrassBlade::GetTurfCenterGrid()
+{
+	if (turfCenterGrid.Num() != turfCenters.Num())
+	{
+		turfCenterGrid.Reset(turfCenterGrid.GetCellSize());
+		for (const FVector2D& center : turfCenters)
+			turfCenterGrid.Add(center.X, center.Y);
+	}
+	return turfCenterGrid;
+}
+
+void AGrassBlade::AddTurfCenters(const TArray<FVector2D>& centers)
+{
+	if (recordedDelta != nullptr)
+		recordedDelta->RecordAddedTurfCenters(centers.Num());
+	for (const FVector2D& center : centers)
+	{
+		turfCenters.Add(center);
+		if (turfCenterGrid.Num() + 1 == turfCenters.Num())
+			turfCenterGrid.Add(center.X, center.Y);
+	}
+}
+
+void AGrassBlade::ClearTurfCenters()
+{
+	if (recordedDelta != nullptr)
+		recordedDelta->RecordClearedTurfCenters(turfCenters);
+	turfCenters.Empty();
+	turfCenterGrid.Reset(turfCenterGrid.GetCellSize());
+}
+
+void AGrassBlade::RevertDelta(FGrassDelta& delta)
+{
+	//reverting is not part of any operation
+	FGrassDelta* recording = recordedDelta;
+	recordedDelta = nullptr;
+
+	//instance manager reverted by the logs of the delta, restored instances are added in one batch per manager
+	struct FInstanceRevert {
+		AGrassBlade* patch;
+		UHierarchicalInstancedStaticMeshComponent* instances;
+		TArray<int32> indices;
+		TArray<FTransform> transforms;
+
+		void RemoveLast(int count)
+		{
+			Flush();
+			int32 last = instances->GetInstanceCount();
+			TArray<int32> tail;
+			for (int32 i = FMath::Max(last - count, 0); i < last; i++)
+				tail.Add(i);
+			patch->RemoveIndexedInstances(instances, tail);
+		}
+
+		void InsertAtSwap(int index, const FGrassRemovedInstance& instance)
+		{
+			indices.Add(index);
+			transforms.Add(instance.ToTransform());
+		}
+
+		void Flush()
+		{
+			patch->InsertIndexedInstancesAtSwap(instances, indices, transforms);
+			indices.Reset();
+			transforms.Reset();
+		}
+	};
+
+	for (const auto& manager : delta.instances)
+	{
+		UHierarchicalInstancedStaticMeshComponent* instances = manager.Key.Get();
+		if (instances == NULL)
+			continue;
+		FInstanceRevert revert = { this, instances };
+		manager.Value.Revert(revert);
+		revert.Flush();
+	}
+
+	struct FTurfCenterRevert {
+		TArray<FVector2D>& centers;
+		grassSampling::PointHashGrid* grid;
+
+		void RemoveLast(int count)
+		{
+			count = FMath::Min(count, centers.Num());
+			centers.RemoveAt(centers.Num() - count, count, false);
+			for (int i = 0; grid != nullptr && i < count; i++)
+				grid->RemoveAtSwap(grid->Num() - 1);
+		}
+
+		void InsertAtSwap(int index, const FVector2D& center)
+		{
+			if (index < centers.Num())
+			{
+				centers.Add(centers[index]);
+				centers[index] = center;
+			}
+			else
+				centers.Add(center);
+			if (grid != nullptr)
+				grid->InsertAtSwap(index, center.X, center.Y);
+		}
+	};
+
+	//grid out of sync is rebuilt on next query
+	bool gridInSync = turfCenterGrid.Num() == turfCenters.Num();
+	FTurfCenterRevert turfRevert = { turfCenters, gridInSync ? &turfCenterGrid : nullptr };
+	delta.turfCenters.Revert(turfRevert);
+	if (!gridInSync)
+		turfCenterGrid.Reset(turfCenterGrid.GetCellSize());
+
+	//progressive cells get back the turfs and spawned amounts they had before the operation
+	for (const FIntPoint& key : delta.createdCells)
+		progressiveCells.Remove(key);
+	for (TPair<FIntPoint, FGrassProgressiveCell>& cell : delta.previousCells)
+		progressiveCells.Add(cell.Key, MoveTemp(cell.Value));
+	for (const TPair<FIntPoint, int32>& spawned : delta.previousSpawnedTurfs)
+	{
+		FGrassProgressiveCell* cell = progressiveCells.Find(spawned.Key);
+		if (cell != nullptr)
+			cell->spawnedTurfs = spawned.Value;
+	}
+	if (delta.previousTurfDensity.IsSet())
+		turfDensity = delta.previousTurfDensity.GetValue();
+
+	delta.Reset();
+	recordedDelta = recording;
+	UpdateRegistration();
+	MarkPackageDirty();
+}
+
+void AGrassBlade::SpawnFlowersAroundPosition(FVector position, int minAmount, int maxAmount, float innerFlowerRadius, EGPFlower flowerKind, bool shouldSnapToTerrain, FQuat normalQuat, float spawnWeight)
+{
+	if (shouldSnapToTerrain && !SnapingAdjustments(position, normalQuat))
+		return;
+
+	FGrassSpawnBatch batch;
+	FRandomStream stream(FMath::Rand());
+	GenerateFlowersAroundPosition(stream, position, minAmount, maxAmount, innerFlowerRadius, flowerKind, normalQuat, spawnWeight, batch);
+	CommitBatch(batch);
+}
+
+void AGrassBlade::GenerateFlowersAroundPosition(FRandomStream& stream, FVector position, int minAmount, int maxAmount, float innerFlowerRadius, EGPFlower flowerKind, FQuat normalQuat, float spawnWeight, FGrassSpawnBatch& batch)
+{
+	//flower mesh is shipped only as GrassFlower.obj, instances without mesh would be invisible but still stored
+	for (int kind = 0; kind < GPFlowerKindCount; kind++)
+	{
+		if ((flowerKind == EGPFlower::Mixed || (int)flowerKind == kind) && GetFlowerInstances((EGPFlower)kind)->GetStaticMesh() == nullptr)
+		{
+			static bool missingMeshReported = false;
+			if (!missingMeshReported)
+				UE_LOG(LogTemp, Warning, TEXT("Flowers are skipped, flower mesh %s does not exist. Import GrassPlugin/Content/Collections/GrassFlower.obj there."),
+					*UGVar::StaticClass()->GetDefaultObject<UGVar>()->flowerMeshLocation);
+			missingMeshReported = true;
+			return;
+		}
+	}
+
+	float weight = 2 - spawnWeight;
+	int amount = floor(minAmount + (maxAmount - minAmount) * (pow(stream.FRandRange(0.f,1.f), weight)));
+	FVector normal = normalQuat.RotateVector(FVector(0, 0, 1));
+
+	float precision = 1000;
+	for (int i = 0; i < amount; i++)
+	{
+		FVector pos = GenRandomPositionWithinRad(stream, position, innerFlowerRadius, precision); 
+		//height of the flower is taken from the plane of the snapped center
+		if (normal.Z > KINDA_SMALL_NUMBER)
+			pos.Z = position.Z - (normal.X * (pos.X - position.X) + normal.Y * (pos.Y - position.Y)) / normal.Z;
+
+		uint16 randomAngle = stream.RandRange(0, 359);
+		FRotator bladeRotation(0, randomAngle, 0);
+		FQuat bladeQ(bladeRotation);
+		
+		FTransform transform;
+		transform.SetRotation(normalQuat * bladeQ);
+		if (pos == FVector::ZeroVector)
+			continue;
+		transform.SetLocation(pos);
+		transform.SetScale3D(FVector(1,1,1));
+
+		EGPFlower kind = flowerKind == EGPFlower::Mixed ? (EGPFlower)stream.RandRange(0, GPFlowerKindCount - 1) : flowerKind;
+		batch.flowerTransforms[(int)kind].Add(transform);
+	}
+}
+
+void AGrassBlade::SpawnDefaultObject(int index)
+{
+	FTransform transform;
+	transform.SetLocation(FVector(-5500, 1060, 0));
+	activeGrassBladesInstances->AddInstance(transform);
+	
+}
+
+
+void AGrassBlade::InitializeMaterials(UMaterialInstanceDynamic* material, UMaterialInstanceDynamic* billboardMat)
+{
+	dynMaterial = material;
+	grassBlades->SetMaterial(0, material);
+	triangleGrassBlades->SetMaterial(0, material);
+	triangleQuadGrassBlades->SetMaterial(0, material);
+
+	bbMat = billboardMat;
+	billboardTurfInstances->SetMaterial(0, billboardMat);
+
+	for (UHierarchicalInstancedStaticMeshComponent* clump : clumpInstances)
+		clump->SetMaterial(0, material);
+	
+}
+
+void AGrassBlade::SetMaterialTextureSize(int textureWidth, int textureHeight)
+{
+	dynMaterial->SetScalarParameterValue(FName("textureWidth"), textureWidth);
+	dynMaterial->SetScalarParameterValue(FName("textureHeight"), textureHeight);
+	activeGrassBladesInstances->SetMaterial(0, dynMaterial);
+}
+
+void AGrassBlade::SetMaterialMovementPosition(const FTransform &transform)
+{
+	//material is already bound to instance managers, only the parameter changes (AGrassInteractionField handles more actors)
+	dynMaterial->SetVectorParameterValue(FName("movementPosition"), transform.GetLocation());
+}
+
+
+FTransform AGrassBlade::GenerateBillboardTransform(FVector position, FQuat normalQuat, float clusterScale)
+{
+	//billboards are generated when the batch gets committed, so a stream would depend on the size of the batches
+	uint32 hash = grassSampling::HashCoordinates(FMath::FloorToInt(position.X), FMath::FloorToInt(position.Y), 0);
+	uint16 randomAngle = hash % 360;
+	uint16 randomSize = 1 + (hash >> 31);
+	FVector size = FVector(clusterScale, clusterScale, randomSize);
+	FRotator bladeRotation(0, randomAngle, 0);
+	FQuat bladeQ(bladeRotation);
+
+	FTransform transform;
+	transform.SetRotation(normalQuat * bladeQ);
+	transform.SetLocation(position);
+	transform.SetScale3D(size);
+	return transform;
+}
+void AGrassBlade::SetupDefaultTexture(UTexture2D*& texture, int textureWidth, int textureHeight, EPixelFormat format)
+{
+	texture->AddToRoot();
+	texture->PlatformData = new FTexturePlatformData();
+	texture->PlatformData->SizeX = textureWidth;
+	texture->PlatformData->SizeY = textureHeight;
+	texture->PlatformData->SetNumSlices(1);
+	texture->PlatformData->PixelFormat = EPixelFormat::PF_R8G8B8A8;
+}
+
+
+void AGrassBlade::SetActiveGrassBlades(EGPGrassShape shape)
+{
+	activeShape = shape;
+	activeGrassBladesInstances = GetGrassBladesInstances(shape);
+}
+
+UHierarchicalInstancedStaticMeshComponent* AGrassBlade::GetFlowerInstances(EGPFlower flowerKind)
+{
+	return flowerKind == EGPFlower::Viola ? violaFlowers : daisyFlowers;
+}
+
+UHierarchicalInstancedStaticMeshComponent* AGrassBlade::GetGrassBladesInstances(EGPGrassShape shape)
+{
+	switch (shape) {
+	case EGPGrassShape::Triangle:
+		return triangleGrassBlades;
+	case EGPGrassShape::TriangleQuad:
+		return triangleQuadGrassBlades;
+	default:
+		return grassBlades;
+	}
+}
+
+void AGrassBlade::ClearHierarchicalInstances(UHierarchicalInstancedStaticMeshComponent* instances) {
+	if (instances != NULL)
+	{
+		if (instances->GetInstanceCount() > 0)
+		{
+			if (recordedDelta != nullptr)
+				recordedDelta->RecordCleared(instances);
+			instances->ClearInstances();
+		}
+		instanceIndex.Reset(instances);
+		instanceStates.Remove(instances);
+	}
+}
+
+void AGrassBlade::InitiateHierarchicalInstanceMesh(UHierarchicalInstancedStaticMeshComponent* instances, FString meshLocation) {
+	//missing asset is left without mesh instead of failing to load it for every patch, its users check GetStaticMesh
+	if (!FPackageName::DoesPackageExist(FPackageName::ObjectPathToPackageName(meshLocation)))
+	{
+		instances->SetStaticMesh(nullptr);
+		return;
+	}
+	UStaticMesh* staticMeshOb = LoadObject<UStaticMesh>(nullptr, *meshLocation);
+	if (staticMeshOb == NULL)
+		staticMeshOb = Cast<UStaticMesh>(FSoftObjectPath(meshLocation).TryLoad());
+
+	instances->SetStaticMesh(staticMeshOb);
+}
+
+void AGrassBlade::InitiateHierarchicalInstanceMaterial(UHierarchicalInstancedStaticMeshComponent* instances, FString matLocation) {
+	UMaterialInterface* material = LoadObject<UMaterialInterface>(nullptr, *matLocation);
+	if (material == NULL)
+	{
+		UE_LOG(LogTemp, Display, TEXT("%s Material not found."), *matLocation);
+		return;
+	}
+
+	instances->SetMaterial(0, material);
+}
+
+UWorld* AGrassBlade::GetTraceWorld() const
+{
+	return GetWorld();
+}
+
+void AGrassBlade::FindLandScapeRayTrace(UWorld* world, FVector start, FVector end, FHitResult & hitResult)
+{
+	static const FName traceTag(TEXT("landscape trace"));
+	ECollisionChannel colChannel = ECollisionChannel::ECC_WorldStatic;
+
+	FCollisionQueryParams TraceParams(traceTag, true);
+
+	TraceParams.bTraceComplex = true;
+	TraceParams.bReturnPhysicalMaterial = false;
+	TraceParams.bFindInitialOverlaps = false;
+
+	hitResult = FHitResult(ForceInit);
+
+	FVector st = start;
+
+	while (st.Z > end.Z) {
+		hitResult = FHitResult(ForceInit);
+		world->LineTraceSingleByChannel(hitResult, st, end, colChannel, TraceParams);
+		if (!hitResult.IsValidBlockingHit()) {
+			break;
+		}
+		else if (IsValid(hitResult.GetActor())) {
+			if (!CanSnapOnto(hitResult.GetActor()))
+				hitResult.Reset();
+			break;
+		}
+		else {
+			
+			st = hitResult.Location + FVector(0,0,-1);
+		}
+	}
+	
+}
+
+bool AGrassBlade::CanSnapOnto(const AActor* actor)
+{
+	static const FName grassEnableTag("grassEnable");
+	return actor->IsA<ALandscapeProxy>() || actor->Tags.Contains(grassEnableTag);
+}
+
+int AGrassBlade::AdjustPosition(UWorld* world, int rayLength, FVector& position, FVector& impactNormal)
+{
+		FHitResult res;
+		position = position + FVector(0, 0, rayLength / 2);
+		FindLandScapeRayTrace(world, position, FVector(0, 0, -rayLength) + position, res);
+		position = res.Location;
+		impactNormal = res.Normal;
+		return res.IsValidBlockingHit();
+}
+
+FQuat AGrassBlade::FindQuatOfNormal(const FVector & upVector, const FVector & normal)
+{
+	FVector rotationAxis = FVector::CrossProduct(upVector, normal);
+	rotationAxis.Normalize();
+
+	float dotproduct = FVector::DotProduct(upVector, normal);
+	float rotationAngle = acosf(dotproduct);
+
+	FQuat resultQuat = FQuat(rotationAxis, rotationAngle);
+
+	return resultQuat;
+}
+
+FVector AGrassBlade::GenRandomPositionWithinRad(FRandomStream& stream, FVector position, int radius, float precision)
+{
+	float t = 2 * PI * (stream.FRandRange(0.f, precision) / precision);
+	float r = radius * FMath::Square(stream.FRandRange(-radius * precision, radius * precision) / precision);
+	return FVector(r * FMath::Cos(t), r * FMath::Sin(t), 0) + position;
+}
+
+void AGrassBlade::InitAllInstancesSelectability()
+{
+	billboardTurfInstances->bSelectable = false;
+	daisyFlowers->bSelectable = false;
+	violaFlowers->bSelectable = false;
+	grassBlades->bSelectable = false;
+	triangleGrassBlades->bSelectable = false;
+	triangleQuadGrassBlades->bSelectable = false;
+}
+
+void AGrassBlade::InitAllInstancesCollision()
+{
+	grassBlades->bDisableCollision = true;
+	triangleGrassBlades->bDisableCollision = true;
+	triangleQuadGrassBlades->bDisableCollision = true;
+	billboardTurfInstances->bDisableCollision = true;
+	daisyFlowers->bDisableCollision = true;
+	violaFlowers->bDisableCollision = true;
+}
+
+void AGrassBlade::InitShadowCast()
+{
+	grassBlades->SetCastShadow(false);
+	triangleGrassBlades->SetCastShadow(false);
+	triangleQuadGrassBlades->SetCastShadow(false);
+	billboardTurfInstances->SetCastShadow(false);
+	daisyFlowers->SetCastShadow(false);
+	violaFlowers->SetCastShadow(false);
+}
+
+void AGrassBlade::InitCullDistance()
+{
+	UGVar* vars = (UGVar*)NewObject<UGVar>(UGVar::StaticClass());
+	int cullDistance = vars->detailedGrassCullDistance;
+
+	grassBlades->InstanceEndCullDistance = cullDistance;
+	triangleGrassBlades->InstanceEndCullDistance = cullDistance;
+	triangleQuadGrassBlades->InstanceEndCullDistance = cullDistance;
+
+	daisyFlowers->InstanceEndCullDistance = cullDistance;
+	violaFlowers->InstanceEndCullDistance = cullDistance;
+
+	billboardTurfInstances->InstanceStartCullDistance = cullDistance;
+	billboardTurfInstances->InstanceEndCullDistance = vars->lodCullDistanceFar;
+}
+
+int AGrassBlade::SnapingAdjustments(FVector & position, FQuat& normalQuat)
+{
+	return SnapToTerrain(GetTraceWorld(), rayLength, position, normalQuat);
+}
+
+int AGrassBlade::SnapToTerrain(UWorld* world, int rayLength, FVector& position, FQuat& normalQuat)
+{
+	FVector upVector = FVector(0, 0, 1);
+	FVector normal = upVector;
+	int output = AdjustPosition(world, rayLength, position, normal);
+	normalQuat = FindQuatOfNormal(upVector, normal);
+	normalQuat.Normalize();
+	return output;
+}
+
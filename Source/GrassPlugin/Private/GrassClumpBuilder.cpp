@@ -0,0 +1,103 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include "GrassClumpBuilder.h"
+
+#if WITH_EDITOR
+#include "RawMesh.h"
+#include "AssetRegistryModule.h"
+#endif
+
+FString FGrassClumpBuilder::GetClumpAssetName(const FString& shape, int blades, float radius, int variant)
+{
+	return FString::Printf(TEXT("Clump_%s_b%i_r%i_v%i"), *shape, blades, FMath::RoundToInt(radius * 100), variant);
+}
+
+UStaticMesh* FGrassClumpBuilder::LoadClumpMesh(const FString& packagePath, const FString& assetName)
+{
+	FString objectPath = packagePath / assetName + FString(".") + assetName;
+	return LoadObject<UStaticMesh>(nullptr, *objectPath, nullptr, LOAD_NoWarn | LOAD_Quiet);
+}
+
+#if WITH_EDITOR
+UStaticMesh* FGrassClumpBuilder::BuildClumpMesh(UStaticMesh* bladeMesh, const TArray<FTransform>& bladeLayout, const FString& packagePath, const FString& assetName)
+{
+	if (bladeMesh == nullptr || bladeMesh->GetNumSourceModels() == 0 || bladeLayout.Num() == 0)
+		return nullptr;
+
+	FRawMesh bladeRaw;
+	bladeMesh->GetSourceModel(0).LoadRawMesh(bladeRaw);
+	if (!bladeRaw.IsValid())
+		return nullptr;
+
+	FRawMesh clumpRaw;
+	for (const FTransform& bladeTransform : bladeLayout)
+	{
+		uint32 vertexOffset = clumpRaw.VertexPositions.Num();
+		for (const FVector& vertex : bladeRaw.VertexPositions)
+			clumpRaw.VertexPositions.Add(bladeTransform.TransformPosition(vertex));
+
+		for (uint32 index : bladeRaw.WedgeIndices)
+			clumpRaw.WedgeIndices.Add(index + vertexOffset);
+
+		for (const FVector& tangent : bladeRaw.WedgeTangentX)
+			clumpRaw.WedgeTangentX.Add(bladeTransform.TransformVectorNoScale(tangent));
+		for (const FVector& tangent : bladeRaw.WedgeTangentY)
+			clumpRaw.WedgeTangentY.Add(bladeTransform.TransformVectorNoScale(tangent));
+		for (const FVector& tangent : bladeRaw.WedgeTangentZ)
+			clumpRaw.WedgeTangentZ.Add(bladeTransform.TransformVectorNoScale(tangent));
+
+		clumpRaw.WedgeColors.Append(bladeRaw.WedgeColors);
+		for (int uv = 0; uv < MAX_MESH_TEXTURE_COORDS; uv++)
+			clumpRaw.WedgeTexCoords[uv].Append(bladeRaw.WedgeTexCoords[uv]);
+
+		clumpRaw.FaceMaterialIndices.Append(bladeRaw.FaceMaterialIndices);
+		clumpRaw.FaceSmoothingMasks.Append(bladeRaw.FaceSmoothingMasks);
+	}
+
+	FString packageName = packagePath / assetName;
+	UPackage* package = CreatePackage(nullptr, *packageName);
+	UStaticMesh* clumpMesh = NewObject<UStaticMesh>(package, *assetName, RF_Public | RF_Standalone);
+
+	FStaticMeshSourceModel& sourceModel = clumpMesh->AddSourceModel();
+	sourceModel.BuildSettings = bladeMesh->GetSourceModel(0).BuildSettings;
+	sourceModel.BuildSettings.bRecomputeNormals = false;
+	sourceModel.BuildSettings.bRecomputeTangents = false;
+	sourceModel.SaveRawMesh(clumpRaw);
+
+	clumpMesh->StaticMaterials = bladeMesh->StaticMaterials;
+	clumpMesh->LightMapCoordinateIndex = bladeMesh->LightMapCoordinateIndex;
+	clumpMesh->Build(false);
+	clumpMesh->PostEditChange();
+
+	FAssetRegistryModule::AssetCreated(clumpMesh);
+	package->MarkPackageDirty();
+	return clumpMesh;
+}
+
+#endif
@@ -0,0 +1,52 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+//Engine independent generation core (ThirdParty/GrassCore) is compiled as part of the module, so no prebuilt library
+//has to be built before the plugin. Its own CMake build is used for tests and benchmarks outside of the editor.
+#include "CoreMinimal.h"
+
+#if PLATFORM_WINDOWS
+#include "Windows/AllowWindowsPlatformTypes.h"
+#endif
+
+#include "../../../ThirdParty/GrassCore/Source/BlueNoiseSampling.cpp"
+#include "../../../ThirdParty/GrassCore/Source/BrushSampling.cpp"
+#include "../../../ThirdParty/GrassCore/Source/CoverageMask.cpp"
+#include "../../../ThirdParty/GrassCore/Source/ExclusionBVH.cpp"
+#include "../../../ThirdParty/GrassCore/Source/HorizonMap.cpp"
+#include "../../../ThirdParty/GrassCore/Source/JitteredGrid.cpp"
+#include "../../../ThirdParty/GrassCore/Source/PointCloud.cpp"
+#include "../../../ThirdParty/GrassCore/Source/PointHashGrid.cpp"
+#include "../../../ThirdParty/GrassCore/Source/PoissonTileSet.cpp"
+#include "../../../ThirdParty/GrassCore/Source/ProgressiveSampling.cpp"
+#include "../../../ThirdParty/GrassCore/Source/SamplingTuner.cpp"
+#include "../../../ThirdParty/GrassCore/Source/TurfLayout.cpp"
+
+#if PLATFORM_WINDOWS
+#include "Windows/HideWindowsPlatformTypes.h"
+#endif
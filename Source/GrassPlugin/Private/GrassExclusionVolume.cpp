@@ -0,0 +1,89 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "GrassExclusionVolume.h"
+#include "Components/SplineComponent.h"
+#include "EngineUtils.h"
+
+AGrassExclusionVolume::AGrassExclusionVolume()
+{
+	box = CreateDefaultSubobject<UBoxComponent>(TEXT("box"));
+	box->SetBoxExtent(FVector(200, 200, 200));
+	box->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	RootComponent = box;
+}
+
+FGrassExclusionsPtr AGrassExclusionVolume::GatherExclusions(UWorld* world, float splineRadius, float splineStep)
+{
+	FGrassExclusionsPtr exclusions = MakeShared<grassSampling::ExclusionBVH, ESPMode::ThreadSafe>();
+	if (world == nullptr)
+		return exclusions;
+
+	for (TActorIterator<AGrassExclusionVolume> iterator(world); iterator; ++iterator)
+	{
+		const UBoxComponent* volumeBox = iterator->box;
+		FVector extent = volumeBox->GetScaledBoxExtent();
+		FVector center = volumeBox->GetComponentLocation();
+		float yaw = FMath::DegreesToRadians(volumeBox->GetComponentRotation().Yaw);
+		exclusions->AddBox(center.X, center.Y, extent.X, extent.Y, yaw);
+	}
+
+	for (TActorIterator<AActor> iterator(world); iterator; ++iterator)
+	{
+		AActor* actor = *iterator;
+		if (!actor->Tags.Contains(FName("grassExclude")) || actor->IsA<AGrassExclusionVolume>())
+			continue;
+
+		TArray<USplineComponent*> splines;
+		actor->GetComponents<USplineComponent>(splines);
+		if (splines.Num() == 0)
+		{
+			FVector origin, extent;
+			actor->GetActorBounds(true, origin, extent);
+			exclusions->AddBox(origin.X, origin.Y, extent.X, extent.Y, 0);
+			continue;
+		}
+
+		//splines are approximated by capsules around their pieces
+		for (const USplineComponent* spline : splines)
+		{
+			float length = spline->GetSplineLength();
+			int pieces = FMath::Max(FMath::CeilToInt(length / splineStep), 1);
+			FVector previous = spline->GetLocationAtDistanceAlongSpline(0, ESplineCoordinateSpace::World);
+			for (int i = 1; i <= pieces; i++)
+			{
+				FVector next = spline->GetLocationAtDistanceAlongSpline(length * i / pieces, ESplineCoordinateSpace::World);
+				exclusions->AddCapsule(previous.X, previous.Y, next.X, next.Y, splineRadius);
+				previous = next;
+			}
+		}
+	}
+
+	exclusions->Build();
+	UE_LOG(LogTemp, Display, TEXT("Gathered %i grass exclusion shapes."), exclusions->Num());
+	return exclusions;
+}
@@ -0,0 +1,151 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "GrassField.h"
+#include "GrassBlade.h"
+#include "GrassPatchRegistry.h"
+
+AGrassField::AGrassField()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("root"));
+}
+
+void AGrassField::BeginPlay()
+{
+	Super::BeginPlay();
+
+	fieldTexture = UTexture2D::CreateTransient(resolution, resolution, PF_B8G8R8A8);
+	fieldTexture->SRGB = false;
+	fieldTexture->CompressionSettings = TextureCompressionSettings::TC_VectorDisplacementmap;
+	fieldTexture->AddressX = TextureAddress::TA_Wrap;
+	fieldTexture->AddressY = TextureAddress::TA_Wrap;
+	fieldTexture->UpdateResource();
+
+	AllocateField();
+	hasOrigin = false;
+}
+
+FVector AGrassField::GetViewLocation() const
+{
+	APlayerController* controller = GetWorld()->GetFirstPlayerController();
+	if (controller != nullptr && controller->PlayerCameraManager != nullptr)
+		return controller->PlayerCameraManager->GetCameraLocation();
+	return GetActorLocation();
+}
+
+int AGrassField::TexelIndex(int worldTexelX, int worldTexelY) const
+{
+	int x = ((worldTexelX % resolution) + resolution) % resolution;
+	int y = ((worldTexelY % resolution) + resolution) % resolution;
+	return y * resolution + x;
+}
+
+void AGrassField::MoveField(FVector center)
+{
+	float texelSize = GetTexelSize();
+	FIntPoint newOrigin(FMath::FloorToInt(center.X / texelSize) - resolution / 2, FMath::FloorToInt(center.Y / texelSize) - resolution / 2);
+	if (hasOrigin && newOrigin == origin)
+		return;
+
+	FIntPoint shift = newOrigin - origin;
+	if (!hasOrigin || FMath::Abs(shift.X) >= resolution || FMath::Abs(shift.Y) >= resolution)
+	{
+		for (int i = 0; i < resolution * resolution; i++)
+			ClearTexel(i);
+	}
+	else
+	{
+		//columns and rows that entered the field reuse storage of the ones that left it
+		int enteredMinX = shift.X > 0 ? origin.X + resolution : newOrigin.X;
+		int enteredMaxX = shift.X > 0 ? newOrigin.X + resolution : origin.X;
+		for (int x = enteredMinX; x < enteredMaxX; x++)
+			for (int y = newOrigin.Y; y < newOrigin.Y + resolution; y++)
+				ClearTexel(TexelIndex(x, y));
+
+		int enteredMinY = shift.Y > 0 ? origin.Y + resolution : newOrigin.Y;
+		int enteredMaxY = shift.Y > 0 ? newOrigin.Y + resolution : origin.Y;
+		for (int y = enteredMinY; y < enteredMaxY; y++)
+			for (int x = newOrigin.X; x < newOrigin.X + resolution; x++)
+				ClearTexel(TexelIndex(x, y));
+	}
+
+	origin = newOrigin;
+	hasOrigin = true;
+	for (UMaterialInstanceDynamic* material : boundMaterials)
+		if (IsValid(material))
+			SetMaterialOrigin(material);
+}
+
+void AGrassField::UploadField()
+{
+	if (fieldTexture == nullptr)
+		return;
+
+	//data are released by render thread after the upload
+	int texels = resolution * resolution;
+	uint8* data = new uint8[texels * 4];
+	for (int i = 0; i < texels; i++)
+		EncodeTexel(i, data + 4 * i);
+
+	FUpdateTextureRegion2D* region = new FUpdateTextureRegion2D(0, 0, 0, 0, resolution, resolution);
+	fieldTexture->UpdateTextureRegions(0, 1, region, resolution * 4, 4, data,
+		[](uint8* srcData, const FUpdateTextureRegion2D* regions) {
+			delete[] srcData;
+			delete regions;
+		});
+}
+
+void AGrassField::BindGrassMaterials()
+{
+	boundMaterials.RemoveAll([](UMaterialInstanceDynamic* material) { return !IsValid(material); });
+
+	UGrassPatchRegistry* registry = GetWorld()->GetSubsystem<UGrassPatchRegistry>();
+	if (registry == nullptr)
+		return;
+
+	//patches of sublevels streamed in later get bound on next update
+	TArray<AGrassBlade*> patches;
+	registry->GetGrassPatches(patches);
+	for (AGrassBlade* patch : patches)
+	{
+		UMaterialInstanceDynamic* material = patch->GetGrassMaterial();
+		if (material == nullptr || boundMaterials.Contains(material))
+			continue;
+
+		material->SetTextureParameterValue(FName(*parameterName), fieldTexture);
+		material->SetScalarParameterValue(FName(*(parameterName + "Size")), fieldSize);
+		SetMaterialOrigin(material);
+		boundMaterials.Add(material);
+	}
+}
+
+void AGrassField::SetMaterialOrigin(UMaterialInstanceDynamic* material) const
+{
+	float texelSize = GetTexelSize();
+	material->SetVectorParameterValue(FName(*(parameterName + "Origin")), FLinearColor(origin.X * texelSize, origin.Y * texelSize, 0, 0));
+}
@@ -0,0 +1,183 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "GrassInstanceIndex.h"
+
+#include <vector>
+
+FGrassInstanceIndex::FGrassInstanceIndex(float cellSize) : cellSize(cellSize)
+{
+}
+
+void FGrassInstanceIndex::AddInstances(UHierarchicalInstancedStaticMeshComponent* instances, const TArray<FTransform>& transforms)
+{
+	if (instances == NULL || transforms.Num() == 0)
+		return;
+
+	int previousCount = instances->GetInstanceCount();
+	instances->AddInstances(transforms, false);
+
+	grassSampling::PointHashGrid* grid = grids.Find(instances);
+	if (grid == nullptr)
+		return;
+	if (grid->Num() != previousCount)
+	{
+		//index got out of sync, it gets rebuilt on next query
+		grids.Remove(instances);
+		return;
+	}
+	for (const FTransform& transform : transforms)
+		grid->Add(transform.GetLocation().X, transform.GetLocation().Y);
+}
+
+grassSampling::PointHashGrid& FGrassInstanceIndex::GetGrid(UHierarchicalInstancedStaticMeshComponent* instances)
+{
+	grassSampling::PointHashGrid& grid = grids.FindOrAdd(instances);
+	int count = instances->GetInstanceCount();
+	if (grid.Num() != count || grid.GetCellSize() != cellSize)
+	{
+		grid.Reset(cellSize);
+		for (int i = 0; i < count; i++)
+		{
+			FTransform transform;
+			instances->GetInstanceTransform(i, transform, false);
+			grid.Add(transform.GetLocation().X, transform.GetLocation().Y);
+		}
+	}
+	return grid;
+}
+
+void FGrassInstanceIndex::QueryRadius(UHierarchicalInstancedStaticMeshComponent* instances, FVector location, float radius, TArray<int32>& result)
+{
+	if (instances == NULL || instances->GetInstanceCount() == 0)
+		return;
+
+	//instances are stored in space of the instance manager
+	FVector localLocation = instances->GetComponentTransform().InverseTransformPosition(location);
+	std::vector<int> found;
+	GetGrid(instances).QueryRadius(localLocation.X, localLocation.Y, radius, found);
+	result.Append(found.data(), found.size());
+}
+
+void FGrassInstanceIndex::FindInstances(UHierarchicalInstancedStaticMeshComponent* instances, const TArray<FTransform>& transforms, TArray<int32>& result)
+{
+	if (instances == NULL || instances->GetInstanceCount() == 0 || transforms.Num() == 0)
+		return;
+
+	//instance transforms go through matrices of the instance manager, so they are compared with tolerance
+	grassSampling::PointHashGrid& grid = GetGrid(instances);
+	TSet<int32> found;
+	std::vector<int> candidates;
+	for (const FTransform& transform : transforms)
+	{
+		candidates.clear();
+		grid.QueryRadius(transform.GetLocation().X, transform.GetLocation().Y, 0.1f, candidates);
+		for (int candidate : candidates)
+		{
+			FTransform instance;
+			if (!found.Contains(candidate) && instances->GetInstanceTransform(candidate, instance, false) && instance.Equals(transform, 0.01f))
+			{
+				found.Add(candidate);
+				result.Add(candidate);
+				break;
+			}
+		}
+	}
+}
+
+int FGrassInstanceIndex::RemoveWithinRadius(UHierarchicalInstancedStaticMeshComponent* instances, FVector location, float radius)
+{
+	TArray<int32> toRemove;
+	QueryRadius(instances, location, radius, toRemove);
+	RemoveInstances(instances, toRemove);
+	return toRemove.Num();
+}
+
+void FGrassInstanceIndex::RemoveInstances(UHierarchicalInstancedStaticMeshComponent* instances, TArray<int32>& indices)
+{
+	if (instances == NULL || indices.Num() == 0)
+		return;
+
+	//instance manager removes from the highest index swapping the last instance in, the index has to do the same
+	indices.Sort(TGreater<int32>());
+	grassSampling::PointHashGrid& grid = GetGrid(instances);
+	instances->RemoveInstances(indices);
+	for (int32 index : indices)
+		grid.RemoveAtSwap(index);
+}
+
+void FGrassInstanceIndex::InsertInstancesAtSwap(UHierarchicalInstancedStaticMeshComponent* instances, const TArray<int32>& indices, const TArray<FTransform>& transforms)
+{
+	if (instances == NULL || indices.Num() == 0)
+		return;
+
+	//changes are collected first, so the instance manager gets one add and one update of changed instances
+	int32 count = instances->GetInstanceCount();
+	TArray<FTransform> appended;
+	TMap<int32, FTransform> updated;
+	grassSampling::PointHashGrid* grid = grids.Find(instances);
+	bool gridInSync = grid != nullptr && grid->Num() == count;
+
+	for (int32 i = 0; i < indices.Num(); i++)
+	{
+		int32 index = FMath::Clamp(indices[i], 0, count + appended.Num());
+		if (index < count + appended.Num())
+		{
+			FTransform moved;
+			if (index >= count)
+				moved = appended[index - count];
+			else if (const FTransform* changed = updated.Find(index))
+				moved = *changed;
+			else
+				instances->GetInstanceTransform(index, moved, false);
+			appended.Add(moved);
+
+			if (index >= count)
+				appended[index - count] = transforms[i];
+			else
+				updated.Add(index, transforms[i]);
+		}
+		else
+			appended.Add(transforms[i]);
+
+		if (gridInSync)
+			grid->InsertAtSwap(index, transforms[i].GetLocation().X, transforms[i].GetLocation().Y);
+	}
+
+	for (const TPair<int32, FTransform>& changed : updated)
+		instances->UpdateInstanceTransform(changed.Key, changed.Value, false, false, true);
+	instances->AddInstances(appended, false);
+	instances->MarkRenderStateDirty();
+
+	if (grid != nullptr && !gridInSync)
+		grids.Remove(instances);
+}
+
+void FGrassInstanceIndex::Reset(UHierarchicalInstancedStaticMeshComponent* instances)
+{
+	grids.Remove(instances);
+}
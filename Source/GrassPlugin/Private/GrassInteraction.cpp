@@ -0,0 +1,125 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "GrassInteraction.h"
+
+TArray<UGrassInteractorComponent*> UGrassInteractorComponent::interactors;
+
+void UGrassInteractorComponent::OnRegister()
+{
+	Super::OnRegister();
+	interactors.AddUnique(this);
+}
+
+void UGrassInteractorComponent::OnUnregister()
+{
+	interactors.RemoveSwap(this);
+	Super::OnUnregister();
+}
+
+AGrassInteractionField::AGrassInteractionField()
+{
+	parameterName = FString("interactionField");
+}
+
+void AGrassInteractionField::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	MoveField(GetViewLocation());
+	DecayField(DeltaSeconds);
+	for (const UGrassInteractorComponent* interactor : UGrassInteractorComponent::GetInteractors())
+		if (interactor->GetWorld() == GetWorld())
+			StampInteractor(interactor);
+	UploadField();
+	BindGrassMaterials();
+}
+
+void AGrassInteractionField::AllocateField()
+{
+	bend.Init(FVector2D::ZeroVector, resolution * resolution);
+	flatten.Init(0.f, resolution * resolution);
+}
+
+void AGrassInteractionField::ClearTexel(int index)
+{
+	bend[index] = FVector2D::ZeroVector;
+	flatten[index] = 0;
+}
+
+void AGrassInteractionField::EncodeTexel(int index, uint8* texel) const
+{
+	texel[0] = (uint8)FMath::Clamp(FMath::RoundToInt(flatten[index] * 255), 0, 255);
+	texel[1] = (uint8)FMath::Clamp(FMath::RoundToInt(127.5f + bend[index].Y * 127.5f), 0, 255);
+	texel[2] = (uint8)FMath::Clamp(FMath::RoundToInt(127.5f + bend[index].X * 127.5f), 0, 255);
+	texel[3] = 255;
+}
+
+void AGrassInteractionField::DecayField(float deltaSeconds)
+{
+	float decay = FMath::Exp(-recoverySpeed * deltaSeconds);
+	for (int i = 0; i < bend.Num(); i++)
+	{
+		bend[i] *= decay;
+		flatten[i] *= decay;
+	}
+}
+
+void AGrassInteractionField::StampInteractor(const UGrassInteractorComponent* interactor)
+{
+	AActor* owner = interactor->GetOwner();
+	if (owner == nullptr || interactor->radius <= 0)
+		return;
+
+	float texelSize = GetTexelSize();
+	FVector location = owner->GetActorLocation();
+	float radius = interactor->radius;
+
+	int minX = FMath::Max(FMath::FloorToInt((location.X - radius) / texelSize), origin.X);
+	int maxX = FMath::Min(FMath::FloorToInt((location.X + radius) / texelSize), origin.X + resolution - 1);
+	int minY = FMath::Max(FMath::FloorToInt((location.Y - radius) / texelSize), origin.Y);
+	int maxY = FMath::Min(FMath::FloorToInt((location.Y + radius) / texelSize), origin.Y + resolution - 1);
+
+	for (int x = minX; x <= maxX; x++)
+	{
+		for (int y = minY; y <= maxY; y++)
+		{
+			FVector2D offset((x + 0.5f) * texelSize - location.X, (y + 0.5f) * texelSize - location.Y);
+			float distance = offset.Size();
+			if (distance >= radius)
+				continue;
+
+			//the strongest interactor wins, so overlapping interactors do not push grass further than one would
+			float falloff = 1 - distance / radius;
+			int index = TexelIndex(x, y);
+			FVector2D stamped = distance > KINDA_SMALL_NUMBER ? offset / distance * falloff * interactor->bendStrength : FVector2D::ZeroVector;
+			if (stamped.SizeSquared() > bend[index].SizeSquared())
+				bend[index] = stamped;
+			flatten[index] = FMath::Max(flatten[index], falloff * interactor->flattenStrength);
+		}
+	}
+}
@@ -0,0 +1,182 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "GrassLandscapeDensity.h"
+#include "LandscapeProxy.h"
+#include "LandscapeInfo.h"
+#include "LandscapeComponent.h"
+#include "LandscapeLayerInfoObject.h"
+#include "EngineUtils.h"
+#if WITH_EDITOR
+#include "LandscapeEdit.h"
+#endif
+
+#if WITH_EDITOR
+int FGrassLandscapeDensity::Update(UWorld* world, const TArray<FGrassDensityLayer>& layers)
+{
+	ULandscapeInfo* info = nullptr;
+	for (TActorIterator<ALandscapeProxy> iterator(world); iterator && info == nullptr; ++iterator)
+		info = iterator->GetLandscapeInfo();
+	if (info == nullptr || info->GetLandscapeProxy() == nullptr)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("No landscape found for landscape density."));
+		return 0;
+	}
+
+	TArray<FName> layerNames;
+	TArray<int> newTermLayers;
+	for (const FGrassDensityLayer& term : layers)
+		newTermLayers.Add(layerNames.AddUnique(term.layerName));
+
+	TArray<ULandscapeLayerInfoObject*> layerInfos;
+	for (const FName& layerName : layerNames)
+	{
+		ULandscapeLayerInfoObject* layerInfo = info->GetLayerInfoByName(layerName);
+		if (layerInfo == nullptr)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Landscape has no paint layer %s."), *layerName.ToString());
+			return 0;
+		}
+		layerInfos.Add(layerInfo);
+	}
+
+	//cache is valid only for the same landscape and the same layers
+	if (landscapeInfo.Get() != info || extractedLayers != layerNames || componentSizeQuads != info->ComponentSizeQuads)
+	{
+		components.Empty();
+		landscapeInfo = info;
+		extractedLayers = layerNames;
+		componentSizeQuads = info->ComponentSizeQuads;
+	}
+	expression = layers;
+	termLayers = newTermLayers;
+	landscapeToWorld = info->GetLandscapeProxy()->LandscapeActorToWorld();
+
+	FLandscapeEditDataInterface landscapeEdit(info);
+	int size = componentSizeQuads + 1;
+	int extracted = 0;
+	TSet<FIntPoint> existing;
+	for (const TPair<FIntPoint, ULandscapeComponent*>& pair : info->XYtoComponentMap)
+	{
+		ULandscapeComponent* component = pair.Value;
+		if (component == nullptr)
+			continue;
+		existing.Add(pair.Key);
+
+		//painting changes weightmap textures of the component, so their ids tell if cached weights are still valid
+		TArray<FGuid> ids;
+		for (UTexture2D* weightmap : component->GetWeightmapTextures())
+			ids.Add(weightmap != nullptr ? weightmap->Source.GetId() : FGuid());
+		FComponentWeights* cached = components.Find(pair.Key);
+		if (cached != nullptr && cached->weightmapIds == ids)
+			continue;
+
+		FComponentWeights weights;
+		weights.weightmapIds = ids;
+		FIntPoint base = component->GetSectionBase();
+		for (ULandscapeLayerInfoObject* layerInfo : layerInfos)
+		{
+			TArray<uint8>& data = weights.layerWeights.AddDefaulted_GetRef();
+			data.SetNumZeroed(size * size);
+			landscapeEdit.GetWeightDataFast(layerInfo, base.X, base.Y, base.X + componentSizeQuads, base.Y + componentSizeQuads, data.GetData(), 0);
+		}
+		components.Add(pair.Key, MoveTemp(weights));
+		extracted++;
+	}
+
+	//components removed from the landscape
+	for (auto cached = components.CreateIterator(); cached; ++cached)
+		if (!existing.Contains(cached.Key()))
+			cached.RemoveCurrent();
+
+	UE_LOG(LogTemp, Display, TEXT("Landscape density: %i of %i components extracted."), extracted, components.Num());
+	return 1;
+}
+#endif
+
+float FGrassLandscapeDensity::SampleWeight(const FComponentWeights& weights, int layer, float localX, float localY) const
+{
+	const TArray<uint8>& data = weights.layerWeights[layer];
+	int size = componentSizeQuads + 1;
+	int x0 = FMath::Clamp(FMath::FloorToInt(localX), 0, componentSizeQuads - 1);
+	int y0 = FMath::Clamp(FMath::FloorToInt(localY), 0, componentSizeQuads - 1);
+	float fx = FMath::Clamp(localX - x0, 0.f, 1.f);
+	float fy = FMath::Clamp(localY - y0, 0.f, 1.f);
+
+	float bottom = FMath::Lerp((float)data[y0 * size + x0], (float)data[y0 * size + x0 + 1], fx);
+	float top = FMath::Lerp((float)data[(y0 + 1) * size + x0], (float)data[(y0 + 1) * size + x0 + 1], fx);
+	return FMath::Lerp(bottom, top, fy) / 255.f;
+}
+
+float FGrassLandscapeDensity::GetDensity(float x, float y) const
+{
+	if (componentSizeQuads <= 0)
+		return 0;
+
+	FVector local = landscapeToWorld.InverseTransformPosition(FVector(x, y, 0));
+	FIntPoint key(FMath::FloorToInt(local.X / componentSizeQuads), FMath::FloorToInt(local.Y / componentSizeQuads));
+	const FComponentWeights* weights = components.Find(key);
+	if (weights == nullptr)
+		return 0;
+
+	float localX = local.X - key.X * componentSizeQuads;
+	float localY = local.Y - key.Y * componentSizeQuads;
+	float density = 0;
+	for (int i = 0; i < expression.Num(); i++)
+	{
+		float weight = SampleWeight(*weights, termLayers[i], localX, localY) * expression[i].scale;
+		switch (expression[i].operation)
+		{
+		case EGPLayerCombine::Add:
+			density += weight;
+			break;
+		case EGPLayerCombine::Subtract:
+			density -= weight;
+			break;
+		case EGPLayerCombine::Multiply:
+			density *= weight;
+			break;
+		case EGPLayerCombine::Max:
+			density = FMath::Max(density, weight);
+			break;
+		case EGPLayerCombine::Min:
+			density = FMath::Min(density, weight);
+			break;
+		}
+	}
+	return FMath::Clamp(density, 0.f, 1.f);
+}
+
+void FGrassLandscapeDensity::Empty()
+{
+	components.Empty();
+	extractedLayers.Empty();
+	expression.Empty();
+	termLayers.Empty();
+	landscapeInfo.Reset();
+	componentSizeQuads = 0;
+}
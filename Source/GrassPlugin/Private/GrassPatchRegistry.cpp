@@ -0,0 +1,146 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "GrassPatchRegistry.h"
+#include "GrassBlade.h"
+#include "GVar.h"
+
+void UGrassPatchRegistry::Initialize(FSubsystemCollectionBase& collection)
+{
+	Super::Initialize(collection);
+	UGVar* configVars = UGVar::StaticClass()->GetDefaultObject<UGVar>();
+	cellSize = FMath::Max(configVars->patchRegistryCellSize, 1);
+}
+
+void UGrassPatchRegistry::Deinitialize()
+{
+	levelPatches.Empty();
+	cellPatches.Empty();
+	patchCells.Empty();
+	Super::Deinitialize();
+}
+
+void UGrassPatchRegistry::RegisterGrassPatch(AGrassBlade* patch)
+{
+	if (patch == nullptr || patch->GetLevel() == nullptr)
+		return;
+
+	FIntRect cells = GetCells(patch->GetGrassBounds());
+	FIntRect* registered = patchCells.Find(patch);
+	if (registered != nullptr)
+	{
+		if (*registered == cells)
+			return;
+		RemoveFromCells(patch, *registered);
+		*registered = cells;
+	}
+	else
+	{
+		levelPatches.FindOrAdd(patch->GetLevel()).Add(patch);
+		patchCells.Add(patch, cells);
+	}
+
+	for (int32 x = cells.Min.X; x < cells.Max.X; x++)
+		for (int32 y = cells.Min.Y; y < cells.Max.Y; y++)
+			cellPatches.FindOrAdd(FIntPoint(x, y)).Add(patch);
+}
+
+void UGrassPatchRegistry::UnregisterGrassPatch(AGrassBlade* patch)
+{
+	FIntRect cells;
+	if (!patchCells.RemoveAndCopyValue(patch, cells))
+		return;
+	RemoveFromCells(patch, cells);
+
+	//level of the patch can already be gone, so all the levels are searched (there are only few of them)
+	for (auto iterator = levelPatches.CreateIterator(); iterator; ++iterator)
+	{
+		iterator.Value().RemoveSingleSwap(patch, false);
+		if (iterator.Value().Num() == 0)
+			iterator.RemoveCurrent();
+	}
+}
+
+AGrassBlade* UGrassPatchRegistry::FindGrassPatch(const ULevel* level) const
+{
+	const TArray<TWeakObjectPtr<AGrassBlade>>* patches = levelPatches.Find(level);
+	if (patches == nullptr)
+		return nullptr;
+
+	for (const TWeakObjectPtr<AGrassBlade>& patch : *patches)
+		if (patch.IsValid() && !patch->IsPendingKill())
+			return patch.Get();
+	return nullptr;
+}
+
+AGrassBlade* UGrassPatchRegistry::FindGrassPatchAt(FVector location) const
+{
+	const TArray<TWeakObjectPtr<AGrassBlade>>* patches = cellPatches.Find(
+		FIntPoint(FMath::FloorToInt(location.X / cellSize), FMath::FloorToInt(location.Y / cellSize)));
+	if (patches == nullptr)
+		return nullptr;
+
+	for (const TWeakObjectPtr<AGrassBlade>& patch : *patches)
+		if (patch.IsValid() && !patch->IsPendingKill())
+			return patch.Get();
+	return nullptr;
+}
+
+void UGrassPatchRegistry::GetGrassPatches(TArray<AGrassBlade*>& patches) const
+{
+	patches.Reset();
+	for (const TPair<TWeakObjectPtr<AGrassBlade>, FIntRect>& registered : patchCells)
+		if (registered.Key.IsValid() && !registered.Key->IsPendingKill())
+			patches.Add(registered.Key.Get());
+}
+
+FIntRect UGrassPatchRegistry::GetCells(const FBox& bounds) const
+{
+	//patch without grass covers no cells
+	if (!bounds.IsValid)
+		return FIntRect(0, 0, 0, 0);
+
+	return FIntRect(FMath::FloorToInt(bounds.Min.X / cellSize), FMath::FloorToInt(bounds.Min.Y / cellSize),
+		FMath::FloorToInt(bounds.Max.X / cellSize) + 1, FMath::FloorToInt(bounds.Max.Y / cellSize) + 1);
+}
+
+void UGrassPatchRegistry::RemoveFromCells(AGrassBlade* patch, const FIntRect& cells)
+{
+	for (int32 x = cells.Min.X; x < cells.Max.X; x++)
+	{
+		for (int32 y = cells.Min.Y; y < cells.Max.Y; y++)
+		{
+			FIntPoint cell(x, y);
+			TArray<TWeakObjectPtr<AGrassBlade>>* patches = cellPatches.Find(cell);
+			if (patches == nullptr)
+				continue;
+			patches->RemoveSingleSwap(patch, false);
+			if (patches->Num() == 0)
+				cellPatches.Remove(cell);
+		}
+	}
+}
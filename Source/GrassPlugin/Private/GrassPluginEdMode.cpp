@@ -1,88 +1,178 @@
-// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
-//
-// Redistribution and use in source and binary forms, with or without
-// modification, are permitted provided that the following conditions are met:
-//
-//   1. Redistributions of source code must retain the above copyright notice,
-//      this list of conditions and the following disclaimer.
-//
-//   2. Redistributions in binary form must reproduce the above copyright notice,
-//      this list of conditions and the following disclaimer in the documentation
-//      and/or other materials provided with the distribution.
-//
-//   3. Neither the name of the copyright holder nor the names of its contributors
-//      may be used to endorse or promote products derived from this software
-//      without specific prior written permission.
-//
-// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
-// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
-// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
-// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
-// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
-// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
-// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
-// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
-// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
-// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
-// POSSIBILITY OF SUCH DAMAGE.
-
-#if WITH_EDITOR
-#include "../Public/GrassPluginEdMode.h"
-#include "../Public/GrassPluginEdModeToolkit.h"
-#include "Toolkits/ToolkitManager.h"
-#include "EditorModeManager.h"
-
-const FEditorModeID FGrassPluginEdMode::EM_GrassPluginEdModeId = TEXT("EM_GrassPluginEdMode");
-
-FGrassPluginEdMode::FGrassPluginEdMode()
-{
-	edModeSettings = NewObject<UGrassRendering>(GetTransientPackage(), TEXT("GrassRendering"), RF_Transactional);
-	edModeSettings->AddToRoot();
-	edModeSettings->editorMode = EM_GrassPluginEdModeId;
-	edModeSettings->OnNewMapLoad.BindRaw(this, &FGrassPluginEdMode::ReloadEditorMode);
-}
-
-FGrassPluginEdMode::~FGrassPluginEdMode()
-{
-	edModeSettings->RemoveFromRoot();
-}
-
-void FGrassPluginEdMode::Enter()
-{
-	FEdMode::Enter();
-
-	if (!Toolkit.IsValid() && UsesToolkits())
-	{
-		Toolkit = MakeShareable(new FGrassPluginEdModeToolkit);
-		Toolkit->Init(Owner->GetToolkitHost());
-	}
-}
-
-void FGrassPluginEdMode::Exit()
-{
-	if (Toolkit.IsValid())
-	{
-		FToolkitManager::Get().CloseToolkit(Toolkit.ToSharedRef());
-		Toolkit.Reset();
-	}
-	
-	// Call base Exit method to ensure proper cleanup
-	FEdMode::Exit();
-}
-
-bool FGrassPluginEdMode::UsesToolkits() const
-{
-	return true;
-}
-
-void FGrassPluginEdMode::ReloadEditorMode()
-{
-	FEditorModeTools tools = GLevelEditorModeTools();
-	tools.ActivateMode(EM_GrassPluginEdModeId, true);
-	Enter();
-	tools.BroadcastEditorModeChanged(tools.FindMode(EM_GrassPluginEdModeId), true);
-}
-
-
-
-#endif
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#if WITH_EDITOR
+#include "../Public/GrassPluginEdMode.h"
+#include "../Public/GrassPluginEdModeToolkit.h"
+#include "Toolkits/ToolkitManager.h"
+#include "EditorModeManager.h"
+#include "EditorViewportClient.h"
+#include "SceneManagement.h"
+
+const FEditorModeID FGrassPluginEdMode::EM_GrassPluginEdModeId = TEXT("EM_GrassPluginEdMode");
+
+FGrassPluginEdMode::FGrassPluginEdMode()
+{
+	edModeSettings = NewObject<UGrassRendering>(GetTransientPackage(), TEXT("GrassRendering"), RF_Transactional);
+	edModeSettings->AddToRoot();
+	edModeSettings->editorMode = EM_GrassPluginEdModeId;
+	edModeSettings->OnNewMapLoad.BindRaw(this, &FGrassPluginEdMode::ReloadEditorMode);
+}
+
+FGrassPluginEdMode::~FGrassPluginEdMode()
+{
+	edModeSettings->RemoveFromRoot();
+}
+
+void FGrassPluginEdMode::Enter()
+{
+	FEdMode::Enter();
+
+	if (!Toolkit.IsValid() && UsesToolkits())
+	{
+		Toolkit = MakeShareable(new FGrassPluginEdModeToolkit);
+		Toolkit->Init(Owner->GetToolkitHost());
+	}
+}
+
+void FGrassPluginEdMode::Exit()
+{
+	if (brushPainting)
+	{
+		brushPainting = false;
+		edModeSettings->EndBrushStroke();
+	}
+
+	if (Toolkit.IsValid())
+	{
+		FToolkitManager::Get().CloseToolkit(Toolkit.ToSharedRef());
+		Toolkit.Reset();
+	}
+	
+	// Call base Exit method to ensure proper cleanup
+	FEdMode::Exit();
+}
+
+bool FGrassPluginEdMode::UsesToolkits() const
+{
+	return true;
+}
+
+bool FGrassPluginEdMode::InputKey(FEditorViewportClient* ViewportClient, FViewport* Viewport, FKey Key, EInputEvent Event)
+{
+	if (Key == EKeys::LeftMouseButton && edModeSettings->brushMode != EGPBrushMode::None)
+	{
+		//alt + left mouse button keeps orbiting the camera
+		bool altDown = Viewport->KeyState(EKeys::LeftAlt) || Viewport->KeyState(EKeys::RightAlt);
+		if (Event == IE_Pressed && !altDown)
+		{
+			brushPainting = UpdateBrushLocation(ViewportClient, Viewport->GetMouseX(), Viewport->GetMouseY()) && edModeSettings->BeginBrushStroke();
+			if (brushPainting)
+			{
+				edModeSettings->ApplyBrush(brushLocation);
+				lastDabLocation = brushLocation;
+			}
+			return brushPainting;
+		}
+		if (Event == IE_Released && brushPainting)
+		{
+			brushPainting = false;
+			edModeSettings->EndBrushStroke();
+			return true;
+		}
+	}
+	return FEdMode::InputKey(ViewportClient, Viewport, Key, Event);
+}
+
+bool FGrassPluginEdMode::MouseMove(FEditorViewportClient* ViewportClient, FViewport* Viewport, int32 x, int32 y)
+{
+	if (edModeSettings->brushMode != EGPBrushMode::None)
+		UpdateBrushLocation(ViewportClient, x, y);
+	return false;
+}
+
+bool FGrassPluginEdMode::CapturedMouseMove(FEditorViewportClient* ViewportClient, FViewport* Viewport, int32 mouseX, int32 mouseY)
+{
+	if (!brushPainting)
+		return false;
+
+	//dabs are spaced by half of the brush radius, so one stroke does not resample the same area on every mouse move
+	if (UpdateBrushLocation(ViewportClient, mouseX, mouseY) &&
+		FVector::Dist2D(brushLocation, lastDabLocation) >= 0.5f * edModeSettings->brushRadius)
+	{
+		edModeSettings->ApplyBrush(brushLocation);
+		lastDabLocation = brushLocation;
+	}
+	return true;
+}
+
+bool FGrassPluginEdMode::DisallowMouseDeltaTracking() const
+{
+	return brushPainting;
+}
+
+void FGrassPluginEdMode::Render(const FSceneView* View, FViewport* Viewport, FPrimitiveDrawInterface* PDI)
+{
+	FEdMode::Render(View, Viewport, PDI);
+
+	if (brushVisible && edModeSettings->brushMode != EGPBrushMode::None)
+	{
+		FLinearColor color = edModeSettings->brushMode == EGPBrushMode::Erase ? FLinearColor::Red : FLinearColor::Green;
+		DrawCircle(PDI, brushLocation, FVector(1, 0, 0), FVector(0, 1, 0), color, edModeSettings->brushRadius, 32, SDPG_Foreground);
+	}
+}
+
+bool FGrassPluginEdMode::UpdateBrushLocation(FEditorViewportClient* viewportClient, int32 mouseX, int32 mouseY)
+{
+	FSceneViewFamilyContext viewFamily(FSceneViewFamily::ConstructionValues(viewportClient->Viewport, viewportClient->GetScene(),
+		viewportClient->EngineShowFlags).SetRealtimeUpdate(viewportClient->IsRealtime()));
+	FSceneView* view = viewportClient->CalcSceneView(&viewFamily);
+	FViewportCursorLocation cursor(view, viewportClient, mouseX, mouseY);
+
+	FVector start = cursor.GetOrigin();
+	FVector end = start + WORLD_MAX * cursor.GetDirection();
+	FHitResult hitResult(ForceInit);
+	FCollisionQueryParams traceParams(FName(TEXT("grass brush trace")), true);
+
+	brushVisible = viewportClient->GetWorld()->LineTraceSingleByChannel(hitResult, start, end, ECollisionChannel::ECC_WorldStatic, traceParams);
+	if (brushVisible)
+		brushLocation = hitResult.Location;
+	return brushVisible;
+}
+
+void FGrassPluginEdMode::ReloadEditorMode()
+{
+	FEditorModeTools tools = GLevelEditorModeTools();
+	tools.ActivateMode(EM_GrassPluginEdModeId, true);
+	Enter();
+	tools.BroadcastEditorModeChanged(tools.FindMode(EM_GrassPluginEdModeId), true);
+}
+
+
+
+#endif
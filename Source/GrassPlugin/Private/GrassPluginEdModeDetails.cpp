@@ -1,107 +1,181 @@
-// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
-//
-// Redistribution and use in source and binary forms, with or without
-// modification, are permitted provided that the following conditions are met:
-//
-//   1. Redistributions of source code must retain the above copyright notice,
-//      this list of conditions and the following disclaimer.
-//
-//   2. Redistributions in binary form must reproduce the above copyright notice,
-//      this list of conditions and the following disclaimer in the documentation
-//      and/or other materials provided with the distribution.
-//
-//   3. Neither the name of the copyright holder nor the names of its contributors
-//      may be used to endorse or promote products derived from this software
-//      without specific prior written permission.
-//
-// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
-// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
-// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
-// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
-// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
-// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
-// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
-// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
-// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
-// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
-// POSSIBILITY OF SUCH DAMAGE.
-
-#if WITH_EDITOR
-#include "GrassPluginEdModeDetails.h"
-
-#define LOCTEXT_NAMESPACE "FGrassPluginDetails"
-
-TSharedRef<IDetailCustomization> FGrassPluginEdModeDetails::MakeInstance()
-{
-	return MakeShareable(new FGrassPluginEdModeDetails);
-}
-
-void FGrassPluginEdModeDetails::CustomizeDetails(IDetailLayoutBuilder& DetailBuilder)
-{
-	TArray<TWeakObjectPtr<UObject>> outObjects;
-	DetailBuilder.GetObjectsBeingCustomized(outObjects);
-	if (outObjects.Num() > 0)
-		FGrassPluginEdModeDetails::ObjectBeingCustomized = outObjects[0];
-
-	IDetailCategoryBuilder& GeneralSettingsCategory = DetailBuilder.EditCategory("General Settings");
-	IDetailCategoryBuilder& GeneralPoissonCategory = DetailBuilder.EditCategory("General Poisson Disk Settings");
-	IDetailCategoryBuilder& PoissonDiskCategory = DetailBuilder.EditCategory("Regular Poisson Sampling");
-	IDetailCategoryBuilder& AdaptivePoissonCategory = DetailBuilder.EditCategory("Adaptive Poisson Sampling");
-
-	//general settings
-	TSharedRef<IPropertyHandle> poissonDiskBool = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, poissonDisk));
-	TSharedRef<IPropertyHandle> shouldSnapToTer = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, shouldSnapToTerrain));
-	TSharedRef<IPropertyHandle> lengthOfRay = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, rayLength));
-	TSharedRef<IPropertyHandle> grassBShape = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, grassShape));
-	TSharedRef<IPropertyHandle> overridePrev =
-		DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, overridePrevious));
-	TSharedRef<IPropertyHandle> experLOD = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, experimentalLODSystem));
-
-	//poissonDisk sampling settings
-	TSharedRef<IPropertyHandle> topLeft = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, topLeftCorner));
-	TSharedRef<IPropertyHandle> botRight = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, botRightCorner));
-	TSharedRef<IPropertyHandle> poissonDiskTry = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, poissonDiskTries));
-	TSharedRef<IPropertyHandle> radiusOfTurf = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, turfGrassRadius));
-	TSharedRef<IPropertyHandle> turfDensity = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, numOfBladesWithinTurf));
-	TSharedRef<IPropertyHandle> adaptiveSamplingOn = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, adaptiveSampling));
-
-	//atributes specific to adaptive sampling
-	TSharedRef<IPropertyHandle> lowerThresh = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, lowerThreshold));
-	TSharedRef<IPropertyHandle> upperThresh = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, upperThreshold));
-	TSharedRef<IPropertyHandle> picName = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, pictureName));
-	TSharedRef<IPropertyHandle> div = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, divideIntoSmaller));
-	TSharedRef<IPropertyHandle> partAm = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, amountOfParts));
-	TSharedRef<IPropertyHandle> part = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, renderPart));
-	
-	//attributes specific to regular sampling
-	TSharedRef<IPropertyHandle> poissonRadius = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, turfRadius));
-	   	 
-	// clang-format off
-
-	GeneralSettingsCategory.AddProperty(poissonDiskBool);
-	GeneralSettingsCategory.AddProperty(shouldSnapToTer);
-	GeneralSettingsCategory.AddProperty(lengthOfRay);
-	GeneralSettingsCategory.AddProperty(grassBShape);
-	GeneralSettingsCategory.AddProperty(overridePrev);
-	GeneralSettingsCategory.AddProperty(experLOD);
-
-	GeneralPoissonCategory.AddProperty(topLeft);
-	GeneralPoissonCategory.AddProperty(botRight);
-	GeneralPoissonCategory.AddProperty(poissonDiskTry);
-	GeneralPoissonCategory.AddProperty(radiusOfTurf);
-	GeneralPoissonCategory.AddProperty(turfDensity);
-
-	PoissonDiskCategory.AddProperty(poissonRadius);
-
-
-	AdaptivePoissonCategory.AddProperty(adaptiveSamplingOn);
-	AdaptivePoissonCategory.AddProperty(lowerThresh);
-	AdaptivePoissonCategory.AddProperty(upperThresh);
-	AdaptivePoissonCategory.AddProperty(picName);
-	AdaptivePoissonCategory.AddProperty(div);
-	AdaptivePoissonCategory.AddProperty(partAm);
-	AdaptivePoissonCategory.AddProperty(part);
-	// clang-format on
-
-}
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#if WITH_EDITOR
+#include "GrassPluginEdModeDetails.h"
+
+#define LOCTEXT_NAMESPACE "FGrassPluginDetails"
+
+TSharedRef<IDetailCustomization> FGrassPluginEdModeDetails::MakeInstance()
+{
+	return MakeShareable(new FGrassPluginEdModeDetails);
+}
+
+void FGrassPluginEdModeDetails::CustomizeDetails(IDetailLayoutBuilder& DetailBuilder)
+{
+	TArray<TWeakObjectPtr<UObject>> outObjects;
+	DetailBuilder.GetObjectsBeingCustomized(outObjects);
+	if (outObjects.Num() > 0)
+		FGrassPluginEdModeDetails::ObjectBeingCustomized = outObjects[0];
+
+	IDetailCategoryBuilder& GeneralSettingsCategory = DetailBuilder.EditCategory("General Settings");
+	IDetailCategoryBuilder& GeneralPoissonCategory = DetailBuilder.EditCategory("General Poisson Disk Settings");
+	IDetailCategoryBuilder& PoissonDiskCategory = DetailBuilder.EditCategory("Regular Poisson Sampling");
+	IDetailCategoryBuilder& AdaptivePoissonCategory = DetailBuilder.EditCategory("Adaptive Poisson Sampling");
+	IDetailCategoryBuilder& FlowersCategory = DetailBuilder.EditCategory("Flowers");
+	IDetailCategoryBuilder& BrushCategory = DetailBuilder.EditCategory("Brush");
+
+	//general settings
+	TSharedRef<IPropertyHandle> poissonDiskBool = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, poissonDisk));
+	TSharedRef<IPropertyHandle> shouldSnapToTer = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, shouldSnapToTerrain));
+	TSharedRef<IPropertyHandle> lengthOfRay = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, rayLength));
+	TSharedRef<IPropertyHandle> grassBShape = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, grassShape));
+	TSharedRef<IPropertyHandle> mixShapes = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, mixGrassShapes));
+	TSharedRef<IPropertyHandle> quadWeight = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, quadShapeWeight));
+	TSharedRef<IPropertyHandle> triangleWeight = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, triangleShapeWeight));
+	TSharedRef<IPropertyHandle> triangleQuadWeight = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, triangleQuadShapeWeight));
+	TSharedRef<IPropertyHandle> densityShape = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, shapeFromDensity));
+	TSharedRef<IPropertyHandle> overridePrev =
+		DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, overridePrevious));
+	TSharedRef<IPropertyHandle> experLOD = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, experimentalLODSystem));
+	TSharedRef<IPropertyHandle> billboardTurfs = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, turfsPerBillboard));
+	TSharedRef<IPropertyHandle> splineExclusion = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, exclusionSplineRadius));
+
+	//poissonDisk sampling settings
+	TSharedRef<IPropertyHandle> topLeft = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, topLeftCorner));
+	TSharedRef<IPropertyHandle> botRight = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, botRightCorner));
+	TSharedRef<IPropertyHandle> bakeRegions = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, useBakeRegions));
+	TSharedRef<IPropertyHandle> bakeSelected = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, bakeSelectedLandscapeComponents));
+	TSharedRef<IPropertyHandle> pointCloudOn = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, usePointCloud));
+	TSharedRef<IPropertyHandle> pointCloudExport = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, exportPointCloud));
+	TSharedRef<IPropertyHandle> pointCloudFile = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, pointCloudPath));
+	TSharedRef<IPropertyHandle> poissonDiskTry = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, poissonDiskTries));
+	TSharedRef<IPropertyHandle> radiusOfTurf = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, turfGrassRadius));
+	TSharedRef<IPropertyHandle> turfDensity = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, numOfBladesWithinTurf));
+	TSharedRef<IPropertyHandle> clumps = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, useTurfClumps));
+	TSharedRef<IPropertyHandle> variantsOfClump = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, clumpVariants));
+	TSharedRef<IPropertyHandle> progressive = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, progressiveSampling));
+	TSharedRef<IPropertyHandle> densityOfTurfs = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, turfDensity));
+	TSharedRef<IPropertyHandle> adaptiveSamplingOn = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, adaptiveSampling));
+
+	//atributes specific to adaptive sampling
+	TSharedRef<IPropertyHandle> lowerThresh = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, lowerThreshold));
+	TSharedRef<IPropertyHandle> upperThresh = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, upperThreshold));
+	TSharedRef<IPropertyHandle> picName = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, pictureName));
+	TSharedRef<IPropertyHandle> sourceOfDensity = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, densitySource));
+	TSharedRef<IPropertyHandle> blueNoise = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, blueNoiseThreshold));
+	TSharedRef<IPropertyHandle> layersOfDensity = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, densityLayers));
+	TSharedRef<IPropertyHandle> div = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, divideIntoSmaller));
+	TSharedRef<IPropertyHandle> partAm = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, amountOfParts));
+	TSharedRef<IPropertyHandle> part = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, renderPart));
+	
+	//attributes specific to regular sampling
+	TSharedRef<IPropertyHandle> poissonRadius = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, turfRadius));
+	TSharedRef<IPropertyHandle> poissonTiles = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, usePoissonTiles));
+	TSharedRef<IPropertyHandle> seed = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, samplingSeed));
+
+	//attributes specific to jittered grid
+	TSharedRef<IPropertyHandle> gridDensity = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, jitteredGridDensity));
+	TSharedRef<IPropertyHandle> jitterOfGrid = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, gridJitter));
+
+	//brush settings
+	TSharedRef<IPropertyHandle> modeOfBrush = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, brushMode));
+	TSharedRef<IPropertyHandle> radiusOfBrush = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, brushRadius));
+
+	//flower settings
+	TSharedRef<IPropertyHandle> flowersOn = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, spawnFlowers));
+	TSharedRef<IPropertyHandle> kindOfFlower = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, flowerKind));
+	TSharedRef<IPropertyHandle> flowerChance = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, flowerTurfChance));
+	TSharedRef<IPropertyHandle> minFlowers = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, minFlowersInTurf));
+	TSharedRef<IPropertyHandle> maxFlowers = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, maxFlowersInTurf));
+	TSharedRef<IPropertyHandle> flowerRadius = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, innerFlowerRadius));
+	TSharedRef<IPropertyHandle> flowerWeight = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UGrassRendering, flowerSpawnWeight));
+	   	 
+	// clang-format off
+
+	GeneralSettingsCategory.AddProperty(poissonDiskBool);
+	GeneralSettingsCategory.AddProperty(gridDensity);
+	GeneralSettingsCategory.AddProperty(jitterOfGrid);
+	GeneralSettingsCategory.AddProperty(shouldSnapToTer);
+	GeneralSettingsCategory.AddProperty(lengthOfRay);
+	GeneralSettingsCategory.AddProperty(grassBShape);
+	GeneralSettingsCategory.AddProperty(mixShapes);
+	GeneralSettingsCategory.AddProperty(quadWeight);
+	GeneralSettingsCategory.AddProperty(triangleWeight);
+	GeneralSettingsCategory.AddProperty(triangleQuadWeight);
+	GeneralSettingsCategory.AddProperty(densityShape);
+	GeneralSettingsCategory.AddProperty(overridePrev);
+	GeneralSettingsCategory.AddProperty(experLOD);
+	GeneralSettingsCategory.AddProperty(billboardTurfs);
+	GeneralSettingsCategory.AddProperty(splineExclusion);
+
+	GeneralPoissonCategory.AddProperty(topLeft);
+	GeneralPoissonCategory.AddProperty(botRight);
+	GeneralPoissonCategory.AddProperty(bakeRegions);
+	GeneralPoissonCategory.AddProperty(bakeSelected);
+	GeneralPoissonCategory.AddProperty(pointCloudOn);
+	GeneralPoissonCategory.AddProperty(pointCloudExport);
+	GeneralPoissonCategory.AddProperty(pointCloudFile);
+	GeneralPoissonCategory.AddProperty(poissonDiskTry);
+	GeneralPoissonCategory.AddProperty(radiusOfTurf);
+	GeneralPoissonCategory.AddProperty(turfDensity);
+	GeneralPoissonCategory.AddProperty(clumps);
+	GeneralPoissonCategory.AddProperty(variantsOfClump);
+	GeneralPoissonCategory.AddProperty(progressive);
+	GeneralPoissonCategory.AddProperty(densityOfTurfs);
+
+	PoissonDiskCategory.AddProperty(poissonRadius);
+	PoissonDiskCategory.AddProperty(poissonTiles);
+	PoissonDiskCategory.AddProperty(seed);
+
+
+	AdaptivePoissonCategory.AddProperty(adaptiveSamplingOn);
+	AdaptivePoissonCategory.AddProperty(lowerThresh);
+	AdaptivePoissonCategory.AddProperty(upperThresh);
+	AdaptivePoissonCategory.AddProperty(picName);
+	AdaptivePoissonCategory.AddProperty(sourceOfDensity);
+	AdaptivePoissonCategory.AddProperty(layersOfDensity);
+	AdaptivePoissonCategory.AddProperty(blueNoise);
+	AdaptivePoissonCategory.AddProperty(div);
+	AdaptivePoissonCategory.AddProperty(partAm);
+	AdaptivePoissonCategory.AddProperty(part);
+
+	FlowersCategory.AddProperty(flowersOn);
+	FlowersCategory.AddProperty(kindOfFlower);
+	FlowersCategory.AddProperty(flowerChance);
+	FlowersCategory.AddProperty(minFlowers);
+	FlowersCategory.AddProperty(maxFlowers);
+	FlowersCategory.AddProperty(flowerRadius);
+	FlowersCategory.AddProperty(flowerWeight);
+
+	BrushCategory.AddProperty(modeOfBrush);
+	BrushCategory.AddProperty(radiusOfBrush);
+	// clang-format on
+
+}
 #endif
\ No newline at end of file
@@ -1,761 +1,1953 @@
-// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
-//
-// Redistribution and use in source and binary forms, with or without
-// modification, are permitted provided that the following conditions are met:
-//
-//   1. Redistributions of source code must retain the above copyright notice,
-//      this list of conditions and the following disclaimer.
-//
-//   2. Redistributions in binary form must reproduce the above copyright notice,
-//      this list of conditions and the following disclaimer in the documentation
-//      and/or other materials provided with the distribution.
-//
-//   3. Neither the name of the copyright holder nor the names of its contributors
-//      may be used to endorse or promote products derived from this software
-//      without specific prior written permission.
-//
-// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
-// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
-// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
-// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
-// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
-// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
-// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
-// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
-// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
-// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
-// POSSIBILITY OF SUCH DAMAGE.
-
-#include "GrassRendering.h"
-
-
-UGrassRendering::UGrassRendering()
-{
-	grassPatch = (AGrassBlade*) NewObject<AGrassBlade>();
-	
-	UGVar* configVars = UGVar::StaticClass()->GetDefaultObject<UGVar>();
-
-	InitMaterial(grassMaterial, configVars->grassMatLocation);
-	InitMaterial(billboardMaterial, configVars->billBoardMatLocation);	
-}
-
-void UGrassRendering::InitMaterial(UMaterial *& mat, FString matLoc)
-{
-	ConstructorHelpers::FObjectFinder<UMaterial> matFinder(*matLoc);
-	if (matFinder.Succeeded())
-	{
-		mat = matFinder.Object;
-	}
-	else {
-		UE_LOG(LogTemp, Display, TEXT("%s Material not found."), *matLoc);
-	}
-	UGVar* configVars = UGVar::StaticClass()->GetDefaultObject<UGVar>();
-	configVars->SaveConfig();
-}
-
-
-void UGrassRendering::SpawnGrassBladesInTurfs()
-{
-	const float bounds[4] = { topLeftCorner.X, topLeftCorner.Y, botRightCorner.X, botRightCorner.Y };
-	std::vector<float> poissonPos;
-	unsigned char* radValues = 0;
-	unsigned imgW = 0, imgH = 0;
-
-	SpawnPatchIfNotSpawned();
-
-	grassPatch->SetRayLength(rayLength);
-	grassPatch->SetExperimentalLOD(experimentalLODSystem);
-	
-	if (!CheckBounds())
-		return;
-	
-	if (!GeneratePositions(poissonPos, radValues, imgW, imgH, bounds))
-		return;
-	
-	UE_LOG(LogTemp, Display, TEXT("size of array %i"), poissonPos.size()/2);
-	if (!CheckInstanceLimit(poissonPos.size()))
-		return;
-		
-	FScopedSlowTask loadingDialogForSpawn(
-		poissonPos.size() / 2, NSLOCTEXT("GrassSpawn", "Spawning Grass", "Spawning instances of grass"), true);
-	loadingDialogForSpawn.MakeDialogDelayed(1, true, true);
-	
-	for (int i = 0; i < poissonPos.size(); i+=2)
-	{
-		loadingDialogForSpawn.EnterProgressFrame(
-			1, NSLOCTEXT("GrassSpawn", "Spawning Grass", "Grass turfs are being generated."));
-
-		if (!SpawnTurf(poissonPos[i], poissonPos[i + 1], radValues, imgW, imgH, bounds))
-			return;
-
-		if (GWarn->ReceivedUserCancel())
-		{
-			UE_LOG(LogTemp, Warning, TEXT("Generating of new grass interupted."));
-			return;
-		}
-
-		if (!CheckRAMLimit())
-			return;
-	}
-	if (radValues)
-		free(radValues);
-	
-	UE_LOG(LogTemp, Display, TEXT("The Total RAM %i, available RAM %i"), GetTotalRAM(), GetAvailRAM());
-}
-
-void UGrassRendering::RefreshGrassMode()
-{
-	grassPatch->SetActiveGrassBlades(grassShape);
-}
-
-void UGrassRendering::ClearGrass()
-{
-	if (grassPatch != NULL)
-		grassPatch->ClearInstances();
-}
-
-
-void UGrassRendering::SpawnPatchIfNotSpawned() {
-	int count = 0;
-#if WITH_EDITOR
-	UEditorEngine* editor = GEditor;
-	UWorld* world = editor->GetLevelViewportClients()[0]->GetWorld();
-#else
-	UWorld* world = GetWorld();
-#endif
-
-	for (TActorIterator<AGrassBlade> iterator(world); iterator; ++iterator)
-	{
-		count++;
-	}
-	if (count < 1)
-	{
-		FActorSpawnParameters spawnInfo;
-		spawnInfo.bNoFail = true;
-		grassPatch = world->SpawnActor<AGrassBlade>(FVector(0, 0, 0), FRotator(0, 0, 0), spawnInfo);
-		grassPatch->SetActiveGrassBlades(grassShape);
-		UMaterialInstanceDynamic* grassDynMaterial = UMaterialInstanceDynamic::Create(grassMaterial, this, FName("GrassInstances"));
-		UMaterialInstanceDynamic* billboardDynMaterial = UMaterialInstanceDynamic::Create(billboardMaterial, this, FName("billboardInstaces"));
-		grassPatch->InitializeMaterials(grassDynMaterial,billboardDynMaterial);
-		grassPatch->SetMaterialTextureSize(abs(topLeftCorner.X - botRightCorner.X), abs(topLeftCorner.Y - botRightCorner.Y));
-	}
-}
-#pragma optimize("", off)
-
-
-
-
-void UGrassRendering::PoissonDiskForWholeBoundaries(std::vector<float>& positions, const int radius, const int maxTries,
-	const float bounds[])
-{
-	float width = abs(bounds[0] - bounds[2]);
-	float height = abs(bounds[1] - bounds[3]);
-	int xSegments, ySegments;
-	float segmentSize;
-	DetermineAmountOfSegments(width, height, xSegments, ySegments, segmentSize);
-	float subBounds[4];
-	UE_LOG(LogTemp, Display, TEXT("width is %f height is %f, segments are %i and %i, segments size %f\n"), width, height,
-		xSegments, ySegments, segmentSize);
-	FScopedSlowTask loadingDialogForSpawn(
-		xSegments * ySegments, NSLOCTEXT("GrassSpawn", "Spawning Grass", "Spawning subSpaces of grass"), true);
-	loadingDialogForSpawn.MakeDialogDelayed(1, true, true);
-
-	for (int i = 0; i < xSegments; i++)
-	{
-		for (int j = 0; j < ySegments; j++)
-		{
-			loadingDialogForSpawn.EnterProgressFrame(
-				1, FText::Format(NSLOCTEXT("GrassSpawn", "Spawning Grass", "Spawning {0} subSpace of grass"),
-					j + ySegments * i));
-			CreateSubBounds(bounds, subBounds, i, j, xSegments, ySegments, segmentSize);
-			cudaPoissonSampling::PoissonDiskDistribution(positions, radius, maxTries, subBounds);
-
-			if (GWarn->ReceivedUserCancel())
-			{
-				UE_LOG(LogTemp, Warning,
-					TEXT("Generating of new positions interupted. Grass will be generated only for positions "
-						"generated until now./n"));
-				return;
-			}
-		}
-	}
-}
-
-void UGrassRendering::PoissonDiskForWholeBoundaries(std::vector<float>& positions, unsigned char* &radiusValues, unsigned& imgW, unsigned& imgH, std::string input,
-	const int maxTries, const float bounds[])
-{
-	float width = abs(bounds[0] - bounds[2]);
-	float height = abs(bounds[1] - bounds[3]);
-	int xSegments, ySegments;
-	float segmentSize;
-	DetermineAmountOfSegments(width, height, xSegments, ySegments, segmentSize);
-	float subBounds[4];
-	UE_LOG(LogTemp, Error, TEXT("width is %f height is %f, segments are %i and %i, segments size %f\n"), width, height,
-		xSegments, ySegments, segmentSize);
-	FScopedSlowTask loadingDialogForSpawn(
-		xSegments * ySegments, NSLOCTEXT("GrassSpawn", "Spawning Grass", "Spawning subSpaces of grass"), true);
-	loadingDialogForSpawn.MakeDialogDelayed(1, true, true);
-
-	for (int i = 0; i < xSegments; i++)
-	{
-		for (int j = 0; j < ySegments; j++)
-		{
-
-			loadingDialogForSpawn.EnterProgressFrame(
-				1, FText::Format(NSLOCTEXT("GrassSpawn", "Spawning Grass", "Spawning {0} subScape of grass"),
-					j + ySegments * i));
-			CreateSubBounds(bounds, subBounds, i, j, xSegments, ySegments, segmentSize);
-			cudaPoissonSampling::partitionAttributes partition = { xSegments, ySegments, i + xSegments * j };
-			cudaPoissonSampling::PoissonDiskDistribution(positions, radiusValues, imgW, imgH, input, maxTries, subBounds, lowerThreshold,
-				upperThreshold, partition);
-			if (GWarn->ReceivedUserCancel())
-			{
-				UE_LOG(LogTemp, Warning,
-					TEXT("Generating of new positions interupted. Grass will be generated only for positions "
-						"generated until now./n"));
-				return;
-			}
-		}
-	}
-}
-
-void UGrassRendering::PoissonDiskForPart(std::vector<float>& positions, unsigned char* &radValues, unsigned& imgW, unsigned& imgH, std::string input, const int maxTries,
-	const float bounds[], int index)
-{
-	float width = abs(bounds[0] - bounds[2]);
-	float height = abs(bounds[1] - bounds[3]);
-	int xSegments, ySegments;
-	float segmentSize;
-	DetermineAmountOfSegments(width, height, xSegments, ySegments, segmentSize);
-	float subBounds[4];
-	UE_LOG(LogTemp, Error, TEXT("width is %f height is %f, segments are %i and %i, segments size %f\n"), width, height,
-		xSegments, ySegments, segmentSize);
-	int totalSegments = xSegments * ySegments;
-	if (totalSegments < amountOfParts)
-		amountOfParts = totalSegments;
-	float partSize = (float)totalSegments / (float)amountOfParts;
-	int lowerIndex = FMath::RoundToInt(renderPart * partSize);
-	int upperIndex = FMath::RoundToInt((renderPart + 1) * partSize);
-
-	FScopedSlowTask loadingDialogForSpawn(
-		upperIndex - lowerIndex, NSLOCTEXT("GrassSpawn", "Spawning Grass", "Spawning subSpaces of grass"), true);
-	loadingDialogForSpawn.MakeDialogDelayed(1, true, true);
-
-	for (int k = lowerIndex; k < upperIndex; k++)
-	{
-		int i = k % xSegments;
-		int j = k / xSegments;
-		loadingDialogForSpawn.EnterProgressFrame(
-			1, FText::Format(NSLOCTEXT("GrassSpawn", "Spawning Grass", "Spawning {0} subScape of grass"), k));
-		CreateSubBounds(bounds, subBounds, i, j, xSegments, ySegments, segmentSize);
-		cudaPoissonSampling::partitionAttributes partition = { xSegments, ySegments, i + xSegments * j };
-		cudaPoissonSampling::PoissonDiskDistribution(positions, radValues, imgW, imgH, input, maxTries, subBounds, lowerThreshold,
-			upperThreshold, partition);
-		if (GWarn->ReceivedUserCancel())
-		{
-			UE_LOG(LogTemp, Warning,
-				TEXT("Generating of new positions interupted. Grass will be generated only for positions "
-					"generated until now./n"));
-			return;
-		}
-	}
-}
-
-int UGrassRendering::DetermineAmountOfSegments(float& width, float& height, int& xSegments, int& ySegments,
-	float& segmentSize)
-{
-
-	if (height > width)
-	{
-		ySegments = ComputeSegmentsVal(height);
-		segmentSize = height / ySegments;
-		xSegments = ComputeSegmentsVal(width);
-		width = segmentSize * xSegments;
-	}
-	else
-	{
-		xSegments = ComputeSegmentsVal(width);
-		segmentSize = width / xSegments;
-		ySegments = ComputeSegmentsVal(height);
-		height = segmentSize * ySegments;
-	}
-
-	return 1;
-}
-void UGrassRendering::CreateSubBounds(const float bounds[], float subBounds[], int xIdx, int yIdx, int xSegments,
-	int ySegments, float segmentSize)
-{
-	if (bounds[1] < bounds[3])
-	{
-		subBounds[0] = bounds[0] + xIdx * segmentSize;
-		subBounds[1] = bounds[1] + yIdx * segmentSize;
-		subBounds[2] = bounds[2] - (xSegments - 1 - xIdx) * segmentSize;
-		subBounds[3] = bounds[3] - (ySegments - 1 - yIdx) * segmentSize;
-	}
-	else
-	{
-		subBounds[0] = bounds[0] + xIdx * segmentSize;
-		subBounds[1] = bounds[1] - (ySegments - 1 - yIdx) * segmentSize;
-		subBounds[2] = bounds[2] - (xSegments - 1 - xIdx) * segmentSize;
-		subBounds[3] = bounds[3] + yIdx * segmentSize;
-	}
-}
-void UGrassRendering::GenerateErrorMessage(const FString& title, const FString& message)
-{
-	FText fullTitle = FText::Format(NSLOCTEXT("HeatMaps", "File_Error", "{0}"), FText::AsCultureInvariant(title));
-	UE_LOG(LogTemp, Error, TEXT("%s"), *message);
-	FMessageDialog::Open(EAppMsgType::Ok, FText::FromString(message), &fullTitle);
-}
-
-EAppReturnType::Type UGrassRendering::GenerateWarningMessage(const FString& title, const FString& message)
-{
-	FText fullTitle = FText::Format(NSLOCTEXT("GrassPlugin", "File_Warning", "{0}"), FText::AsCultureInvariant(title));
-	UE_LOG(LogTemp, Warning, TEXT("%s"), *message);
-	return FMessageDialog::Open(EAppMsgType::YesNo, FText::FromString(message), &fullTitle);
-}
-
-int UGrassRendering::GeneratePositions(std::vector<float>& positions, unsigned char *& radValues, unsigned & imgW, unsigned & imgH, const float bounds[])
-{
-	if (adaptiveSampling)
-	{
-		FString path = FPaths::ProjectPluginsDir() + FString("GrassPlugin/Content/Textures/") + pictureName + FString(".png");
-		std::string input = std::string(TCHAR_TO_UTF8(*(path)));
-
-		if (!FPaths::FileExists(path))
-		{
-			GenerateErrorMessage(FString("GrassPlugin"),
-				FString("Image not found. Make sure the image file is in Texture folder."));
-			return 0;
-		}
-		else
-		{
-			if (divideIntoSmaller)
-				PoissonDiskForPart(positions, radValues, imgW, imgH, input, poissonDiskTries, bounds, renderPart);
-			else
-				PoissonDiskForWholeBoundaries(positions, radValues, imgW, imgH, input, poissonDiskTries, bounds);
-		}
-	}
-	else
-		PoissonDiskForWholeBoundaries(positions, turfRadius, poissonDiskTries, bounds);
-
-	return 1;
-}
-
-int UGrassRendering::SpawnTurf(float xCoord, float yCoord, unsigned char* radValues, unsigned imgW, unsigned imgH, const float bounds[])
-{
-	FVector turfPosition;
-	FQuat normalQuat;
-	turfPosition = FVector(xCoord, yCoord, 0);
-	normalQuat = FQuat::Identity;
-	int rad = 0; //0 - 255
-	if (adaptiveSampling)
-	{
-		float2 pos2D = FormFloat2(xCoord, yCoord);
-		float4 boundaries = FormFloat4(bounds[0], bounds[1], bounds[2], bounds[3]);
-		if (!cudaPoissonSampling::GetPixelValueOnPosition(radValues, imgW, imgH, pos2D, rad, boundaries, lowerThreshold,
-			upperThreshold, { 1, 1, 0 }))
-			return 0;
-	}
-	int adjustedNum = ((float)(256 - rad) / 255.f) * numOfBladesWithinTurf;
-	int adjustedRad = ((float)(256 - rad) / 255.f) * 2.f + turfGrassRadius;
-
-	int numOfGrass = adaptiveSampling ? adjustedNum : numOfBladesWithinTurf;
-	int radOfTurf = adaptiveSampling ? adjustedRad : turfGrassRadius;
-	grassPatch->SpawnGrassBladesAroundPosition(numOfGrass, radOfTurf, turfPosition, shouldSnapToTerrain, normalQuat);
-	return 1;
-}
-
-int UGrassRendering::CheckBounds()
-{
-	int widthX = abs(topLeftCorner.X - botRightCorner.X);
-	int widthY = abs(topLeftCorner.Y - botRightCorner.Y);
-
-	if (widthX != widthY)
-	{
-		GenerateErrorMessage(FString("GrassPlugin"),
-			FString("The inserted field ratio is not square! Please adjust it."));
-		return 0;
-	}
-	return 1;
-}
-
-int UGrassRendering::CheckInstanceLimit(int amountOfPositions)
-{
-	UGVar* configVars = UGVar::StaticClass()->GetDefaultObject<UGVar>();
-
-	if (amountOfPositions > configVars->maxInstanceLimitPG)
-	{
-
-		if (EAppReturnType::Yes !=
-			GenerateWarningMessage(FString("GrassPlugin"),
-				FString("Warning: Exceeding limit of %i objects. This might lead to memory "
-					"overflow, possibly causing Unreal to crash. Do you wish to proceed?",
-					configVars->maxInstanceLimitPG)))
-			return 0;
-	}
-	return 1;
-}
-
-int UGrassRendering::CheckRAMLimit()
-{
-	UGVar* configVars = UGVar::StaticClass()->GetDefaultObject<UGVar>();
-	if (configVars->memoryBarrier)
-		if (GetAvailRAM() < configVars->minMemoryRemaining)
-		{
-			GenerateErrorMessage(FString("GrassPlugin"),
-				FString("Available memory dropped under allowed capacity. Computation will be stopped."));
-			return 0;
-		}
-
-	return 1;
-}
-
-int UGrassRendering::ComputeSegmentsVal(int oneDSize)
-{
-	UGVar* configVars = UGVar::StaticClass()->GetDefaultObject<UGVar>();
-
-	int val = FMath::RoundToInt(oneDSize / configVars->subSpaceMaxWidth);
-	return val < 1 ? 1 : val;
-}
-
-float2 UGrassRendering::FormFloat2(float x, float y)
-{
-	float2 result;
-	result.x = x;
-	result.y = y;
-	return result;
-}
-
-float4 UGrassRendering::FormFloat4(float x, float y, float z, float w)
-{
-	float4 result;
-	result.x = x;
-	result.y = y;
-	result.z = z;
-	result.w = w;
-	return result;
-}
-
-// get memory info...
-int UGrassRendering::GetTotalRAM()
-{
-	int ret = 0;
-#ifdef WIN32
-	DWORD v = GetVersion();
-	DWORD major = (DWORD)(LOBYTE(LOWORD(v)));
-	DWORD minor = (DWORD)(HIBYTE(LOWORD(v)));
-	DWORD build;
-	if (v < 0x80000000) build = (DWORD)(HIWORD(v));
-	else build = 0;
-
-	// because compiler static links the function...
-	BOOL(__stdcall*GMSEx)(LPMEMORYSTATUSEX) = 0;
-
-	HINSTANCE hIL = LoadLibrary(L"kernel32.dll");
-	GMSEx = (BOOL(__stdcall*)(LPMEMORYSTATUSEX))GetProcAddress(hIL, "GlobalMemoryStatusEx");
-
-	if (GMSEx)
-	{
-		MEMORYSTATUSEX m;
-		m.dwLength = sizeof(m);
-		if (GMSEx(&m))
-		{
-			ret = (int)(m.ullTotalPhys >> 20);
-		}
-	}
-	else
-	{
-		MEMORYSTATUS m;
-		m.dwLength = sizeof(m);
-		GlobalMemoryStatus(&m);
-		ret = (int)(m.dwTotalPhys >> 20);
-	}
-#endif
-	return ret;
-}
-
-int UGrassRendering::GetAvailRAM()
-{
-	int ret = 0;
-#ifdef WIN32
-	DWORD v = GetVersion();
-	DWORD major = (DWORD)(LOBYTE(LOWORD(v)));
-	DWORD minor = (DWORD)(HIBYTE(LOWORD(v)));
-	DWORD build;
-	if (v < 0x80000000) build = (DWORD)(HIWORD(v));
-	else build = 0;
-
-	// because compiler static links the function...
-	BOOL(__stdcall*GMSEx)(LPMEMORYSTATUSEX) = 0;
-
-	HINSTANCE hIL = LoadLibrary(L"kernel32.dll");
-	GMSEx = (BOOL(__stdcall*)(LPMEMORYSTATUSEX))GetProcAddress(hIL, "GlobalMemoryStatusEx");
-
-	if (GMSEx)
-	{
-		MEMORYSTATUSEX m;
-		m.dwLength = sizeof(m);
-		if (GMSEx(&m))
-		{
-			ret = (int)(m.ullAvailPhys >> 20);
-		}
-	}
-	else
-	{
-		MEMORYSTATUS m;
-		m.dwLength = sizeof(m);
-		GlobalMemoryStatus(&m);
-		ret = (int)(m.dwAvailPhys >> 20);
-	}
-#endif
-	return ret;
-}
-
-int UGrassRendering::GetTotalMemory()
-{
-	int ret = 0;
-#ifdef WIN32
-	DWORD v = GetVersion();
-	DWORD major = (DWORD)(LOBYTE(LOWORD(v)));
-	DWORD minor = (DWORD)(HIBYTE(LOWORD(v)));
-	DWORD build;
-	if (v < 0x80000000) build = (DWORD)(HIWORD(v));
-	else build = 0;
-
-	// because compiler static links the function...
-	BOOL(__stdcall*GMSEx)(LPMEMORYSTATUSEX) = 0;
-
-	HINSTANCE hIL = LoadLibrary(L"kernel32.dll");
-	GMSEx = (BOOL(__stdcall*)(LPMEMORYSTATUSEX))GetProcAddress(hIL, "GlobalMemoryStatusEx");
-
-	if (GMSEx)
-	{
-		MEMORYSTATUSEX m;
-		m.dwLength = sizeof(m);
-		if (GMSEx(&m))
-		{
-			ret = (int)(m.ullTotalPhys >> 20) + (int)(m.ullTotalVirtual >> 20);
-		}
-	}
-	else
-	{
-		MEMORYSTATUS m;
-		m.dwLength = sizeof(m);
-		GlobalMemoryStatus(&m);
-		ret = (int)(m.dwTotalPhys >> 20) + (int)(m.dwTotalVirtual >> 20);
-	}
-#endif
-	return ret;
-}
-
-int UGrassRendering::GetAvailMemory()
-{
-	int ret = 0;
-#ifdef WIN32
-	DWORD v = GetVersion();
-	DWORD major = (DWORD)(LOBYTE(LOWORD(v)));
-	DWORD minor = (DWORD)(HIBYTE(LOWORD(v)));
-	DWORD build;
-	if (v < 0x80000000) build = (DWORD)(HIWORD(v));
-	else build = 0;
-
-	// because compiler static links the function...
-	BOOL(__stdcall*GMSEx)(LPMEMORYSTATUSEX) = 0;
-
-	HINSTANCE hIL = LoadLibrary(L"kernel32.dll");
-	GMSEx = (BOOL(__stdcall*)(LPMEMORYSTATUSEX))GetProcAddress(hIL, "GlobalMemoryStatusEx");
-
-	if (GMSEx)
-	{
-		MEMORYSTATUSEX m;
-		m.dwLength = sizeof(m);
-		if (GMSEx(&m))
-		{
-			ret = (int)(m.ullAvailPhys >> 20) + (int)(m.ullAvailVirtual >> 20);
-		}
-	}
-	else
-	{
-		MEMORYSTATUS m;
-		m.dwLength = sizeof(m);
-		GlobalMemoryStatus(&m);
-		ret = (int)(m.dwAvailPhys >> 20) + (int)(m.dwAvailVirtual >> 20);
-	}
-#endif
-	return ret;
-}
-//************************************************
-//*********USABLE FUNCTIONS (not active)**********
-//************************************************
-
-void UGrassRendering::SpawnGrassBladesCompletelyRandDistr()
-{
-	SpawnPatchIfNotSpawned();
-	grassPatch->SetRayLength(rayLength);
-
-	FVector4 patchBounds = FVector4(topLeftCorner.X, topLeftCorner.Y, botRightCorner.X, botRightCorner.Y);
-
-	int widthX = abs(topLeftCorner.X - botRightCorner.X);
-	int widthY = abs(topLeftCorner.Y - botRightCorner.Y);
-
-	int density = 2;
-	int amountOfGrassSquareRooted = 150;
-	float edgeIndex = ((float)density * 0.5) - 0.5;
-
-	int patchNum = 1;
-	FVector patchPosition = FVector(topLeftCorner.X + widthX, topLeftCorner.Y + widthY, 0);
-
-	FScopedSlowTask loadingDialogForSpawn(density * density, NSLOCTEXT("GrassSpawn", "Spawning Grass", "Spawning instances of grass"), true);
-	loadingDialogForSpawn.MakeDialogDelayed(1, true, true);
-
-	int textureSideSize = density * amountOfGrassSquareRooted;
-	int textureSize = textureSideSize * textureSideSize;
-	int amountOfGrass = FMath::Pow(amountOfGrassSquareRooted, 2);
-
-	FVector textureCorner;
-
-	int startIndex = 0;
-
-	for (float i = -edgeIndex; i <= edgeIndex; i++) {
-		UE_LOG(LogTemp, Display, TEXT("density %i densityDiv %f res %f"), density, (float)density*0.5, edgeIndex);
-		for (float j = -edgeIndex; j <= edgeIndex; j++) {
-			FVector offsetVector = FVector(i, j, 0);
-
-			loadingDialogForSpawn.EnterProgressFrame(1, FText::Format(NSLOCTEXT("GrassSpawn", "Spawning Grass", "Spawning {0} patch of grass"), patchNum++));
-
-			grassPatch->SpawnGrassBlades(amountOfGrass, startIndex, patchBounds, widthX * offsetVector + patchPosition, textureCorner, widthX * density, shouldSnapToTerrain);
-			startIndex += amountOfGrass;
-		}
-	}
-
-	grassPatch->SpawnDefaultObject(startIndex);
-#if WITH_EDITOR
-	UEditorEngine* editor = GEditor;
-	UWorld* world = editor->GetLevelViewportClients()[0]->GetWorld();
-#else
-	UWorld* world = GetWorld();
-#endif
-
-	grassPatch->SetMaterialTextureSize(textureSideSize, textureSideSize);
-	
-	UMaterialInstanceDynamic* grassDynMaterial = UMaterialInstanceDynamic::Create(grassMaterial, this, FName("GrassInstances"));
-}
-
-
-TArray<FVector> UGrassRendering::poissonDiskSampling(int radius, int maxTries, const FVector4 bounds)
-{
-	/**Initialization of array**/
-	int dimensions = 2;
-	TArray<FVector> points = TArray<FVector>();
-
-	TArray<FVector> active = TArray<FVector>();
-
-
-	int width = abs(bounds.Z - bounds.X);
-	int height = abs(bounds.W - bounds.Y);
-	int cellsize = floor(radius / sqrt(dimensions));
-
-	int ncells_width = floor(width / cellsize) + 1;
-	int ncells_height = floor(height / cellsize) + 1;
-	grid.Empty();
-
-	for (int i = 0; i < ncells_width*ncells_height; i++) {
-		grid.Add(FVector::ZeroVector);
-	}
-
-	//initial point
-	int randomX = width / 2;
-	int randomY = height / 2;
-	FVector p0 = FVector(randomX, randomY, 0);
-	InsertPointToGrid(p0, cellsize, ncells_width, ncells_height);
-	int xindex = floor(p0.X / cellsize);
-	int yindex = floor(p0.Y / cellsize);
-	points.Add(p0);
-	active.Add(p0);
-
-	int iter = 0;
-
-	//Active slow taks
-	FScopedSlowTask poissonDiskST(2, NSLOCTEXT("PoissonDisk", "PoissonDiskGenerating", "Loading points for Poisson Disk"), true);
-	poissonDiskST.MakeDialogDelayed(1, true, true);
-	poissonDiskST.EnterProgressFrame(1, NSLOCTEXT("PoissonDisk", "PoissonDiskGenerating", "Loading points for Poisson Disk"));
-	/**Computation of other points**/
-	while (active.Num() > 0) {
-		int random_index = int(FMath::RandRange(0, active.Num() - 1)); //?? possible issue with the array
-		FVector p = active[random_index];
-		bool found = false;
-		for (int tries = 0; tries < maxTries; tries++) {
-			float theta = FMath::RandRange(0, 359);
-			float new_radius = FMath::RandRange(radius, 2 * radius);
-
-			int pnewx = floor(p.X + new_radius * FMath::Cos(theta));
-			int pnewy = floor(p.Y + new_radius * FMath::Sin(theta));
-			if (pnewx < 0 || pnewx >= width || pnewy < 0 || pnewy >= height)
-				continue;
-			FVector pnew = FVector(pnewx, pnewy, 0);
-
-			if (IsValidPoint(cellsize, ncells_width, ncells_height, pnew, radius, width, height))
-			{
-				points.Add(pnew);
-				InsertPointToGrid(pnew, cellsize, ncells_width, ncells_height);
-				active.Add(pnew);
-
-				found = true;
-			}
-		}
-		if (!found)
-			active.RemoveAt(random_index, 1);
-	}
-	poissonDiskST.EnterProgressFrame(1, NSLOCTEXT("PoissonDisk", "PoissonDiskSample", "PoissonDiskSamplingFinished"));
-	UE_LOG(LogTemp, Display, TEXT("points : %i"), points.Num());
-	return points;
-}
-void UGrassRendering::InsertPointToGrid(FVector point, float cellsize, int gWidth, int gHeight) {
-	int xindex = floor(point.X / cellsize);
-	int yindex = floor(point.Y / cellsize);
-	if (xindex < gWidth && xindex >= 0) {
-		if (yindex < gHeight && yindex >= 0) {
-			grid.RemoveAt(xindex + yindex * gWidth);
-			grid.Insert(point, xindex + yindex * gWidth);// = point;
-		}
-	}
-}
-
-bool UGrassRendering::IsValidPoint(int cellsize, int gWidth, int gHeight, FVector p, int radius, int width, int height) {
-	if (!PointWithinBounds(p, width, height))
-		return false;
-
-	int xindex = floor(p.X / cellsize);
-	int yindex = floor(p.Y / cellsize);
-	int i0 = FMath::Max(xindex - 1, 0);
-	int i1 = FMath::Min(xindex + 1, gWidth - 1);
-	int j0 = FMath::Max(yindex - 1, 0);
-	int j1 = FMath::Min(yindex + 1, gHeight - 1);
-
-	for (int i = i0; i <= i1; i++)
-		for (int j = j0; j <= j1; j++) {
-			if (grid[i + j * gWidth] != FVector::ZeroVector) {
-				FVector distVec = grid[i + j * gWidth] - p;
-				float length = distVec.Size();
-
-				if (length < radius)
-					return false;
-			}
-		}
-
-
-	return true;
-}
-
-bool UGrassRendering::PointWithinBounds(FVector p, int width, int height) {
-	if (p.X < 0 || p.X >= width || p.Y < 0 || p.Y >= height) {
-		return false;
-	}
-	else
-		return true;
-
-}
-
-
-
-#pragma optimize("", on)
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include "GrassRendering.h"
+#include "GrassClumpBuilder.h"
+#include "GrassPatchRegistry.h"
+#include "cuda_runtime_api.h"
+#include <atomic>
+#include "Async/ParallelFor.h"
+#include "IImageWrapperModule.h"
+#include "IImageWrapper.h"
+#if WITH_EDITOR
+#include "Editor.h"
+#include "ScopedTransaction.h"
+#endif
+
+
+UGrassRendering::UGrassRendering()
+{
+	grassPatch = (AGrassBlade*) NewObject<AGrassBlade>();
+	
+	UGVar* configVars = UGVar::StaticClass()->GetDefaultObject<UGVar>();
+
+	InitMaterial(grassMaterial, configVars->grassMatLocation);
+	InitMaterial(billboardMaterial, configVars->billBoardMatLocation);	
+}
+
+void UGrassRendering::InitMaterial(UMaterial *& mat, FString matLoc)
+{
+	ConstructorHelpers::FObjectFinder<UMaterial> matFinder(*matLoc);
+	if (matFinder.Succeeded())
+	{
+		mat = matFinder.Object;
+	}
+	else {
+		UE_LOG(LogTemp, Display, TEXT("%s Material not found."), *matLoc);
+	}
+	UGVar* configVars = UGVar::StaticClass()->GetDefaultObject<UGVar>();
+	configVars->SaveConfig();
+}
+
+
+void UGrassRendering::SpawnGrassBladesInTurfs()
+{
+	const float bounds[4] = { topLeftCorner.X, topLeftCorner.Y, botRightCorner.X, botRightCorner.Y };
+	std::vector<float> poissonPos;
+	unsigned char* radValues = 0;
+	unsigned imgW = 0, imgH = 0;
+
+	SpawnPatchIfNotSpawned();
+	ApplyPatchSettings();
+	
+	//point cloud replaces sampling entirely, respawning is a pure spawn pass
+	if (usePointCloud)
+	{
+		if (PrepareClumpMeshes())
+			SpawnPointCloudFile();
+		return;
+	}
+
+	if (!useBakeRegions && !CheckBounds())
+		return;
+
+	if (!PrepareClumpMeshes())
+		return;
+	
+	if (!GeneratePositions(poissonPos, radValues, imgW, imgH, bounds))
+		return;
+	
+	UE_LOG(LogTemp, Display, TEXT("size of array %i"), poissonPos.size()/2);
+	if (!CheckInstanceLimit(poissonPos.size()))
+		return;
+
+	//exported turfs get spawned from the cloud, so spawning from the file later gives the same grass
+	std::vector<uint8_t> cloudData;
+	if (exportPointCloud && ExportPointCloud(poissonPos, radValues, imgW, imgH, bounds, cloudData) && !progressiveSampling)
+	{
+		if (radValues)
+			free(radValues);
+		grassSampling::PointCloudView cloud;
+		if (cloud.Open(cloudData.data(), cloudData.size()))
+			SpawnPointCloudTurfs(cloud);
+		return;
+	}
+		
+	if (progressiveSampling)
+	{
+		SpawnProgressiveTurfs(poissonPos, radValues, imgW, imgH, bounds);
+		if (radValues)
+			free(radValues);
+		return;
+	}
+	else if (grassPatch->HasProgressiveCells())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Grass patch contains non progressive grass, turfDensity will not be applicable anymore."));
+		grassPatch->ClearProgressiveCells();
+	}
+
+	FScopedSlowTask loadingDialogForSpawn(
+		poissonPos.size() / 2, NSLOCTEXT("GrassSpawn", "Spawning Grass", "Spawning instances of grass"), true);
+	loadingDialogForSpawn.MakeDialogDelayed(1, true, true);
+
+	UGVar* configVars = UGVar::StaticClass()->GetDefaultObject<UGVar>();
+	FGrassSpawnBatch batch;
+	for (int i = 0; i < poissonPos.size(); i+=2)
+	{
+		loadingDialogForSpawn.EnterProgressFrame(
+			1, NSLOCTEXT("GrassSpawn", "Spawning Grass", "Grass turfs are being generated."));
+
+		if (!SpawnTurf(poissonPos[i], poissonPos[i + 1], radValues, imgW, imgH, bounds, batch))
+			break;
+
+		if (batch.turfs >= configVars->spawnBatchSize)
+			grassPatch->CommitBatch(batch);
+
+		if (GWarn->ReceivedUserCancel())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Generating of new grass interupted."));
+			break;
+		}
+
+		if (!CheckRAMLimit())
+			break;
+	}
+	//turfs generated until now get spawned even if generating was interupted
+	grassPatch->CommitBatch(batch);
+
+	if (radValues)
+		free(radValues);
+	
+	UE_LOG(LogTemp, Display, TEXT("The Total RAM %i, available RAM %i"), GetTotalRAM(), GetAvailRAM());
+}
+
+void UGrassRendering::SpawnGrassBladesInJitteredGrid()
+{
+	const float bounds[4] = { topLeftCorner.X, topLeftCorner.Y, botRightCorner.X, botRightCorner.Y };
+
+	SpawnPatchIfNotSpawned();
+	ApplyPatchSettings();
+
+	if (!CheckBounds())
+		return;
+
+	if (grassPatch->HasProgressiveCells())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Grass patch contains non progressive grass, turfDensity will not be applicable anymore."));
+		grassPatch->ClearProgressiveCells();
+	}
+	GatherExclusions();
+
+	//density is given per square meter (100 x 100 units)
+	float spacing = 100.f / FMath::Sqrt(FMath::Max(jitteredGridDensity, 0.01f));
+	grassSampling::JitteredGridCells cells = grassSampling::GetJitteredGridCells(bounds, spacing);
+	if (!CheckInstanceLimit(cells.columns * cells.rows))
+		return;
+
+	//every block holds roughly one spawn batch, wave of blocks is generated in parallel and committed in block order
+	UGVar* configVars = UGVar::StaticClass()->GetDefaultObject<UGVar>();
+	int rowsPerBlock = FMath::Max(1, configVars->spawnBatchSize / FMath::Max(cells.columns, 1));
+	int blocks = FMath::DivideAndRoundUp(cells.rows, rowsPerBlock);
+	int blocksPerWave = FMath::Max(1, FTaskGraphInterface::Get().GetNumWorkerThreads());
+
+	UWorld* world = GetEditedWorld();
+	uint32 seed = (uint32)samplingSeed;
+
+	FScopedSlowTask loadingDialogForSpawn(blocks, NSLOCTEXT("GrassSpawn", "Spawning Grass", "Spawning instances of grass"), true);
+	loadingDialogForSpawn.MakeDialogDelayed(1, true, true);
+
+	int spawned = 0;
+	TArray<FGrassSpawnBatch> batches;
+	for (int firstBlock = 0; firstBlock < blocks; firstBlock += blocksPerWave)
+	{
+		int waveBlocks = FMath::Min(blocksPerWave, blocks - firstBlock);
+		batches.SetNum(waveBlocks);
+		ParallelFor(waveBlocks, [&](int32 waveBlock) {
+			int firstRow = cells.firstY + (firstBlock + waveBlock) * rowsPerBlock;
+			std::vector<float> positions;
+			grassSampling::JitteredGridRows(positions, bounds, spacing, gridJitter, seed, firstRow, firstRow + rowsPerBlock);
+			if (exclusions.IsValid())
+				exclusions->RemoveContained(positions);
+
+			//rotation and height of blade depend only on its cell, so regenerating the same space gives the same grass
+			FGrassSpawnBatch& batch = batches[waveBlock];
+			for (int i = 0; i < positions.size(); i += 2)
+			{
+				FVector pos(positions[i], positions[i + 1], 0);
+				uint32 hash = grassSampling::HashCoordinates(FMath::FloorToInt(pos.X / spacing), FMath::FloorToInt(pos.Y / spacing), seed + 1);
+				FQuat bladeQ(FRotator(0, (float)(hash % 360), 0));
+				FQuat normalQuat = FQuat::Identity;
+				if (shouldSnapToTerrain && !AGrassBlade::SnapToTerrain(world, rayLength, pos, normalQuat))
+					continue;
+				if (pos == FVector::ZeroVector)
+					continue;
+				FTransform transform(normalQuat * bladeQ, pos, FVector(1, 1, 1 + (hash >> 31)));
+				batch.bladeTransforms[(int)ChooseTurfShape(pos.X, pos.Y, 0)].Add(transform);
+			}
+		});
+
+		for (FGrassSpawnBatch& batch : batches)
+		{
+			loadingDialogForSpawn.EnterProgressFrame(1, NSLOCTEXT("GrassSpawn", "Spawning Grass", "Grass blades are being generated."));
+			for (int shape = 0; shape < GPGrassShapeCount; shape++)
+				spawned += batch.bladeTransforms[shape].Num();
+			grassPatch->CommitBatch(batch);
+		}
+
+		if (GWarn->ReceivedUserCancel())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Generating of new grass interupted."));
+			break;
+		}
+
+		if (!CheckRAMLimit())
+			break;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Jittered grid of %i x %i cells spawned %i grass blades."), cells.columns, cells.rows, spawned);
+}
+
+void UGrassRendering::ApplyPatchSettings()
+{
+	grassPatch->SetRayLength(rayLength);
+	grassPatch->SetExperimentalLOD(experimentalLODSystem);
+	grassPatch->SetFlowerSettings(GetFlowerSettings());
+	//expected turf spacing times sqrt of turfs per billboard gives square holding roughly turfsPerBillboard turfs
+	float turfSpacing = adaptiveSampling ? 0.5f * (lowerThreshold + upperThreshold) : turfRadius;
+	grassPatch->SetBillboardClustering(turfsPerBillboard, turfSpacing * FMath::Sqrt((float)turfsPerBillboard));
+}
+
+int UGrassRendering::BeginBrushStroke()
+{
+	if (!PrepareBrushStroke())
+		return 0;
+	BeginGrassOperation(EGPGrassOperation::BrushStroke);
+	return 1;
+}
+
+void UGrassRendering::EndBrushStroke()
+{
+	EndGrassOperation();
+}
+
+int UGrassRendering::PrepareBrushStroke()
+{
+	SpawnPatchIfNotSpawned();
+	if (brushMode != EGPBrushMode::Paint)
+		return 1;
+
+	ApplyPatchSettings();
+	if (grassPatch->HasProgressiveCells())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Grass patch contains painted grass, turfDensity will not be applicable anymore."));
+		grassPatch->ClearProgressiveCells();
+	}
+	GatherExclusions();
+	return PrepareClumpMeshes();
+}
+
+void UGrassRendering::ApplyBrush(FVector location)
+{
+	//every dab seeds its own random stream, so redo of the stroke places the same turfs
+	int32 seed = FMath::Rand();
+	if (currentOperation.IsValid())
+	{
+		currentOperation->record.dabs.Add(location);
+		currentOperation->record.dabSeeds.Add(seed);
+	}
+	ApplyBrushDab(location, seed);
+}
+
+void UGrassRendering::ApplyBrushDab(FVector location, int32 seed)
+{
+	if (grassPatch == NULL)
+		return;
+
+	if (brushMode == EGPBrushMode::Erase)
+	{
+		grassPatch->RemoveGrassWithinRadius(location, brushRadius);
+		return;
+	}
+	if (brushMode != EGPBrushMode::Paint)
+		return;
+
+	//brush ignores density texture of adaptive sampling, painted turfs use turfRadius and full turf attributes
+	FRandomStream dabStream(seed);
+	std::vector<float> positions;
+	grassSampling::SampleBrushDisk(positions, location.X, location.Y, brushRadius, turfRadius, poissonDiskTries, dabStream.GetUnsignedInt(),
+		grassPatch->GetTurfCenterGrid());
+	if (exclusions.IsValid())
+		exclusions->RemoveContained(positions);
+
+	FGrassSpawnBatch batch;
+	for (int i = 0; i < positions.size(); i += 2)
+		grassPatch->AddTurfToBatch(batch, dabStream, ChooseTurfShape(positions[i], positions[i + 1], 0), numOfBladesWithinTurf, turfGrassRadius,
+			FVector(positions[i], positions[i + 1], location.Z), shouldSnapToTerrain, FQuat::Identity);
+	grassPatch->CommitBatch(batch);
+}
+
+void UGrassRendering::RefreshGrassMode()
+{
+	grassPatch->SetActiveGrassBlades(grassShape);
+}
+
+void UGrassRendering::RefreshTurfDensity()
+{
+	if (grassPatch != NULL)
+		grassPatch->SetTurfDensity(turfDensity);
+}
+
+void UGrassRendering::ClearGrass()
+{
+	if (grassPatch != NULL)
+	{
+		grassPatch->ClearInstances();
+		grassPatch->ClearProgressiveCells();
+		grassPatch->ClearTurfCenters();
+	}
+}
+
+void UGrassRendering::GenerateGrass()
+{
+	SpawnPatchIfNotSpawned();
+	if (overridePrevious)
+		ClearGrass();
+
+	if (poissonDisk)
+		SpawnGrassBladesInTurfs();
+	else
+		SpawnGrassBladesInJitteredGrid();
+}
+
+void UGrassRendering::BeginGrassOperation(EGPGrassOperation operation)
+{
+	SpawnPatchIfNotSpawned();
+	currentOperation = MakeUnique<FGrassOperationChange>();
+	currentOperation->record.operation = operation;
+	currentOperation->record.settings = ExportBakeSettings();
+	currentOperation->record.seed = FMath::Rand();
+	turfStream.Initialize(currentOperation->record.seed);
+	grassPatch->BeginDelta(&currentOperation->delta);
+}
+
+void UGrassRendering::EndGrassOperation()
+{
+	if (!currentOperation.IsValid())
+		return;
+	if (grassPatch != NULL)
+		grassPatch->EndDelta();
+
+#if WITH_EDITOR
+	//only parameters and removed instances get stored, instance managers are not snapshotted
+	if (GEditor != nullptr && grassPatch != NULL && !currentOperation->delta.IsEmpty())
+	{
+		FScopedTransaction transaction(FText::FromString(currentOperation->ToString()));
+		if (GUndo != nullptr)
+		{
+			GUndo->StoreUndo(this, MoveTemp(currentOperation));
+			grassPatch->MarkPackageDirty();
+		}
+	}
+#endif
+	currentOperation.Reset();
+}
+
+void UGrassRendering::RepeatGrassOperation(const FGrassOperationRecord& record, FGrassDelta& delta)
+{
+	SpawnPatchIfNotSpawned();
+
+	//operation runs with the settings it was recorded with, current settings of editor mode are restored afterwards
+	FString currentSettings = ExportBakeSettings();
+	ImportBakeSettings(record.settings);
+
+	delta.Reset();
+	grassPatch->BeginDelta(&delta);
+	switch (record.operation)
+	{
+	case EGPGrassOperation::Generate:
+		turfStream.Initialize(record.seed);
+		GenerateGrass();
+		break;
+	case EGPGrassOperation::BrushStroke:
+		if (PrepareBrushStroke())
+			for (int i = 0; i < record.dabs.Num() && i < record.dabSeeds.Num(); i++)
+				ApplyBrushDab(record.dabs[i], record.dabSeeds[i]);
+		break;
+	case EGPGrassOperation::Clear:
+		ClearGrass();
+		break;
+	case EGPGrassOperation::TurfDensity:
+		RefreshTurfDensity();
+		break;
+	}
+	grassPatch->EndDelta();
+
+	ImportBakeSettings(currentSettings);
+	grassPatch->MarkPackageDirty();
+}
+
+void UGrassRendering::RevertGrassOperation(FGrassDelta& delta)
+{
+	//current level could have changed since the operation, so the delta goes back to the patch it came from
+	AGrassBlade* patch = Cast<AGrassBlade>(delta.GetOwner());
+	if (patch == NULL)
+		patch = grassPatch;
+	if (patch != NULL)
+		patch->RevertDelta(delta);
+}
+
+int UGrassRendering::SpawnProgressiveTurfs(std::vector<float>& positions, unsigned char* radValues, unsigned imgW, unsigned imgH, const float bounds[])
+{
+	UGVar* configVars = UGVar::StaticClass()->GetDefaultObject<UGVar>();
+	float cellSize = configVars->grassCellSize;
+	float minRadius = adaptiveSampling ? lowerThreshold : turfRadius;
+
+	std::vector<int> cellStarts, cellCoords;
+	grassSampling::ProgressiveOrderByCells(positions, cellSize, minRadius, samplingSeed, cellStarts, cellCoords);
+
+	FScopedSlowTask loadingDialogForSpawn(
+		positions.size() / 2, NSLOCTEXT("GrassSpawn", "Spawning Grass", "Spawning instances of grass"), true);
+	loadingDialogForSpawn.MakeDialogDelayed(1, true, true);
+
+	int result = 1;
+	for (int c = 0; c + 1 < (int)cellStarts.size() && result; c++)
+	{
+		FIntPoint cell(cellCoords[2 * c], cellCoords[2 * c + 1]);
+		for (int i = cellStarts[c]; i < cellStarts[c + 1]; i++)
+		{
+			loadingDialogForSpawn.EnterProgressFrame(
+				1, NSLOCTEXT("GrassSpawn", "Spawning Grass", "Grass turfs are being generated."));
+
+			int numOfGrass, radOfTurf;
+			EGPGrassShape shape;
+			if (!ComputeTurfAttributes(positions[2 * i], positions[2 * i + 1], radValues, imgW, imgH, bounds, numOfGrass, radOfTurf, shape))
+			{
+				result = 0;
+				break;
+			}
+			grassPatch->AddProgressiveTurf(cell, turfStream, shape, numOfGrass, radOfTurf, FVector(positions[2 * i], positions[2 * i + 1], 0),
+				shouldSnapToTerrain, FQuat::Identity);
+
+			if (GWarn->ReceivedUserCancel())
+			{
+				UE_LOG(LogTemp, Warning, TEXT("Generating of new grass interupted."));
+				result = 0;
+				break;
+			}
+
+			if (!CheckRAMLimit())
+			{
+				result = 0;
+				break;
+			}
+		}
+	}
+
+	//turfs generated until now get spawned even if generating was interupted
+	grassPatch->SetTurfDensity(turfDensity);
+	return result;
+}
+
+
+void UGrassRendering::SpawnPatchIfNotSpawned() {
+	UWorld* world = GetEditedWorld();
+
+	//grass goes into current level of the editor, so every streaming sublevel can hold its own patch
+	ULevel* level = world->GetCurrentLevel();
+	UGrassPatchRegistry* registry = world->GetSubsystem<UGrassPatchRegistry>();
+	grassPatch = registry != nullptr ? registry->FindGrassPatch(level) : NULL;
+	if (grassPatch == NULL)
+	{
+		FActorSpawnParameters spawnInfo;
+		spawnInfo.bNoFail = true;
+		spawnInfo.OverrideLevel = level;
+		grassPatch = world->SpawnActor<AGrassBlade>(FVector(0, 0, 0), FRotator(0, 0, 0), spawnInfo);
+		grassPatch->SetActiveGrassBlades(grassShape);
+		UMaterialInstanceDynamic* grassDynMaterial = UMaterialInstanceDynamic::Create(grassMaterial, this, FName("GrassInstances"));
+		UMaterialInstanceDynamic* billboardDynMaterial = UMaterialInstanceDynamic::Create(billboardMaterial, this, FName("billboardInstaces"));
+		grassPatch->InitializeMaterials(grassDynMaterial,billboardDynMaterial);
+		grassPatch->SetMaterialTextureSize(abs(topLeftCorner.X - botRightCorner.X), abs(topLeftCorner.Y - botRightCorner.Y));
+	}
+}
+
+void UGrassRendering::PoissonTilesForWholeBoundaries(std::vector<float>& positions, const float bounds[])
+{
+	UE_LOG(LogTemp, Display, TEXT("Filling bounds with %i poisson tiles of size %f"), poissonTiles.GetAmountOfVariants(),
+		poissonTiles.GetTileSize());
+	poissonTiles.FillBounds(positions, bounds, samplingSeed);
+}
+
+int UGrassRendering::LandscapeDensityForWholeBoundaries(std::vector<float>& positions, const float bounds[])
+{
+	if (!UpdateLandscapeDensity())
+		return 0;
+	if (!PreparePoissonTiles(GetMinAdaptiveRadius(), poissonDiskTries))
+		return 0;
+
+	std::vector<float> candidates;
+	poissonTiles.FillBounds(candidates, bounds, samplingSeed);
+	//excluded candidates are rejected before their density is looked up
+	exclusions->RemoveContained(candidates);
+	ThinByLandscapeDensity(candidates, positions);
+	return 1;
+}
+
+int UGrassRendering::UpdateLandscapeDensity()
+{
+#if WITH_EDITOR
+	if (densityLayers.Num() == 0 || !landscapeDensity.Update(GetEditedWorld(), densityLayers))
+	{
+		GenerateErrorMessage(FString("GrassPlugin"),
+			FString("Landscape density could not be read. Make sure the level contains landscape with all paint layers of densityLayers."));
+		return 0;
+	}
+#endif
+	return 1;
+}
+
+float UGrassRendering::GetMinAdaptiveRadius() const
+{
+	return FMath::Max(FMath::Min(lowerThreshold, upperThreshold), 1);
+}
+
+void UGrassRendering::ThinByLandscapeDensity(std::vector<float>& candidates, std::vector<float>& positions)
+{
+	//candidates are accepted in progressive order, so the accepted ones are spread evenly even where the radius is large
+	UGVar* configVars = UGVar::StaticClass()->GetDefaultObject<UGVar>();
+	std::vector<int> cellStarts, cellCoords;
+	grassSampling::ProgressiveOrderByCells(candidates, configVars->grassCellSize, GetMinAdaptiveRadius(), samplingSeed, cellStarts, cellCoords);
+
+	grassSampling::PointHashGrid accepted(FMath::Max(lowerThreshold, upperThreshold));
+	for (int i = 0; i + 1 < candidates.size(); i += 2)
+	{
+		int rad = GetLandscapeDensityPixel(candidates[i], candidates[i + 1]);
+		if (rad >= 255)
+			continue;
+		float radius = FMath::Lerp((float)lowerThreshold, (float)upperThreshold, rad / 254.f);
+		if (accepted.HasPointWithin(candidates[i], candidates[i + 1], radius))
+			continue;
+		accepted.Add(candidates[i], candidates[i + 1]);
+		positions.push_back(candidates[i]);
+		positions.push_back(candidates[i + 1]);
+	}
+}
+
+int UGrassRendering::BakeRegionPositions(std::vector<float>& positions)
+{
+	bool useLandscapeDensity = adaptiveSampling && densitySource == EGPDensitySource::LandscapeLayers;
+	if (adaptiveSampling && !useLandscapeDensity)
+	{
+		GenerateErrorMessage(FString("GrassPlugin"),
+			FString("Bake regions can not be used with density texture. Use landscape density or turn off adaptive sampling."));
+		return 0;
+	}
+
+	if (!BuildBakeMask())
+		return 0;
+	if (useLandscapeDensity && !UpdateLandscapeDensity())
+		return 0;
+	if (!PreparePoissonTiles(useLandscapeDensity ? GetMinAdaptiveRadius() : turfRadius, poissonDiskTries))
+		return 0;
+
+	//only covered tiles get filled, only partially covered ones get clipped by the regions
+	std::vector<float> candidates, tilePositions;
+	float tileSize = bakeMask.GetTileSize();
+	int partialTiles = 0;
+	for (const grassSampling::CoverageMask::Tile& tile : bakeMask.GetTiles())
+	{
+		const float tileBounds[4] = { tile.x * tileSize, (tile.y + 1) * tileSize, (tile.x + 1) * tileSize, tile.y * tileSize };
+		tilePositions.clear();
+		poissonTiles.FillBounds(tilePositions, tileBounds, samplingSeed);
+		if (!tile.full)
+		{
+			bakeMask.RemoveOutside(tilePositions);
+			partialTiles++;
+		}
+		candidates.insert(candidates.end(), tilePositions.begin(), tilePositions.end());
+	}
+	UE_LOG(LogTemp, Display, TEXT("Bake regions cover %i tiles (%i partially)."), (int)bakeMask.GetTiles().size(), partialTiles);
+
+	exclusions->RemoveContained(candidates);
+	if (useLandscapeDensity)
+		ThinByLandscapeDensity(candidates, positions);
+	else
+		positions.swap(candidates);
+	return 1;
+}
+
+int UGrassRendering::BuildBakeMask()
+{
+	UGVar* configVars = UGVar::StaticClass()->GetDefaultObject<UGVar>();
+	bakeMask.Clear();
+	AGrassBakeRegion::GatherRegions(GetEditedWorld(), bakeSelectedLandscapeComponents, bakeMask);
+	bakeMask.Build(configVars->grassCellSize);
+	if (bakeMask.IsEmpty())
+	{
+		GenerateErrorMessage(FString("GrassPlugin"),
+			FString("No bake regions found. Place GrassBakeRegion actors or select landscape components."));
+		return 0;
+	}
+	return 1;
+}
+
+FString UGrassRendering::ExportBakeSettings() const
+{
+	FString settings;
+	for (TFieldIterator<UProperty> property(GetClass()); property; ++property)
+	{
+		if (!property->HasAnyPropertyFlags(CPF_Edit))
+			continue;
+		FString value;
+		property->ExportTextItem(value, property->ContainerPtrToValuePtr<void>(this), nullptr, nullptr, PPF_None);
+		settings += property->GetName() + FString("=") + value + LINE_TERMINATOR;
+	}
+	return settings;
+}
+
+int UGrassRendering::ImportBakeSettings(const FString& settings)
+{
+	TArray<FString> lines;
+	settings.ParseIntoArrayLines(lines);
+	for (const FString& line : lines)
+	{
+		FString name, value;
+		if (!line.Split(FString("="), &name, &value))
+			continue;
+		UProperty* property = FindField<UProperty>(GetClass(), *name);
+		if (property == nullptr || !property->HasAnyPropertyFlags(CPF_Edit) ||
+			property->ImportText(*value, property->ContainerPtrToValuePtr<void>(this), PPF_None, this) == nullptr)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Bake setting %s could not be applied."), *line);
+			return 0;
+		}
+	}
+	return 1;
+}
+
+int UGrassRendering::PrepareShardedBake()
+{
+	//cells are filled independently, which is seamless only for world aligned poisson tiles
+	bool useLandscapeDensity = adaptiveSampling && densitySource == EGPDensitySource::LandscapeLayers;
+	if (!poissonDisk || progressiveSampling || (adaptiveSampling ? !useLandscapeDensity : !usePoissonTiles && !useBakeRegions))
+	{
+		GenerateErrorMessage(FString("GrassPlugin"),
+			FString("Sharded bake needs poisson tiles or landscape density, and can not be used with progressive sampling."));
+		return 0;
+	}
+
+	SpawnPatchIfNotSpawned();
+	ApplyPatchSettings();
+	if (!useBakeRegions && !CheckBounds())
+		return 0;
+	if (!PrepareClumpMeshes())
+		return 0;
+
+	GatherExclusions();
+	if (useLandscapeDensity && !UpdateLandscapeDensity())
+		return 0;
+	if (useBakeRegions && !BuildBakeMask())
+		return 0;
+	return PreparePoissonTiles(useLandscapeDensity ? GetMinAdaptiveRadius() : turfRadius, poissonDiskTries);
+}
+
+void UGrassRendering::GetBakeCells(TArray<FIntPoint>& cells)
+{
+	cells.Reset();
+	partialBakeCells.Reset();
+	if (useBakeRegions)
+	{
+		for (const grassSampling::CoverageMask::Tile& tile : bakeMask.GetTiles())
+		{
+			cells.Add(FIntPoint(tile.x, tile.y));
+			if (!tile.full)
+				partialBakeCells.Add(FIntPoint(tile.x, tile.y));
+		}
+	}
+	else
+	{
+		UGVar* configVars = UGVar::StaticClass()->GetDefaultObject<UGVar>();
+		float cellSize = configVars->grassCellSize;
+		int firstX = FMath::FloorToInt(FMath::Min(topLeftCorner.X, botRightCorner.X) / cellSize);
+		int lastX = FMath::CeilToInt(FMath::Max(topLeftCorner.X, botRightCorner.X) / cellSize) - 1;
+		int firstY = FMath::FloorToInt(FMath::Min(topLeftCorner.Y, botRightCorner.Y) / cellSize);
+		int lastY = FMath::CeilToInt(FMath::Max(topLeftCorner.Y, botRightCorner.Y) / cellSize) - 1;
+		for (int y = firstY; y <= lastY; y++)
+			for (int x = firstX; x <= lastX; x++)
+				cells.Add(FIntPoint(x, y));
+	}
+	cells.Sort([](const FIntPoint& a, const FIntPoint& b) { return a.Y != b.Y ? a.Y < b.Y : a.X < b.X; });
+}
+
+int UGrassRendering::BakeCell(FIntPoint cell, FGrassBakeCell& bakedCell)
+{
+	UGVar* configVars = UGVar::StaticClass()->GetDefaultObject<UGVar>();
+	float cellSize = configVars->grassCellSize;
+	float cellBounds[4] = { cell.X * cellSize, (cell.Y + 1) * cellSize, (cell.X + 1) * cellSize, cell.Y * cellSize };
+	if (!useBakeRegions)
+	{
+		//border cells get clipped by the bounds, fill of clipped cells matches fill of the whole bounds
+		cellBounds[0] = FMath::Max(cellBounds[0], FMath::Min(topLeftCorner.X, botRightCorner.X));
+		cellBounds[1] = FMath::Min(cellBounds[1], FMath::Max(topLeftCorner.Y, botRightCorner.Y));
+		cellBounds[2] = FMath::Min(cellBounds[2], FMath::Max(topLeftCorner.X, botRightCorner.X));
+		cellBounds[3] = FMath::Max(cellBounds[3], FMath::Min(topLeftCorner.Y, botRightCorner.Y));
+	}
+
+	std::vector<float> candidates, positions;
+	poissonTiles.FillBounds(candidates, cellBounds, samplingSeed);
+	if (partialBakeCells.Contains(cell))
+		bakeMask.RemoveOutside(candidates);
+	exclusions->RemoveContained(candidates);
+	if (adaptiveSampling)
+		ThinByLandscapeDensity(candidates, positions);
+	else
+		positions.swap(candidates);
+
+	//random blade layout of the cell depends only on the cell, not on the shard or order of generating
+	FRandomStream cellStream(grassSampling::HashCoordinates(cell.X, cell.Y, samplingSeed));
+	bakedCell.cell = cell;
+	for (int i = 0; i + 1 < positions.size(); i += 2)
+	{
+		int numOfGrass, radOfTurf;
+		EGPGrassShape shape;
+		if (!ComputeTurfAttributes(positions[i], positions[i + 1], nullptr, 0, 0, nullptr, numOfGrass, radOfTurf, shape))
+			return 0;
+		grassPatch->AddTurfToBatch(bakedCell.batch, cellStream, shape, numOfGrass, radOfTurf, FVector(positions[i], positions[i + 1], 0),
+			shouldSnapToTerrain, FQuat::Identity);
+		bakedCell.turfCenters.Add(FVector2D(positions[i], positions[i + 1]));
+	}
+	return 1;
+}
+
+void UGrassRendering::CommitBakedCell(FGrassBakeCell& bakedCell)
+{
+	grassPatch->AddTurfCenters(bakedCell.turfCenters);
+	grassPatch->CommitBatch(bakedCell.batch);
+	bakedCell = FGrassBakeCell();
+}
+
+int UGrassRendering::GetLandscapeDensityPixel(float xCoord, float yCoord) const
+{
+	float density = landscapeDensity.GetDensity(xCoord, yCoord);
+	return density <= 0 ? 255 : FMath::RoundToInt((1 - density) * 254);
+}
+
+int UGrassRendering::PreparePoissonTiles(const float radius, const int maxTries)
+{
+	//BlueprintReadWrite radius is not clamped by the editor, tiles of non-positive radius would divide by zero
+	if (radius <= 0)
+	{
+		GenerateErrorMessage(FString("GrassPlugin"), FString::Printf(TEXT("Poisson tiles need positive radius (got %g)."), radius));
+		return 0;
+	}
+
+	UGVar* configVars = UGVar::StaticClass()->GetDefaultObject<UGVar>();
+	int tileSizeInRadii = configVars->poissonTileSizeInRadii;
+	int variants = configVars->poissonTileVariants;
+
+	if (poissonTiles.Matches(radius, tileSizeInRadii, variants, samplingSeed))
+		return 1;
+
+	FString cachePath = GetPoissonTilesCachePath(radius, tileSizeInRadii, variants);
+	std::string cacheFile = std::string(TCHAR_TO_UTF8(*cachePath));
+	if (FPaths::FileExists(cachePath) && poissonTiles.LoadFromFile(cacheFile) &&
+		poissonTiles.Matches(radius, tileSizeInRadii, variants, samplingSeed))
+	{
+		UE_LOG(LogTemp, Display, TEXT("Poisson tiles loaded from %s"), *cachePath);
+		return 1;
+	}
+
+	FScopedSlowTask loadingDialogForTiles(
+		1, NSLOCTEXT("GrassSpawn", "Generating Tiles", "Generating poisson tiles"), true);
+	loadingDialogForTiles.MakeDialogDelayed(1, false, true);
+	loadingDialogForTiles.EnterProgressFrame(1);
+
+	if (!poissonTiles.Generate(radius, tileSizeInRadii, variants, maxTries, samplingSeed))
+	{
+		GenerateErrorMessage(FString("GrassPlugin"), FString("Poisson tiles could not be generated."));
+		return 0;
+	}
+
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(cachePath), true);
+	if (!poissonTiles.SaveToFile(cacheFile))
+		UE_LOG(LogTemp, Warning, TEXT("Poisson tiles could not be cached into %s"), *cachePath);
+
+	return 1;
+}
+
+int UGrassRendering::PrepareClumpMeshes()
+{
+	grassPatch->SetUseClumps(useTurfClumps);
+	if (!useTurfClumps)
+		return 1;
+
+	UGVar* configVars = UGVar::StaticClass()->GetDefaultObject<UGVar>();
+	const FString shapeNames[GPGrassShapeCount] = { FString("Quad"), FString("Triangle"), FString("TriangleQuad") };
+	const FString meshLocations[GPGrassShapeCount] = { configVars->quadMeshLocation, configVars->triangleMeshLocation, configVars->triangleQuadMeshLocation };
+
+	for (int shape = 0; shape < GPGrassShapeCount; shape++)
+	{
+		if (!mixGrassShapes && shape != (int)grassShape)
+			continue;
+
+		TArray<UStaticMesh*> clumpMeshes;
+		for (int variant = 0; variant < clumpVariants; variant++)
+		{
+			FString assetName = FGrassClumpBuilder::GetClumpAssetName(shapeNames[shape], numOfBladesWithinTurf, turfGrassRadius, variant);
+			UStaticMesh* clumpMesh = FGrassClumpBuilder::LoadClumpMesh(configVars->clumpMeshFolder, assetName);
+#if WITH_EDITOR
+			if (clumpMesh == nullptr)
+			{
+				UStaticMesh* bladeMesh = LoadObject<UStaticMesh>(nullptr, *meshLocations[shape]);
+				TArray<FTransform> bladeLayout;
+				//layout depends only on the asset name, so rebuilt clump mesh looks the same
+				FRandomStream layoutStream(grassSampling::HashCoordinates(shape, variant, 0));
+				grassPatch->GenerateGrassBladesAroundPosition(layoutStream, numOfBladesWithinTurf, turfGrassRadius, FVector::ZeroVector, false, FQuat::Identity, bladeLayout);
+				clumpMesh = FGrassClumpBuilder::BuildClumpMesh(bladeMesh, bladeLayout, configVars->clumpMeshFolder, assetName);
+				if (clumpMesh != nullptr)
+					UE_LOG(LogTemp, Display, TEXT("Clump mesh %s was built, save it to keep it for next sessions."), *assetName);
+			}
+#endif
+			if (clumpMesh == nullptr)
+			{
+				GenerateErrorMessage(FString("Clump meshes"), FString::Printf(TEXT("Clump mesh %s could not be loaded or built from %s."),
+					*assetName, *meshLocations[shape]));
+				return 0;
+			}
+			clumpMeshes.Add(clumpMesh);
+		}
+		grassPatch->SetClumpMeshes((EGPGrassShape)shape, clumpMeshes);
+	}
+	return 1;
+}
+
+FString UGrassRendering::GetPoissonTilesCachePath(const float radius, int tileSizeInRadii, int variants)
+{
+	return HelperFunctions::GetPoissonTilesCachePath(radius, tileSizeInRadii, variants, samplingSeed);
+}
+
+void UGrassRendering::GatherExclusions()
+{
+	exclusions = AGrassExclusionVolume::GatherExclusions(GetEditedWorld(), exclusionSplineRadius);
+}
+
+UWorld* UGrassRendering::GetEditedWorld() const
+{
+	if (bakeWorld != nullptr)
+		return bakeWorld;
+#if WITH_EDITOR
+	return GEditor->GetEditorWorldContext().World();
+#else
+	return GetWorld();
+#endif
+}
+
+int UGrassRendering::ComputeTurfAttributes(float xCoord, float yCoord, unsigned char* radValues, unsigned imgW, unsigned imgH, const float bounds[], int& numOfGrass, int& radOfTurf, EGPGrassShape& shape)
+{
+	int rad;
+	if (!GetTurfPixel(xCoord, yCoord, radValues, imgW, imgH, bounds, rad))
+		return 0;
+	TurfAttributesForPixel(xCoord, yCoord, rad, adaptiveSampling, numOfGrass, radOfTurf, shape);
+	return 1;
+}
+
+EGPGrassShape UGrassRendering::ChooseTurfShape(float xCoord, float yCoord, int rad)
+{
+	if (!mixGrassShapes)
+		return grassShape;
+
+	const float weights[GPGrassShapeCount] = { quadShapeWeight, triangleShapeWeight, triangleQuadShapeWeight };
+	float totalWeight = 0;
+	for (int i = 0; i < GPGrassShapeCount; i++)
+		totalWeight += FMath::Max(weights[i], 0.f);
+	if (totalWeight <= 0)
+		return grassShape;
+
+	//random value in <0,1) stable for the position, so regenerating the same space gives the same models
+	float value;
+	if (shapeFromDensity && adaptiveSampling)
+		value = FMath::Clamp(rad / 256.f, 0.f, 0.999f);
+	else
+		value = (grassSampling::HashCoordinates(FMath::FloorToInt(xCoord * 16), FMath::FloorToInt(yCoord * 16), samplingSeed) & 0xFFFFFF) / 16777216.f;
+
+	float threshold = value * totalWeight;
+	for (int i = 0; i < GPGrassShapeCount; i++)
+	{
+		threshold -= FMath::Max(weights[i], 0.f);
+		if (threshold < 0)
+			return (EGPGrassShape)i;
+	}
+	return (EGPGrassShape)(GPGrassShapeCount - 1);
+}
+
+FGrassFlowerSettings UGrassRendering::GetFlowerSettings() const
+{
+	FGrassFlowerSettings settings;
+	settings.enabled = spawnFlowers;
+	settings.flowerKind = flowerKind;
+	settings.turfChance = flowerTurfChance;
+	settings.minAmount = FMath::Min(minFlowersInTurf, maxFlowersInTurf);
+	settings.maxAmount = FMath::Max(minFlowersInTurf, maxFlowersInTurf);
+	settings.innerFlowerRadius = innerFlowerRadius;
+	settings.spawnWeight = flowerSpawnWeight;
+	return settings;
+}
+
+int UGrassRendering::AutoTuneSampling(const std::string& input, const float bounds[])
+{
+	tunedSegmentWidth = 0;
+	ReleaseReusedProbe();
+	UGVar* configVars = UGVar::StaticClass()->GetDefaultObject<UGVar>();
+	if (!configVars->autoTuneSampling)
+		return 0;
+
+	//parts of one divideIntoSmaller bake have to share the split of the space, otherwise they overlap or leave gaps
+	FBox2D bakeBounds(FVector2D(bounds[0], bounds[1]), FVector2D(bounds[2], bounds[3]));
+	if (divideIntoSmaller && renderPart > 0)
+	{
+		if (tunedPartBounds.bIsValid && tunedPartBounds == bakeBounds)
+		{
+			tunedSegmentWidth = tunedPartSegmentWidth;
+			UE_LOG(LogTemp, Display, TEXT("Part %i keeps sampling tuned for part 0 (segment %.0f)."), renderPart, tunedSegmentWidth);
+			return tunedSegmentWidth > 0;
+		}
+		UE_LOG(LogTemp, Warning, TEXT("Part %i is sampled without auto tuning, bake part 0 of the same bounds first so that all parts get the tuned split."),
+			renderPart);
+		return 0;
+	}
+	tunedPartBounds = bakeBounds;
+	tunedPartSegmentWidth = 0;
+
+	float width = FMath::Max(abs(bounds[0] - bounds[2]), abs(bounds[1] - bounds[3]));
+	int configuredSegments = ComputeSegmentsVal(width);
+	//space fitting one configured segment is sampled by one call anyway
+	if (configuredSegments < 2)
+		return 0;
+
+	//probes are first segments of finer splits, output of one of them is reused by the sampling
+	int probes = FMath::Max(configVars->autoTuneProbes, 2);
+	TArray<std::vector<float>> probePositions;
+	TArray<unsigned char*> probeRadValues;
+	TArray<FIntPoint> probeImageSizes;
+	probePositions.SetNum(probes);
+	probeRadValues.Init(nullptr, probes);
+	probeImageSizes.Init(FIntPoint::ZeroValue, probes);
+	samplingTuner.Clear();
+	for (int probe = 0; probe < probes; probe++)
+	{
+		unsigned imgW = 0, imgH = 0;
+		samplingTuner.AddProbe(MeasureProbe(input, bounds, configuredSegments << (probes - probe), probePositions[probe], probeRadValues[probe],
+			imgW, imgH));
+		probeImageSizes[probe] = FIntPoint(imgW, imgH);
+	}
+
+	size_t freeGPU = 0, totalGPU = 0;
+	cudaMemGetInfo(&freeGPU, &totalGPU);
+	size_t minGPU = (size_t)configVars->minGPUMemoryRemaining << 20;
+	int availRAM = GetAvailRAM();
+	grassSampling::SamplingLimits limits;
+	limits.minWidth = width / 256;
+	limits.maxWidth = width;
+	limits.gpuBudget = freeGPU > minGPU ? freeGPU - minGPU : 0;
+	limits.ramBudget = availRAM > configVars->minMemoryRemaining ? (size_t)(availRAM - configVars->minMemoryRemaining) << 20 : 0;
+	limits.bytesPerPosition = FMath::Max(numOfBladesWithinTurf, 1) * (sizeof(FTransform) + sizeof(FMatrix)) + 2 * sizeof(float);
+	limits.maxPositionsPerPart = configVars->maxInstanceLimitPG;
+	limits.cores = FPlatformMisc::NumberOfCores();
+
+	grassSampling::SamplingPlan plan;
+	int reused = -1;
+	if (samplingTuner.Plan(width, limits, plan))
+	{
+		reused = samplingTuner.ReuseProbe(width, plan);
+		tunedSegmentWidth = plan.segmentWidth;
+		tunedPartSegmentWidth = tunedSegmentWidth;
+	}
+	for (int probe = 0; probe < probes; probe++)
+	{
+		if (probe == reused)
+		{
+			reusedProbePositions = MoveTemp(probePositions[probe]);
+			reusedProbeRadValues = probeRadValues[probe];
+			reusedProbeImgW = probeImageSizes[probe].X;
+			reusedProbeImgH = probeImageSizes[probe].Y;
+			int probeSegments = configuredSegments << (probes - probe);
+			CreateSubBounds(bounds, reusedProbeBounds, 0, 0, probeSegments, probeSegments, width / probeSegments);
+			hasReusedProbe = true;
+		}
+		else if (probeRadValues[probe])
+			free(probeRadValues[probe]);
+	}
+	if (tunedSegmentWidth <= 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Sampling could not be tuned, subSpaceMaxWidth is used."));
+		return 0;
+	}
+
+	//amountOfParts changes only before the first part, so parts baked later share its split
+	if (divideIntoSmaller && amountOfParts < plan.parts)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("amountOfParts raised from %i to %i, so every part fits maxInstanceLimitPG and free RAM. Bake parts 1 - %i with the same settings."),
+			amountOfParts, plan.parts, plan.parts - 1);
+		amountOfParts = plan.parts;
+	}
+	else if (!divideIntoSmaller && plan.parts > 1)
+		UE_LOG(LogTemp, Warning, TEXT("Grass of the bounds exceeds memory ceiling, turn on divideIntoSmaller with %i parts or bake it by %i workers of GrassBake commandlet."),
+			plan.parts, plan.workers);
+
+	FString summary = FString::Printf(TEXT("segment %.0f (%i x %i, configured %i x %i), parts %i, workers %i, predicted %.1f s and %.0f positions; "
+		"measured %.3f s per call, %.3g s per area, %.3g positions per area, GPU %.0f MB + %.3g B per area; budget GPU %i MB, RAM %i MB%s"),
+		plan.segmentWidth, plan.segments, plan.segments, configuredSegments, configuredSegments, plan.parts, plan.workers, plan.predictedSeconds,
+		plan.predictedPositions, plan.secondsPerCall, plan.secondsPerArea, plan.positionsPerArea, plan.gpuBaseBytes / (1 << 20), plan.gpuBytesPerArea,
+		(int)(limits.gpuBudget >> 20), (int)(limits.ramBudget >> 20), reused != -1 ? TEXT("; first segment reused from probe") : TEXT(""));
+	UE_LOG(LogTemp, Display, TEXT("Sampling auto tuned: %s"), *summary);
+	WriteBakeLog(FString::Printf(TEXT("bounds (%.0f, %.0f) - (%.0f, %.0f), %s, seed %i: %s"), bounds[0], bounds[1], bounds[2], bounds[3],
+		input.empty() ? *FString::Printf(TEXT("radius %g"), turfRadius) : *FString::Printf(TEXT("adaptive %i - %i"), lowerThreshold, upperThreshold),
+		samplingSeed, *summary));
+	return 1;
+}
+
+grassSampling::SamplingProbe UGrassRendering::MeasureProbe(const std::string& input, const float bounds[], int segments, std::vector<float>& positions,
+	unsigned char*& radValues, unsigned& imgW, unsigned& imgH)
+{
+	float segmentSize = FMath::Max(abs(bounds[0] - bounds[2]), abs(bounds[1] - bounds[3])) / segments;
+	float subBounds[4];
+	CreateSubBounds(bounds, subBounds, 0, 0, segments, segments, segmentSize);
+
+	//sampler frees its GPU memory before returning, so its peak is polled from other thread
+	size_t freeBefore = 0, total = 0;
+	cudaMemGetInfo(&freeBefore, &total);
+	std::atomic<size_t> minFree(freeBefore);
+	std::atomic<bool> sampling(true);
+	TFuture<void> poll = Async(EAsyncExecution::Thread, [&minFree, &sampling]() {
+		while (sampling)
+		{
+			size_t freeNow = 0, totalNow = 0;
+			if (cudaMemGetInfo(&freeNow, &totalNow) == cudaSuccess && freeNow < minFree)
+				minFree = freeNow;
+			FPlatformProcess::Sleep(0.001f);
+		}
+	});
+
+	double start = FPlatformTime::Seconds();
+	if (input.empty())
+		cudaPoissonSampling::PoissonDiskDistribution(positions, turfRadius, poissonDiskTries, subBounds);
+	else
+	{
+		cudaPoissonSampling::partitionAttributes partition = { segments, segments, 0 };
+		cudaPoissonSampling::PoissonDiskDistribution(positions, radValues, imgW, imgH, input, poissonDiskTries, subBounds, lowerThreshold,
+			upperThreshold, partition);
+	}
+
+	grassSampling::SamplingProbe probe;
+	probe.seconds = FPlatformTime::Seconds() - start;
+	sampling = false;
+	poll.Wait();
+
+	probe.width = segmentSize;
+	probe.positions = positions.size() / 2;
+	probe.gpuBytes = freeBefore - FMath::Min(freeBefore, minFree.load());
+	return probe;
+}
+
+int UGrassRendering::TakeReusedProbe(std::vector<float>& positions, unsigned char*& radValues, unsigned& imgW, unsigned& imgH, const float subBounds[])
+{
+	bool matches = hasReusedProbe;
+	for (int i = 0; i < 4 && matches; i++)
+		matches = reusedProbeBounds[i] == subBounds[i];
+	if (matches)
+	{
+		positions.insert(positions.end(), reusedProbePositions.begin(), reusedProbePositions.end());
+		//density image is loaded by the first sampler call, which the probe replaces
+		if (radValues == 0 && reusedProbeRadValues != 0)
+		{
+			radValues = reusedProbeRadValues;
+			imgW = reusedProbeImgW;
+			imgH = reusedProbeImgH;
+			reusedProbeRadValues = 0;
+		}
+	}
+	ReleaseReusedProbe();
+	return matches;
+}
+
+void UGrassRendering::ReleaseReusedProbe()
+{
+	if (reusedProbeRadValues)
+		free(reusedProbeRadValues);
+	reusedProbeRadValues = 0;
+	std::vector<float>().swap(reusedProbePositions);
+	hasReusedProbe = false;
+}
+
+void UGrassRendering::WriteBakeLog(const FString& line)
+{
+	FString path = FPaths::ProjectSavedDir() + FString("GrassPlugin/BakeLog.txt");
+	FFileHelper::SaveStringToFile(FDateTime::Now().ToString() + FString(" ") + line + LINE_TERMINATOR, *path,
+		FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+}
+
+int UGrassRendering::BlueNoiseForWholeBoundaries(std::vector<float>& positions, const float bounds[])
+{
+	bool useLandscapeDensity = densitySource == EGPDensitySource::LandscapeLayers;
+	if (useLandscapeDensity && !UpdateLandscapeDensity())
+		return 0;
+	if (!useLandscapeDensity && !LoadDensityImage(FPaths::ProjectPluginsDir() + FString("GrassPlugin/Content/Textures/") + pictureName + FString(".png")))
+	{
+		GenerateErrorMessage(FString("GrassPlugin"),
+			FString("Image not found or could not be decoded. Make sure the image file is in Texture folder."));
+		return 0;
+	}
+
+	UGVar* configVars = UGVar::StaticClass()->GetDefaultObject<UGVar>();
+	if (blueNoiseMask.GetSize() != configVars->blueNoiseMaskSize)
+		blueNoiseMask.Generate(configVars->blueNoiseMaskSize, 0);
+
+	//densest grass fills every pixel of lowerThreshold spacing, sparser grass keeps fraction (lowerThreshold / radius)^2 of pixels
+	float spacing = GetMinAdaptiveRadius();
+	float minX = FMath::Min(bounds[0], bounds[2]), maxX = FMath::Max(bounds[0], bounds[2]);
+	float minY = FMath::Min(bounds[1], bounds[3]), maxY = FMath::Max(bounds[1], bounds[3]);
+	int firstX = FMath::FloorToInt(minX / spacing);
+	int firstY = FMath::FloorToInt(minY / spacing);
+	int width = FMath::CeilToInt(maxX / spacing) - firstX;
+	int rows = FMath::CeilToInt(maxY / spacing) - firstY;
+
+	//blocks of rows are thresholded in parallel and joined in row order, so the result does not depend on threads
+	const int rowsPerBlock = 64;
+	int blocks = FMath::DivideAndRoundUp(rows, rowsPerBlock);
+	std::vector<std::vector<float>> blockPositions(blocks);
+	ParallelFor(blocks, [&](int32 block) {
+		int firstRow = block * rowsPerBlock;
+		int blockRows = FMath::Min(rowsPerBlock, rows - firstRow);
+		std::vector<float> density((size_t)width * blockRows);
+		for (int row = 0; row < blockRows; row++)
+		{
+			float y = (firstY + firstRow + row + 0.5f) * spacing;
+			for (int i = 0; i < width; i++)
+			{
+				float x = (firstX + i + 0.5f) * spacing;
+				int rad = 255;
+				if (x >= minX && x < maxX && y >= minY && y < maxY)
+					rad = useLandscapeDensity ? GetLandscapeDensityPixel(x, y) : GetDensityImagePixel(x, y, bounds);
+				float radius = FMath::Lerp((float)lowerThreshold, (float)upperThreshold, rad / 254.f);
+				density[(size_t)row * width + i] = rad >= 255 ? 0.f : FMath::Min(FMath::Square(spacing / radius), 1.f);
+			}
+		}
+		grassSampling::ThresholdDensity(blockPositions[block], density.data(), width, blockRows, firstX, firstY + firstRow, spacing,
+			blueNoiseMask, samplingSeed);
+	});
+
+	for (const std::vector<float>& block : blockPositions)
+		positions.insert(positions.end(), block.begin(), block.end());
+	UE_LOG(LogTemp, Display, TEXT("Blue noise threshold of %i x %i pixels accepted %i positions."), width, rows, (int)positions.size() / 2);
+	return 1;
+}
+
+int UGrassRendering::LoadDensityImage(const FString& path)
+{
+	TArray<uint8> fileData;
+	if (!FFileHelper::LoadFileToArray(fileData, *path))
+		return 0;
+
+	IImageWrapperModule& imageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+	TSharedPtr<IImageWrapper> imageWrapper = imageWrapperModule.CreateImageWrapper(EImageFormat::PNG);
+	const TArray<uint8>* rawData = nullptr;
+	if (!imageWrapper.IsValid() || !imageWrapper->SetCompressed(fileData.GetData(), fileData.Num()) ||
+		!imageWrapper->GetRaw(ERGBFormat::Gray, 8, rawData) || rawData == nullptr)
+		return 0;
+
+	densityImage = *rawData;
+	densityImageWidth = imageWrapper->GetWidth();
+	densityImageHeight = imageWrapper->GetHeight();
+	return 1;
+}
+
+int UGrassRendering::GetDensityImagePixel(float xCoord, float yCoord, const float bounds[]) const
+{
+	if (densityImageWidth == 0 || densityImageHeight == 0 || bounds[0] == bounds[2] || bounds[1] == bounds[3])
+		return 255;
+	float u = (xCoord - bounds[0]) / (bounds[2] - bounds[0]);
+	float v = (yCoord - bounds[1]) / (bounds[3] - bounds[1]);
+	if (u < 0 || u >= 1 || v < 0 || v >= 1)
+		return 255;
+	return densityImage[FMath::FloorToInt(v * densityImageHeight) * densityImageWidth + FMath::FloorToInt(u * densityImageWidth)];
+}
+
+int UGrassRendering::GetTurfPixel(float xCoord, float yCoord, unsigned char* radValues, unsigned imgW, unsigned imgH, const float bounds[], int& rad)
+{
+	rad = 0; //0 - 255
+	if (adaptiveSampling && densitySource == EGPDensitySource::LandscapeLayers)
+		rad = GetLandscapeDensityPixel(xCoord, yCoord);
+	else if (adaptiveSampling && blueNoiseThreshold)
+		rad = GetDensityImagePixel(xCoord, yCoord, bounds);
+	else if (adaptiveSampling)
+	{
+		float2 pos2D = FormFloat2(xCoord, yCoord);
+		float4 boundaries = FormFloat4(bounds[0], bounds[1], bounds[2], bounds[3]);
+		if (!cudaPoissonSampling::GetPixelValueOnPosition(radValues, imgW, imgH, pos2D, rad, boundaries, lowerThreshold,
+			upperThreshold, { 1, 1, 0 }))
+			return 0;
+	}
+	return 1;
+}
+
+void UGrassRendering::TurfAttributesForPixel(float xCoord, float yCoord, int rad, bool adaptive, int& numOfGrass, int& radOfTurf, EGPGrassShape& shape)
+{
+	int adjustedNum = ((float)(256 - rad) / 255.f) * numOfBladesWithinTurf;
+	int adjustedRad = ((float)(256 - rad) / 255.f) * 2.f + turfGrassRadius;
+
+	numOfGrass = adaptive ? adjustedNum : numOfBladesWithinTurf;
+	radOfTurf = adaptive ? adjustedRad : turfGrassRadius;
+	shape = ChooseTurfShape(xCoord, yCoord, rad);
+}
+
+int UGrassRendering::SpawnPointCloudFile()
+{
+	FString path = GetPointCloudFilePath();
+	grassSampling::MappedFile file;
+	grassSampling::PointCloudView cloud;
+	if (!file.Open(std::string(TCHAR_TO_UTF8(*path))))
+	{
+		GenerateErrorMessage(FString("GrassPlugin"), FString::Printf(TEXT("Point cloud %s could not be opened."), *path));
+		return 0;
+	}
+	if (!cloud.Open(file.GetData(), file.GetSize()))
+	{
+		GenerateErrorMessage(FString("GrassPlugin"), FString::Printf(TEXT("%s is not a valid grass point cloud."), *path));
+		return 0;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Point cloud %s with %i turfs mapped."), *path, (int)cloud.Num());
+	if (!CheckInstanceLimit((int)cloud.Num() * 2))
+		return 0;
+
+	GatherExclusions();
+	SpawnPointCloudTurfs(cloud);
+	return 1;
+}
+
+int UGrassRendering::ExportPointCloud(const std::vector<float>& positions, unsigned char* radValues, unsigned imgW, unsigned imgH, const float bounds[], std::vector<uint8_t>& data)
+{
+	grassSampling::PointCloud cloud;
+	cloud.attributes = grassSampling::PointCloudSeed | (adaptiveSampling ? grassSampling::PointCloudDensity : 0);
+	cloud.AddPositions(positions);
+	cloud.seeds.resize(cloud.Num());
+	if (adaptiveSampling)
+		cloud.densities.resize(cloud.Num());
+
+	for (size_t i = 0; i < cloud.Num(); i++)
+	{
+		cloud.seeds[i] = turfStream.GetUnsignedInt();
+		int rad = 0;
+		if (adaptiveSampling && !GetTurfPixel(positions[2 * i], positions[2 * i + 1], radValues, imgW, imgH, bounds, rad))
+			return 0;
+		if (adaptiveSampling)
+			cloud.densities[i] = (255 - rad) / 255.f;
+	}
+
+	FString path = GetPointCloudFilePath();
+	if (!grassSampling::SerializePointCloud(cloud, data) ||
+		!FFileHelper::SaveArrayToFile(TArrayView<const uint8>(data.data(), data.size()), *path))
+	{
+		GenerateErrorMessage(FString("GrassPlugin"), FString::Printf(TEXT("Point cloud %s could not be written."), *path));
+		return 0;
+	}
+	UE_LOG(LogTemp, Display, TEXT("Point cloud with %i turfs exported into %s"), (int)cloud.Num(), *path);
+	return 1;
+}
+
+void UGrassRendering::SpawnPointCloudTurfs(const grassSampling::PointCloudView& cloud)
+{
+	if (grassPatch->HasProgressiveCells())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Grass patch contains non progressive grass, turfDensity will not be applicable anymore."));
+		grassPatch->ClearProgressiveCells();
+	}
+
+	FScopedSlowTask loadingDialogForSpawn(
+		cloud.Num(), NSLOCTEXT("GrassSpawn", "Spawning Grass", "Spawning instances of grass"), true);
+	loadingDialogForSpawn.MakeDialogDelayed(1, true, true);
+
+	UGVar* configVars = UGVar::StaticClass()->GetDefaultObject<UGVar>();
+	FGrassSpawnBatch batch;
+	for (size_t i = 0; i < cloud.Num(); i++)
+	{
+		loadingDialogForSpawn.EnterProgressFrame(
+			1, NSLOCTEXT("GrassSpawn", "Spawning Grass", "Grass turfs are being generated."));
+
+		const float* position = cloud.GetPositions() + 3 * i;
+		if (!exclusions.IsValid() || !exclusions->Contains(position[0], position[1]))
+			SpawnCloudTurf(cloud, i, batch);
+
+		if (batch.turfs >= configVars->spawnBatchSize)
+			grassPatch->CommitBatch(batch);
+
+		if (GWarn->ReceivedUserCancel())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Generating of new grass interupted."));
+			break;
+		}
+
+		if (!CheckRAMLimit())
+			break;
+	}
+	//turfs generated until now get spawned even if generating was interupted
+	grassPatch->CommitBatch(batch);
+}
+
+void UGrassRendering::SpawnCloudTurf(const grassSampling::PointCloudView& cloud, size_t index, FGrassSpawnBatch& batch)
+{
+	//seeded turf is the same whenever the cloud gets spawned
+	FRandomStream pointStream(cloud.Has(grassSampling::PointCloudSeed) ? (int32)cloud.GetSeeds()[index] : (int32)turfStream.GetUnsignedInt());
+
+	const float* position = cloud.GetPositions() + 3 * index;
+	bool hasDensity = cloud.Has(grassSampling::PointCloudDensity);
+	int rad = hasDensity ? FMath::Clamp(FMath::RoundToInt((1 - cloud.GetDensities()[index]) * 255), 0, 255) : 0;
+	int numOfGrass, radOfTurf;
+	EGPGrassShape shape;
+	TurfAttributesForPixel(position[0], position[1], rad, hasDensity, numOfGrass, radOfTurf, shape);
+
+	FQuat normalQuat = FQuat::Identity;
+	if (cloud.Has(grassSampling::PointCloudNormal))
+	{
+		const float* normal = cloud.GetNormals() + 3 * index;
+		normalQuat = FQuat::FindBetweenNormals(FVector::UpVector, FVector(normal[0], normal[1], normal[2]).GetSafeNormal(SMALL_NUMBER, FVector::UpVector));
+	}
+
+	//points placed onto the terrain by their source are not traced again
+	bool hasHeight = cloud.Has(grassSampling::PointCloudHeight);
+	FVector turfPosition(position[0], position[1], hasHeight ? position[2] : 0);
+	grassPatch->AddTurfToBatch(batch, pointStream, shape, numOfGrass, radOfTurf, turfPosition, shouldSnapToTerrain && !hasHeight, normalQuat);
+}
+
+FString UGrassRendering::GetPointCloudFilePath() const
+{
+	return FPaths::ConvertRelativePathToFull(FPaths::ProjectDir(), pointCloudPath);
+}
+
+#pragma optimize("", off)
+
+
+
+
+void UGrassRendering::PoissonDiskForWholeBoundaries(std::vector<float>& positions, const int radius, const int maxTries,
+	const float bounds[])
+{
+	float width = abs(bounds[0] - bounds[2]);
+	float height = abs(bounds[1] - bounds[3]);
+	int xSegments, ySegments;
+	float segmentSize;
+	DetermineAmountOfSegments(width, height, xSegments, ySegments, segmentSize);
+	float subBounds[4];
+	UE_LOG(LogTemp, Display, TEXT("width is %f height is %f, segments are %i and %i, segments size %f\n"), width, height,
+		xSegments, ySegments, segmentSize);
+	FScopedSlowTask loadingDialogForSpawn(
+		xSegments * ySegments, NSLOCTEXT("GrassSpawn", "Spawning Grass", "Spawning subSpaces of grass"), true);
+	loadingDialogForSpawn.MakeDialogDelayed(1, true, true);
+
+	for (int i = 0; i < xSegments; i++)
+	{
+		for (int j = 0; j < ySegments; j++)
+		{
+			loadingDialogForSpawn.EnterProgressFrame(
+				1, FText::Format(NSLOCTEXT("GrassSpawn", "Spawning Grass", "Spawning {0} subSpace of grass"),
+					j + ySegments * i));
+			CreateSubBounds(bounds, subBounds, i, j, xSegments, ySegments, segmentSize);
+			unsigned char* noRadValues = 0;
+			unsigned noW = 0, noH = 0;
+			if (!TakeReusedProbe(positions, noRadValues, noW, noH, subBounds))
+				cudaPoissonSampling::PoissonDiskDistribution(positions, radius, maxTries, subBounds);
+
+			if (GWarn->ReceivedUserCancel())
+			{
+				UE_LOG(LogTemp, Warning,
+					TEXT("Generating of new positions interupted. Grass will be generated only for positions "
+						"generated until now./n"));
+				return;
+			}
+		}
+	}
+}
+
+void UGrassRendering::PoissonDiskForWholeBoundaries(std::vector<float>& positions, unsigned char* &radiusValues, unsigned& imgW, unsigned& imgH, std::string input,
+	const int maxTries, const float bounds[])
+{
+	float width = abs(bounds[0] - bounds[2]);
+	float height = abs(bounds[1] - bounds[3]);
+	int xSegments, ySegments;
+	float segmentSize;
+	DetermineAmountOfSegments(width, height, xSegments, ySegments, segmentSize);
+	float subBounds[4];
+	UE_LOG(LogTemp, Error, TEXT("width is %f height is %f, segments are %i and %i, segments size %f\n"), width, height,
+		xSegments, ySegments, segmentSize);
+	FScopedSlowTask loadingDialogForSpawn(
+		xSegments * ySegments, NSLOCTEXT("GrassSpawn", "Spawning Grass", "Spawning subSpaces of grass"), true);
+	loadingDialogForSpawn.MakeDialogDelayed(1, true, true);
+
+	for (int i = 0; i < xSegments; i++)
+	{
+		for (int j = 0; j < ySegments; j++)
+		{
+
+			loadingDialogForSpawn.EnterProgressFrame(
+				1, FText::Format(NSLOCTEXT("GrassSpawn", "Spawning Grass", "Spawning {0} subScape of grass"),
+					j + ySegments * i));
+			CreateSubBounds(bounds, subBounds, i, j, xSegments, ySegments, segmentSize);
+			cudaPoissonSampling::partitionAttributes partition = { xSegments, ySegments, i + xSegments * j };
+			if (!TakeReusedProbe(positions, radiusValues, imgW, imgH, subBounds))
+				cudaPoissonSampling::PoissonDiskDistribution(positions, radiusValues, imgW, imgH, input, maxTries, subBounds, lowerThreshold,
+					upperThreshold, partition);
+			if (GWarn->ReceivedUserCancel())
+			{
+				UE_LOG(LogTemp, Warning,
+					TEXT("Generating of new positions interupted. Grass will be generated only for positions "
+						"generated until now./n"));
+				return;
+			}
+		}
+	}
+}
+
+void UGrassRendering::PoissonDiskForPart(std::vector<float>& positions, unsigned char* &radValues, unsigned& imgW, unsigned& imgH, std::string input, const int maxTries,
+	const float bounds[], int index)
+{
+	float width = abs(bounds[0] - bounds[2]);
+	float height = abs(bounds[1] - bounds[3]);
+	int xSegments, ySegments;
+	float segmentSize;
+	DetermineAmountOfSegments(width, height, xSegments, ySegments, segmentSize);
+	float subBounds[4];
+	UE_LOG(LogTemp, Error, TEXT("width is %f height is %f, segments are %i and %i, segments size %f\n"), width, height,
+		xSegments, ySegments, segmentSize);
+	int totalSegments = xSegments * ySegments;
+	if (totalSegments < amountOfParts)
+		amountOfParts = totalSegments;
+	float partSize = (float)totalSegments / (float)amountOfParts;
+	int lowerIndex = FMath::RoundToInt(renderPart * partSize);
+	int upperIndex = FMath::RoundToInt((renderPart + 1) * partSize);
+
+	FScopedSlowTask loadingDialogForSpawn(
+		upperIndex - lowerIndex, NSLOCTEXT("GrassSpawn", "Spawning Grass", "Spawning subSpaces of grass"), true);
+	loadingDialogForSpawn.MakeDialogDelayed(1, true, true);
+
+	for (int k = lowerIndex; k < upperIndex; k++)
+	{
+		int i = k % xSegments;
+		int j = k / xSegments;
+		loadingDialogForSpawn.EnterProgressFrame(
+			1, FText::Format(NSLOCTEXT("GrassSpawn", "Spawning Grass", "Spawning {0} subScape of grass"), k));
+		CreateSubBounds(bounds, subBounds, i, j, xSegments, ySegments, segmentSize);
+		cudaPoissonSampling::partitionAttributes partition = { xSegments, ySegments, i + xSegments * j };
+		if (!TakeReusedProbe(positions, radValues, imgW, imgH, subBounds))
+			cudaPoissonSampling::PoissonDiskDistribution(positions, radValues, imgW, imgH, input, maxTries, subBounds, lowerThreshold,
+				upperThreshold, partition);
+		if (GWarn->ReceivedUserCancel())
+		{
+			UE_LOG(LogTemp, Warning,
+				TEXT("Generating of new positions interupted. Grass will be generated only for positions "
+					"generated until now./n"));
+			return;
+		}
+	}
+}
+
+int UGrassRendering::DetermineAmountOfSegments(float& width, float& height, int& xSegments, int& ySegments,
+	float& segmentSize)
+{
+
+	if (height > width)
+	{
+		ySegments = ComputeSegmentsVal(height);
+		segmentSize = height / ySegments;
+		xSegments = ComputeSegmentsVal(width);
+		width = segmentSize * xSegments;
+	}
+	else
+	{
+		xSegments = ComputeSegmentsVal(width);
+		segmentSize = width / xSegments;
+		ySegments = ComputeSegmentsVal(height);
+		height = segmentSize * ySegments;
+	}
+
+	return 1;
+}
+void UGrassRendering::CreateSubBounds(const float bounds[], float subBounds[], int xIdx, int yIdx, int xSegments,
+	int ySegments, float segmentSize)
+{
+	if (bounds[1] < bounds[3])
+	{
+		subBounds[0] = bounds[0] + xIdx * segmentSize;
+		subBounds[1] = bounds[1] + yIdx * segmentSize;
+		subBounds[2] = bounds[2] - (xSegments - 1 - xIdx) * segmentSize;
+		subBounds[3] = bounds[3] - (ySegments - 1 - yIdx) * segmentSize;
+	}
+	else
+	{
+		subBounds[0] = bounds[0] + xIdx * segmentSize;
+		subBounds[1] = bounds[1] - (ySegments - 1 - yIdx) * segmentSize;
+		subBounds[2] = bounds[2] - (xSegments - 1 - xIdx) * segmentSize;
+		subBounds[3] = bounds[3] + yIdx * segmentSize;
+	}
+}
+void UGrassRendering::GenerateErrorMessage(const FString& title, const FString& message)
+{
+	FText fullTitle = FText::Format(NSLOCTEXT("HeatMaps", "File_Error", "{0}"), FText::AsCultureInvariant(title));
+	UE_LOG(LogTemp, Error, TEXT("%s"), *message);
+	FMessageDialog::Open(EAppMsgType::Ok, FText::FromString(message), &fullTitle);
+}
+
+EAppReturnType::Type UGrassRendering::GenerateWarningMessage(const FString& title, const FString& message)
+{
+	FText fullTitle = FText::Format(NSLOCTEXT("GrassPlugin", "File_Warning", "{0}"), FText::AsCultureInvariant(title));
+	UE_LOG(LogTemp, Warning, TEXT("%s"), *message);
+	return FMessageDialog::Open(EAppMsgType::YesNo, FText::FromString(message), &fullTitle);
+}
+
+int UGrassRendering::GeneratePositions(std::vector<float>& positions, unsigned char *& radValues, unsigned & imgW, unsigned & imgH, const float bounds[])
+{
+	GatherExclusions();
+
+	//bake regions reject excluded positions themselves
+	if (useBakeRegions)
+		return BakeRegionPositions(positions);
+
+	if (adaptiveSampling && blueNoiseThreshold)
+	{
+		if (!BlueNoiseForWholeBoundaries(positions, bounds))
+			return 0;
+	}
+	else if (adaptiveSampling && densitySource == EGPDensitySource::LandscapeLayers)
+	{
+		if (!LandscapeDensityForWholeBoundaries(positions, bounds))
+			return 0;
+	}
+	else if (adaptiveSampling)
+	{
+		FString path = FPaths::ProjectPluginsDir() + FString("GrassPlugin/Content/Textures/") + pictureName + FString(".png");
+		std::string input = std::string(TCHAR_TO_UTF8(*(path)));
+
+		if (!FPaths::FileExists(path))
+		{
+			GenerateErrorMessage(FString("GrassPlugin"),
+				FString("Image not found. Make sure the image file is in Texture folder."));
+			return 0;
+		}
+		else
+		{
+			AutoTuneSampling(input, bounds);
+			if (divideIntoSmaller)
+				PoissonDiskForPart(positions, radValues, imgW, imgH, input, poissonDiskTries, bounds, renderPart);
+			else
+				PoissonDiskForWholeBoundaries(positions, radValues, imgW, imgH, input, poissonDiskTries, bounds);
+		}
+	}
+	else if (usePoissonTiles)
+	{
+		if (!PreparePoissonTiles(turfRadius, poissonDiskTries))
+			return 0;
+		PoissonTilesForWholeBoundaries(positions, bounds);
+	}
+	else
+	{
+		AutoTuneSampling(std::string(), bounds);
+		PoissonDiskForWholeBoundaries(positions, turfRadius, poissonDiskTries, bounds);
+	}
+
+	//GPU sampler cannot check exclusions, its positions are rejected before any turf gets traced
+	int excluded = exclusions->RemoveContained(positions);
+	if (excluded > 0)
+		UE_LOG(LogTemp, Display, TEXT("%i positions rejected by grass exclusions."), excluded);
+	return 1;
+}
+
+int UGrassRendering::SpawnTurf(float xCoord, float yCoord, unsigned char* radValues, unsigned imgW, unsigned imgH, const float bounds[], FGrassSpawnBatch& batch)
+{
+	FVector turfPosition;
+	FQuat normalQuat;
+	turfPosition = FVector(xCoord, yCoord, 0);
+	normalQuat = FQuat::Identity;
+
+	int numOfGrass, radOfTurf;
+	EGPGrassShape shape;
+	if (!ComputeTurfAttributes(xCoord, yCoord, radValues, imgW, imgH, bounds, numOfGrass, radOfTurf, shape))
+		return 0;
+	grassPatch->AddTurfToBatch(batch, turfStream, shape, numOfGrass, radOfTurf, turfPosition, shouldSnapToTerrain, normalQuat);
+	return 1;
+}
+
+int UGrassRendering::CheckBounds()
+{
+	int widthX = abs(topLeftCorner.X - botRightCorner.X);
+	int widthY = abs(topLeftCorner.Y - botRightCorner.Y);
+
+	if (widthX != widthY)
+	{
+		GenerateErrorMessage(FString("GrassPlugin"),
+			FString("The inserted field ratio is not square! Please adjust it."));
+		return 0;
+	}
+	return 1;
+}
+
+int UGrassRendering::CheckInstanceLimit(int amountOfPositions)
+{
+	UGVar* configVars = UGVar::StaticClass()->GetDefaultObject<UGVar>();
+
+	if (amountOfPositions > configVars->maxInstanceLimitPG)
+	{
+
+		if (EAppReturnType::Yes !=
+			GenerateWarningMessage(FString("GrassPlugin"),
+				FString("Warning: Exceeding limit of %i objects. This might lead to memory "
+					"overflow, possibly causing Unreal to crash. Do you wish to proceed?",
+					configVars->maxInstanceLimitPG)))
+			return 0;
+	}
+	return 1;
+}
+
+int UGrassRendering::CheckRAMLimit()
+{
+	UGVar* configVars = UGVar::StaticClass()->GetDefaultObject<UGVar>();
+	if (configVars->memoryBarrier)
+		if (GetAvailRAM() < configVars->minMemoryRemaining)
+		{
+			GenerateErrorMessage(FString("GrassPlugin"),
+				FString("Available memory dropped under allowed capacity. Computation will be stopped."));
+			return 0;
+		}
+
+	return 1;
+}
+
+int UGrassRendering::ComputeSegmentsVal(int oneDSize)
+{
+	UGVar* configVars = UGVar::StaticClass()->GetDefaultObject<UGVar>();
+	if (tunedSegmentWidth > 0)
+		return FMath::Max(FMath::CeilToInt(oneDSize / tunedSegmentWidth - 0.001f), 1);
+
+	int val = FMath::RoundToInt(oneDSize / configVars->subSpaceMaxWidth);
+	return val < 1 ? 1 : val;
+}
+
+float2 UGrassRendering::FormFloat2(float x, float y)
+{
+	float2 result;
+	result.x = x;
+	result.y = y;
+	return result;
+}
+
+float4 UGrassRendering::FormFloat4(float x, float y, float z, float w)
+{
+	float4 result;
+	result.x = x;
+	result.y = y;
+	result.z = z;
+	result.w = w;
+	return result;
+}
+
+// get memory info...
+int UGrassRendering::GetTotalRAM()
+{
+	int ret = 0;
+#ifdef WIN32
+	DWORD v = GetVersion();
+	DWORD major = (DWORD)(LOBYTE(LOWORD(v)));
+	DWORD minor = (DWORD)(HIBYTE(LOWORD(v)));
+	DWORD build;
+	if (v < 0x80000000) build = (DWORD)(HIWORD(v));
+	else build = 0;
+
+	// because compiler static links the function...
+	BOOL(__stdcall*GMSEx)(LPMEMORYSTATUSEX) = 0;
+
+	HINSTANCE hIL = LoadLibrary(L"kernel32.dll");
+	GMSEx = (BOOL(__stdcall*)(LPMEMORYSTATUSEX))GetProcAddress(hIL, "GlobalMemoryStatusEx");
+
+	if (GMSEx)
+	{
+		MEMORYSTATUSEX m;
+		m.dwLength = sizeof(m);
+		if (GMSEx(&m))
+		{
+			ret = (int)(m.ullTotalPhys >> 20);
+		}
+	}
+	else
+	{
+		MEMORYSTATUS m;
+		m.dwLength = sizeof(m);
+		GlobalMemoryStatus(&m);
+		ret = (int)(m.dwTotalPhys >> 20);
+	}
+#endif
+	return ret;
+}
+
+int UGrassRendering::GetAvailRAM()
+{
+	int ret = 0;
+#ifdef WIN32
+	DWORD v = GetVersion();
+	DWORD major = (DWORD)(LOBYTE(LOWORD(v)));
+	DWORD minor = (DWORD)(HIBYTE(LOWORD(v)));
+	DWORD build;
+	if (v < 0x80000000) build = (DWORD)(HIWORD(v));
+	else build = 0;
+
+	// because compiler static links the function...
+	BOOL(__stdcall*GMSEx)(LPMEMORYSTATUSEX) = 0;
+
+	HINSTANCE hIL = LoadLibrary(L"kernel32.dll");
+	GMSEx = (BOOL(__stdcall*)(LPMEMORYSTATUSEX))GetProcAddress(hIL, "GlobalMemoryStatusEx");
+
+	if (GMSEx)
+	{
+		MEMORYSTATUSEX m;
+		m.dwLength = sizeof(m);
+		if (GMSEx(&m))
+		{
+			ret = (int)(m.ullAvailPhys >> 20);
+		}
+	}
+	else
+	{
+		MEMORYSTATUS m;
+		m.dwLength = sizeof(m);
+		GlobalMemoryStatus(&m);
+		ret = (int)(m.dwAvailPhys >> 20);
+	}
+#endif
+	return ret;
+}
+
+int UGrassRendering::GetTotalMemory()
+{
+	int ret = 0;
+#ifdef WIN32
+	DWORD v = GetVersion();
+	DWORD major = (DWORD)(LOBYTE(LOWORD(v)));
+	DWORD minor = (DWORD)(HIBYTE(LOWORD(v)));
+	DWORD build;
+	if (v < 0x80000000) build = (DWORD)(HIWORD(v));
+	else build = 0;
+
+	// because compiler static links the function...
+	BOOL(__stdcall*GMSEx)(LPMEMORYSTATUSEX) = 0;
+
+	HINSTANCE hIL = LoadLibrary(L"kernel32.dll");
+	GMSEx = (BOOL(__stdcall*)(LPMEMORYSTATUSEX))GetProcAddress(hIL, "GlobalMemoryStatusEx");
+
+	if (GMSEx)
+	{
+		MEMORYSTATUSEX m;
+		m.dwLength = sizeof(m);
+		if (GMSEx(&m))
+		{
+			ret = (int)(m.ullTotalPhys >> 20) + (int)(m.ullTotalVirtual >> 20);
+		}
+	}
+	else
+	{
+		MEMORYSTATUS m;
+		m.dwLength = sizeof(m);
+		GlobalMemoryStatus(&m);
+		ret = (int)(m.dwTotalPhys >> 20) + (int)(m.dwTotalVirtual >> 20);
+	}
+#endif
+	return ret;
+}
+
+int UGrassRendering::GetAvailMemory()
+{
+	int ret = 0;
+#ifdef WIN32
+	DWORD v = GetVersion();
+	DWORD major = (DWORD)(LOBYTE(LOWORD(v)));
+	DWORD minor = (DWORD)(HIBYTE(LOWORD(v)));
+	DWORD build;
+	if (v < 0x80000000) build = (DWORD)(HIWORD(v));
+	else build = 0;
+
+	// because compiler static links the function...
+	BOOL(__stdcall*GMSEx)(LPMEMORYSTATUSEX) = 0;
+
+	HINSTANCE hIL = LoadLibrary(L"kernel32.dll");
+	GMSEx = (BOOL(__stdcall*)(LPMEMORYSTATUSEX))GetProcAddress(hIL, "GlobalMemoryStatusEx");
+
+	if (GMSEx)
+	{
+		MEMORYSTATUSEX m;
+		m.dwLength = sizeof(m);
+		if (GMSEx(&m))
+		{
+			ret = (int)(m.ullAvailPhys >> 20) + (int)(m.ullAvailVirtual >> 20);
+		}
+	}
+	else
+	{
+		MEMORYSTATUS m;
+		m.dwLength = sizeof(m);
+		GlobalMemoryStatus(&m);
+		ret = (int)(m.dwAvailPhys >> 20) + (int)(m.dwAvailVirtual >> 20);
+	}
+#endif
+	return ret;
+}
+//************************************************
+//*********USABLE FUNCTIONS (not active)**********
+//************************************************
+
+TArray<FVector> UGrassRendering::poissonDiskSampling(int radius, int maxTries, const FVector4 bounds)
+{
+	/**Initialization of array**/
+	int dimensions = 2;
+	TArray<FVector> points = TArray<FVector>();
+
+	TArray<FVector> active = TArray<FVector>();
+
+
+	int width = abs(bounds.Z - bounds.X);
+	int height = abs(bounds.W - bounds.Y);
+	int cellsize = floor(radius / sqrt(dimensions));
+
+	int ncells_width = floor(width / cellsize) + 1;
+	int ncells_height = floor(height / cellsize) + 1;
+	grid.Empty();
+
+	for (int i = 0; i < ncells_width*ncells_height; i++) {
+		grid.Add(FVector::ZeroVector);
+	}
+
+	//initial point
+	int randomX = width / 2;
+	int randomY = height / 2;
+	FVector p0 = FVector(randomX, randomY, 0);
+	InsertPointToGrid(p0, cellsize, ncells_width, ncells_height);
+	int xindex = floor(p0.X / cellsize);
+	int yindex = floor(p0.Y / cellsize);
+	points.Add(p0);
+	active.Add(p0);
+
+	int iter = 0;
+
+	//Active slow taks
+	FScopedSlowTask poissonDiskST(2, NSLOCTEXT("PoissonDisk", "PoissonDiskGenerating", "Loading points for Poisson Disk"), true);
+	poissonDiskST.MakeDialogDelayed(1, true, true);
+	poissonDiskST.EnterProgressFrame(1, NSLOCTEXT("PoissonDisk", "PoissonDiskGenerating", "Loading points for Poisson Disk"));
+	/**Computation of other points**/
+	while (active.Num() > 0) {
+		int random_index = int(FMath::RandRange(0, active.Num() - 1)); //?? possible issue with the array
+		FVector p = active[random_index];
+		bool found = false;
+		for (int tries = 0; tries < maxTries; tries++) {
+			float theta = FMath::RandRange(0, 359);
+			float new_radius = FMath::RandRange(radius, 2 * radius);
+
+			int pnewx = floor(p.X + new_radius * FMath::Cos(theta));
+			int pnewy = floor(p.Y + new_radius * FMath::Sin(theta));
+			if (pnewx < 0 || pnewx >= width || pnewy < 0 || pnewy >= height)
+				continue;
+			FVector pnew = FVector(pnewx, pnewy, 0);
+
+			if (IsValidPoint(cellsize, ncells_width, ncells_height, pnew, radius, width, height))
+			{
+				points.Add(pnew);
+				InsertPointToGrid(pnew, cellsize, ncells_width, ncells_height);
+				active.Add(pnew);
+
+				found = true;
+			}
+		}
+		if (!found)
+			active.RemoveAt(random_index, 1);
+	}
+	poissonDiskST.EnterProgressFrame(1, NSLOCTEXT("PoissonDisk", "PoissonDiskSample", "PoissonDiskSamplingFinished"));
+	UE_LOG(LogTemp, Display, TEXT("points : %i"), points.Num());
+	return points;
+}
+void UGrassRendering::InsertPointToGrid(FVector point, float cellsize, int gWidth, int gHeight) {
+	int xindex = floor(point.X / cellsize);
+	int yindex = floor(point.Y / cellsize);
+	if (xindex < gWidth && xindex >= 0) {
+		if (yindex < gHeight && yindex >= 0) {
+			grid.RemoveAt(xindex + yindex * gWidth);
+			grid.Insert(point, xindex + yindex * gWidth);// = point;
+		}
+	}
+}
+
+bool UGrassRendering::IsValidPoint(int cellsize, int gWidth, int gHeight, FVector p, int radius, int width, int height) {
+	if (!PointWithinBounds(p, width, height))
+		return false;
+
+	int xindex = floor(p.X / cellsize);
+	int yindex = floor(p.Y / cellsize);
+	int i0 = FMath::Max(xindex - 1, 0);
+	int i1 = FMath::Min(xindex + 1, gWidth - 1);
+	int j0 = FMath::Max(yindex - 1, 0);
+	int j1 = FMath::Min(yindex + 1, gHeight - 1);
+
+	for (int i = i0; i <= i1; i++)
+		for (int j = j0; j <= j1; j++) {
+			if (grid[i + j * gWidth] != FVector::ZeroVector) {
+				FVector distVec = grid[i + j * gWidth] - p;
+				float length = distVec.Size();
+
+				if (length < radius)
+					return false;
+			}
+		}
+
+
+	return true;
+}
+
+bool UGrassRendering::PointWithinBounds(FVector p, int width, int height) {
+	if (p.X < 0 || p.X >= width || p.Y < 0 || p.Y >= height) {
+		return false;
+	}
+	else
+		return true;
+
+}
+
+
+
+#pragma optimize("", on)
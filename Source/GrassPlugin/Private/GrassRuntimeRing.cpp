@@ -0,0 +1,414 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "GrassRuntimeRing.h"
+#include "ProgressiveSampling.h"
+#include "HelperFunctions.h"
+#include "Async/Async.h"
+
+#include <string>
+
+AGrassRuntimeRing::AGrassRuntimeRing()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("root"));
+}
+
+void AGrassRuntimeRing::BeginPlay()
+{
+	Super::BeginPlay();
+
+	//tile lookup divides by the radius, so the ring stays empty instead
+	if (turfRadius <= 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Runtime grass of %s is not generated, turfRadius has to be positive."), *GetName());
+		SetActorTickEnabled(false);
+		return;
+	}
+
+	UGVar* configVars = UGVar::StaticClass()->GetDefaultObject<UGVar>();
+	settings.cellSize = configVars->grassCellSize;
+	settings.turfRadius = turfRadius;
+	settings.turfDensity = FMath::Clamp(turfDensity, 0.f, 1.f);
+	settings.numOfBladesWithinTurf = numOfBladesWithinTurf;
+	settings.turfGrassRadius = turfGrassRadius;
+	settings.grassShape = grassShape;
+	settings.samplingSeed = samplingSeed;
+	settings.shouldSnapToTerrain = shouldSnapToTerrain;
+	settings.rayLength = rayLength;
+	settings.traceHeight = GetActorLocation().Z;
+	settings.heightSamplesPerCell = useOcclusionCulling ? heightSamplesPerCell : 0;
+	settings.exclusions = AGrassExclusionVolume::GatherExclusions(GetWorld(), exclusionSplineRadius);
+
+	if (grassMaterial == nullptr)
+		grassMaterial = LoadObject<UMaterialInterface>(nullptr, *configVars->grassMatLocation);
+	if (billboardMaterial == nullptr)
+		billboardMaterial = LoadObject<UMaterialInterface>(nullptr, *configVars->billBoardMatLocation);
+	grassDynMaterial = UMaterialInstanceDynamic::Create(grassMaterial, this, FName("GrassInstances"));
+	billboardDynMaterial = UMaterialInstanceDynamic::Create(billboardMaterial, this, FName("billboardInstaces"));
+
+	//tiles are loaded from the same cache as the editor uses, or generated and cached on worker thread
+	FString cachePath = HelperFunctions::GetPoissonTilesCachePath(turfRadius, configVars->poissonTileSizeInRadii,
+		configVars->poissonTileVariants, samplingSeed);
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(cachePath), true);
+	std::string cacheFile = std::string(TCHAR_TO_UTF8(*cachePath));
+	float radius = turfRadius;
+	int tileSizeInRadii = configVars->poissonTileSizeInRadii;
+	int variants = configVars->poissonTileVariants;
+	int seed = samplingSeed;
+
+	poissonTilesTask = Async(EAsyncExecution::ThreadPool, [cacheFile, radius, tileSizeInRadii, variants, seed]() {
+		FGrassTileSetPtr tiles = MakeShared<grassSampling::PoissonTileSet, ESPMode::ThreadSafe>();
+		if (!tiles->LoadFromFile(cacheFile) || !tiles->Matches(radius, tileSizeInRadii, variants, seed))
+		{
+			if (tiles->Generate(radius, tileSizeInRadii, variants, 30, seed))
+				tiles->SaveToFile(cacheFile);
+		}
+		return tiles;
+	});
+}
+
+void AGrassRuntimeRing::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	//tasks trace in the world, so they have to finish before the world goes away
+	if (poissonTilesTask.IsValid())
+		poissonTilesTask.Wait();
+	for (TPair<FIntPoint, TFuture<FGrassCellPtr>>& pending : pendingCells)
+		pending.Value.Wait();
+	pendingCells.Empty();
+
+	TArray<FIntPoint> cells;
+	visibleCells.GetKeys(cells);
+	for (const FIntPoint& cell : cells)
+		HideCell(cell);
+	for (AGrassBlade* patch : patchPool)
+		if (IsValid(patch))
+			patch->Destroy();
+	patchPool.Empty();
+	cellCache.Empty();
+	cacheOrder.Empty();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AGrassRuntimeRing::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (!poissonTiles.IsValid())
+	{
+		if (!poissonTilesTask.IsValid() || !poissonTilesTask.IsReady())
+			return;
+		poissonTiles = poissonTilesTask.Get();
+		if (poissonTiles->IsEmpty())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Poisson tiles for runtime grass could not be generated."));
+			SetActorTickEnabled(false);
+			return;
+		}
+	}
+
+	FVector viewer;
+	if (!GetViewerLocation(viewer))
+		return;
+	FIntPoint center(FMath::FloorToInt(viewer.X / settings.cellSize), FMath::FloorToInt(viewer.Y / settings.cellSize));
+
+	for (auto pending = pendingCells.CreateIterator(); pending; ++pending)
+	{
+		if (!pending.Value().IsReady())
+			continue;
+		cellCache.Add(pending.Key(), pending.Value().Get());
+		TouchCache(pending.Key());
+		pending.RemoveCurrent();
+	}
+
+	//cells are hidden one cell further than they are shown, so moving along the border does not respawn them
+	TArray<FIntPoint> cellsToHide;
+	for (const TPair<FIntPoint, AGrassBlade*>& visible : visibleCells)
+	{
+		FIntPoint offset = visible.Key - center;
+		if (FMath::Max(FMath::Abs(offset.X), FMath::Abs(offset.Y)) > ringRadiusInCells + 1)
+			cellsToHide.Add(visible.Key);
+	}
+	for (const FIntPoint& cell : cellsToHide)
+		HideCell(cell);
+
+	//nearest cells first
+	TArray<FIntPoint> ring;
+	for (int x = -ringRadiusInCells; x <= ringRadiusInCells; x++)
+		for (int y = -ringRadiusInCells; y <= ringRadiusInCells; y++)
+			ring.Add(FIntPoint(x, y));
+	ring.Sort([](const FIntPoint& a, const FIntPoint& b) { return a.SizeSquared() < b.SizeSquared(); });
+
+	for (const FIntPoint& offset : ring)
+	{
+		FIntPoint cell = center + offset;
+		if (visibleCells.Contains(cell))
+			continue;
+
+		FGrassCellPtr* cached = cellCache.Find(cell);
+		if (cached != nullptr)
+		{
+			ShowCell(cell, (*cached)->batch);
+			TouchCache(cell);
+		}
+		else if (!pendingCells.Contains(cell) && pendingCells.Num() < maxCellsInProgress)
+			RequestCell(cell);
+	}
+
+	TrimCache();
+	UpdateOcclusion(viewer);
+}
+
+FGrassCellPtr AGrassRuntimeRing::GenerateCell(FIntPoint cell, const FGrassRuntimeSettings& settings, FGrassTileSetPtr tiles, UWorld* world)
+{
+	FGrassCellPtr cellData = MakeShared<FGrassRuntimeCell, ESPMode::ThreadSafe>();
+
+	float minX = cell.X * settings.cellSize, minY = cell.Y * settings.cellSize;
+	const float bounds[4] = { minX, minY + settings.cellSize, minX + settings.cellSize, minY };
+	std::vector<float> positions;
+	tiles->FillBounds(positions, bounds, settings.samplingSeed);
+	if (settings.exclusions.IsValid())
+		settings.exclusions->RemoveContained(positions);
+
+	//progressive order keeps any prefix of turfs evenly distributed, so turfDensity thins the cell out evenly
+	uint32 cellSeed = grassSampling::HashCoordinates(cell.X, cell.Y, settings.samplingSeed);
+	int count = positions.size() / 2;
+	grassSampling::ProgressiveOrder(positions.data(), count, minX, minY, settings.cellSize, settings.turfRadius, cellSeed);
+	int turfs = FMath::CeilToInt(count * settings.turfDensity);
+
+	grassSampling::RandomStream stream(cellSeed);
+	FGrassSpawnBatch& batch = cellData->batch;
+	TArray<FTransform>& bladeTransforms = batch.bladeTransforms[(int)settings.grassShape];
+	for (int i = 0; i < turfs; i++)
+	{
+		FVector position(positions[2 * i], positions[2 * i + 1], settings.traceHeight);
+		FQuat normalQuat = FQuat::Identity;
+		if (settings.shouldSnapToTerrain && !AGrassBlade::SnapToTerrain(world, settings.rayLength, position, normalQuat))
+			continue;
+
+		AGrassBlade::GenerateTurfLayout(stream, settings.numOfBladesWithinTurf, settings.turfGrassRadius, position, normalQuat, bladeTransforms);
+		batch.turfCenters.Add(FTransform(normalQuat, position));
+		batch.turfs++;
+		cellData->maxHeight = FMath::Max(cellData->maxHeight, position.Z);
+	}
+
+	//heights are traced in corners of heightfield samples, sample keeps the lowest of its corners
+	int samples = settings.heightSamplesPerCell;
+	if (!settings.shouldSnapToTerrain || samples <= 0)
+		return cellData;
+
+	float sampleSize = settings.cellSize / samples;
+	TArray<float> cornerHeights;
+	for (int y = 0; y <= samples; y++)
+	{
+		for (int x = 0; x <= samples; x++)
+		{
+			FVector position(minX + x * sampleSize, minY + y * sampleSize, settings.traceHeight);
+			FQuat normalQuat;
+			//terrain with holes does not occlude anything
+			if (!AGrassBlade::SnapToTerrain(world, settings.rayLength, position, normalQuat))
+				return cellData;
+			cornerHeights.Add(position.Z);
+		}
+	}
+
+	cellData->minHeights.SetNum(samples * samples);
+	for (int y = 0; y < samples; y++)
+	{
+		for (int x = 0; x < samples; x++)
+		{
+			int corner = y * (samples + 1) + x;
+			cellData->minHeights[y * samples + x] = FMath::Min(FMath::Min(cornerHeights[corner], cornerHeights[corner + 1]),
+				FMath::Min(cornerHeights[corner + samples + 1], cornerHeights[corner + samples + 2]));
+		}
+	}
+	return cellData;
+}
+
+bool AGrassRuntimeRing::GetViewerLocation(FVector& location) const
+{
+	APlayerController* controller = GetWorld()->GetFirstPlayerController();
+	if (controller == nullptr || controller->PlayerCameraManager == nullptr)
+		return false;
+	location = controller->PlayerCameraManager->GetCameraLocation();
+	return true;
+}
+
+void AGrassRuntimeRing::RequestCell(FIntPoint cell)
+{
+	FGrassRuntimeSettings cellSettings = settings;
+	FGrassTileSetPtr tiles = poissonTiles;
+	UWorld* world = GetWorld();
+	pendingCells.Add(cell, Async(EAsyncExecution::ThreadPool, [cell, cellSettings, tiles, world]() {
+		return GenerateCell(cell, cellSettings, tiles, world);
+	}));
+}
+
+void AGrassRuntimeRing::ShowCell(FIntPoint cell, const FGrassSpawnBatch& cellData)
+{
+	AGrassBlade* patch = AcquirePatch();
+	//batch is emptied by commit, cached cell data stay untouched
+	FGrassSpawnBatch batch = cellData;
+	patch->CommitBatch(batch);
+	visibleCells.Add(cell, patch);
+}
+
+void AGrassRuntimeRing::HideCell(FIntPoint cell)
+{
+	AGrassBlade* patch = nullptr;
+	occludedFrames.Remove(cell);
+	bool wasOccluded = occludedCells.Remove(cell) > 0;
+	if (!visibleCells.RemoveAndCopyValue(cell, patch) || !IsValid(patch))
+		return;
+	if (wasOccluded)
+		patch->SetActorHiddenInGame(false);
+	patch->ClearInstances();
+	patchPool.Add(patch);
+}
+
+void AGrassRuntimeRing::UpdateOcclusion(FVector viewer)
+{
+	TArray<TPair<float, FIntPoint>> cells;
+	float farthestCell = 0;
+	horizon.Reset(viewer.X, viewer.Y, viewer.Z, horizonBins);
+	for (const TPair<FIntPoint, AGrassBlade*>& visible : visibleCells)
+	{
+		FIntPoint cell = visible.Key;
+		float distance = horizon.NearestDistance(cell.X * settings.cellSize, cell.Y * settings.cellSize,
+			(cell.X + 1) * settings.cellSize, (cell.Y + 1) * settings.cellSize);
+		cells.Add(TPair<float, FIntPoint>(distance, cell));
+		farthestCell = FMath::Max(farthestCell, distance);
+	}
+
+	if (!useOcclusionCulling || settings.heightSamplesPerCell <= 0)
+	{
+		for (const TPair<float, FIntPoint>& cell : cells)
+			SetCellOccluded(cell.Value, false);
+		return;
+	}
+
+	//heightfield samples of all cached cells in front of the farthest visible cell are occluders
+	struct FOccluder {
+		float minX, minY, height, distance;
+	};
+	TArray<FOccluder> occluders;
+	int samples = settings.heightSamplesPerCell;
+	float sampleSize = settings.cellSize / samples;
+	for (const TPair<FIntPoint, FGrassCellPtr>& cached : cellCache)
+	{
+		const TArray<float>& heights = cached.Value->minHeights;
+		if (heights.Num() != samples * samples)
+			continue;
+		for (int y = 0; y < samples; y++)
+		{
+			for (int x = 0; x < samples; x++)
+			{
+				FOccluder occluder;
+				occluder.minX = cached.Key.X * settings.cellSize + x * sampleSize;
+				occluder.minY = cached.Key.Y * settings.cellSize + y * sampleSize;
+				occluder.height = heights[y * samples + x];
+				occluder.distance = horizon.FarthestDistance(occluder.minX, occluder.minY, occluder.minX + sampleSize, occluder.minY + sampleSize);
+				if (occluder.distance <= farthestCell)
+					occluders.Add(occluder);
+			}
+		}
+	}
+	occluders.Sort([](const FOccluder& a, const FOccluder& b) { return a.distance < b.distance; });
+	cells.Sort([](const TPair<float, FIntPoint>& a, const TPair<float, FIntPoint>& b) { return a.Key < b.Key; });
+
+	//cell is tested against occluders that are completely in front of it
+	int nextOccluder = 0;
+	for (const TPair<float, FIntPoint>& cell : cells)
+	{
+		for (; nextOccluder < occluders.Num() && occluders[nextOccluder].distance <= cell.Key; nextOccluder++)
+		{
+			const FOccluder& occluder = occluders[nextOccluder];
+			horizon.AddOccluder(occluder.minX, occluder.minY, occluder.minX + sampleSize, occluder.minY + sampleSize, occluder.height);
+		}
+
+		FGrassCellPtr* cellData = cellCache.Find(cell.Value);
+		bool occluded = cellData != nullptr && (*cellData)->batch.turfs > 0 &&
+			horizon.IsOccluded(cell.Value.X * settings.cellSize, cell.Value.Y * settings.cellSize, (cell.Value.X + 1) * settings.cellSize,
+				(cell.Value.Y + 1) * settings.cellSize, (*cellData)->maxHeight + occlusionHeightMargin);
+		SetCellOccluded(cell.Value, occluded);
+	}
+}
+
+void AGrassRuntimeRing::SetCellOccluded(FIntPoint cell, bool occluded)
+{
+	AGrassBlade* patch = visibleCells.FindRef(cell);
+	if (!IsValid(patch))
+		return;
+
+	//cells are shown immediately, but hidden only after being occluded for several frames
+	if (!occluded)
+	{
+		occludedFrames.Remove(cell);
+		if (occludedCells.Remove(cell) > 0)
+			patch->SetActorHiddenInGame(false);
+		return;
+	}
+
+	int& frames = occludedFrames.FindOrAdd(cell);
+	frames++;
+	if (frames >= occludedFramesToHide && !occludedCells.Contains(cell))
+	{
+		occludedCells.Add(cell);
+		patch->SetActorHiddenInGame(true);
+	}
+}
+
+void AGrassRuntimeRing::TouchCache(FIntPoint cell)
+{
+	cacheOrder.Remove(cell);
+	cacheOrder.Add(cell);
+}
+
+void AGrassRuntimeRing::TrimCache()
+{
+	while (cellCache.Num() > cacheCapacity && cacheOrder.Num() > 0)
+	{
+		cellCache.Remove(cacheOrder[0]);
+		cacheOrder.RemoveAt(0);
+	}
+}
+
+AGrassBlade* AGrassRuntimeRing::AcquirePatch()
+{
+	if (patchPool.Num() > 0)
+		return patchPool.Pop();
+
+	FActorSpawnParameters spawnInfo;
+	spawnInfo.bNoFail = true;
+	spawnInfo.Owner = this;
+	AGrassBlade* patch = GetWorld()->SpawnActor<AGrassBlade>(FVector(0, 0, 0), FRotator(0, 0, 0), spawnInfo);
+	patch->InitializeMaterials(grassDynMaterial, billboardDynMaterial);
+	patch->SetActiveGrassBlades(settings.grassShape);
+	patch->SetExperimentalLOD(false);
+	return patch;
+}
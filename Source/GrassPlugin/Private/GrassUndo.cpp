@@ -0,0 +1,180 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "GrassUndo.h"
+#include "GrassRendering.h"
+
+FGrassRemovedInstance FGrassRemovedInstance::FromTransform(const FTransform& transform)
+{
+	FQuat rotation = transform.GetRotation();
+	return { transform.GetLocation(), { rotation.X, rotation.Y, rotation.Z, rotation.W }, transform.GetScale3D() };
+}
+
+FTransform FGrassRemovedInstance::ToTransform() const
+{
+	return FTransform(FQuat(rotation[0], rotation[1], rotation[2], rotation[3]), location, scale);
+}
+
+void FGrassDelta::Reset()
+{
+	instances.Empty();
+	turfCenters.Clear();
+	previousCells.Empty();
+	createdCells.Empty();
+	previousSpawnedTurfs.Empty();
+	previousTurfDensity.Reset();
+}
+
+bool FGrassDelta::IsEmpty() const
+{
+	return instances.Num() == 0 && turfCenters.IsEmpty() && previousCells.Num() == 0 && createdCells.Num() == 0 &&
+		previousSpawnedTurfs.Num() == 0 && !previousTurfDensity.IsSet();
+}
+
+void FGrassDelta::RecordAdded(UHierarchicalInstancedStaticMeshComponent* manager, int32 count)
+{
+	if (manager == NULL || count == 0)
+		return;
+	instances.FindOrAdd(manager).RecordAppend(count);
+}
+
+void FGrassDelta::RecordRemoved(UHierarchicalInstancedStaticMeshComponent* manager, const TArray<int32>& indices)
+{
+	if (manager == NULL || indices.Num() == 0)
+		return;
+
+	//indices go from the highest, so every instance is still on its index when it gets removed
+	grassSampling::SwapArrayDelta<FGrassRemovedInstance>& delta = instances.FindOrAdd(manager);
+	for (int32 index : indices)
+	{
+		FTransform transform;
+		if (manager->GetInstanceTransform(index, transform, false))
+			delta.RecordRemoveAtSwap(index, FGrassRemovedInstance::FromTransform(transform));
+	}
+}
+
+void FGrassDelta::RecordCleared(UHierarchicalInstancedStaticMeshComponent* manager)
+{
+	if (manager == NULL)
+		return;
+
+	//clearing is removal from the end
+	TArray<int32> indices;
+	indices.Reserve(manager->GetInstanceCount());
+	for (int32 i = manager->GetInstanceCount() - 1; i >= 0; i--)
+		indices.Add(i);
+	RecordRemoved(manager, indices);
+}
+
+void FGrassDelta::RecordClearedTurfCenters(const TArray<FVector2D>& centers)
+{
+	for (int32 i = centers.Num() - 1; i >= 0; i--)
+		turfCenters.RecordRemoveAtSwap(i, centers[i]);
+}
+
+void FGrassDelta::RecordProgressiveCell(FIntPoint key, const FGrassProgressiveCell* cell)
+{
+	if (previousCells.Contains(key) || createdCells.Contains(key))
+		return;
+	if (cell != nullptr)
+		previousCells.Add(key, *cell);
+	else
+		createdCells.Add(key);
+}
+
+void FGrassDelta::RecordClearedProgressiveCells(TMap<FIntPoint, FGrassProgressiveCell>& cells)
+{
+	for (TPair<FIntPoint, FGrassProgressiveCell>& cell : cells)
+		if (!previousCells.Contains(cell.Key) && !createdCells.Contains(cell.Key))
+			previousCells.Add(cell.Key, MoveTemp(cell.Value));
+}
+
+void FGrassDelta::RecordSpawnedTurfs(FIntPoint key, int32 spawnedTurfs)
+{
+	if (!previousSpawnedTurfs.Contains(key))
+		previousSpawnedTurfs.Add(key, spawnedTurfs);
+}
+
+void FGrassDelta::RecordTurfDensity(float density)
+{
+	if (!previousTurfDensity.IsSet())
+		previousTurfDensity = density;
+}
+
+int32 FGrassDelta::NumRemovedInstances() const
+{
+	int32 removed = 0;
+	for (const auto& manager : instances)
+		removed += (int32)manager.Value.NumRemoved();
+	return removed;
+}
+
+AActor* FGrassDelta::GetOwner() const
+{
+	for (const auto& manager : instances)
+		if (manager.Key.IsValid())
+			return manager.Key->GetOwner();
+	return nullptr;
+}
+
+SIZE_T FGrassDelta::GetAllocatedSize() const
+{
+	SIZE_T size = instances.GetAllocatedSize() + turfCenters.GetAllocatedSize();
+	for (const auto& manager : instances)
+		size += manager.Value.GetAllocatedSize();
+	size += previousCells.GetAllocatedSize() + createdCells.GetAllocatedSize() + previousSpawnedTurfs.GetAllocatedSize();
+	for (const auto& cell : previousCells)
+		size += cell.Value.GetAllocatedSize();
+	return size;
+}
+
+void FGrassOperationChange::Apply(UObject* object)
+{
+	UGrassRendering* render = Cast<UGrassRendering>(object);
+	if (render != nullptr)
+		render->RepeatGrassOperation(record, delta);
+}
+
+void FGrassOperationChange::Revert(UObject* object)
+{
+	UGrassRendering* render = Cast<UGrassRendering>(object);
+	if (render != nullptr)
+		render->RevertGrassOperation(delta);
+}
+
+bool FGrassOperationChange::HasExpired(UObject* object) const
+{
+	UGrassRendering* render = Cast<UGrassRendering>(object);
+	return render == nullptr || !render->HasGrassPatch();
+}
+
+FString FGrassOperationChange::ToString() const
+{
+	static const TCHAR* names[] = { TEXT("Generate Grass"), TEXT("Grass Brush Stroke"), TEXT("Clear Grass"), TEXT("Grass Turf Density") };
+	return FString::Printf(TEXT("%s (%i removed instances, %llu bytes)"), names[(int)record.operation], delta.NumRemovedInstances(),
+		(uint64)delta.GetAllocatedSize());
+}
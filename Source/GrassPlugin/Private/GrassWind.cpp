@@ -0,0 +1,248 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "GrassWind.h"
+
+//Simulation steps done in one frame at most, when the game hitches, the simulation does not try to catch up
+static const int maxStepsPerFrame = 4;
+
+TArray<UGrassWindEmitterComponent*> UGrassWindEmitterComponent::emitters;
+
+void UGrassWindEmitterComponent::OnRegister()
+{
+	Super::OnRegister();
+	emitters.AddUnique(this);
+}
+
+void UGrassWindEmitterComponent::OnUnregister()
+{
+	emitters.RemoveSwap(this);
+	Super::OnUnregister();
+}
+
+void UGrassWindEmitterComponent::Trigger()
+{
+	triggerTime = GetWorld()->GetTimeSeconds();
+}
+
+float UGrassWindEmitterComponent::GetCurrentStrength() const
+{
+	if (fadeTime <= 0)
+		return strength;
+
+	float elapsed = GetWorld()->GetTimeSeconds() - triggerTime;
+	if (elapsed < 0 || elapsed >= fadeTime)
+		return 0;
+	return strength * (1 - elapsed / fadeTime);
+}
+
+AGrassWindField::AGrassWindField()
+{
+	parameterName = FString("windField");
+	resolution = 64;
+	fieldSize = 16384;
+}
+
+void AGrassWindField::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	MoveField(GetViewLocation());
+
+	float step = 1.f / simulationRate;
+	accumulatedTime += DeltaSeconds;
+	int steps = 0;
+	while (accumulatedTime >= step && steps < maxStepsPerFrame)
+	{
+		Step(step);
+		accumulatedTime -= step;
+		steps++;
+	}
+	accumulatedTime = FMath::Min(accumulatedTime, step);
+
+	if (steps > 0)
+		UploadField();
+	BindGrassMaterials();
+}
+
+void AGrassWindField::AllocateField()
+{
+	int texels = resolution * resolution;
+	FVector2D ambient = GetAmbientWind();
+	windX.Init(ambient.X, texels);
+	windY.Init(ambient.Y, texels);
+	targetX.Init(0.f, texels);
+	targetY.Init(0.f, texels);
+	diffusedX.Init(0.f, texels);
+	diffusedY.Init(0.f, texels);
+}
+
+void AGrassWindField::ClearTexel(int index)
+{
+	//entering texels start with ambient wind, so no calm border travels with the viewer
+	FVector2D ambient = GetAmbientWind();
+	windX[index] = ambient.X;
+	windY[index] = ambient.Y;
+}
+
+void AGrassWindField::EncodeTexel(int index, uint8* texel) const
+{
+	float x = FMath::Clamp(windX[index] / maxWindSpeed, -1.f, 1.f);
+	float y = FMath::Clamp(windY[index] / maxWindSpeed, -1.f, 1.f);
+	float speed = FMath::Min(FMath::Sqrt(x * x + y * y), 1.f);
+	texel[0] = (uint8)FMath::RoundToInt(speed * 255);
+	texel[1] = (uint8)FMath::RoundToInt(127.5f + y * 127.5f);
+	texel[2] = (uint8)FMath::RoundToInt(127.5f + x * 127.5f);
+	texel[3] = 255;
+}
+
+FVector2D AGrassWindField::GetAmbientWind() const
+{
+	float yaw = FMath::DegreesToRadians(windYaw);
+	return FVector2D(FMath::Cos(yaw), FMath::Sin(yaw)) * windSpeed;
+}
+
+void AGrassWindField::Step(float step)
+{
+	simulationTime += step;
+
+	ComputeAmbientTarget();
+	for (const UGrassWindEmitterComponent* emitter : UGrassWindEmitterComponent::GetEmitters())
+		if (emitter->GetWorld() == GetWorld())
+			AddEmitter(emitter);
+	RelaxToTarget(step);
+	if (diffusion > 0)
+		Diffuse();
+}
+
+void AGrassWindField::ComputeAmbientTarget()
+{
+	float yaw = FMath::DegreesToRadians(windYaw);
+	FVector2D direction(FMath::Cos(yaw), FMath::Sin(yaw));
+	float texelSize = GetTexelSize();
+	float travelled = simulationTime * gustSpeed;
+
+	for (int y = origin.Y; y < origin.Y + resolution; y++)
+	{
+		for (int x = origin.X; x < origin.X + resolution; x++)
+		{
+			//gusts are waves travelling in the direction of the wind
+			float along = ((x + 0.5f) * direction.X + (y + 0.5f) * direction.Y) * texelSize;
+			float gust = FMath::Sin(2 * PI * (along - travelled) / gustWavelength);
+			float speed = windSpeed + gustStrength * gust;
+
+			int index = TexelIndex(x, y);
+			targetX[index] = direction.X * speed;
+			targetY[index] = direction.Y * speed;
+		}
+	}
+}
+
+void AGrassWindField::AddEmitter(const UGrassWindEmitterComponent* emitter)
+{
+	AActor* owner = emitter->GetOwner();
+	float strength = emitter->GetCurrentStrength();
+	if (owner == nullptr || emitter->radius <= 0 || strength <= 0)
+		return;
+
+	float texelSize = GetTexelSize();
+	FVector location = owner->GetActorLocation();
+	float radius = emitter->radius;
+
+	int minX = FMath::Max(FMath::FloorToInt((location.X - radius) / texelSize), origin.X);
+	int maxX = FMath::Min(FMath::FloorToInt((location.X + radius) / texelSize), origin.X + resolution - 1);
+	int minY = FMath::Max(FMath::FloorToInt((location.Y - radius) / texelSize), origin.Y);
+	int maxY = FMath::Min(FMath::FloorToInt((location.Y + radius) / texelSize), origin.Y + resolution - 1);
+
+	for (int x = minX; x <= maxX; x++)
+	{
+		for (int y = minY; y <= maxY; y++)
+		{
+			FVector2D offset((x + 0.5f) * texelSize - location.X, (y + 0.5f) * texelSize - location.Y);
+			float distance = offset.Size();
+			if (distance >= radius || distance <= KINDA_SMALL_NUMBER)
+				continue;
+
+			FVector2D wind = offset / distance * strength * (1 - distance / radius);
+			int index = TexelIndex(x, y);
+			targetX[index] += wind.X;
+			targetY[index] += wind.Y;
+		}
+	}
+}
+
+void AGrassWindField::RelaxToTarget(float step)
+{
+	float blend = 1 - FMath::Exp(-responsiveness * step);
+	VectorRegister blendVector = VectorSetFloat1(blend);
+
+	float* wx = windX.GetData();
+	float* wy = windY.GetData();
+	const float* tx = targetX.GetData();
+	const float* ty = targetY.GetData();
+	int count = windX.Num();
+	int vectorCount = count & ~3;
+
+	//wind += (target - wind) * blend, four texels at once
+	for (int i = 0; i < vectorCount; i += 4)
+	{
+		VectorRegister windVector = VectorLoad(wx + i);
+		VectorStore(VectorMultiplyAdd(VectorSubtract(VectorLoad(tx + i), windVector), blendVector, windVector), wx + i);
+		windVector = VectorLoad(wy + i);
+		VectorStore(VectorMultiplyAdd(VectorSubtract(VectorLoad(ty + i), windVector), blendVector, windVector), wy + i);
+	}
+	for (int i = vectorCount; i < count; i++)
+	{
+		wx[i] += (tx[i] - wx[i]) * blend;
+		wy[i] += (ty[i] - wy[i]) * blend;
+	}
+}
+
+void AGrassWindField::Diffuse()
+{
+	int maxX = origin.X + resolution - 1;
+	int maxY = origin.Y + resolution - 1;
+
+	//neighbours are clamped to the field, so texels on the opposite side of the toroidal storage do not mix
+	for (int y = origin.Y; y <= maxY; y++)
+	{
+		for (int x = origin.X; x <= maxX; x++)
+		{
+			int index = TexelIndex(x, y);
+			int left = TexelIndex(FMath::Max(x - 1, origin.X), y);
+			int right = TexelIndex(FMath::Min(x + 1, maxX), y);
+			int down = TexelIndex(x, FMath::Max(y - 1, origin.Y));
+			int up = TexelIndex(x, FMath::Min(y + 1, maxY));
+
+			diffusedX[index] = windX[index] + diffusion * (windX[left] + windX[right] + windX[down] + windX[up] - 4 * windX[index]);
+			diffusedY[index] = windY[index] + diffusion * (windY[left] + windY[right] + windY[down] + windY[up] - 4 * windY[index]);
+		}
+	}
+
+	Swap(windX, diffusedX);
+	Swap(windY, diffusedY);
+}
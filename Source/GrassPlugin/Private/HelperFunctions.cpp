@@ -1,52 +1,58 @@
-// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
-//
-// Redistribution and use in source and binary forms, with or without
-// modification, are permitted provided that the following conditions are met:
-//
-//   1. Redistributions of source code must retain the above copyright notice,
-//      this list of conditions and the following disclaimer.
-//
-//   2. Redistributions in binary form must reproduce the above copyright notice,
-//      this list of conditions and the following disclaimer in the documentation
-//      and/or other materials provided with the distribution.
-//
-//   3. Neither the name of the copyright holder nor the names of its contributors
-//      may be used to endorse or promote products derived from this software
-//      without specific prior written permission.
-//
-// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
-// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
-// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
-// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
-// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
-// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
-// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
-// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
-// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
-// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
-// POSSIBILITY OF SUCH DAMAGE.
-
-#include "..\Public\HelperFunctions.h"
-
-void HelperFunctions::Convert16BitTo8Bits(TArray<uint16>& input, TArray<uint8>& outputLow, TArray<uint8>& outputHigh)
-{
-	for (int i = 0; i < input.Num(); i++) {
-		uint16_t inputVal = input[i];
-		outputLow.Add(input[i] & 0x00FF);
-		
-		outputHigh.Add(inputVal >> 8);
-
-	}
-	
-}
-
-int HelperFunctions::IsNumNegative(int number)
-{
-	return (number < 0 ? 1 : 0);
-}
-
-int HelperFunctions::CompressSignValues(const FVector vector)
-{
-
-	return IsNumNegative(vector.X) * 100 + IsNumNegative(vector.Y) * 10 + IsNumNegative(vector.Z);
-}
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include "..\Public\HelperFunctions.h"
+
+void HelperFunctions::Convert16BitTo8Bits(TArray<uint16>& input, TArray<uint8>& outputLow, TArray<uint8>& outputHigh)
+{
+	for (int i = 0; i < input.Num(); i++) {
+		uint16_t inputVal = input[i];
+		outputLow.Add(input[i] & 0x00FF);
+		
+		outputHigh.Add(inputVal >> 8);
+
+	}
+	
+}
+
+int HelperFunctions::IsNumNegative(int number)
+{
+	return (number < 0 ? 1 : 0);
+}
+
+int HelperFunctions::CompressSignValues(const FVector vector)
+{
+
+	return IsNumNegative(vector.X) * 100 + IsNumNegative(vector.Y) * 10 + IsNumNegative(vector.Z);
+}
+
+FString HelperFunctions::GetPoissonTilesCachePath(float radius, int tileSizeInRadii, int variants, int seed)
+{
+	return FPaths::ProjectSavedDir() + FString::Printf(TEXT("GrassPlugin/PoissonTiles_r%g_t%i_v%i_s%i.bin"), radius,
+		tileSizeInRadii, variants, seed);
+}
@@ -0,0 +1,394 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Engine/World.h"
+#include "GrassBlade.h"
+#include "GrassRendering.h"
+#include "GrassUndo.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+//Tests run in their own empty world (no landscape), so turfs are placed without snapping
+
+//Empty editor world destroyed together with the test
+struct FGrassTestWorld {
+	UWorld* world;
+
+	FGrassTestWorld() { world = UWorld::CreateWorld(EWorldType::Editor, false); };
+	~FGrassTestWorld() { world->DestroyWorld(false); };
+
+	AGrassBlade* SpawnPatch() { return world->SpawnActor<AGrassBlade>(FVector::ZeroVector, FRotator::ZeroRotator); };
+};
+
+//Transforms of instances of every instance manager of the patch in instance order
+typedef TArray<TArray<FTransform>> FGrassPatchInstances;
+
+static FGrassPatchInstances GetPatchInstances(AGrassBlade* patch)
+{
+	TArray<UHierarchicalInstancedStaticMeshComponent*> managers;
+	patch->GetComponents(managers);
+	FGrassPatchInstances result;
+	for (UHierarchicalInstancedStaticMeshComponent* instances : managers)
+	{
+		TArray<FTransform>& transforms = result.AddDefaulted_GetRef();
+		for (int32 i = 0; i < instances->GetInstanceCount(); i++)
+			instances->GetInstanceTransform(i, transforms.AddDefaulted_GetRef(), false);
+	}
+	return result;
+}
+
+//@return if both snapshots hold the same instances in the same order
+static bool SameInstances(const FGrassPatchInstances& a, const FGrassPatchInstances& b)
+{
+	if (a.Num() != b.Num())
+		return false;
+	for (int manager = 0; manager < a.Num(); manager++)
+	{
+		if (a[manager].Num() != b[manager].Num())
+			return false;
+		for (int i = 0; i < a[manager].Num(); i++)
+			if (!a[manager][i].Equals(b[manager][i], 0.01f))
+				return false;
+	}
+	return true;
+}
+
+static int32 CountInstances(AGrassBlade* patch)
+{
+	int32 count = 0;
+	for (const TArray<FTransform>& transforms : GetPatchInstances(patch))
+		count += transforms.Num();
+	return count;
+}
+
+static int32 CountInstancesWithinRadius(AGrassBlade* patch, FVector location, float radius)
+{
+	TArray<UHierarchicalInstancedStaticMeshComponent*> managers;
+	patch->GetComponents(managers);
+	TArray<int32> found;
+	for (UHierarchicalInstancedStaticMeshComponent* instances : managers)
+		patch->QueryInstancesWithinRadius(instances, location, radius, found);
+	return found.Num();
+}
+
+//Adds row of turfs (5 blades within radius 4 plus billboard) spaced along X in one batch
+static void PaintTurfRow(AGrassBlade* patch, FVector start, int turfs, float spacing)
+{
+	FGrassSpawnBatch batch;
+	FRandomStream stream(turfs);
+	for (int i = 0; i < turfs; i++)
+		patch->AddTurfToBatch(batch, stream, EGPGrassShape::Quad, 5, 4, start + FVector(i * spacing, 0, 0), false, FQuat::Identity);
+	patch->CommitBatch(batch);
+}
+
+//Stores row of turfs spaced along X into one progressive cell
+static void AddProgressiveTurfRow(AGrassBlade* patch, FVector start, int turfs, float spacing)
+{
+	FRandomStream stream(turfs);
+	for (int i = 0; i < turfs; i++)
+		patch->AddProgressiveTurf(FIntPoint(0, 0), stream, EGPGrassShape::Quad, 5, 4, start + FVector(i * spacing, 0, 0), false, FQuat::Identity);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGrassUndoPaintEraseTest, "GrassPlugin.Undo.PaintEraseUndoUndo",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGrassUndoPaintEraseTest::RunTest(const FString& Parameters)
+{
+	FGrassTestWorld testWorld;
+	AGrassBlade* patch = testWorld.SpawnPatch();
+	PaintTurfRow(patch, FVector(100, 100, 0), 3, 100);
+	FGrassPatchInstances beforePaint = GetPatchInstances(patch);
+
+	FGrassDelta paint;
+	patch->BeginDelta(&paint);
+	PaintTurfRow(patch, FVector(100, 300, 0), 4, 100);
+	patch->EndDelta();
+	FGrassPatchInstances afterPaint = GetPatchInstances(patch);
+
+	//erasing turfs of both strokes swaps instances of the second stroke into erased slots of the first one
+	FGrassDelta erase;
+	patch->BeginDelta(&erase);
+	patch->RemoveGrassWithinRadius(FVector(200, 100, 0), 10);
+	patch->RemoveGrassWithinRadius(FVector(300, 300, 0), 10);
+	patch->EndDelta();
+	TestEqual(TEXT("Erased area is empty"), CountInstancesWithinRadius(patch, FVector(200, 100, 0), 10), 0);
+	TestEqual(TEXT("Erase removes turf centers"), patch->GetTurfCenterGrid().Num(), 5);
+
+	patch->RevertDelta(erase);
+	TestTrue(TEXT("Undo of erase restores instances in their order"), SameInstances(GetPatchInstances(patch), afterPaint));
+	TestEqual(TEXT("Undo of erase restores turf centers"), patch->GetTurfCenterGrid().Num(), 7);
+
+	patch->RevertDelta(paint);
+	TestTrue(TEXT("Undo of paint restores grass before the stroke"), SameInstances(GetPatchInstances(patch), beforePaint));
+	TestEqual(TEXT("Undo of paint removes its turf centers"), patch->GetTurfCenterGrid().Num(), 3);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGrassUndoClearSingleInstanceTest, "GrassPlugin.Undo.ClearSingleInstance",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGrassUndoClearSingleInstanceTest::RunTest(const FString& Parameters)
+{
+	FGrassTestWorld testWorld;
+	AGrassBlade* patch = testWorld.SpawnPatch();
+	UHierarchicalInstancedStaticMeshComponent* blades = patch->GetGrassBladesInstances(EGPGrassShape::Quad);
+	FGrassSpawnBatch batch;
+	batch.bladeTransforms[(int)EGPGrassShape::Quad].Add(FTransform(FVector(50, 50, 0)));
+	patch->CommitBatch(batch);
+
+	FGrassDelta clear;
+	patch->BeginDelta(&clear);
+	patch->ClearInstances();
+	patch->EndDelta();
+	TestEqual(TEXT("Clear removes the instance"), blades->GetInstanceCount(), 0);
+
+	patch->RevertDelta(clear);
+	TestEqual(TEXT("Undo of clear restores exactly one instance"), blades->GetInstanceCount(), 1);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGrassBrushStrokeTest, "GrassPlugin.Brush.PaintEraseUndoRedo",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGrassBrushStrokeTest::RunTest(const FString& Parameters)
+{
+	FGrassTestWorld testWorld;
+	UGrassRendering* render = NewObject<UGrassRendering>(GetTransientPackage());
+	render->SetBakeWorld(testWorld.world);
+	render->shouldSnapToTerrain = false;
+	render->spawnFlowers = false;
+	render->turfRadius = 30;
+	render->brushRadius = 200;
+	render->brushMode = EGPBrushMode::Paint;
+
+	//strokes are run the way redo repeats them, so no editor transaction is needed
+	FGrassOperationRecord stroke;
+	stroke.operation = EGPGrassOperation::BrushStroke;
+	stroke.settings = render->ExportBakeSettings();
+	stroke.dabs = { FVector(0, 0, 0), FVector(150, 0, 0) };
+	stroke.dabSeeds = { 7, 11 };
+
+	FGrassDelta paint;
+	render->RepeatGrassOperation(stroke, paint);
+	AGrassBlade* patch = Cast<AGrassBlade>(paint.GetOwner());
+	if (!TestNotNull(TEXT("Stroke spawns grass patch"), patch))
+		return false;
+	FGrassPatchInstances painted = GetPatchInstances(patch);
+	int32 paintedTurfs = patch->GetTurfCenterGrid().Num();
+	TestTrue(TEXT("Stroke paints turfs"), paintedTurfs > 0);
+
+	//overlapping dabs keep distance of turfRadius from turfs already painted
+	const grassSampling::PointHashGrid& centers = patch->GetTurfCenterGrid();
+	bool keepsDistance = true;
+	for (int i = 0; i < centers.Num(); i++)
+	{
+		std::vector<int> near;
+		centers.QueryRadius(centers.GetX(i), centers.GetY(i), render->turfRadius * 0.99f, near);
+		keepsDistance &= near.size() == 1;
+	}
+	TestTrue(TEXT("Painted turfs keep turfRadius from each other"), keepsDistance);
+
+	FGrassOperationRecord erase = stroke;
+	render->brushMode = EGPBrushMode::Erase;
+	render->brushRadius = 50;
+	erase.settings = render->ExportBakeSettings();
+	erase.dabs = { FVector(0, 0, 0) };
+	erase.dabSeeds = { 3 };
+
+	FGrassDelta erased;
+	render->RepeatGrassOperation(erase, erased);
+	TestEqual(TEXT("Erase brush empties its area"), CountInstancesWithinRadius(patch, FVector::ZeroVector, 50), 0);
+
+	//undo both strokes, then redo of the paint stroke places the same grass again
+	render->RevertGrassOperation(erased);
+	TestTrue(TEXT("Undo of erase stroke restores painted grass"), SameInstances(GetPatchInstances(patch), painted));
+	render->RevertGrassOperation(paint);
+	TestEqual(TEXT("Undo of paint stroke removes its grass"), CountInstances(patch), 0);
+	TestEqual(TEXT("Undo of paint stroke removes its turf centers"), patch->GetTurfCenterGrid().Num(), 0);
+
+	render->RepeatGrassOperation(stroke, paint);
+	TestTrue(TEXT("Redo of paint stroke places the same grass"), SameInstances(GetPatchInstances(patch), painted));
+	TestEqual(TEXT("Redo of paint stroke places the same turfs"), patch->GetTurfCenterGrid().Num(), paintedTurfs);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGrassTurfDensityKeepsOtherGrassTest, "GrassPlugin.TurfDensity.KeepsOtherGrass",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGrassTurfDensityKeepsOtherGrassTest::RunTest(const FString& Parameters)
+{
+	FGrassTestWorld testWorld;
+	AGrassBlade* patch = testWorld.SpawnPatch();
+	PaintTurfRow(patch, FVector(100, 1000, 0), 5, 100);
+	int32 painted = CountInstances(patch);
+
+	AddProgressiveTurfRow(patch, FVector(100, 100, 0), 10, 50);
+	patch->SetTurfDensity(1);
+	int32 full = CountInstances(patch);
+	TestTrue(TEXT("Density 1 spawns progressive turfs"), full > painted);
+
+	patch->SetTurfDensity(0.5f);
+	int32 half = CountInstances(patch);
+	TestTrue(TEXT("Lower density removes progressive turfs"), half > painted && half < full);
+
+	patch->SetTurfDensity(0);
+	TestEqual(TEXT("Density 0 keeps painted grass"), CountInstances(patch), painted);
+	TestEqual(TEXT("Painted turfs are untouched"), CountInstancesWithinRadius(patch, FVector(300, 1000, 0), 10), painted / 5);
+
+	patch->SetTurfDensity(0.5f);
+	TestEqual(TEXT("Raising density adds the same turfs back"), CountInstances(patch), half);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGrassTurfDensityAfterEraseTest, "GrassPlugin.TurfDensity.EraseUndo",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGrassTurfDensityAfterEraseTest::RunTest(const FString& Parameters)
+{
+	FGrassTestWorld testWorld;
+	AGrassBlade* patch = testWorld.SpawnPatch();
+	AddProgressiveTurfRow(patch, FVector(100, 100, 0), 10, 50);
+	patch->SetTurfDensity(1);
+	FGrassPatchInstances full = GetPatchInstances(patch);
+	int32 fullCount = CountInstances(patch);
+
+	//every change is recorded and undone in reverse order the way the editor does it
+	FGrassDelta erase;
+	patch->BeginDelta(&erase);
+	patch->RemoveGrassWithinRadius(FVector(150, 100, 0), 10);
+	patch->EndDelta();
+	int32 erased = CountInstances(patch);
+	TestTrue(TEXT("Erase removes progressive turf"), erased < fullCount);
+
+	FGrassDelta lowered, raised;
+	patch->BeginDelta(&lowered);
+	patch->SetTurfDensity(0);
+	patch->EndDelta();
+	patch->BeginDelta(&raised);
+	patch->SetTurfDensity(1);
+	patch->EndDelta();
+	TestEqual(TEXT("Density change does not respawn erased turf"), CountInstancesWithinRadius(patch, FVector(150, 100, 0), 10), 0);
+	TestEqual(TEXT("Density change keeps other turfs"), CountInstances(patch), erased);
+	FGrassPatchInstances beforeThinning = GetPatchInstances(patch);
+
+	FGrassDelta thinning;
+	patch->BeginDelta(&thinning);
+	patch->SetTurfDensity(0.3f);
+	patch->EndDelta();
+	FGrassPatchInstances thinned = GetPatchInstances(patch);
+	patch->RevertDelta(thinning);
+	TestTrue(TEXT("Undo of density change restores the grass"), SameInstances(GetPatchInstances(patch), beforeThinning));
+
+	//spawned amounts are restored too, so redo of the change gives the same grass
+	patch->BeginDelta(&thinning);
+	patch->SetTurfDensity(0.3f);
+	patch->EndDelta();
+	TestTrue(TEXT("Redo of density change gives the same grass"), SameInstances(GetPatchInstances(patch), thinned));
+	patch->RevertDelta(thinning);
+
+	patch->RevertDelta(raised);
+	patch->RevertDelta(lowered);
+	patch->RevertDelta(erase);
+	TestTrue(TEXT("Undo of all changes restores the grass"), SameInstances(GetPatchInstances(patch), full));
+
+	//undo of erase gives the turf back to its cell, so density thins it again
+	patch->SetTurfDensity(0);
+	TestEqual(TEXT("Restored turf is thinned by density"), CountInstances(patch), 0);
+	patch->SetTurfDensity(1);
+	TestEqual(TEXT("Restored turf is spawned by density"), CountInstances(patch), fullCount);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGrassHideFlattenCompactTest, "GrassPlugin.Gameplay.HideFlattenCompact",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGrassHideFlattenCompactTest::RunTest(const FString& Parameters)
+{
+	FGrassTestWorld testWorld;
+	AGrassBlade* patch = testWorld.SpawnPatch();
+	PaintTurfRow(patch, FVector(100, 100, 0), 4, 100);
+	UHierarchicalInstancedStaticMeshComponent* blades = patch->GetGrassBladesInstances(EGPGrassShape::Quad);
+	FGrassPatchInstances original = GetPatchInstances(patch);
+	int32 count = blades->GetInstanceCount();
+
+	TArray<int32> hidden, flattened;
+	patch->QueryInstancesWithinRadius(blades, FVector(100, 100, 0), 10, hidden);
+	patch->QueryInstancesWithinRadius(blades, FVector(300, 100, 0), 10, flattened);
+	TArray<FTransform> flattenedOriginals;
+	for (int32 index : flattened)
+		blades->GetInstanceTransform(index, flattenedOriginals.AddDefaulted_GetRef(), false);
+
+	patch->HideGrassWithinRadius(FVector(100, 100, 0), 10);
+	patch->FlattenGrassWithinRadius(FVector(300, 100, 0), 10, 0.2f);
+	patch->FlushGrassStateUpdates();
+	TestEqual(TEXT("Hiding keeps instances"), blades->GetInstanceCount(), count);
+
+	bool hiddenScaled = true;
+	for (int32 index : hidden)
+	{
+		FTransform transform;
+		blades->GetInstanceTransform(index, transform, false);
+		hiddenScaled &= transform.GetScale3D().IsNearlyZero();
+	}
+	TestTrue(TEXT("Hidden instances get zero scale"), hiddenScaled);
+
+	bool flattenedScaled = true;
+	for (int i = 0; i < flattened.Num(); i++)
+	{
+		FTransform transform;
+		blades->GetInstanceTransform(flattened[i], transform, false);
+		flattenedScaled &= FMath::IsNearlyEqual(transform.GetScale3D().Z, flattenedOriginals[i].GetScale3D().Z * 0.2f);
+	}
+	TestTrue(TEXT("Flattened instances keep 0.2 of their height"), flattenedScaled);
+
+	//compaction swaps flattened instances into removed slots, their states have to follow them
+	TestEqual(TEXT("Compaction removes hidden instances"), patch->CompactHiddenGrass(), hidden.Num());
+	TestEqual(TEXT("Compaction shrinks instance manager"), blades->GetInstanceCount(), count - hidden.Num());
+	TestEqual(TEXT("Compacted area is empty"), CountInstancesWithinRadius(patch, FVector(100, 100, 0), 10), 0);
+
+	patch->RestoreGrassWithinRadius(FVector(300, 100, 0), 10);
+	patch->FlushGrassStateUpdates();
+	TArray<int32> restored;
+	patch->QueryInstancesWithinRadius(blades, FVector(300, 100, 0), 10, restored);
+	bool restoredHeight = restored.Num() == flattened.Num();
+	for (int32 index : restored)
+	{
+		FTransform transform;
+		blades->GetInstanceTransform(index, transform, false);
+		bool found = false;
+		for (const FTransform& flattenedOriginal : flattenedOriginals)
+			found |= transform.Equals(flattenedOriginal, 0.01f);
+		restoredHeight &= found;
+	}
+	TestTrue(TEXT("Restore returns flattened instances moved by compaction to original transforms"), restoredHeight);
+	return true;
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,65 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GrassRendering.h"
+
+#include "GrassBakeCommandlet.generated.h"
+
+//Bakes grass of a map headless, split into shards generated by parallel worker processes
+//Usage: UE4Editor-Cmd.exe <project> -run=GrassBake -Map=<map package> [-Settings=<file>] [-Shards=<n>] [-Workers=<n>] [-Output=<folder>] [-MergeOnly]
+//Settings are exported in grass editor mode (Export Bake Settings). Every shard writes its cells into one chunk file and chunks
+//of finished shards are kept, so rerunning the same bake after crash generates only missing shards. Shards can be also run
+//on other machines with -Shard=<index>, their chunks copied into the output folder and merged with -MergeOnly.
+//Merge spawns cells of all chunks in fixed cell order and saves the map.
+UCLASS()
+class UGrassBakeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UGrassBakeCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+protected:
+	//Loads map and initializes its world for line traces
+	UWorld* LoadBakeWorld(const FString& map);
+
+	//Generates cells of one shard into its chunk file
+	int32 BakeShard(UGrassRendering* grass, int shard, int shardCount, uint32 settingsHash, const FString& outputDir);
+
+	//Runs worker process for every shard without valid chunk, at most workers at once. Returns success of all shards
+	//@param map, settingsPath, outputDir - handed over to workers
+	int RunShards(const FString& map, const FString& settingsPath, const FString& outputDir, int shardCount, int workers, uint32 settingsHash);
+
+	//Spawns cells of all chunks into grass patch of the world and saves the map
+	int32 MergeShards(UGrassRendering* grass, UWorld* world, int shardCount, uint32 settingsHash, const FString& outputDir);
+};
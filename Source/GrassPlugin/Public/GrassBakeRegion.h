@@ -0,0 +1,63 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EngineMinimal.h"
+#include "Runtime/Engine/Classes/GameFramework/Actor.h"
+#include "Components/SplineComponent.h"
+#include "CoverageMask.h"
+
+#include "GrassBakeRegion.generated.h"
+
+//Region of irregular shape in which grass gets generated (used with useBakeRegions)
+//Shape of the region is given by its spline, which is always treated as closed loop
+UCLASS()
+class GRASSPLUGIN_API AGrassBakeRegion : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AGrassBakeRegion();
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Grass")
+	USplineComponent* spline;
+
+	//Length of spline pieces approximated by one edge of the region polygon
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grass", meta = (UIMin = 10, ClampMin = 10))
+	float polygonStep = 200;
+
+	//Returns polygon of the region on horizontal plane
+	//@return param points - vertices of the polygon (x,y pairs)
+	void GetPolygon(std::vector<float>& points) const;
+
+	//Adds polygons of bake regions of the world into the mask
+	//@param selectedLandscapeComponents - adds also landscape components selected in landscape mode
+	//@return - amount of added polygons
+	static int GatherRegions(UWorld* world, bool selectedLandscapeComponents, grassSampling::CoverageMask& mask);
+};
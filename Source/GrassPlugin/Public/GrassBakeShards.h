@@ -0,0 +1,80 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GrassBlade.h"
+
+//Turfs of one world aligned cell (of grassCellSize) generated by one shard of sharded bake
+struct FGrassBakeCell {
+	FIntPoint cell = FIntPoint::ZeroValue;
+	//Sampled turf centers (not snapped), handed to grass patch for brush sampling
+	TArray<FVector2D> turfCenters;
+	//Generated instances of the cell, not yet added to instance managers
+	FGrassSpawnBatch batch;
+};
+
+//Cells generated by one shard, stored in one chunk file
+struct GRASSPLUGIN_API FGrassBakeChunk {
+	//Hash of settings and map the chunk was baked with (chunks of other bakes are stale)
+	uint32 settingsHash = 0;
+	int shard = 0;
+	int shardCount = 1;
+	TArray<FGrassBakeCell> cells;
+
+	//Chunk is written into temporary file renamed once it is complete, so crashed shard never leaves valid chunk behind
+	int SaveToFile(const FString& fileName);
+
+	//@param headerOnly - reads only settingsHash, shard and shardCount
+	int LoadFromFile(const FString& fileName, bool headerOnly = false);
+
+	//Whether chunk file exists and was baked by given shard of the same bake
+	static bool IsChunkValid(const FString& fileName, uint32 settingsHash, int shard, int shardCount);
+};
+
+//Shared rules of sharded bake, workers and merge have to agree on them
+class GRASSPLUGIN_API FGrassBakeShards {
+public:
+	//Shard generating given cell. Cells are scattered among shards by hash, so dense areas are spread over all workers
+	static int ShardOfCell(FIntPoint cell, int shardCount);
+
+	//Hash identifying bake by its exported settings and map
+	static uint32 GetSettingsHash(const FString& settings, const FString& map);
+
+	//Returns order in which cells of all chunks get spawned (pairs of chunk index and cell index within the chunk)
+	//Cells are sorted by their coordinates, so the result does not depend on which shard finished first
+	static void GetMergeOrder(const TArray<FGrassBakeChunk>& chunks, TArray<FIntPoint>& order);
+
+	static FString GetChunkPath(const FString& outputDir, int shard);
+
+	//Default location of settings exported by grass editor mode
+	static FString GetDefaultSettingsPath();
+
+	//Default folder of chunk files of the map
+	static FString GetDefaultOutputDir(const FString& map);
+};
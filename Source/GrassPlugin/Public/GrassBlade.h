@@ -1,164 +1,435 @@
-// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
-//
-// Redistribution and use in source and binary forms, with or without
-// modification, are permitted provided that the following conditions are met:
-//
-//   1. Redistributions of source code must retain the above copyright notice,
-//      this list of conditions and the following disclaimer.
-//
-//   2. Redistributions in binary form must reproduce the above copyright notice,
-//      this list of conditions and the following disclaimer in the documentation
-//      and/or other materials provided with the distribution.
-//
-//   3. Neither the name of the copyright holder nor the names of its contributors
-//      may be used to endorse or promote products derived from this software
-//      without specific prior written permission.
-//
-// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
-// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
-// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
-// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
-// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
-// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
-// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
-// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
-// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
-// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
-// POSSIBILITY OF SUCH DAMAGE.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "EngineMinimal.h"
-#include "Runtime/Engine/Classes/GameFramework/Actor.h"
-#include "Runtime/Engine/Classes/Materials/MaterialInstanceDynamic.h"
-#include "Components/HierarchicalInstancedStaticMeshComponent.h"
-#include "Runtime/CoreUObject/Public/UObject/Object.h"
-#include "AssetRegistryModule.h"
-#include "HelperFunctions.h"
-#include "GVar.h"
-
-
-#if WITH_EDITOR 
-#include "Editor.h"
-#include "LevelEditorViewport.h"
-#endif
-
-#include "EngineUtils.h"
-
-#include "GrassBlade.generated.h"
-
-
-
-UCLASS()
-class GRASSPLUGIN_API AGrassBlade : public AActor //outdated name, grass patch would probably be more appropriate
-{
-	GENERATED_BODY()
-
-public:
-	AGrassBlade();
-	AGrassBlade(const FObjectInitializer& objectInitializer);
-	
-	//Removes all instances of grass generated in this class
-	void ClearInstances();
-
-	//Spawns given amount of sole grass blades in given space
-	void SpawnGrassBlades(int amount, int startIndex, FVector4 bounds, FVector patchPosition, FVector textureCorner, int textureWidth, bool shouldSnapToTerrain);
-
-	//Spawns turf of grass around given position based on given attributes
-	//@param amount - amount of grass in turf
-	//@param radius - distance from position in which can grass blade be randomly positioned
-	//@param position - placement of center of turf
-	//@param bDebugCubes - should put debug cubes on grass positions?
-	//@param cubeSize - size of debug cube
-	//@param shouldSnapToTerrain - should the grass be modes onto height of landscape/tagged objects?
-	//@param normalQuat - gives quaternion of normal generated based on terrain normal (if input FQuat is FQuat::Identity, the normal quaternion is generated within this function)
-	void SpawnGrassBladesAroundPosition(int amount, int radius, FVector position, bool shouldSnapToTerrain, FQuat normalQuat);
-
-	//Spawns Flowers around given position based on given attributes
-	void SpawnFlowersAroundPosition(FVector position, int minAmount, int maxAmount, float innerFlowerRadius, EGPFlower flowerKind, bool shouldSnapToTerrain, FQuat normalQuat, float spawnWeight);
-
-	//Spawns just one grass blade plus debug cube to check functionality of single grass
-	void SpawnDefaultObject(int index);
-
-	//Helper function for initialization of the materials
-	void InitializeMaterials(UMaterialInstanceDynamic* mat, UMaterialInstanceDynamic* billBoardMat);
-	
-	//Setters of attributes within materials
-	void SetMaterialTextureSize(int textureWidth, int textureHeight);
-	void SetMaterialMovementPosition(const FTransform &transform);
-	void SetActiveGrassBlades(EGPGrassShape shape);
-
-	//Ray Setter
-	void SetRayLength(int value) { rayLength = value; };
-
-	//function raytraces position of terrain, then adjusts given position and normalQuat accordingly. Returns sucess of operation
-	//@return param position - insert position of the object and returns adjusted position
-	//@return param position - returns normal quaternion of the intersection 
-	//@return - returns if ray got valid blocking hit
-	int SnapingAdjustments(FVector& position, FQuat& normalQuat);
-
-	void SetExperimentalLOD(bool value) { experimentalLOD = value; };
-protected:
-	
-	int width = 5;
-	int height = 30;
-	int rayLength;
-	bool experimentalLOD;
-	   
-	//Helper function to initialize meshes
-	void InitiateMesh();
-
-	UPROPERTY(EditAnywhere)
-	UMaterialInstanceDynamic* dynMaterial;
-	
-	UPROPERTY(EditAnywhere)
-	UMaterialInstanceDynamic* bbMat;
-	
-	
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UHierarchicalInstancedStaticMeshComponent* grassBlades;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UHierarchicalInstancedStaticMeshComponent* triangleGrassBlades;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UHierarchicalInstancedStaticMeshComponent* triangleQuadGrassBlades;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UHierarchicalInstancedStaticMeshComponent* activeGrassBladesInstances;
-
-	//Billboard turfs 
-	UPROPERTY(Editanywhere, BlueprintReadWrite)
-	UHierarchicalInstancedStaticMeshComponent* billboardTurfInstances;
-	
-private:
-
-	//Spawns the billboard instance on position
-	void SpawnBillboardGrassTurf(FVector position, int radius, bool shouldSnapToTerrain, FQuat normalQuat);
-	
-	//Attribute setter for texture
-	void SetupDefaultTexture(UTexture2D*& texture, int textureWidth, int textureHeight, EPixelFormat format);
-	
-	//Removes all instances of given instance manager
-	void ClearHierarchicalInstances(UHierarchicalInstancedStaticMeshComponent* instances);
-	
-	//Helper function for Initialization of instance manager
-	void InitiateHierarchicalInstanceMesh(UHierarchicalInstancedStaticMeshComponent* instances, FString meshLocation);
-
-	//Sends ray up and bellow grass position and returns hit information if there are any
-	void FindLandScapeRayTrace(FVector start, FVector end, FHitResult& hitResult);
-
-	//if snap is turned on, ray searches for nearby terrain and if found adjusts given position and returns normal in the point found by ray
-	int AdjustPosition(FVector& position, FVector& impactNormal);
-
-	//Creates quaternion out of given normal
-	FQuat FindQuatOfNormal(const FVector& upVector, const FVector& normal);
-
-	//Generates random position ofseted from given position based on radius
-	FVector GenRandomPositionWithinRad(FVector position, int radius, float precision);
-
-	//
-	void InitAllInstancesSelectability();
-	void InitAllInstancesCollision();
-	void InitShadowCast();
-	void InitCullDistance();
-};
-
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EngineMinimal.h"
+#include "Runtime/Engine/Classes/GameFramework/Actor.h"
+#include "Runtime/Engine/Classes/Materials/MaterialInstanceDynamic.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Runtime/CoreUObject/Public/UObject/Object.h"
+#include "AssetRegistryModule.h"
+#include "HelperFunctions.h"
+#include "PointHashGrid.h"
+#include "TurfLayout.h"
+#include "GrassInstanceIndex.h"
+#include "GrassUndo.h"
+#include "GrassProgressiveCell.h"
+#include "GVar.h"
+
+
+#if WITH_EDITOR 
+#include "Editor.h"
+#include "LevelEditorViewport.h"
+#endif
+
+#include "EngineUtils.h"
+
+#include "GrassBlade.generated.h"
+
+//Instances that get added to instance managers together, one batched add per instance manager
+struct FGrassSpawnBatch {
+	//Blade transforms for every grass model (indexed by EGPGrassShape)
+	TArray<FTransform> bladeTransforms[GPGrassShapeCount];
+	//Snapped turf centers (location and normal rotation) waiting for billboard pass
+	TArray<FTransform> turfCenters;
+	TArray<FTransform> billboardTransforms;
+	//Flower transforms for every kind of flower (indexed by EGPFlower)
+	TArray<FTransform> flowerTransforms[GPFlowerKindCount];
+	//Clump transforms for every clump instance manager (indexed same as clump instance managers of grass patch)
+	TArray<TArray<FTransform>> clumpTransforms;
+	//Amount of turfs added into the batch
+	int turfs = 0;
+};
+
+//Attributes of flowers spawned within turfs
+struct FGrassFlowerSettings {
+	bool enabled = false;
+	EGPFlower flowerKind = EGPFlower::Mixed;
+	//Probability that turf contains flowers (0 - 1)
+	float turfChance = 0.05f;
+	int minAmount = 1;
+	int maxAmount = 3;
+	//Distance from turf center in which flowers get placed
+	float innerFlowerRadius = 4;
+	//Weight of the amount of flowers (0 - min amount is more likely, 2 - max amount is more likely)
+	float spawnWeight = 1;
+};
+
+//Instance whose transform was changed by gameplay
+struct FGrassModifiedInstance {
+	FTransform original;
+	EGPGrassInstanceState state;
+};
+
+//Gameplay changes of instances of one instance manager
+struct FGrassInstanceStates {
+	//Changed instances by instance index
+	TMap<int32, FGrassModifiedInstance> modified;
+	//Transforms waiting for upload by instance index
+	TMap<int32, FTransform> pending;
+};
+
+UCLASS()
+class GRASSPLUGIN_API AGrassBlade : public AActor //outdated name, grass patch would probably be more appropriate
+{
+	GENERATED_BODY()
+
+public:
+	AGrassBlade();
+	AGrassBlade(const FObjectInitializer& objectInitializer);
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	//Patch registers into grass patch registry of its world whenever its level gets loaded or streamed in
+	virtual void PostRegisterAllComponents() override;
+	virtual void PostUnregisterAllComponents() override;
+
+	//@return world space bounds of all grass added into the patch (invalid if there is none)
+	const FBox& GetGrassBounds() const { return grassBounds; };
+	
+	//Removes all instances of grass generated in this class
+	void ClearInstances();
+
+	//Spawns turf of grass around given position based on given attributes
+	//@param amount - amount of grass in turf
+	//@param radius - distance from position in which can grass blade be randomly positioned
+	//@param position - placement of center of turf
+	//@param bDebugCubes - should put debug cubes on grass positions?
+	//@param cubeSize - size of debug cube
+	//@param shouldSnapToTerrain - should the grass be modes onto height of landscape/tagged objects?
+	//@param normalQuat - gives quaternion of normal generated based on terrain normal (if input FQuat is FQuat::Identity, the normal quaternion is generated within this function)
+	void SpawnGrassBladesAroundPosition(int amount, int radius, FVector position, bool shouldSnapToTerrain, FQuat normalQuat);
+
+	//Generates transforms of grass blades of turf around given position without spawning them (attributes same as SpawnGrassBladesAroundPosition)
+	//@param stream - random stream of the turf (the same seed gives the same blades)
+	//@return param bladeTransforms - generated transforms get appended into this array
+	void GenerateGrassBladesAroundPosition(FRandomStream& stream, int amount, int radius, FVector position, bool shouldSnapToTerrain, FQuat normalQuat, TArray<FTransform>& bladeTransforms);
+
+	//Generates turf around given position into the batch instead of spawning it (attributes same as SpawnGrassBladesAroundPosition)
+	//@return param batch - batch the turf instances are added to
+	//@param stream - random stream of the turf, seeded by the caller from the seed of operation, dab, cell or point
+	//@param shape - grass model used for the blades of the turf
+	void AddTurfToBatch(FGrassSpawnBatch& batch, FRandomStream& stream, EGPGrassShape shape, int amount, int radius, FVector position, bool shouldSnapToTerrain, FQuat normalQuat);
+
+	//Adds all instances of the batch into instance managers (one batched add per instance manager) and empties the batch
+	void CommitBatch(FGrassSpawnBatch& batch);
+
+	//Turns turf centers of the batch into billboards (no ray is traced, centers are already snapped)
+	//@return param batch - batch with turf centers, billboards are added into it
+	//@param turfsPerBillboard - amount of turfs represented by one billboard, turfs get clustered if higher than 1
+	void GenerateBillboardPass(FGrassSpawnBatch& batch, int turfsPerBillboard);
+
+	//Stores turf into progressive cell instead of spawning it. Turfs have to be added in progressive order
+	//Stored turfs get spawned by SetTurfDensity
+	//@param cell - coordinates of world aligned cell the turf belongs to
+	//@param stream - random stream of the turf
+	//@param shape - grass model used for the blades of the turf
+	void AddProgressiveTurf(FIntPoint cell, FRandomStream& stream, EGPGrassShape shape, int amount, int radius, FVector position, bool shouldSnapToTerrain, FQuat normalQuat);
+
+	//Spawns given fraction of turfs of every progressive cell (no sampling or snapping is done). Only instances of turfs
+	//between the spawned and the new amount get added or removed, other grass of the patch is kept
+	//@param density - fraction of turfs that get spawned (0 - 1)
+	UFUNCTION(BlueprintCallable, Category = "Grass")
+	void SetTurfDensity(float density);
+
+	//Forgets stored progressive cells (already spawned instances are kept)
+	void ClearProgressiveCells();
+	bool HasProgressiveCells() const { return progressiveCells.Num() > 0; };
+
+	//Removes all grass (blades, clumps, billboards and flowers) and turf centers within radius from location on horizontal plane
+	//Turfs of progressive cells centered within radius get erased too, so turfDensity does not spawn them again
+	void RemoveGrassWithinRadius(FVector location, float radius);
+
+	//Returns indices of instances of given instance manager within radius from location on horizontal plane
+	//Instances get found through spatial index, so cost depends on amount of instances around the location only
+	//@return param result - found instance indices get appended
+	void QueryInstancesWithinRadius(UHierarchicalInstancedStaticMeshComponent* instances, FVector location, float radius, TArray<int32>& result);
+
+	//Hides grass within radius from location (cutting, burning). Changes get uploaded in batches once per frame
+	//(every upload rebuilds cluster tree and instance buffer of the changed instance manager)
+	UFUNCTION(BlueprintCallable, Category = "Grass")
+	void HideGrassWithinRadius(FVector location, float radius);
+
+	//Flattens grass within radius from location (trampling, vehicles)
+	//@param heightScale - height of flattened grass relative to its original height
+	UFUNCTION(BlueprintCallable, Category = "Grass")
+	void FlattenGrassWithinRadius(FVector location, float radius, float heightScale = 0.2f);
+
+	//Returns hidden or flattened grass within radius from location into its original state
+	UFUNCTION(BlueprintCallable, Category = "Grass")
+	void RestoreGrassWithinRadius(FVector location, float radius);
+
+	//Removes hidden instances from instance managers (hidden instances still cost vertex processing until compacted)
+	//@return - amount of removed instances
+	UFUNCTION(BlueprintCallable, Category = "Grass")
+	int CompactHiddenGrass();
+
+	//Uploads pending gameplay changes of instances immediately (otherwise uploaded in next Tick)
+	void FlushGrassStateUpdates();
+
+	//Returns spatial hash of centers of all turfs of this patch (rebuilt from stored turf centers if needed)
+	const grassSampling::PointHashGrid& GetTurfCenterGrid();
+
+	//Stores centers of turfs generated elsewhere (e.g. by bake shards)
+	void AddTurfCenters(const TArray<FVector2D>& centers);
+
+	//Forgets stored turf centers (instances are kept)
+	void ClearTurfCenters();
+
+	//Records instances and turf centers added and removed from now on into the delta (undo of grass operations)
+	void BeginDelta(FGrassDelta* delta) { recordedDelta = delta; };
+	void EndDelta() { recordedDelta = nullptr; };
+
+	//Removes instances and turf centers the delta added, restores the ones it removed and empties the delta
+	void RevertDelta(FGrassDelta& delta);
+
+	//Spawns Flowers around given position based on given attributes
+	void SpawnFlowersAroundPosition(FVector position, int minAmount, int maxAmount, float innerFlowerRadius, EGPFlower flowerKind, bool shouldSnapToTerrain, FQuat normalQuat, float spawnWeight);
+
+	//Generates flowers around already snapped position into the batch. Flowers are placed onto the plane given by position and normalQuat, so no ray is traced
+	//@param position - snapped center of the flowers
+	//@param normalQuat - normal quaternion of the terrain on position
+	//@param stream - random stream of the turf the flowers belong to
+	//@return param batch - batch the flowers are added to
+	void GenerateFlowersAroundPosition(FRandomStream& stream, FVector position, int minAmount, int maxAmount, float innerFlowerRadius, EGPFlower flowerKind, FQuat normalQuat, float spawnWeight, FGrassSpawnBatch& batch);
+
+	//Spawns just one grass blade plus debug cube to check functionality of single grass
+	void SpawnDefaultObject(int index);
+
+	//Helper function for initialization of the materials
+	void InitializeMaterials(UMaterialInstanceDynamic* mat, UMaterialInstanceDynamic* billBoardMat);
+	
+	//Setters of attributes within materials
+	void SetMaterialTextureSize(int textureWidth, int textureHeight);
+	void SetMaterialMovementPosition(const FTransform &transform);
+	UMaterialInstanceDynamic* GetGrassMaterial() const { return dynMaterial; };
+	void SetActiveGrassBlades(EGPGrassShape shape);
+
+	//Returns instance manager of given grass model
+	UHierarchicalInstancedStaticMeshComponent* GetGrassBladesInstances(EGPGrassShape shape);
+
+	//Returns instance manager of given flower kind (Mixed is not valid input)
+	UHierarchicalInstancedStaticMeshComponent* GetFlowerInstances(EGPFlower flowerKind);
+
+	//Ray Setter
+	void SetRayLength(int value) { rayLength = value; };
+
+	//function raytraces position of terrain, then adjusts given position and normalQuat accordingly. Returns sucess of operation
+	//@return param position - insert position of the object and returns adjusted position
+	//@return param position - returns normal quaternion of the intersection 
+	//@return - returns if ray got valid blocking hit
+	int SnapingAdjustments(FVector& position, FQuat& normalQuat);
+
+	//Same as SnapingAdjustments for given world and ray length. Does not touch the patch, so it can be called from worker threads
+	static int SnapToTerrain(UWorld* world, int rayLength, FVector& position, FQuat& normalQuat);
+
+	//Generates blades of turf around already snapped position using given random stream (deterministic, usable from worker threads)
+	//Blades are placed onto the plane given by position and normalQuat, so no ray is traced
+	//@return param bladeTransforms - generated transforms get appended into this array
+	static void GenerateTurfLayout(grassSampling::RandomStream& stream, int amount, float radius, FVector position, FQuat normalQuat, TArray<FTransform>& bladeTransforms);
+
+	void SetExperimentalLOD(bool value) { experimentalLOD = value; };
+	void SetFlowerSettings(const FGrassFlowerSettings& settings) { flowerSettings = settings; };
+
+	//Billboard clustering setter
+	//@param turfsPerBillboard - amount of turfs represented by one billboard
+	//@param clusterSize - width of square area clustered into one billboard
+	void SetBillboardClustering(int turfsPerBillboard, float clusterSize) { billboardTurfsPerBillboard = turfsPerBillboard; billboardClusterSize = clusterSize; };
+
+	//Sets clump meshes of given grass model, every mesh gets its own instance manager
+	//@param meshes - variants of clump mesh, turf picks one of them randomly
+	void SetClumpMeshes(EGPGrassShape shape, const TArray<UStaticMesh*>& meshes);
+
+	//Turns on placing one clump instance per turf instead of one instance per blade (for grass models with clump meshes)
+	void SetUseClumps(bool value) { useClumps = value; };
+protected:
+	
+	int width = 5;
+	int height = 30;
+	int rayLength;
+	bool experimentalLOD;
+	FGrassFlowerSettings flowerSettings;
+	int billboardTurfsPerBillboard = 1;
+	float billboardClusterSize = 0;
+	bool useClumps = false;
+	   
+	//Helper function to initialize meshes
+	void InitiateMesh();
+
+	UPROPERTY(EditAnywhere)
+	UMaterialInstanceDynamic* dynMaterial;
+	
+	UPROPERTY(EditAnywhere)
+	UMaterialInstanceDynamic* bbMat;
+	
+	
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	UHierarchicalInstancedStaticMeshComponent* grassBlades;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	UHierarchicalInstancedStaticMeshComponent* triangleGrassBlades;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	UHierarchicalInstancedStaticMeshComponent* triangleQuadGrassBlades;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	UHierarchicalInstancedStaticMeshComponent* activeGrassBladesInstances;
+	EGPGrassShape activeShape;
+
+	//Billboard turfs 
+	UPROPERTY(Editanywhere, BlueprintReadWrite)
+	UHierarchicalInstancedStaticMeshComponent* billboardTurfInstances;
+
+	//Flowers
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	UHierarchicalInstancedStaticMeshComponent* daisyFlowers;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	UHierarchicalInstancedStaticMeshComponent* violaFlowers;
+
+	//Clumps (created on demand by SetClumpMeshes), clumpShapes holds grass model of every clump instance manager
+	UPROPERTY()
+	TArray<UHierarchicalInstancedStaticMeshComponent*> clumpInstances;
+	UPROPERTY()
+	TArray<EGPGrassShape> clumpShapes;
+
+	//Turfs generated by progressive sampling, enable changing of turf density without regenerating
+	UPROPERTY()
+	TMap<FIntPoint, FGrassProgressiveCell> progressiveCells;
+
+	UPROPERTY()
+	float turfDensity = 1.f;
+
+	//Centers of all turfs added into this patch, used to keep density of brush painted grass consistent with existing grass
+	UPROPERTY()
+	TArray<FVector2D> turfCenters;
+
+	//Spatial hash over turfCenters (same indices), not serialized and rebuilt on demand
+	grassSampling::PointHashGrid turfCenterGrid;
+
+	//Spatial index over instances of all instance managers
+	FGrassInstanceIndex instanceIndex;
+
+	//Gameplay changes of instances for every instance manager (not serialized)
+	TMap<UHierarchicalInstancedStaticMeshComponent*, FGrassInstanceStates> instanceStates;
+
+	//Delta of grass operation being recorded (null if none)
+	FGrassDelta* recordedDelta = nullptr;
+
+	//World space bounds of grass added since last clear (cells of grass patch registry are derived from them)
+	UPROPERTY()
+	FBox grassBounds = FBox(ForceInit);
+
+	//Updates cells of the patch in grass patch registry after grassBounds changed
+	void UpdateRegistration();
+	
+private:
+
+	//Computes transform of billboard on already snapped position. Rotation and height depend only on the position, so billboards
+	//do not depend on how the turfs were split into batches
+	//@param normalQuat - normal quaternion of the terrain on position
+	//@param clusterScale - horizontal scale of billboard (billboards of clustered turfs cover bigger area)
+	FTransform GenerateBillboardTransform(FVector position, FQuat normalQuat, float clusterScale);
+
+	//Returns index of randomly chosen clump instance manager of given grass model, INDEX_NONE if the model has no clumps
+	int ChooseClump(FRandomStream& stream, EGPGrassShape shape);
+
+	//Returns all instance managers of the patch (blades, clumps, billboards and flowers)
+	void GetAllInstanceManagers(TArray<UHierarchicalInstancedStaticMeshComponent*>& managers) const;
+
+	//Sets gameplay state of all instances within radius from location
+	//@param heightScale - relative height of flattened instances
+	void SetGrassStateWithinRadius(FVector location, float radius, EGPGrassInstanceState state, float heightScale);
+
+	//Returns amount of leading turfs of progressive cell whose instances are spawned
+	int32 GetSpawnedTurfs(const FGrassProgressiveCell& cell) const;
+
+	//Adds instances of turf of progressive cell into the batch
+	void GatherProgressiveTurf(const FGrassProgressiveCell& cell, int32 turf, FGrassSpawnBatch& batch);
+
+	//Erases turfs of progressive cells centered within radius and removes their spawned instances
+	void EraseProgressiveTurfs(FVector2D location, float radius);
+
+	//Removes instances equal to the instances of the batch (one batched removal per instance manager) and empties the batch
+	void RemoveBatch(FGrassSpawnBatch& batch);
+
+	//Removes instances equal to given transforms through spatial index
+	void RemoveMatchingInstances(UHierarchicalInstancedStaticMeshComponent* instances, TArray<FTransform>& transforms);
+
+	//Adds instances through spatial index and records them into recorded delta
+	void AddIndexedInstances(UHierarchicalInstancedStaticMeshComponent* instances, const TArray<FTransform>& transforms);
+
+	//Removes given instances through spatial index and moves gameplay states of instances swapped into removed slots
+	//@return param indices - indices of instances to remove
+	void RemoveIndexedInstances(UHierarchicalInstancedStaticMeshComponent* instances, TArray<int32>& indices);
+
+	//Reverts swap removals of instances through spatial index (instance on the index moves to the end, given instance takes
+	//the index) and moves gameplay states the same way
+	//@param indices - indices in reverse order of their removal
+	void InsertIndexedInstancesAtSwap(UHierarchicalInstancedStaticMeshComponent* instances, const TArray<int32>& indices, const TArray<FTransform>& transforms);
+
+	//Applies material, selectability, collision, shadow and cull distance settings of grass blades to new clump instance manager
+	void InitClumpInstances(UHierarchicalInstancedStaticMeshComponent* instances);
+
+	
+	//Attribute setter for texture
+	void SetupDefaultTexture(UTexture2D*& texture, int textureWidth, int textureHeight, EPixelFormat format);
+	
+	//Removes all instances of given instance manager
+	void ClearHierarchicalInstances(UHierarchicalInstancedStaticMeshComponent* instances);
+	
+	//Helper function for Initialization of instance manager
+	void InitiateHierarchicalInstanceMesh(UHierarchicalInstancedStaticMeshComponent* instances, FString meshLocation);
+
+	//Helper function for Initialization of material of instance manager
+	void InitiateHierarchicalInstanceMaterial(UHierarchicalInstancedStaticMeshComponent* instances, FString matLocation);
+
+	//Returns world the snapping rays are traced in (world of the patch, so patches of sublevels trace their own world)
+	UWorld* GetTraceWorld() const;
+
+	//Sends ray up and bellow grass position and returns hit information if there are any
+	//Hit of actor grass cannot snap onto (rock, building) is reset, so no grass gets placed under it
+	static void FindLandScapeRayTrace(UWorld* world, FVector start, FVector end, FHitResult& hitResult);
+
+	//@return if grass can snap onto the actor (landscapes and actors tagged grassEnable), checks class and tags only
+	static bool CanSnapOnto(const AActor* actor);
+
+	//if snap is turned on, ray searches for nearby terrain and if found adjusts given position and returns normal in the point found by ray
+	static int AdjustPosition(UWorld* world, int rayLength, FVector& position, FVector& impactNormal);
+
+	//Creates quaternion out of given normal
+	static FQuat FindQuatOfNormal(const FVector& upVector, const FVector& normal);
+
+	//Generates random position ofseted from given position based on radius
+	FVector GenRandomPositionWithinRad(FRandomStream& stream, FVector position, int radius, float precision);
+
+	//
+	void InitAllInstancesSelectability();
+	void InitAllInstancesCollision();
+	void InitShadowCast();
+	void InitCullDistance();
+};
+
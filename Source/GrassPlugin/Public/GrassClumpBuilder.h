@@ -0,0 +1,57 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EngineMinimal.h"
+
+//Builds clump meshes - static meshes containing whole turf of grass blades, so turf can be placed as one instance instead
+//of one instance per blade
+class FGrassClumpBuilder {
+public:
+	//Returns asset name of clump mesh for given attributes
+	//@param shape - name of the grass model the clump is made of
+	//@param blades - amount of blades within clump
+	//@param radius - radius of the turf the clump was generated for
+	//@param variant - index of clump variant
+	static FString GetClumpAssetName(const FString& shape, int blades, float radius, int variant);
+
+	//Loads clump mesh from given content folder, returns nullptr if it does not exist
+	static UStaticMesh* LoadClumpMesh(const FString& packagePath, const FString& assetName);
+
+#if WITH_EDITOR
+	//Merges copies of blade mesh placed by bladeLayout into new static mesh asset (asset is created, but not saved to disk)
+	//@param bladeMesh - mesh of one grass blade
+	//@param bladeLayout - transforms of blades within clump relative to clump origin
+	//@param packagePath - content folder where the asset is created
+	//@param assetName - name of the new asset
+	//@return - created mesh or nullptr if blade mesh has no source data
+	static UStaticMesh* BuildClumpMesh(UStaticMesh* bladeMesh, const TArray<FTransform>& bladeLayout, const FString& packagePath, const FString& assetName);
+#endif
+};
@@ -0,0 +1,58 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EngineMinimal.h"
+#include "Runtime/Engine/Classes/GameFramework/Actor.h"
+#include "Components/BoxComponent.h"
+#include "ExclusionBVH.h"
+
+#include "GrassExclusionVolume.generated.h"
+
+typedef TSharedPtr<grassSampling::ExclusionBVH, ESPMode::ThreadSafe> FGrassExclusionsPtr;
+
+//Box in which no grass gets generated (roads, buildings)
+//Besides these volumes, actors tagged grassExclude keep grass away from their bounds, or from their splines if they have any
+UCLASS()
+class GRASSPLUGIN_API AGrassExclusionVolume : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AGrassExclusionVolume();
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Grass")
+	UBoxComponent* box;
+
+	//Gathers exclusion volumes and tagged actors of the world into hierarchy checked by samplers
+	//@param splineRadius - distance from splines of tagged actors in which grass is excluded
+	//@param splineStep - length of spline pieces approximated by capsules
+	//@return - built hierarchy (empty if the world has no exclusions)
+	static FGrassExclusionsPtr GatherExclusions(UWorld* world, float splineRadius, float splineStep = 200);
+};
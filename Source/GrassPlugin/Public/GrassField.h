@@ -0,0 +1,105 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EngineMinimal.h"
+#include "Runtime/Engine/Classes/GameFramework/Actor.h"
+#include "Runtime/Engine/Classes/Materials/MaterialInstanceDynamic.h"
+
+#include "GrassField.generated.h"
+
+//World aligned square field around the viewer, uploaded as one small texture shared by all grass materials
+//
+//Field is stored toroidally (texel of world position is position modulo field size), so moving viewer only clears
+//texels that entered the field and nothing gets shifted. Texture is bound into grass materials once, only origin of the
+//field gets updated when the field moves.
+//Material parameters: <parameterName> (texture), <parameterName>Size (scalar), <parameterName>Origin (vector)
+UCLASS(Abstract)
+class GRASSPLUGIN_API AGrassField : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AGrassField();
+
+	virtual void BeginPlay() override;
+
+	//Amount of texels of the field in one direction
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grass", meta = (UIMin = 16, ClampMin = 16))
+	int resolution = 128;
+
+	//World size covered by the field
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grass")
+	float fieldSize = 4096;
+
+protected:
+	//Prefix of material parameters the field is bound to
+	FString parameterName;
+
+	UPROPERTY()
+	UTexture2D* fieldTexture;
+
+	//Grass materials the field is bound into
+	UPROPERTY()
+	TArray<UMaterialInstanceDynamic*> boundMaterials;
+
+	//Texel coordinates of the minimal corner of the field
+	FIntPoint origin;
+	bool hasOrigin = false;
+
+	//Allocates field values for resolution * resolution texels
+	virtual void AllocateField() {};
+
+	//Resets values of one texel
+	virtual void ClearTexel(int index) {};
+
+	//Writes one texel into uploaded data (B, G, R, A)
+	virtual void EncodeTexel(int index, uint8* texel) const {};
+
+	//Location the field is centered on (camera of the first player)
+	FVector GetViewLocation() const;
+
+	//Moves the field to be centered on given location, texels that entered the field get cleared
+	void MoveField(FVector center);
+
+	//Uploads the field into the texture in one texture update
+	void UploadField();
+
+	//Binds the field into grass materials of grass patches that are not bound yet
+	void BindGrassMaterials();
+
+	float GetTexelSize() const { return fieldSize / resolution; };
+
+	//@param worldTexelX, worldTexelY texel coordinates in world (position / texel size)
+	//@return index of the texel in field arrays
+	int TexelIndex(int worldTexelX, int worldTexelY) const;
+
+private:
+	void SetMaterialOrigin(UMaterialInstanceDynamic* material) const;
+};
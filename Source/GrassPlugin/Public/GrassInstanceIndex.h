@@ -0,0 +1,84 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "PointHashGrid.h"
+
+// Spatial index from location to instance index for instance managers of grass patch
+//
+// Every instance manager gets its own spatial hash holding instance locations under the same indices as the instance
+// manager. Instance managers remove instances by moving the last instance into the removed slot, the hash removes
+// its points the same way, so both stay aligned without remapping.
+// Index of an instance manager is built on its first query and from then on maintained with every add, so instance
+// managers that are never queried cost nothing. Index that got out of sync (instances added elsewhere, level reload)
+// is rebuilt on next query.
+class FGrassInstanceIndex {
+public:
+	//@param cellSize - width of cell of the spatial hashes
+	explicit FGrassInstanceIndex(float cellSize = 50.f);
+
+	//Adds instances into the instance manager and into its index (if the index is built)
+	void AddInstances(UHierarchicalInstancedStaticMeshComponent* instances, const TArray<FTransform>& transforms);
+
+	//Returns indices of instances within radius from location on horizontal plane
+	//@return param result - found instance indices get appended
+	void QueryRadius(UHierarchicalInstancedStaticMeshComponent* instances, FVector location, float radius, TArray<int32>& result);
+
+	//Returns indices of instances with given transforms (in space of the instance manager), every transform matches one
+	//instance at most
+	//@return param result - found instance indices get appended
+	void FindInstances(UHierarchicalInstancedStaticMeshComponent* instances, const TArray<FTransform>& transforms, TArray<int32>& result);
+
+	//Removes all instances within radius from location on horizontal plane in one batched removal
+	//@return - amount of removed instances
+	int RemoveWithinRadius(UHierarchicalInstancedStaticMeshComponent* instances, FVector location, float radius);
+
+	//Removes given instances in one batched removal
+	//@return param indices - indices of instances to remove, get sorted from the highest
+	void RemoveInstances(UHierarchicalInstancedStaticMeshComponent* instances, TArray<int32>& indices);
+
+	//Reverts swap removals in one batched add and update (undo), instance on the index moves to the end and the given
+	//instance takes the index, so instances get back the exact order they had before the removal
+	//@param indices - indices in reverse order of their removal (index equal to the amount of instances appends)
+	void InsertInstancesAtSwap(UHierarchicalInstancedStaticMeshComponent* instances, const TArray<int32>& indices, const TArray<FTransform>& transforms);
+
+	//Forgets index of given instance manager (has to be called when all its instances get cleared)
+	void Reset(UHierarchicalInstancedStaticMeshComponent* instances);
+
+	//Forgets indices of all instance managers
+	void Empty() { grids.Empty(); };
+
+private:
+	float cellSize;
+	TMap<const UHierarchicalInstancedStaticMeshComponent*, grassSampling::PointHashGrid> grids;
+
+	//Returns index of the instance manager, builds it if it does not exist or is out of sync
+	grassSampling::PointHashGrid& GetGrid(UHierarchicalInstancedStaticMeshComponent* instances);
+};
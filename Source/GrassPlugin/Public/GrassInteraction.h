@@ -0,0 +1,101 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EngineMinimal.h"
+#include "Runtime/Engine/Classes/GameFramework/Actor.h"
+#include "Components/ActorComponent.h"
+#include "GrassField.h"
+
+#include "GrassInteraction.generated.h"
+
+//Makes its owner bend and flatten grass through AGrassInteractionField
+UCLASS(ClassGroup = (Grass), meta = (BlueprintSpawnableComponent))
+class GRASSPLUGIN_API UGrassInteractorComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	//Distance from the owner in which grass is affected
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grass", meta = (UIMin = 0, ClampMin = 0))
+	float radius = 100;
+
+	//How much grass bends away from the owner (0 - 1)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grass", meta = (UIMin = 0, ClampMin = 0, UIMax = 1, ClampMax = 1))
+	float bendStrength = 1;
+
+	//How much grass gets flattened under the owner (0 - 1)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grass", meta = (UIMin = 0, ClampMin = 0, UIMax = 1, ClampMax = 1))
+	float flattenStrength = 0.5f;
+
+	//All registered interactors
+	static const TArray<UGrassInteractorComponent*>& GetInteractors() { return interactors; };
+
+protected:
+	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
+
+private:
+	static TArray<UGrassInteractorComponent*> interactors;
+};
+
+//Field of grass displacement around the viewer, shared by all grass materials
+//
+//Every frame the field decays and all interactors are stamped into it on CPU, then it is uploaded as one small texture.
+//Texture channels: R,G - bend direction (0.5 is no bend), B - flattening
+//Material parameters: interactionField (texture), interactionFieldSize (scalar), interactionFieldOrigin (vector)
+UCLASS()
+class GRASSPLUGIN_API AGrassInteractionField : public AGrassField
+{
+	GENERATED_BODY()
+
+public:
+	AGrassInteractionField();
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	//Speed of grass returning into original state (higher is faster)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grass", meta = (UIMin = 0, ClampMin = 0))
+	float recoverySpeed = 1.5f;
+
+protected:
+	//Field values for every texel (toroidal addressing)
+	TArray<FVector2D> bend;
+	TArray<float> flatten;
+
+	virtual void AllocateField() override;
+	virtual void ClearTexel(int index) override;
+	virtual void EncodeTexel(int index, uint8* texel) const override;
+
+	//Decays the whole field
+	void DecayField(float deltaSeconds);
+
+	//Stamps interactor into the field
+	void StampInteractor(const UGrassInteractorComponent* interactor);
+};
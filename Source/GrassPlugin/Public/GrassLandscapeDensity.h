@@ -0,0 +1,94 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EngineMinimal.h"
+#include "GVar.h"
+
+#include "GrassLandscapeDensity.generated.h"
+
+class ULandscapeInfo;
+
+//One term of density expression, terms are applied in order on density starting at 0
+USTRUCT(BlueprintType)
+struct FGrassDensityLayer {
+	GENERATED_BODY()
+
+	//Name of paint layer of the landscape
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FName layerName;
+
+	//Weight of the layer is multiplied by this value before it gets combined
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float scale = 1;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	EGPLayerCombine operation = EGPLayerCombine::Add;
+};
+
+//Density of grass read directly from paint layer weightmaps of the landscape
+//
+//Weights of layers used by the expression are extracted per landscape component and cached together with ids of
+//weightmap textures of the component, so next update extracts again only components that were painted since.
+//Density is combined from cached weights on every lookup, so changing the expression needs no extraction.
+class FGrassLandscapeDensity {
+public:
+#if WITH_EDITOR
+	//Finds landscape of the world and extracts weights of changed components
+	//@param layers - density expression
+	//@return 0 if there is no landscape in the world or layer of the expression does not exist
+	int Update(UWorld* world, const TArray<FGrassDensityLayer>& layers);
+#endif
+
+	//@return density on world position (0 - 1), 0 outside of the landscape
+	float GetDensity(float x, float y) const;
+
+	//Forgets all extracted weights
+	void Empty();
+
+private:
+	struct FComponentWeights {
+		TArray<FGuid> weightmapIds;
+		//Weights of every extracted layer, (componentSizeQuads + 1)^2 values each
+		TArray<TArray<uint8>> layerWeights;
+	};
+
+	TWeakObjectPtr<ULandscapeInfo> landscapeInfo;
+	TArray<FGrassDensityLayer> expression;
+	//Layer of extracted weights used by every term of the expression
+	TArray<int> termLayers;
+	TArray<FName> extractedLayers;
+	TMap<FIntPoint, FComponentWeights> components;
+	FTransform landscapeToWorld;
+	int componentSizeQuads = 0;
+
+	//Bilinearly samples weight of extracted layer (0 - 1)
+	//@param localX, localY - position within component in quads
+	float SampleWeight(const FComponentWeights& weights, int layer, float localX, float localY) const;
+};
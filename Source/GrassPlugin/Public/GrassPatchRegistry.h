@@ -0,0 +1,81 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "GrassPatchRegistry.generated.h"
+
+class AGrassBlade;
+
+//Registry of grass patches (AGrassBlade actors) of one world
+//Patches register when components of their level get registered (level loaded or streamed in) and unregister when the level gets unloaded,
+//so grass can be split among streaming sublevels. Patches are indexed by level and by world aligned cells their grass covers.
+UCLASS()
+class GRASSPLUGIN_API UGrassPatchRegistry : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& collection) override;
+	virtual void Deinitialize() override;
+
+	//Adds the patch into the registry or updates its cells after its grass bounds changed
+	void RegisterGrassPatch(AGrassBlade* patch);
+
+	void UnregisterGrassPatch(AGrassBlade* patch);
+
+	//@return first grass patch of the level, null if the level has none
+	AGrassBlade* FindGrassPatch(const ULevel* level) const;
+
+	//@return grass patch whose grass covers cell of the location, null if there is none
+	UFUNCTION(BlueprintCallable, Category = "Grass")
+	AGrassBlade* FindGrassPatchAt(FVector location) const;
+
+	//@param patches - all registered grass patches of loaded levels
+	void GetGrassPatches(TArray<AGrassBlade*>& patches) const;
+
+	int Num() const { return patchCells.Num(); };
+
+private:
+	//Registered patches of every level
+	TMap<const ULevel*, TArray<TWeakObjectPtr<AGrassBlade>>> levelPatches;
+
+	//Registered patches of every cell
+	TMap<FIntPoint, TArray<TWeakObjectPtr<AGrassBlade>>> cellPatches;
+
+	//Cells every patch got registered into (rectangle of cells from min to max)
+	TMap<TWeakObjectPtr<AGrassBlade>, FIntRect> patchCells;
+
+	float cellSize = 10000;
+
+	FIntRect GetCells(const FBox& bounds) const;
+
+	void RemoveFromCells(AGrassBlade* patch, const FIntRect& cells);
+};
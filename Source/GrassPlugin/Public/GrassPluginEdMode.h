@@ -1,60 +1,75 @@
-// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
-//
-// Redistribution and use in source and binary forms, with or without
-// modification, are permitted provided that the following conditions are met:
-//
-//   1. Redistributions of source code must retain the above copyright notice,
-//      this list of conditions and the following disclaimer.
-//
-//   2. Redistributions in binary form must reproduce the above copyright notice,
-//      this list of conditions and the following disclaimer in the documentation
-//      and/or other materials provided with the distribution.
-//
-//   3. Neither the name of the copyright holder nor the names of its contributors
-//      may be used to endorse or promote products derived from this software
-//      without specific prior written permission.
-//
-// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
-// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
-// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
-// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
-// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
-// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
-// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
-// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
-// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
-// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
-// POSSIBILITY OF SUCH DAMAGE.
-
-#pragma once
-#if WITH_EDITOR
-#include "GrassRendering.h"
-
-#include "CoreMinimal.h"
-//#if WITH_EDITOR
-#include "EdMode.h"
-//#endif
-
-class FGrassPluginEdMode : public FEdMode
-{
-public:
-	const static FEditorModeID EM_GrassPluginEdModeId;
-public:
-	FGrassPluginEdMode();
-	virtual ~FGrassPluginEdMode();
-
-	// FEdMode interface
-	virtual void Enter() override;
-	virtual void Exit() override;
-	bool UsesToolkits() const override;
-	// End of FEdMode interface
-
-	UGrassRendering* edModeSettings;
-
-	UFUNCTION()
-	void ReloadEditorMode();
-
-	TSharedPtr<SWidget> ToolkitWidget;
-};
-
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#if WITH_EDITOR
+#include "GrassRendering.h"
+
+#include "CoreMinimal.h"
+//#if WITH_EDITOR
+#include "EdMode.h"
+//#endif
+
+class FGrassPluginEdMode : public FEdMode
+{
+public:
+	const static FEditorModeID EM_GrassPluginEdModeId;
+public:
+	FGrassPluginEdMode();
+	virtual ~FGrassPluginEdMode();
+
+	// FEdMode interface
+	virtual void Enter() override;
+	virtual void Exit() override;
+	bool UsesToolkits() const override;
+	virtual bool InputKey(FEditorViewportClient* ViewportClient, FViewport* Viewport, FKey Key, EInputEvent Event) override;
+	virtual bool MouseMove(FEditorViewportClient* ViewportClient, FViewport* Viewport, int32 x, int32 y) override;
+	virtual bool CapturedMouseMove(FEditorViewportClient* ViewportClient, FViewport* Viewport, int32 mouseX, int32 mouseY) override;
+	virtual bool DisallowMouseDeltaTracking() const override;
+	virtual void Render(const FSceneView* View, FViewport* Viewport, FPrimitiveDrawInterface* PDI) override;
+	// End of FEdMode interface
+
+	UGrassRendering* edModeSettings;
+
+	UFUNCTION()
+	void ReloadEditorMode();
+
+	TSharedPtr<SWidget> ToolkitWidget;
+
+private:
+	//Brush state
+	bool brushPainting = false;
+	bool brushVisible = false;
+	FVector brushLocation;
+	FVector lastDabLocation;
+
+	//Traces the scene under the mouse cursor and moves the brush onto the hit. Returns if anything was hit
+	bool UpdateBrushLocation(FEditorViewportClient* viewportClient, int32 mouseX, int32 mouseY);
+};
+
 #endif
\ No newline at end of file
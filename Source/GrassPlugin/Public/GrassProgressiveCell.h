@@ -0,0 +1,103 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GVar.h"
+
+#include "GrassProgressiveCell.generated.h"
+
+//Turfs of one world aligned cell stored in progressive order (any prefix of turfs is well distributed)
+USTRUCT()
+struct FGrassProgressiveCell {
+	GENERATED_BODY()
+public:
+	//Transforms of all blades of the cell, blades of one turf are stored next to each other
+	UPROPERTY()
+	TArray<FTransform> bladeTransforms;
+
+	//For every turf index after its last blade within bladeTransforms
+	UPROPERTY()
+	TArray<int32> turfBladeEnds;
+
+	//Grass model used for the blades of every turf
+	UPROPERTY()
+	TArray<EGPGrassShape> turfShapes;
+
+	//Index of clump instance manager of every turf (INDEX_NONE for turfs made of blades), clump turfs store their only
+	//transform within bladeTransforms
+	UPROPERTY()
+	TArray<int32> turfClumps;
+
+	UPROPERTY()
+	TArray<FTransform> billboardTransforms;
+
+	//For every turf index after its last billboard within billboardTransforms
+	UPROPERTY()
+	TArray<int32> turfBillboardEnds;
+
+	UPROPERTY()
+	TArray<FTransform> flowerTransforms;
+
+	//Kind of every flower within flowerTransforms
+	UPROPERTY()
+	TArray<EGPFlower> flowerKinds;
+
+	//For every turf index after its last flower within flowerTransforms
+	UPROPERTY()
+	TArray<int32> turfFlowerEnds;
+
+	//Center of every turf, erasing grass prunes turfs by their centers (cells stored before erasing was tracked have none)
+	UPROPERTY()
+	TArray<FVector2D> turfCenters;
+
+	//Bounds of turfCenters
+	UPROPERTY()
+	FBox2D turfBounds = FBox2D(ForceInit);
+
+	//Turfs removed by erasing grass, they keep their place in progressive order but never get spawned again
+	UPROPERTY()
+	TArray<bool> turfErased;
+
+	//Amount of leading turfs whose instances are spawned (INDEX_NONE for cells stored before it was tracked, the amount
+	//then follows turfDensity of the patch)
+	UPROPERTY()
+	int32 spawnedTurfs = INDEX_NONE;
+
+	int32 NumTurfs() const { return turfBladeEnds.Num(); };
+	bool HasTurfCenters() const { return turfCenters.Num() == turfBladeEnds.Num(); };
+	bool IsTurfErased(int32 turf) const { return turfErased.IsValidIndex(turf) && turfErased[turf]; };
+
+	SIZE_T GetAllocatedSize() const
+	{
+		return bladeTransforms.GetAllocatedSize() + turfBladeEnds.GetAllocatedSize() + turfShapes.GetAllocatedSize() +
+			turfClumps.GetAllocatedSize() + billboardTransforms.GetAllocatedSize() + turfBillboardEnds.GetAllocatedSize() +
+			flowerTransforms.GetAllocatedSize() + flowerKinds.GetAllocatedSize() + turfFlowerEnds.GetAllocatedSize() +
+			turfCenters.GetAllocatedSize() + turfErased.GetAllocatedSize();
+	};
+};
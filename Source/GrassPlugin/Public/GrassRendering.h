@@ -1,326 +1,703 @@
-// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
-//
-// Redistribution and use in source and binary forms, with or without
-// modification, are permitted provided that the following conditions are met:
-//
-//   1. Redistributions of source code must retain the above copyright notice,
-//      this list of conditions and the following disclaimer.
-//
-//   2. Redistributions in binary form must reproduce the above copyright notice,
-//      this list of conditions and the following disclaimer in the documentation
-//      and/or other materials provided with the distribution.
-//
-//   3. Neither the name of the copyright holder nor the names of its contributors
-//      may be used to endorse or promote products derived from this software
-//      without specific prior written permission.
-//
-// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
-// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
-// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
-// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
-// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
-// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
-// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
-// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
-// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
-// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
-// POSSIBILITY OF SUCH DAMAGE.
-
-#pragma once
-#include "CoreMinimal.h"
-#include "GrassBlade.h"
-#include "Containers/Array.h"
-#include "Math.h"
-#include "Runtime/Core/Public/Math/Quat.h"
-#include "EngineUtils.h"
-#include <vector>
-#include "cuda_poisson_lib.h"
-#include "GVar.h"
-
-
-#include "windows.h"
-
-#include "GameFramework/CharacterMovementComponent.h"
-
-#include "GrassRendering.generated.h"
-
- //Now becauase this is just a simulation of 2D array within Unreal environment, you need to be carefull with use
-	 // Ti. While accessing 2D array by grid[x][y] is possible. Replacing values this way is not
-USTRUCT()
-struct F2DVectorArray {
-	GENERATED_BODY()
-public:
-	TArray<FVector> array;
-
-	FVector operator[] (int32 i) {
-		return array[i];
-	}
-
-	void Add(FVector vec) {
-		array.Add(vec);
-	}
-
-	void Replace(int32 i, FVector value) {
-		if (array.IsValidIndex(i)) {
-			array.RemoveAt(i, 1, false);
-			array.Insert(value, i);
-		}
-	}
-};
-UCLASS()
-class GRASSPLUGIN_API UGrassRendering : public UObject
-{
-	GENERATED_BODY()
-public:
-	UGrassRendering();
-	
-	// Used to be able to invoke it
-#if WITH_EDITOR
-	FEditorModeID editorMode;
-#endif
-	FSimpleDelegate OnNewMapLoad;
-			
-	//TopLeft and botRight determine the plane within Unreal in which the grass gets spawned, in default x goes from negative to positive
-	//Created plane needs to be square
-	//TopLeft corner of the space where the grass should get generated (x needs to be negative)
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	FVector2D topLeftCorner = FVector2D(-1000, 1000);
-
-	//TopLeft and botRight determine the plane within Unreal in which the grass gets spawned, in default x goes from negative to positive
-	//Created plane needs to be square
-	//Bottom Right corner of the space where the grass should get generated (x needs to be positive)
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	FVector2D botRightCorner = FVector2D(1000, -1000);
-	
-	//Turns on adaptive sampling based on given texture
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	bool adaptiveSampling = false;
-
-	//Sets the density of grass spawned on positions coresponding to black pixels within the image
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "adaptiveSampling"))
-		int lowerThreshold = 10;
-	//Sets the density of grass spawned on positions coresponding to white pixels within the image (aside from completelly white which will leave space empty)
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "adaptiveSampling"))
-		int upperThreshold = 80;
-
-	//Name of greyscale texture in .png format that should serve as a density texture for adaptive sampling
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "adaptiveSampling"))
-		FString pictureName = "snow_tigerG";
-
-	//Allows to divide space on which we generate grass into multiple parts and generate only some
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "adaptiveSampling"))
-		bool divideIntoSmaller;
-
-	//Sets amount of parts the space should be divided into
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "adaptiveSampling"))
-		int amountOfParts = 9;
-	//Index of part of space that should be generated(0 to amountOfParts-1)
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "adaptiveSampling", UIMin = 0, ClampMin = 0))
-		int renderPart = 0;
-	
-	//Determines whether the ray should be send for every grass to be moved onto landscape/collision objects
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	bool shouldSnapToTerrain = true;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "No LOD"))
-	bool experimentalLODSystem = false;
-	
-	//Determines the default model used for the grass 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	EGPGrassShape grassShape = EGPGrassShape::Triangle;
-
-	//Determines the length of ray being shot from grass blade in both directions (understand total distance, not just in one direction)
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	int rayLength = 1200;
-
-	//In case of true, clears first the previous grass and then generates new one
-	//In case of false, generates new grass while keeping the previously generated grass
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-		bool overridePrevious = true;
-
-	//*** POISSON DISK ATTRIBUTES ***//
-	//Determines density of poisson disk sapling (higher number, less dense)
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-		float turfRadius = 10;
-
-	//Determines number of iterations needed to find other places within sapling (smaller is faster, but might leave spots empty)
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-		int poissonDiskTries = 30;
-
-	//Radius of where can be grass generated around turf origin (generated by poisson sapling)
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-		float turfGrassRadius = 2;
-
-	//Number of blades generated within turf
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-		int numOfBladesWithinTurf = 20;
-
-	//Helper function for initializing of materials
-	void InitMaterial(UMaterial*& mat, FString matLoc);
-
-	//Main spawn function that computes poissonDisk distribution (regular/adapted) and spawns grass
-	void SpawnGrassBladesInTurfs();
-	
-	//Changes the grass model on the fly based on the chosen variable
-	void RefreshGrassMode();
-
-	//Removes all the instances from grass instance managers
-	void ClearGrass();
-
-	//Checks whether GrassBlade instance manager is spawned within scene, and if not, it spawns one and sets the attributes properly
-	void SpawnPatchIfNotSpawned();
-
-protected:
-	bool spawned = false;
-
-	UMaterial* grassMaterial;
-	UMaterial* billboardMaterial;
-	
-	AGrassBlade* grassPatch;
-	// Divides the space into subspaces that can be handled by GPU
-	//@return param positions - array of positions 
-	//@param radius - max distance between positions
-	//@param maxTries - max amount of attempts in dart throwing in poisson disk sampling
-	//@param bounds - borders for sampling
-	void PoissonDiskForWholeBoundaries(std::vector<float>& positions, const int radius, const int maxTries,
-		const float bounds[]);
-	//Poisson Disk adaptive sampling variation
-	//@return param positions - array of positions 
-	//@return param radiusValues - array of max distances between positions created based on an image
-	//@return param imgH - height of image
-	//@return param imgW - width of image
-	//@param input - name of the input image (without the format sufix)
-	//@param maxTries - max amount of attempts in dart throwing in poisson disk sampling
-	//@param bounds - borders for sampling
-	//@param lowerThreshold - radius for positions coresponding to black pixels
-	//@param upperThreshold - radius for positions coresponding to white pixels (aside from complete white which remains empty)
-	void PoissonDiskForWholeBoundaries(std::vector<float>& positions, unsigned char* &radiusValues, unsigned& imgW, unsigned& imgH, std::string input, const int maxTries,
-		const float bounds[]);
-
-	// Divides the space into subspaces that can be handled by GPU and only part on index is generated
-	//for adaptive sampling only
-	//@return param positions - array of positions 
-	//@return param radiusValues - array of max distances between positions created based on an image
-	//@return param imgH - height of image
-	//@return param imgW - width of image
-	//@param input - name of the input image (without the format sufix)
-	//@param maxTries - max amount of attempts in dart throwing in poisson disk sampling
-	//@param bounds - borders for sampling
-	//@param lowerThreshold - radius for positions coresponding to black pixels
-	//@param upperThreshold - radius for positions coresponding to white pixels (aside from complete white which remains empty)
-	//@param index - index of part of the grass space that we want to generate
-	void PoissonDiskForPart(std::vector<float>& positions, unsigned char* &radValues, unsigned& imgW, unsigned& imgH, std::string input, const int maxTries, const float bounds[],
-		int index);
-
-	// Computes optimal squares within the segment (based on set subSpaceMaxWidth), adjusting smaller dimension to
-	// preserve subSquares
-	//@return param width - input width of space (can be adjusted within function)
-	//@return param height - input height of space (can be adjusted within function)  
-	//@return param xSegments - amount of segments in x axis 
-	//@return param ySegments - amount of segments in y axis 
-	//@return param segmentSize - width/height(they are equal) of the segment
-	int DetermineAmountOfSegments(float& width, float& height, int& xSegments, int& ySegments, float& segmentSize);
-
-	// Recomputes subbounds for underlying segment 
-	//@param bounds - borders of space
-	//@return param subBounds - borders of computed subspace
-	//@param xIdx - index of subspace on x axis
-	//@param yIdx - index of subspace on y axis
-	//@param xSegments - amount of segments in x axis
-	//@param ySegments - amount of segments in y axis
-	//@param segmentSize - size of segment
-	void CreateSubBounds(const float bounds[], float subBounds[], int xIdx, int yIdx, int xSegments, int ySegments, float segmentSize);
-
-	//creates a notification window about an error within Unreal
-	//@param title - Title of the error message
-	//@param message - message that gets written to user
-	void GenerateErrorMessage(const FString& title, const FString& message);
-
-	//creates a warning popup window (gives options Ok and Cancel)
-	//@param title - Title of the warning message
-	//@param message - message that gets written to user
-	EAppReturnType::Type GenerateWarningMessage(const FString& title, const FString& message);
-
-	//***Helper functions***
-
-	//Generate positions in given spacial domain using class attributes
-	//@return param positions - returns generated positions by poissonSampling
-	//@return param radValues - if adaptiveSampling is turned on, returns pointer to image pixel array
-	//@return param imgW - if adaptiveSampling is turned on, returns image width
-	//@return param imgH - if adaptiveSampling is turned on, returns image height
-	//@param bounds - determines spacial domain for which we want to generate positions
-	int GeneratePositions(std::vector<float> &positions, unsigned char* &radValues, unsigned &imgW, unsigned &imgH, const float bounds[]);
-
-	//Spawn one turf
-	//@param xCoord - coordinates on x axis where to place center of turf
-	//@param yCoord - coordinates on y axis where to place center of turf
-	//@param radValues - pointer to array with image pixel values for adaptive sampling
-	//@param imgW - image width used for adaptive sampling
-	//@param imgH - image height used for adaptive sampling
-	//@param bounds - determines spacial domain for which we want to generate positions
-	int SpawnTurf(float xCoord, float yCoord, unsigned char* radValues, unsigned imgW, unsigned imgH, const float bounds[]);
-
-	//Check that bounds are square
-	int CheckBounds();
-
-	//Check if amount of generated positions is within limit set in configuration file
-	int CheckInstanceLimit(int amountOfPositions);
-
-	//Checks if RAM barrier is set. If so checks that RAM performance doesnt go over set limit
-	int CheckRAMLimit();
-
-	int ComputeSegmentsVal(int oneDSize);
-
-	float2 FormFloat2(float x, float y);
-	float4 FormFloat4(float x, float y, float z, float w);
-	
-	unsigned long long getTotalSystemMemory()
-	{
-		MEMORYSTATUSEX status;
-		status.dwLength = sizeof(status);
-		GlobalMemoryStatusEx(&status);
-		return status.ullTotalPhys;
-	}
-
-	//Functions to get information about system operations
-	int GetTotalRAM();
-
-	int GetAvailRAM();
-
-	int GetTotalMemory();
-
-	int GetAvailMemory();
-
-//************************************************
-//*********USABLE FUNCTIONS (not active)**********
-//************************************************
-	//crude and simple implementation of poisson disk sampling (not used anymore) and helper functions
-	TArray<FVector> poissonDiskSampling(int radius, int k, FVector4 bounds);
-	void InsertPointToGrid(FVector point, float cellsize, int gWidth, int gHeight);
-	// Validity is determined by being within bounds and further than radius from neighbouring points within the grid 
-	bool IsValidPoint(int cellsize, int gwidth, int gheight, FVector p, int radius, int width, int height);
-	bool PointWithinBounds(FVector p, int width, int height);
-
-public:
-	//*** RANDOM DISTRIBUTION ATTRIBUTES ***//
-//Square roots
-/*UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	int amountOfGrassSquareRooted = 150;*/
-
-	//density (if poisson sampling not used)
-	/*UPROPERTY(EditAnywhere, BlueprintReadWrite)
-		int density = 2;*/
-
-	//Generates random x, y coordinates in bounds and spawns the grass there
-	//Just simple temporary implementation (currently not usedf)
-	void SpawnGrassBladesCompletelyRandDistr();
-
-	//If true generated grass based on poisson disk otherwise just randomly
-	//UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	bool poissonDisk = true;
-private:
-	UPROPERTY()
-	TArray<FVector> grid;
-
-	
-};
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include "CoreMinimal.h"
+#include "GrassBlade.h"
+#include "Containers/Array.h"
+#include "Math.h"
+#include "Runtime/Core/Public/Math/Quat.h"
+#include "EngineUtils.h"
+#include <vector>
+#include "cuda_poisson_lib.h"
+#include "PoissonTileSet.h"
+#include "ProgressiveSampling.h"
+#include "BrushSampling.h"
+#include "GrassLandscapeDensity.h"
+#include "GrassExclusionVolume.h"
+#include "GrassBakeRegion.h"
+#include "GrassBakeShards.h"
+#include "SamplingTuner.h"
+#include "BlueNoiseSampling.h"
+#include "JitteredGrid.h"
+#include "PointCloud.h"
+#include "GrassUndo.h"
+#include "GVar.h"
+
+
+#include "windows.h"
+
+#include "GameFramework/CharacterMovementComponent.h"
+
+#include "GrassRendering.generated.h"
+
+ //Now becauase this is just a simulation of 2D array within Unreal environment, you need to be carefull with use
+	 // Ti. While accessing 2D array by grid[x][y] is possible. Replacing values this way is not
+USTRUCT()
+struct F2DVectorArray {
+	GENERATED_BODY()
+public:
+	TArray<FVector> array;
+
+	FVector operator[] (int32 i) {
+		return array[i];
+	}
+
+	void Add(FVector vec) {
+		array.Add(vec);
+	}
+
+	void Replace(int32 i, FVector value) {
+		if (array.IsValidIndex(i)) {
+			array.RemoveAt(i, 1, false);
+			array.Insert(value, i);
+		}
+	}
+};
+UCLASS()
+class GRASSPLUGIN_API UGrassRendering : public UObject
+{
+	GENERATED_BODY()
+public:
+	UGrassRendering();
+	
+	// Used to be able to invoke it
+#if WITH_EDITOR
+	FEditorModeID editorMode;
+#endif
+	FSimpleDelegate OnNewMapLoad;
+			
+	//TopLeft and botRight determine the plane within Unreal in which the grass gets spawned, in default x goes from negative to positive
+	//Created plane needs to be square
+	//TopLeft corner of the space where the grass should get generated (x needs to be negative)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FVector2D topLeftCorner = FVector2D(-1000, 1000);
+
+	//TopLeft and botRight determine the plane within Unreal in which the grass gets spawned, in default x goes from negative to positive
+	//Created plane needs to be square
+	//Bottom Right corner of the space where the grass should get generated (x needs to be positive)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FVector2D botRightCorner = FVector2D(1000, -1000);
+
+	//Generates grass only within GrassBakeRegion actors (and selected landscape components) instead of topLeftCorner/botRightCorner square
+	//Regions are always filled with poisson tiles (turfRadius, or landscape density with adaptive sampling)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool useBakeRegions = false;
+
+	//Adds landscape components selected in landscape mode into bake regions
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "useBakeRegions"))
+	bool bakeSelectedLandscapeComponents = false;
+
+	//Spawns turfs from binary point cloud (pointCloudPath) instead of sampling positions
+	//Cloud is written by exportPointCloud or by external scatter tools (format is described in ThirdParty/GrassCore/Includes/PointCloud.h)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool usePointCloud = false;
+
+	//Writes sampled turf positions with their density and seeds into pointCloudPath, so respawning grass can skip sampling
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "!usePointCloud"))
+	bool exportPointCloud = false;
+
+	//Point cloud file (relative to project directory)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FString pointCloudPath = "Saved/GrassPlugin/Turfs.gpcl";
+	
+	//Turns on adaptive sampling based on given texture
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool adaptiveSampling = false;
+
+	//Sets the density of grass spawned on positions coresponding to black pixels within the image
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "adaptiveSampling"))
+		int lowerThreshold = 10;
+	//Sets the density of grass spawned on positions coresponding to white pixels within the image (aside from completelly white which will leave space empty)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "adaptiveSampling"))
+		int upperThreshold = 80;
+
+	//Name of greyscale texture in .png format that should serve as a density texture for adaptive sampling
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "adaptiveSampling"))
+		FString pictureName = "snow_tigerG";
+
+	//Density of adaptive sampling is read from density texture (pictureName) or from paint layers of the landscape (densityLayers)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "adaptiveSampling"))
+		EGPDensitySource densitySource = EGPDensitySource::Texture;
+
+	//Expression combining weights of landscape paint layers into density (full density uses lowerThreshold, no density leaves space empty)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "adaptiveSampling"))
+		TArray<FGrassDensityLayer> densityLayers;
+
+	//Positions are emitted where density exceeds tiled blue noise threshold mask instead of adaptive poisson sampling
+	//Cost is proportional to area / lowerThreshold^2 and runs in parallel on CPU, but spacing is less even (fast previews, billboard layers)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "adaptiveSampling"))
+		bool blueNoiseThreshold = false;
+
+	//Allows to divide space on which we generate grass into multiple parts and generate only some
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "adaptiveSampling"))
+		bool divideIntoSmaller;
+
+	//Sets amount of parts the space should be divided into
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "adaptiveSampling"))
+		int amountOfParts = 9;
+	//Index of part of space that should be generated(0 to amountOfParts-1)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "adaptiveSampling", UIMin = 0, ClampMin = 0))
+		int renderPart = 0;
+	
+	//Determines whether the ray should be send for every grass to be moved onto landscape/collision objects
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool shouldSnapToTerrain = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "No LOD"))
+	bool experimentalLODSystem = false;
+
+	//Amount of turfs represented by one billboard of grass LOD. Higher than 1 clusters nearby turfs into one bigger billboard
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (UIMin = 1, ClampMin = 1))
+	int turfsPerBillboard = 1;
+
+	//Distance from splines of actors tagged grassExclude in which no grass gets generated
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (UIMin = 0, ClampMin = 0))
+	float exclusionSplineRadius = 300;
+	
+	//Determines the default model used for the grass 
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	EGPGrassShape grassShape = EGPGrassShape::Triangle;
+
+	//Mixes all grass models within one generating. Model of every turf is chosen based on weights of the models
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool mixGrassShapes = false;
+
+	//Weight of Quad model when mixing grass models
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "mixGrassShapes", UIMin = 0, ClampMin = 0))
+	float quadShapeWeight = 1;
+
+	//Weight of Triangle model when mixing grass models
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "mixGrassShapes", UIMin = 0, ClampMin = 0))
+	float triangleShapeWeight = 1;
+
+	//Weight of TriangleQuad model when mixing grass models
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "mixGrassShapes", UIMin = 0, ClampMin = 0))
+	float triangleQuadShapeWeight = 1;
+
+	//With adaptive sampling the density texture chooses the model instead of random (darker pixels pick models from the start of the list)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "mixGrassShapes"))
+	bool shapeFromDensity = false;
+
+	//Determines the length of ray being shot from grass blade in both directions (understand total distance, not just in one direction)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int rayLength = 1200;
+
+	//In case of true, clears first the previous grass and then generates new one
+	//In case of false, generates new grass while keeping the previously generated grass
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+		bool overridePrevious = true;
+
+	//*** POISSON DISK ATTRIBUTES ***//
+	//Determines density of poisson disk sapling (higher number, less dense)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (UIMin = 1, ClampMin = 1))
+		float turfRadius = 10;
+
+	//Determines number of iterations needed to find other places within sapling (smaller is faster, but might leave spots empty)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+		int poissonDiskTries = 30;
+
+	//Radius of where can be grass generated around turf origin (generated by poisson sapling)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+		float turfGrassRadius = 2;
+
+	//Number of blades generated within turf
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+		int numOfBladesWithinTurf = 20;
+
+	//Places every turf as one instance of prebuilt clump mesh (numOfBladesWithinTurf blades merged into one mesh) instead of one instance per blade
+	//Clump meshes are built from grass models once per attributes and kept in clumpMeshFolder set in configuration file
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+		bool useTurfClumps = false;
+
+	//Amount of different clump meshes (blade layouts) per grass model
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "useTurfClumps", UIMin = 1, ClampMin = 1))
+		int clumpVariants = 4;
+
+	//Fills the space with precomputed tileable poisson disk tiles instead of sampling every segment from scratch (regular sampling only)
+	//Tiles are generated once per turfRadius and cached in Saved/GrassPlugin folder of the project
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+		bool usePoissonTiles = false;
+
+	//Seed of deterministic samplers (changes the layout of poisson tiles and jittered grid)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+		int samplingSeed = 0;
+
+	//If true grass is generated in turfs placed by poisson disk, otherwise sole blades are placed by jittered grid
+	//Jittered grid is much cheaper, but neighbouring blades can get close to each other
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+		bool poissonDisk = true;
+
+	//Amount of grass blades per square meter placed by jittered grid (one blade in every cell of the grid)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "!poissonDisk", ClampMin = "0.01", ClampMax = "400"))
+		float jitteredGridDensity = 25;
+
+	//How far can blade move from center of its grid cell (0 - regular grid, 1 - anywhere within the cell)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "!poissonDisk", ClampMin = "0", ClampMax = "1"))
+		float gridJitter = 0.8f;
+
+	//Orders turfs of every cell progressively, so density of already generated grass can be changed by turfDensity without regenerating
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+		bool progressiveSampling = false;
+
+	//Fraction of progressively generated turfs that get spawned (0 - 1). Change is applied immediately without regenerating
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "progressiveSampling", UIMin = 0, ClampMin = 0, UIMax = 1, ClampMax = 1))
+		float turfDensity = 1;
+
+	//*** BRUSH ATTRIBUTES ***//
+	//Action of the brush in the viewport (hold left mouse button to paint, alt keeps moving the camera)
+	//Paint samples turfs with turfRadius under the brush keeping distance from existing turfs, Erase removes all grass under the brush
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+		EGPBrushMode brushMode = EGPBrushMode::None;
+
+	//Radius of the brush
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (UIMin = 1, ClampMin = 1))
+		float brushRadius = 200;
+
+	//*** FLOWER ATTRIBUTES ***//
+	//Spawns flowers within some of the turfs
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+		bool spawnFlowers = false;
+
+	//Kind of flowers spawned within turfs (Mixed picks kind randomly for every flower)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "spawnFlowers"))
+		EGPFlower flowerKind = EGPFlower::Mixed;
+
+	//Probability that turf contains flowers
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "spawnFlowers", UIMin = 0, ClampMin = 0, UIMax = 1, ClampMax = 1))
+		float flowerTurfChance = 0.05f;
+
+	//Minimal amount of flowers within turf with flowers
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "spawnFlowers", UIMin = 0, ClampMin = 0))
+		int minFlowersInTurf = 1;
+
+	//Maximal amount of flowers within turf with flowers
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "spawnFlowers", UIMin = 0, ClampMin = 0))
+		int maxFlowersInTurf = 3;
+
+	//Distance from turf center in which flowers get placed
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "spawnFlowers", UIMin = 0, ClampMin = 0))
+		float innerFlowerRadius = 4;
+
+	//Weight of amount of flowers (0 - minimal amount is more likely, 2 - maximal amount is more likely)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "spawnFlowers", UIMin = 0, ClampMin = 0, UIMax = 2, ClampMax = 2))
+		float flowerSpawnWeight = 1;
+
+	//Helper function for initializing of materials
+	void InitMaterial(UMaterial*& mat, FString matLoc);
+
+	//Main spawn function that computes poissonDisk distribution (regular/adapted) and spawns grass
+	void SpawnGrassBladesInTurfs();
+
+	//Spawns sole grass blades placed by jittered grid within bounds (used when poissonDisk is off)
+	//Blocks of grid rows are generated and snapped in parallel and every block is added to instance managers in one batch
+	void SpawnGrassBladesInJitteredGrid();
+	
+	//Changes the grass model on the fly based on the chosen variable
+	void RefreshGrassMode();
+
+	//Applies turfDensity to progressively generated grass
+	void RefreshTurfDensity();
+
+	//Removes all the instances from grass instance managers
+	void ClearGrass();
+
+	//Generates grass by chosen distribution (poissonDisk turfs or jittered grid), previous grass is cleared if overridePrevious is set
+	void GenerateGrass();
+
+	//Starts recording of grass operation for undo, turf random stream gets seeded so the operation can be repeated on redo
+	void BeginGrassOperation(EGPGrassOperation operation);
+
+	//Stores recorded grass operation into undo buffer of the editor (operations that changed nothing are dropped)
+	void EndGrassOperation();
+
+	//Repeats recorded grass operation with its settings and seeds (redo), changes get recorded into the delta
+	void RepeatGrassOperation(const FGrassOperationRecord& record, FGrassDelta& delta);
+
+	//Reverts changes of grass operation (undo)
+	void RevertGrassOperation(FGrassDelta& delta);
+
+	bool HasGrassPatch() const { return grassPatch != NULL; };
+
+	//Prepares grass patch for brush stroke (applies settings and prepares clump meshes) and starts recording of the stroke
+	//Returns success of operation
+	int BeginBrushStroke();
+
+	//Paints or erases grass under the brush (based on brushMode), new turfs are added into the scene in one batch
+	//@param location - center of the brush
+	void ApplyBrush(FVector location);
+
+	//Stores brush stroke into undo buffer of the editor
+	void EndBrushStroke();
+
+	//Checks whether GrassBlade instance manager is spawned within scene, and if not, it spawns one and sets the attributes properly
+	void SpawnPatchIfNotSpawned();
+
+	//Sets world the grass gets generated into instead of world of level viewport (used by GrassBake commandlet)
+	void SetBakeWorld(UWorld* world) { bakeWorld = world; };
+
+	//Returns edited properties as text (one name=value line per property), used to hand the settings over to bake workers
+	FString ExportBakeSettings() const;
+
+	//Applies properties exported by ExportBakeSettings. Returns success of operation
+	int ImportBakeSettings(const FString& settings);
+
+	//Prepares generating of separate cells for sharded bake (poisson tiles or landscape density only). Returns success of operation
+	int PrepareShardedBake();
+
+	//Returns world aligned cells (of grassCellSize) covered by the bake, sorted by their coordinates
+	void GetBakeCells(TArray<FIntPoint>& cells);
+
+	//Generates turfs of one cell (returned by GetBakeCells) into batch without spawning them
+	//Blades of the cell are the same no matter which shard generates it
+	//@return param bakedCell - cell with generated instances and turf centers
+	int BakeCell(FIntPoint cell, FGrassBakeCell& bakedCell);
+
+	//Spawns instances of baked cell into grass patch (the cell gets emptied)
+	void CommitBakedCell(FGrassBakeCell& bakedCell);
+
+protected:
+	bool spawned = false;
+
+	UMaterial* grassMaterial;
+	UMaterial* billboardMaterial;
+	
+	AGrassBlade* grassPatch;
+
+	UWorld* bakeWorld = nullptr;
+	// Divides the space into subspaces that can be handled by GPU
+	//@return param positions - array of positions 
+	//@param radius - max distance between positions
+	//@param maxTries - max amount of attempts in dart throwing in poisson disk sampling
+	//@param bounds - borders for sampling
+	void PoissonDiskForWholeBoundaries(std::vector<float>& positions, const int radius, const int maxTries,
+		const float bounds[]);
+	//Poisson Disk adaptive sampling variation
+	//@return param positions - array of positions 
+	//@return param radiusValues - array of max distances between positions created based on an image
+	//@return param imgH - height of image
+	//@return param imgW - width of image
+	//@param input - name of the input image (without the format sufix)
+	//@param maxTries - max amount of attempts in dart throwing in poisson disk sampling
+	//@param bounds - borders for sampling
+	//@param lowerThreshold - radius for positions coresponding to black pixels
+	//@param upperThreshold - radius for positions coresponding to white pixels (aside from complete white which remains empty)
+	void PoissonDiskForWholeBoundaries(std::vector<float>& positions, unsigned char* &radiusValues, unsigned& imgW, unsigned& imgH, std::string input, const int maxTries,
+		const float bounds[]);
+
+	// Divides the space into subspaces that can be handled by GPU and only part on index is generated
+	//for adaptive sampling only
+	//@return param positions - array of positions 
+	//@return param radiusValues - array of max distances between positions created based on an image
+	//@return param imgH - height of image
+	//@return param imgW - width of image
+	//@param input - name of the input image (without the format sufix)
+	//@param maxTries - max amount of attempts in dart throwing in poisson disk sampling
+	//@param bounds - borders for sampling
+	//@param lowerThreshold - radius for positions coresponding to black pixels
+	//@param upperThreshold - radius for positions coresponding to white pixels (aside from complete white which remains empty)
+	//@param index - index of part of the grass space that we want to generate
+	void PoissonDiskForPart(std::vector<float>& positions, unsigned char* &radValues, unsigned& imgW, unsigned& imgH, std::string input, const int maxTries, const float bounds[],
+		int index);
+
+	// Fills the whole space with precomputed poisson tiles (constant radius only)
+	//@return param positions - array of positions 
+	//@param bounds - borders for sampling
+	void PoissonTilesForWholeBoundaries(std::vector<float>& positions, const float bounds[]);
+
+	// Makes sure poisson tiles for given radius are ready. Tiles are loaded from cache file, or generated and cached if file does not exist
+	//@param radius - max distance between positions
+	//@param maxTries - max amount of attempts in dart throwing in poisson disk sampling
+	int PreparePoissonTiles(const float radius, const int maxTries);
+
+	// Makes sure clump meshes of used grass models are ready and hands them to grass patch. Clump meshes are loaded from
+	// clumpMeshFolder, or built from the blade meshes if they do not exist
+	int PrepareClumpMeshes();
+
+	// Returns path of cache file of poisson tiles for given radius
+	FString GetPoissonTilesCachePath(const float radius, int tileSizeInRadii, int variants);
+
+	grassSampling::PoissonTileSet poissonTiles;
+
+	// Fills the space with positions of radius given by landscape density (densest poisson tiles thinned by the density)
+	//@return param positions - array of positions
+	//@param bounds - borders for sampling
+	int LandscapeDensityForWholeBoundaries(std::vector<float>& positions, const float bounds[]);
+
+	// Reads changed weightmaps of landscape used by densityLayers. Returns success of operation
+	int UpdateLandscapeDensity();
+
+	// Radius of the densest grass of adaptive sampling
+	float GetMinAdaptiveRadius() const;
+
+	// Accepts candidates with radius given by landscape density on their position
+	//@param candidates - densest candidates (get reordered)
+	//@return param positions - accepted positions get appended
+	void ThinByLandscapeDensity(std::vector<float>& candidates, std::vector<float>& positions);
+
+	// Fills bake regions with positions, only tiles covered by the regions get sampled
+	//@return param positions - array of positions
+	int BakeRegionPositions(std::vector<float>& positions);
+
+	// Gathers bake regions into bakeMask. Returns success of operation
+	int BuildBakeMask();
+
+	grassSampling::CoverageMask bakeMask;
+
+	// Emits positions on pixels of lowerThreshold spacing where density (texture or landscape) exceeds blue noise threshold
+	//@return param positions - array of positions
+	//@param bounds - borders for sampling
+	int BlueNoiseForWholeBoundaries(std::vector<float>& positions, const float bounds[]);
+
+	// Decodes density texture into densityImage (as greyscale). Returns success of operation
+	int LoadDensityImage(const FString& path);
+
+	//@return value of pixel of decoded density texture on the position (0 - dense, 255 - empty), texture covers the bounds
+	//with first row at topLeftCorner
+	int GetDensityImagePixel(float xCoord, float yCoord, const float bounds[]) const;
+
+	TArray<uint8> densityImage;
+	int densityImageWidth = 0;
+	int densityImageHeight = 0;
+
+	grassSampling::BlueNoiseMask blueNoiseMask;
+
+	//Cells of sharded bake only partially covered by bake regions
+	TSet<FIntPoint> partialBakeCells;
+
+	//@return value of pixel of density texture corresponding to landscape density on the position (0 - dense, 255 - empty)
+	int GetLandscapeDensityPixel(float xCoord, float yCoord) const;
+
+	FGrassLandscapeDensity landscapeDensity;
+
+	// Gathers exclusion volumes and tagged actors of the edited world, sampled positions inside of them get rejected
+	void GatherExclusions();
+
+	FGrassExclusionsPtr exclusions;
+
+	// Returns world edited by the editor mode (world of the game outside of editor)
+	UWorld* GetEditedWorld() const;
+
+	// Computes optimal squares within the segment (based on set subSpaceMaxWidth), adjusting smaller dimension to
+	// preserve subSquares
+	//@return param width - input width of space (can be adjusted within function)
+	//@return param height - input height of space (can be adjusted within function)  
+	//@return param xSegments - amount of segments in x axis 
+	//@return param ySegments - amount of segments in y axis 
+	//@return param segmentSize - width/height(they are equal) of the segment
+	int DetermineAmountOfSegments(float& width, float& height, int& xSegments, int& ySegments, float& segmentSize);
+
+	// Recomputes subbounds for underlying segment 
+	//@param bounds - borders of space
+	//@return param subBounds - borders of computed subspace
+	//@param xIdx - index of subspace on x axis
+	//@param yIdx - index of subspace on y axis
+	//@param xSegments - amount of segments in x axis
+	//@param ySegments - amount of segments in y axis
+	//@param segmentSize - size of segment
+	void CreateSubBounds(const float bounds[], float subBounds[], int xIdx, int yIdx, int xSegments, int ySegments, float segmentSize);
+
+	//creates a notification window about an error within Unreal
+	//@param title - Title of the error message
+	//@param message - message that gets written to user
+	void GenerateErrorMessage(const FString& title, const FString& message);
+
+	//creates a warning popup window (gives options Ok and Cancel)
+	//@param title - Title of the warning message
+	//@param message - message that gets written to user
+	EAppReturnType::Type GenerateWarningMessage(const FString& title, const FString& message);
+
+	//***Helper functions***
+
+	//Generate positions in given spacial domain using class attributes
+	//@return param positions - returns generated positions by poissonSampling
+	//@return param radValues - if adaptiveSampling is turned on, returns pointer to image pixel array
+	//@return param imgW - if adaptiveSampling is turned on, returns image width
+	//@return param imgH - if adaptiveSampling is turned on, returns image height
+	//@param bounds - determines spacial domain for which we want to generate positions
+	int GeneratePositions(std::vector<float> &positions, unsigned char* &radValues, unsigned &imgW, unsigned &imgH, const float bounds[]);
+
+	//Spawn one turf
+	//@param xCoord - coordinates on x axis where to place center of turf
+	//@param yCoord - coordinates on y axis where to place center of turf
+	//@param radValues - pointer to array with image pixel values for adaptive sampling
+	//@param imgW - image width used for adaptive sampling
+	//@param imgH - image height used for adaptive sampling
+	//@param bounds - determines spacial domain for which we want to generate positions
+	//@return param batch - batch the turf gets generated into
+	int SpawnTurf(float xCoord, float yCoord, unsigned char* radValues, unsigned imgW, unsigned imgH, const float bounds[], FGrassSpawnBatch& batch);
+
+	//Computes amount of blades, radius and grass model of turf on given coordinates (attributes same as SpawnTurf)
+	//@return param numOfGrass - amount of blades within turf
+	//@return param radOfTurf - radius of turf
+	//@return param shape - grass model of the turf
+	int ComputeTurfAttributes(float xCoord, float yCoord, unsigned char* radValues, unsigned imgW, unsigned imgH, const float bounds[], int& numOfGrass, int& radOfTurf, EGPGrassShape& shape);
+
+	//Reads pixel value of density of adaptive sampling on given coordinates (0 when adaptive sampling is off, attributes same as SpawnTurf)
+	//@return param rad - pixel value 0 - 255 (0 is the densest)
+	int GetTurfPixel(float xCoord, float yCoord, unsigned char* radValues, unsigned imgW, unsigned imgH, const float bounds[], int& rad);
+
+	//Computes turf attributes from pixel value of density (outputs same as ComputeTurfAttributes)
+	//@param adaptive - should the pixel value scale amount of blades and radius of turf?
+	void TurfAttributesForPixel(float xCoord, float yCoord, int rad, bool adaptive, int& numOfGrass, int& radOfTurf, EGPGrassShape& shape);
+
+	//Spawns turfs from point cloud file in pointCloudPath (memory mapped). Returns success of operation
+	int SpawnPointCloudFile();
+
+	//Writes sampled positions into point cloud file in pointCloudPath with density (adaptive sampling) and seed of every turf
+	//Returns success of operation
+	//@return param data - serialized point cloud, turfs can be spawned from it the same way as from the file
+	int ExportPointCloud(const std::vector<float>& positions, unsigned char* radValues, unsigned imgW, unsigned imgH, const float bounds[], std::vector<uint8_t>& data);
+
+	//Spawns turf of every point of the cloud in batches (points inside of grass exclusions are skipped)
+	void SpawnPointCloudTurfs(const grassSampling::PointCloudView& cloud);
+
+	//Spawn turf of point of the cloud, points with height are placed without snapping
+	//@param index - index of the point
+	//@return param batch - batch the turf gets generated into
+	void SpawnCloudTurf(const grassSampling::PointCloudView& cloud, size_t index, FGrassSpawnBatch& batch);
+
+	//@return absolute path of pointCloudPath
+	FString GetPointCloudFilePath() const;
+
+	//Chooses grass model of turf (either grassShape, or one of the models based on weights if mixGrassShapes is on)
+	//@param xCoord - coordinates on x axis of center of turf
+	//@param yCoord - coordinates on y axis of center of turf
+	//@param rad - pixel value of density texture on turf position (used with shapeFromDensity)
+	EGPGrassShape ChooseTurfShape(float xCoord, float yCoord, int rad);
+
+	//Orders positions progressively by cells and stores the turfs into progressive cells of grass patch, then spawns them based on turfDensity
+	//@param positions - generated positions
+	//@param radValues - pointer to array with image pixel values for adaptive sampling
+	//@param imgW - image width used for adaptive sampling
+	//@param imgH - image height used for adaptive sampling
+	//@param bounds - determines spacial domain for which we want to generate positions
+	int SpawnProgressiveTurfs(std::vector<float>& positions, unsigned char* radValues, unsigned imgW, unsigned imgH, const float bounds[]);
+
+	//Hands the attributes of generating (ray length, LOD, flowers, billboard clustering) to grass patch
+	void ApplyPatchSettings();
+
+	//Check that bounds are square
+	int CheckBounds();
+
+	//Check if amount of generated positions is within limit set in configuration file
+	int CheckInstanceLimit(int amountOfPositions);
+
+	//Checks if RAM barrier is set. If so checks that RAM performance doesnt go over set limit
+	int CheckRAMLimit();
+
+	//Gathers flower attributes for grass patch
+	FGrassFlowerSettings GetFlowerSettings() const;
+
+	int ComputeSegmentsVal(int oneDSize);
+
+	// Measures probe segments of GPU sampling and sets segment size from the measurements. With divideIntoSmaller only the
+	// first part (renderPart 0) is tuned and may raise amountOfParts, later parts of the same bounds keep its split.
+	// Chosen parameters are appended into bake log. Returns 0 if tuning was skipped (subSpaceMaxWidth is used)
+	//@param input - density image of adaptive sampling (empty for constant radius)
+	//@param bounds - borders for sampling
+	int AutoTuneSampling(const std::string& input, const float bounds[]);
+
+	// Samples first of given amount of segments, measuring its time and peak GPU memory
+	//@return param positions, radValues, imgW, imgH - output of the sampler (kept if the probe gets reused)
+	grassSampling::SamplingProbe MeasureProbe(const std::string& input, const float bounds[], int segments, std::vector<float>& positions,
+		unsigned char*& radValues, unsigned& imgW, unsigned& imgH);
+
+	// Appends positions of reused probe instead of sampling the segment, if the probe sampled exactly given sub bounds
+	// Reused probe is released in any case, so it can not be taken by later sampling
+	//@return if the probe was taken
+	int TakeReusedProbe(std::vector<float>& positions, unsigned char*& radValues, unsigned& imgW, unsigned& imgH, const float subBounds[]);
+	void ReleaseReusedProbe();
+
+	// Appends line with time stamp into Saved/GrassPlugin/BakeLog.txt
+	void WriteBakeLog(const FString& line);
+
+	grassSampling::SamplingTuner samplingTuner;
+
+	// Segment width chosen by AutoTuneSampling (0 - subSpaceMaxWidth is used)
+	float tunedSegmentWidth = 0;
+
+	// Bounds and segment width tuned for renderPart 0 of divideIntoSmaller bake, reused by its later parts
+	FBox2D tunedPartBounds = FBox2D(ForceInit);
+	float tunedPartSegmentWidth = 0;
+
+	// Output of probe whose segment is the first segment of following sampling (reusedProbeBounds are its sub bounds)
+	std::vector<float> reusedProbePositions;
+	unsigned char* reusedProbeRadValues = 0;
+	unsigned reusedProbeImgW = 0, reusedProbeImgH = 0;
+	float reusedProbeBounds[4];
+	bool hasReusedProbe = false;
+
+	float2 FormFloat2(float x, float y);
+	float4 FormFloat4(float x, float y, float z, float w);
+	
+	unsigned long long getTotalSystemMemory()
+	{
+		MEMORYSTATUSEX status;
+		status.dwLength = sizeof(status);
+		GlobalMemoryStatusEx(&status);
+		return status.ullTotalPhys;
+	}
+
+	//Functions to get information about system operations
+	int GetTotalRAM();
+
+	int GetAvailRAM();
+
+	int GetTotalMemory();
+
+	int GetAvailMemory();
+
+//************************************************
+//*********USABLE FUNCTIONS (not active)**********
+//************************************************
+	//crude and simple implementation of poisson disk sampling (not used anymore) and helper functions
+	TArray<FVector> poissonDiskSampling(int radius, int k, FVector4 bounds);
+	void InsertPointToGrid(FVector point, float cellsize, int gWidth, int gHeight);
+	// Validity is determined by being within bounds and further than radius from neighbouring points within the grid 
+	bool IsValidPoint(int cellsize, int gwidth, int gheight, FVector p, int radius, int width, int height);
+	bool PointWithinBounds(FVector p, int width, int height);
+
+private:
+	UPROPERTY()
+	TArray<FVector> grid;
+
+	//Grass operation being recorded for undo
+	TUniquePtr<FGrassOperationChange> currentOperation;
+
+	//Random stream of turfs generated by grass operation, seeded from the seed of its record, so redo generates the same grass
+	FRandomStream turfStream;
+
+	//Prepares grass patch for brush stroke without recording it. Returns success of operation
+	int PrepareBrushStroke();
+
+	//Applies one dab of the brush with random stream seeded by given seed
+	void ApplyBrushDab(FVector location, int32 seed);
+
+	
+};
@@ -0,0 +1,217 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EngineMinimal.h"
+#include "Runtime/Engine/Classes/GameFramework/Actor.h"
+#include "Async/Future.h"
+#include "GrassBlade.h"
+#include "PoissonTileSet.h"
+#include "HorizonMap.h"
+#include "GrassExclusionVolume.h"
+#include "GVar.h"
+
+#include "GrassRuntimeRing.generated.h"
+
+//Generated grass of one cell and coarse heightfield of its terrain used for occlusion culling
+struct FGrassRuntimeCell {
+	FGrassSpawnBatch batch;
+	//Lowest terrain height within every heightfield sample (heightSamplesPerCell x heightSamplesPerCell, empty if not traced)
+	TArray<float> minHeights;
+	//Height of the highest turf of the cell
+	float maxHeight = -BIG_NUMBER;
+};
+
+typedef TSharedPtr<grassSampling::PoissonTileSet, ESPMode::ThreadSafe> FGrassTileSetPtr;
+typedef TSharedPtr<FGrassRuntimeCell, ESPMode::ThreadSafe> FGrassCellPtr;
+
+//Attributes of runtime generated grass, copied into every cell task
+struct FGrassRuntimeSettings {
+	float cellSize = 2000;
+	float turfRadius = 10;
+	float turfDensity = 1;
+	int numOfBladesWithinTurf = 20;
+	float turfGrassRadius = 2;
+	EGPGrassShape grassShape = EGPGrassShape::Triangle;
+	int samplingSeed = 0;
+	bool shouldSnapToTerrain = true;
+	int rayLength = 1200;
+	//height around which the rays are traced
+	float traceHeight = 0;
+	//resolution of heightfield of the cell in one direction (0 - no heightfield)
+	int heightSamplesPerCell = 8;
+	//shapes in which no turfs get generated, gathered once when the game starts
+	FGrassExclusionsPtr exclusions;
+};
+
+//Generates grass at runtime in a ring of world aligned cells around the viewer instead of storing baked grass with the level
+//Cells are generated deterministically from samplingSeed and cell coordinates on worker threads (poisson tiles, progressive
+//turf density and snapping), recently generated cells are kept in LRU cache, so coming back to them costs no generating
+//Every frame cells hidden behind hills are found with horizon built from heightfields of the cells (front to back)
+//and hidden before their instances get submitted for rendering
+UCLASS()
+class GRASSPLUGIN_API AGrassRuntimeRing : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AGrassRuntimeRing();
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void Tick(float DeltaSeconds) override;
+
+	//Distance (in cells) from the cell of the viewer in which cells get spawned
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grass", meta = (UIMin = 0, ClampMin = 0))
+	int ringRadiusInCells = 2;
+
+	//Amount of generated cells kept in memory (cells outside of the ring included)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grass", meta = (UIMin = 1, ClampMin = 1))
+	int cacheCapacity = 64;
+
+	//Amount of cells generated on worker threads at the same time
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grass", meta = (UIMin = 1, ClampMin = 1))
+	int maxCellsInProgress = 4;
+
+	//Hides cells hidden behind terrain (needs shouldSnapToTerrain)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Occlusion")
+	bool useOcclusionCulling = true;
+
+	//Resolution of heightfield traced for every cell in one direction
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Occlusion", meta = (UIMin = 1, ClampMin = 1, UIMax = 32))
+	int heightSamplesPerCell = 8;
+
+	//Amount of azimuth bins of the horizon
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Occlusion", meta = (UIMin = 64, ClampMin = 64))
+	int horizonBins = 512;
+
+	//Height added above the highest turf of the cell (height of grass blades)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Occlusion", meta = (UIMin = 0, ClampMin = 0))
+	float occlusionHeightMargin = 100;
+
+	//Amount of frames the cell has to be occluded before it gets hidden, prevents hiding and showing cells every frame
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Occlusion", meta = (UIMin = 1, ClampMin = 1))
+	int occludedFramesToHide = 10;
+
+	//Min distance between turfs
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grass", meta = (UIMin = 1, ClampMin = 1))
+	float turfRadius = 10;
+
+	//Fraction of turfs of every cell that get spawned (0 - 1)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grass", meta = (UIMin = 0, ClampMin = 0, UIMax = 1, ClampMax = 1))
+	float turfDensity = 1;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grass")
+	int numOfBladesWithinTurf = 20;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grass")
+	float turfGrassRadius = 2;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grass")
+	EGPGrassShape grassShape = EGPGrassShape::Triangle;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grass")
+	int samplingSeed = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grass")
+	bool shouldSnapToTerrain = true;
+
+	//Distance from splines of actors tagged grassExclude in which no grass gets generated
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grass", meta = (UIMin = 0, ClampMin = 0))
+	float exclusionSplineRadius = 300;
+
+	//Length of snapping ray, the ray is centered on the height of this actor
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grass")
+	int rayLength = 1200;
+
+	//Materials of grass and billboards (materials from configuration file are used if not set)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grass")
+	UMaterialInterface* grassMaterial;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grass")
+	UMaterialInterface* billboardMaterial;
+
+	//Generates grass of one cell, called on worker thread
+	//@param cell - coordinates of world aligned cell
+	//@param tiles - poisson tiles for settings.turfRadius
+	//@param world - world the snapping rays are traced in
+	static FGrassCellPtr GenerateCell(FIntPoint cell, const FGrassRuntimeSettings& settings, FGrassTileSetPtr tiles, UWorld* world);
+
+protected:
+	FGrassRuntimeSettings settings;
+	FGrassTileSetPtr poissonTiles;
+	TFuture<FGrassTileSetPtr> poissonTilesTask;
+
+	TMap<FIntPoint, TFuture<FGrassCellPtr>> pendingCells;
+
+	//Generated cells and their order of use (least recently used first)
+	TMap<FIntPoint, FGrassCellPtr> cellCache;
+	TArray<FIntPoint> cacheOrder;
+
+	//Spawned cells, every cell has its own grass patch so it can be removed without touching the other cells
+	UPROPERTY()
+	TMap<FIntPoint, AGrassBlade*> visibleCells;
+	UPROPERTY()
+	TArray<AGrassBlade*> patchPool;
+
+	//Cells hidden by occlusion culling and amount of frames the visible cells are occluded for
+	TSet<FIntPoint> occludedCells;
+	TMap<FIntPoint, int> occludedFrames;
+	grassSampling::HorizonMap horizon;
+
+	UPROPERTY()
+	UMaterialInstanceDynamic* grassDynMaterial;
+	UPROPERTY()
+	UMaterialInstanceDynamic* billboardDynMaterial;
+
+	//Returns location of the camera of the first player
+	bool GetViewerLocation(FVector& location) const;
+
+	//Starts generating of the cell on worker thread
+	void RequestCell(FIntPoint cell);
+
+	//Spawns instances of generated cell
+	void ShowCell(FIntPoint cell, const FGrassSpawnBatch& cellData);
+
+	//Removes instances of the cell and returns its grass patch into the pool
+	void HideCell(FIntPoint cell);
+
+	//Tests visible cells against horizon of cells in front of them and hides the occluded ones
+	void UpdateOcclusion(FVector viewer);
+
+	//Hides or shows instances of the cell without removing them
+	void SetCellOccluded(FIntPoint cell, bool occluded);
+
+	//Marks the cell as most recently used
+	void TouchCache(FIntPoint cell);
+
+	//Removes least recently used cells over cacheCapacity
+	void TrimCache();
+
+	AGrassBlade* AcquirePatch();
+};
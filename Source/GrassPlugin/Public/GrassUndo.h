@@ -0,0 +1,135 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/Change.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "SwapArrayDelta.h"
+#include "GrassProgressiveCell.h"
+
+class UGrassRendering;
+
+//Operations of grass editor mode recorded for undo
+enum class EGPGrassOperation : uint8 {
+	Generate,
+	BrushStroke,
+	Clear,
+	TurfDensity
+};
+
+//Instance removed by grass operation (transform in space of its instance manager, 40 bytes instead of instance data and tree)
+struct FGrassRemovedInstance {
+	FVector location;
+	float rotation[4];
+	FVector scale;
+
+	static FGrassRemovedInstance FromTransform(const FTransform& transform);
+	FTransform ToTransform() const;
+};
+
+//Changes of grass patch done by one grass operation, enough to revert them without snapshot of instance managers
+//Every instance manager (and turf centers) gets its own log of appends and swap removals in the order they happened,
+//reverting the logs backwards restores exact order of instances, so deltas reverted in reverse order (undo) find the
+//instances they appended at the end of their managers even when later operations erased and restored other instances.
+class FGrassDelta {
+public:
+	void Reset();
+
+	bool IsEmpty() const;
+
+	//Counts instances appended into the instance manager
+	void RecordAdded(UHierarchicalInstancedStaticMeshComponent* instances, int32 count);
+
+	//Stores transforms of instances that are going to be removed from the instance manager
+	//@param indices - sorted from the highest (order instance managers remove them in)
+	void RecordRemoved(UHierarchicalInstancedStaticMeshComponent* instances, const TArray<int32>& indices);
+
+	//Stores transforms of all instances of the instance manager that is going to be cleared
+	void RecordCleared(UHierarchicalInstancedStaticMeshComponent* instances);
+
+	void RecordAddedTurfCenters(int32 count) { turfCenters.RecordAppend(count); };
+	void RecordRemovedTurfCenter(int32 index, const FVector2D& center) { turfCenters.RecordRemoveAtSwap(index, center); };
+	void RecordClearedTurfCenters(const TArray<FVector2D>& centers);
+
+	//Stores progressive cell before its first change by the operation
+	//@param cell - null if the cell is being created
+	void RecordProgressiveCell(FIntPoint key, const FGrassProgressiveCell* cell);
+
+	//Takes over progressive cells that are being cleared (cells changed earlier keep their stored state)
+	void RecordClearedProgressiveCells(TMap<FIntPoint, FGrassProgressiveCell>& cells);
+
+	//Stores amount of spawned turfs of progressive cell before its first change by the operation
+	void RecordSpawnedTurfs(FIntPoint key, int32 spawnedTurfs);
+
+	void RecordTurfDensity(float density);
+
+	int32 NumRemovedInstances() const;
+
+	SIZE_T GetAllocatedSize() const;
+
+	//@return actor owning the instance managers the delta changed (null if they are gone)
+	AActor* GetOwner() const;
+
+	//Changes of every instance manager
+	TMap<TWeakObjectPtr<UHierarchicalInstancedStaticMeshComponent>, grassSampling::SwapArrayDelta<FGrassRemovedInstance>> instances;
+	grassSampling::SwapArrayDelta<FVector2D> turfCenters;
+
+	//Progressive cells as they were before the operation changed them and cells the operation created
+	TMap<FIntPoint, FGrassProgressiveCell> previousCells;
+	TSet<FIntPoint> createdCells;
+	//Spawned turfs of progressive cells before the operation changed them (changed by turfDensity only)
+	TMap<FIntPoint, int32> previousSpawnedTurfs;
+	TOptional<float> previousTurfDensity;
+};
+
+//Parameters the grass operation can be repeated from
+struct FGrassOperationRecord {
+	EGPGrassOperation operation = EGPGrassOperation::Generate;
+	//Edited properties of grass editor mode (ExportBakeSettings)
+	FString settings;
+	//Seed of the turf random stream of the operation
+	int32 seed = 0;
+	//Dabs of brush stroke and seeds they were generated with
+	TArray<FVector> dabs;
+	TArray<int32> dabSeeds;
+};
+
+//Undo record of grass operation
+//Undo reverts the delta, redo repeats the operation from its record with the same seeds (recording new delta), so only the
+//parameters and removed instances are kept in memory.
+class FGrassOperationChange : public FCommandChange {
+public:
+	FGrassOperationRecord record;
+	FGrassDelta delta;
+
+	virtual void Apply(UObject* object) override;
+	virtual void Revert(UObject* object) override;
+	virtual bool HasExpired(UObject* object) const override;
+	virtual FString ToString() const override;
+};
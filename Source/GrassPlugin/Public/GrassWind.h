@@ -0,0 +1,160 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EngineMinimal.h"
+#include "Components/ActorComponent.h"
+#include "GrassField.h"
+
+#include "GrassWind.generated.h"
+
+//Local source of wind pushing air away from its owner (helicopter downwash, explosions)
+UCLASS(ClassGroup = (Grass), meta = (BlueprintSpawnableComponent))
+class GRASSPLUGIN_API UGrassWindEmitterComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	//Distance from the owner in which the wind is emitted
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grass", meta = (UIMin = 0, ClampMin = 0))
+	float radius = 1000;
+
+	//Speed of the wind at the owner
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grass", meta = (UIMin = 0, ClampMin = 0))
+	float strength = 1000;
+
+	//Time in which the emitter fades out after Trigger (0 - emits all the time)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grass", meta = (UIMin = 0, ClampMin = 0))
+	float fadeTime = 0;
+
+	//Starts emitting of emitter with fadeTime (explosion)
+	UFUNCTION(BlueprintCallable, Category = "Grass")
+	void Trigger();
+
+	//@return current strength of the emitter (0 if it does not emit)
+	float GetCurrentStrength() const;
+
+	//All registered emitters
+	static const TArray<UGrassWindEmitterComponent*>& GetEmitters() { return emitters; };
+
+protected:
+	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
+
+private:
+	float triggerTime = -BIG_NUMBER;
+
+	static TArray<UGrassWindEmitterComponent*> emitters;
+};
+
+//Wind simulated on CPU on coarse world grid around the viewer, shared by all grass materials
+//
+//Simulation runs with fixed step: wind of every texel relaxes towards ambient wind with gusts travelling in the wind
+//direction plus wind of emitters, then it gets diffused into neighbouring texels.
+//Texture channels: R,G - wind direction and speed normalized by maxWindSpeed (0.5 is calm), B - normalized speed
+//Material parameters: windField (texture), windFieldSize (scalar), windFieldOrigin (vector)
+UCLASS()
+class GRASSPLUGIN_API AGrassWindField : public AGrassField
+{
+	GENERATED_BODY()
+
+public:
+	AGrassWindField();
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	//Direction of ambient wind (yaw in degrees)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Wind")
+	float windYaw = 0;
+
+	//Speed of ambient wind
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Wind", meta = (UIMin = 0, ClampMin = 0))
+	float windSpeed = 300;
+
+	//Speed added and removed by gusts
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Wind", meta = (UIMin = 0, ClampMin = 0))
+	float gustStrength = 200;
+
+	//Distance between two gusts
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Wind", meta = (UIMin = 1, ClampMin = 1))
+	float gustWavelength = 3000;
+
+	//Speed in which gusts travel over the field
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Wind", meta = (UIMin = 0, ClampMin = 0))
+	float gustSpeed = 600;
+
+	//Speed of wind reaching its target (higher is faster)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Wind", meta = (UIMin = 0, ClampMin = 0))
+	float responsiveness = 4;
+
+	//Part of the wind exchanged with neighbouring texels in one step (0 - 0.25)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Wind", meta = (UIMin = 0, ClampMin = 0, UIMax = 0.25, ClampMax = 0.25))
+	float diffusion = 0.1f;
+
+	//Wind speed stored in the texture as full bend
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Wind", meta = (UIMin = 1, ClampMin = 1))
+	float maxWindSpeed = 2000;
+
+	//Simulation steps per second
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Wind", meta = (UIMin = 1, ClampMin = 1))
+	float simulationRate = 30;
+
+protected:
+	//Wind and its target of every texel (toroidal addressing), components are stored separately to be processed with SIMD
+	TArray<float> windX;
+	TArray<float> windY;
+	TArray<float> targetX;
+	TArray<float> targetY;
+	TArray<float> diffusedX;
+	TArray<float> diffusedY;
+
+	float simulationTime = 0;
+	float accumulatedTime = 0;
+
+	virtual void AllocateField() override;
+	virtual void ClearTexel(int index) override;
+	virtual void EncodeTexel(int index, uint8* texel) const override;
+
+	//Advances the simulation by one fixed step
+	void Step(float step);
+
+	//Sets target of every texel to ambient wind with gusts
+	void ComputeAmbientTarget();
+
+	//Adds wind of emitter into target of texels
+	void AddEmitter(const UGrassWindEmitterComponent* emitter);
+
+	//Moves wind of every texel towards its target
+	void RelaxToTarget(float step);
+
+	//Exchanges wind with neighbouring texels
+	void Diffuse();
+
+	FVector2D GetAmbientWind() const;
+};
@@ -0,0 +1,183 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "PoissonTileSet.h"
+#include "ProgressiveSampling.h"
+#include "PointHashGrid.h"
+#include "BrushSampling.h"
+#include "ExclusionBVH.h"
+#include "CoverageMask.h"
+#include "BlueNoiseSampling.h"
+#include "JitteredGrid.h"
+#include "TurfLayout.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+// Benchmarks of GrassCore samplers on workloads of typical bake (run under perf/VTune to profile them outside of the editor)
+// Usage: GrassCoreBenchmarks [name prefix] [repeats]
+
+//Runs the workload given amount of times and prints the best time
+//@param work - runs the workload once and returns amount of generated items
+static void Measure(const char* name, const char* prefix, int repeats, const std::function<size_t()>& work)
+{
+	if (std::strncmp(name, prefix, std::strlen(prefix)) != 0)
+		return;
+
+	double best = 1e30;
+	size_t items = 0;
+	for (int i = 0; i < repeats; i++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		items = work();
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		best = seconds < best ? seconds : best;
+	}
+	std::printf("%-32s %10.3f ms %12zu items %10.1f M items/s\n", name, best * 1e3, items, items / best * 1e-6);
+}
+
+int main(int argc, char** argv)
+{
+	const char* prefix = argc > 1 ? argv[1] : "";
+	int repeats = argc > 2 ? std::atoi(argv[2]) : 5;
+
+	//100 x 100 m of turfs with radius 20
+	const float bounds[4] = { 0, 0, 10000, 10000 };
+	grassSampling::PoissonTileSet tileSet;
+	tileSet.Generate(20, 16, 8, 30, 1);
+	std::vector<float> tilePositions;
+	tileSet.FillBounds(tilePositions, bounds, 1);
+
+	Measure("PoissonTileSet.Generate", prefix, repeats, [&]() {
+		grassSampling::PoissonTileSet generated;
+		generated.Generate(20, 16, 8, 30, 2);
+		size_t points = 0;
+		for (int i = 0; i < generated.GetAmountOfVariants(); i++)
+			points += generated.GetTile(i).size() / 2;
+		return points;
+	});
+
+	Measure("PoissonTileSet.FillBounds", prefix, repeats, [&]() {
+		std::vector<float> positions;
+		tileSet.FillBounds(positions, bounds, 1);
+		return positions.size() / 2;
+	});
+
+	Measure("ProgressiveOrderByCells", prefix, repeats, [&]() {
+		std::vector<float> positions = tilePositions;
+		std::vector<int> cellStarts, cellCoords;
+		grassSampling::ProgressiveOrderByCells(positions, 2000, 20, 1, cellStarts, cellCoords);
+		return positions.size() / 2;
+	});
+
+	Measure("PointHashGrid.QueryRadius", prefix, repeats, [&]() {
+		grassSampling::PointHashGrid grid(50);
+		for (size_t i = 0; i < tilePositions.size(); i += 2)
+			grid.Add(tilePositions[i], tilePositions[i + 1]);
+		std::vector<int> found;
+		for (size_t i = 0; i < tilePositions.size(); i += 2)
+			grid.QueryRadius(tilePositions[i], tilePositions[i + 1], 50, found);
+		return found.size();
+	});
+
+	Measure("SampleBrushDisk", prefix, repeats, [&]() {
+		grassSampling::PointHashGrid existing(20);
+		std::vector<float> positions;
+		grassSampling::SampleBrushDisk(positions, 0, 0, 2000, 20, 30, 1, existing);
+		return positions.size() / 2;
+	});
+
+	Measure("ExclusionBVH.RemoveContained", prefix, repeats, [&]() {
+		grassSampling::ExclusionBVH exclusions;
+		for (int i = 0; i < 1000; i++)
+			exclusions.AddBox((i % 32) * 300.f, (i / 32) * 300.f, 75, 40, i * 0.1f);
+		for (int i = 0; i < 200; i++)
+			exclusions.AddCapsule(i * 50.f, 0, i * 50.f + 40, 10000, 60);
+		exclusions.Build();
+		std::vector<float> positions = tilePositions;
+		exclusions.RemoveContained(positions);
+		return tilePositions.size() / 2;
+	});
+
+	Measure("CoverageMask.RemoveOutside", prefix, repeats, [&]() {
+		grassSampling::CoverageMask mask;
+		std::vector<float> polygon;
+		for (int i = 0; i < 256; i++)
+		{
+			float angle = i * 6.2831853f / 256;
+			float radius = 4000 + 750 * std::sin(angle * 7);
+			polygon.push_back(5000 + radius * std::cos(angle));
+			polygon.push_back(5000 + radius * std::sin(angle));
+		}
+		mask.AddPolygon(polygon);
+		mask.Build(500);
+		std::vector<float> positions = tilePositions;
+		mask.RemoveOutside(positions);
+		return tilePositions.size() / 2;
+	});
+
+	grassSampling::BlueNoiseMask blueNoise;
+	Measure("BlueNoiseMask.Generate", prefix, repeats, [&]() {
+		blueNoise.Generate(64, 0);
+		return (size_t)64 * 64;
+	});
+
+	Measure("ThresholdDensity", prefix, repeats, [&]() {
+		int width = 2000, rows = 2000;
+		std::vector<float> density((size_t)width * rows);
+		for (size_t i = 0; i < density.size(); i++)
+			density[i] = (i % width) / (float)width;
+		std::vector<float> positions;
+		grassSampling::ThresholdDensity(positions, density.data(), width, rows, 0, 0, 10, blueNoise, 1);
+		return density.size();
+	});
+
+	Measure("JitteredGridRows", prefix, repeats, [&]() {
+		std::vector<float> positions;
+		grassSampling::JitteredGridRows(positions, bounds, 10, 0.8f, 1, 0, 1000);
+		return positions.size() / 2;
+	});
+
+	Measure("GenerateTurfLayout", prefix, repeats, [&]() {
+		grassSampling::RandomStream stream(1);
+		std::vector<grassSampling::TurfBlade> blades;
+		const float normal[3] = { 0.1f, 0.2f, 0.97f };
+		for (size_t i = 0; i < tilePositions.size(); i += 2)
+		{
+			const float center[3] = { tilePositions[i], tilePositions[i + 1], 0 };
+			grassSampling::GenerateTurfLayout(blades, stream, 20, 10, center, normal);
+		}
+		return blades.size();
+	});
+
+	return 0;
+}
@@ -0,0 +1,70 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Blue noise threshold sampling (ordered dithering of density by tileable blue noise mask)
+//
+// Mask is rank field generated by void and cluster method: every pixel gets threshold (rank + 0.5) / pixels, and pixels
+// with threshold under any value d form blue noise pattern covering fraction d of the mask. Density grid is compared
+// with the mask tiled over world aligned pixels, so every pixel is decided independently (rows can run in parallel) and
+// neighbouring grids match seamlessly.
+namespace grassSampling {
+
+	class BlueNoiseMask {
+	public:
+		//Generates size x size rank field (cost grows with square of pixel amount, 64 x 64 takes tens of milliseconds)
+		void Generate(int size, uint32_t seed);
+
+		int GetSize() const { return size; };
+
+		//@return threshold in (0, 1) of pixel, coordinates wrap around
+		float GetThreshold(int x, int y) const;
+
+		const float* GetRow(int y) const { return thresholds.data() + (size_t)Wrap(y) * size; };
+
+	private:
+		int size = 0;
+		std::vector<float> thresholds;
+
+		int Wrap(int value) const { return ((value % size) + size) % size; };
+	};
+
+	//Emits positions of density grid pixels whose density exceeds threshold of the mask on the pixel
+	//Pixel (i, j) of the grid covers square starting at (firstPixelX + i, firstPixelY + j) * spacing, positions are
+	//pixel centers jittered by up to quarter of spacing
+	//@return param positions - accepted positions get appended (x,y pairs), row by row
+	//@param density - row major grid of values in <0, 1> (1 accepts every pixel), width * rows values
+	//@param firstPixelX, firstPixelY - world pixel coordinates of the first pixel of the grid
+	//@param seed - shifts the mask and jitter, so different seeds give different patterns
+	void ThresholdDensity(std::vector<float>& positions, const float* density, int width, int rows, int firstPixelX, int firstPixelY,
+		float spacing, const BlueNoiseMask& mask, uint32_t seed);
+}
@@ -0,0 +1,52 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include "PointHashGrid.h"
+
+#include <vector>
+#include <cstdint>
+
+// Local poisson disk sampling under a brush
+//
+// Bridson's sampling restricted to a disk, seeded by already existing points around the disk, so newly sampled points
+// keep the minimal distance to the grass that is already placed. Cost depends only on amount of points under the brush.
+namespace grassSampling {
+
+	//Samples positions within disk that are further than radius from each other and from all existing points
+	//@return param positions - newly sampled positions (x,y pairs) get appended
+	//@param centerX - x coordinate of brush center
+	//@param centerY - y coordinate of brush center
+	//@param brushRadius - radius of the brush disk
+	//@param radius - minimal distance between positions
+	//@param maxTries - max amount of attempts in dart throwing around one active position
+	//@param seed - seed of the random generator
+	//@param existing - already placed positions
+	void SampleBrushDisk(std::vector<float>& positions, float centerX, float centerY, float brushRadius, float radius, int maxTries,
+		uint32_t seed, const PointHashGrid& existing);
+}
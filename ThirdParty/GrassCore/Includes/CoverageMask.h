@@ -0,0 +1,87 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+// Coverage of world aligned tiles by union of polygons (bake regions)
+//
+// Polygon edges are rasterised into the tiles they cross, which makes those tiles partially covered, remaining tiles
+// within bounds of the polygon are fully covered if their center is inside of the polygon. Samplers fill only covered
+// tiles and clip positions against polygons only within partially covered tiles.
+namespace grassSampling {
+
+	class CoverageMask {
+	public:
+		struct Tile {
+			int x, y;
+			bool full;
+		};
+
+		//Removes all polygons and tiles
+		void Clear();
+
+		//Adds polygon (closed implicitly, any orientation)
+		//@param points - vertices of the polygon (x,y pairs)
+		void AddPolygon(const std::vector<float>& points);
+
+		//Rasterises polygons into tiles of given size
+		void Build(float newTileSize);
+
+		//Covered tiles ordered by rows
+		const std::vector<Tile>& GetTiles() const { return tiles; }
+		float GetTileSize() const { return tileSize; }
+		bool IsEmpty() const { return tiles.empty(); }
+
+		//Checks if the point is inside of any polygon
+		bool Contains(float x, float y) const;
+
+		//Removes positions outside of all polygons, order of remaining positions is kept
+		//@return param positions - positions (x,y pairs)
+		//@return - amount of removed positions
+		int RemoveOutside(std::vector<float>& positions) const;
+
+	private:
+		struct Polygon {
+			std::vector<float> points;
+			float minX, minY, maxX, maxY;
+		};
+
+		std::vector<Polygon> polygons;
+		std::vector<Tile> tiles;
+		//Index into tiles for every covered tile
+		std::unordered_map<uint64_t, int> tileIndices;
+		float tileSize = 1;
+
+		uint64_t TileKey(int x, int y) const;
+		static bool PolygonContains(const Polygon& polygon, float x, float y);
+		static bool SegmentCrossesBox(float ax, float ay, float bx, float by, float minX, float minY, float maxX, float maxY);
+	};
+}
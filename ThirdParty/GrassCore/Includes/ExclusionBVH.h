@@ -0,0 +1,86 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <vector>
+
+// Bounding volume hierarchy of 2D exclusion shapes (rotated boxes and capsules) on horizontal plane
+//
+// Shapes are gathered once before sampling, then every sampled candidate costs one point query against the hierarchy,
+// so candidates inside excluded areas get rejected before any density lookup or tracing is done.
+namespace grassSampling {
+
+	class ExclusionBVH {
+	public:
+		//Removes all shapes
+		void Clear();
+
+		//Adds rectangle rotated around its center
+		//@param halfX, halfY - half of the size of the rectangle
+		//@param angle - rotation in radians
+		void AddBox(float centerX, float centerY, float halfX, float halfY, float angle);
+
+		//Adds all points within radius from segment (piece of spline)
+		void AddCapsule(float ax, float ay, float bx, float by, float radius);
+
+		//Builds the hierarchy, has to be called after shapes are added and before queries
+		void Build();
+
+		//Checks if the point is inside of any shape
+		bool Contains(float x, float y) const;
+
+		//Removes positions inside of shapes, order of remaining positions is kept
+		//@return param positions - positions (x,y pairs)
+		//@return - amount of removed positions
+		int RemoveContained(std::vector<float>& positions) const;
+
+		bool IsEmpty() const { return shapes.empty(); }
+		int Num() const { return (int)shapes.size(); }
+
+	private:
+		struct Shape {
+			bool isBox;
+			//box: center, half size, cos and sin of the rotation; capsule: both ends and radius
+			float params[6];
+			float minX, minY, maxX, maxY;
+		};
+
+		//Inner node has children on index + 1 and secondChild, leaf has shapes [first, first + count)
+		struct Node {
+			float minX, minY, maxX, maxY;
+			int first, count;
+			int secondChild;
+		};
+
+		std::vector<Shape> shapes;
+		std::vector<Node> nodes;
+
+		int BuildNode(int first, int count);
+		static bool ShapeContains(const Shape& shape, float x, float y);
+	};
+}
@@ -0,0 +1,67 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <vector>
+
+// Horizon of the terrain seen from one view point, used to cull boxes hidden behind hills
+//
+// Horizon stores for every azimuth bin the highest elevation (tangent of elevation angle) of occluders added so far.
+// Occluders raise bins whose center their footprint covers with their lowest possible elevation, boxes are occluded
+// only if every bin they touch is above their highest possible elevation. Occluders have to be added in front to back
+// order and should tile the terrain (heightfield cells), so every bin behind them is covered.
+namespace grassSampling {
+
+	class HorizonMap {
+	public:
+		//Clears the horizon for new view point
+		//@param bins - amount of azimuth bins (angular resolution of the horizon)
+		void Reset(float viewX, float viewY, float viewZ, int bins);
+
+		//Checks if axis aligned box with given top height is hidden behind the horizon
+		bool IsOccluded(float minX, float minY, float maxX, float maxY, float topZ) const;
+
+		//Raises the horizon by terrain footprint that is at least given height everywhere
+		void AddOccluder(float minX, float minY, float maxX, float maxY, float height);
+
+		//@return distance of the nearest point of the box from the view point (0 if the view point is inside)
+		float NearestDistance(float minX, float minY, float maxX, float maxY) const;
+
+		//@return distance of the farthest point of the box from the view point
+		float FarthestDistance(float minX, float minY, float maxX, float maxY) const;
+
+	private:
+		float viewX = 0, viewY = 0, viewZ = 0;
+		std::vector<float> horizon;
+
+		//Finds azimuth range of the box
+		//@return param first, last - azimuth of the range in bins (last >= first, can exceed amount of bins)
+		//@return false if the view point is inside of the box
+		bool GetAzimuthRange(float minX, float minY, float maxX, float maxY, float& first, float& last) const;
+	};
+}
@@ -0,0 +1,57 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+// Stratified (jittered grid) sampling
+//
+// World is split into square cells of given spacing and every cell gets exactly one position, pushed from the cell center
+// by hashed offset of up to jitter * spacing / 2. Cells are world aligned and the offsets depend only on cell coordinates
+// and seed, so rows can be generated in any order (or in parallel) and neighbouring bounds match seamlessly.
+namespace grassSampling {
+
+	//Range of world cells covering bounds
+	struct JitteredGridCells {
+		int firstX = 0;
+		int firstY = 0;
+		int columns = 0;
+		int rows = 0;
+	};
+
+	//@return cells intersecting bounds {x0, y0, x1, y1} (corners are normalized)
+	JitteredGridCells GetJitteredGridCells(const float bounds[4], float spacing);
+
+	//Generates positions of cell rows firstRow <= row < lastRow (world cell coordinates) that fall within half open bounds
+	//@return param positions - generated positions get appended (x,y pairs), row by row
+	//@param jitter - 0 places positions into cell centers, 1 anywhere within the cell
+	//@param seed - changes the offsets, so different seeds give different patterns
+	void JitteredGridRows(std::vector<float>& positions, const float bounds[4], float spacing, float jitter, uint32_t seed,
+		int firstRow, int lastRow);
+}
@@ -0,0 +1,141 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// Binary point cloud of turf positions
+//
+// File is a 64 byte header followed by sections of arrays (structure of arrays), every section starts on 16 byte boundary:
+// positions (x,y,z), normals (x,y,z), densities and seeds. Optional sections are present only if their attribute is set.
+// Sections are read in place, so the file can be memory mapped and spawned from without parsing or copying.
+// Data are stored in little endian byte order of the platforms the plugin runs on.
+namespace grassSampling {
+
+	enum PointCloudAttribute : uint32_t {
+		//z of positions is height of the terrain (positions without it get snapped onto terrain)
+		PointCloudHeight = 1,
+		//Normal of the terrain under the point
+		PointCloudNormal = 2,
+		//Density 0 - 1 (1 is the densest turf)
+		PointCloudDensity = 4,
+		//Seed of random generator of the turf
+		PointCloudSeed = 8
+	};
+
+	struct PointCloudHeader {
+		uint32_t magic;
+		uint32_t version;
+		uint32_t attributes;
+		uint32_t reserved;
+		uint64_t count;
+		//x0, y0, x1, y1 of positions
+		float bounds[4];
+		uint8_t padding[24];
+	};
+
+	//Point cloud being built (or exported), arrays of absent attributes stay empty
+	struct PointCloud {
+		uint32_t attributes = 0;
+		std::vector<float> positions;
+		std::vector<float> normals;
+		std::vector<float> densities;
+		std::vector<uint32_t> seeds;
+
+		size_t Num() const { return positions.size() / 3; }
+
+		//Appends positions of sampler (x,y pairs) with zero height
+		void AddPositions(const std::vector<float>& positions2D);
+	};
+
+	//@return size of serialized point cloud in bytes
+	size_t GetPointCloudSize(uint64_t count, uint32_t attributes);
+
+	//Serializes the point cloud into the file layout. Returns success of operation (arrays have to match count and attributes)
+	//@return param data - serialized point cloud
+	int SerializePointCloud(const PointCloud& cloud, std::vector<uint8_t>& data);
+
+	//Writes serialized point cloud into binary file. Returns success of operation
+	int WritePointCloud(const std::string& fileName, const PointCloud& cloud);
+
+	//Read only view into serialized point cloud, arrays point into the viewed memory (nothing is copied)
+	class PointCloudView {
+	public:
+		//Validates header and size of serialized point cloud. Returns success of operation
+		//@param data - serialized point cloud aligned to 16 bytes, has to outlive the view
+		int Open(const void* data, size_t size);
+
+		size_t Num() const { return count; }
+		uint32_t GetAttributes() const { return attributes; }
+		bool Has(PointCloudAttribute attribute) const { return (attributes & attribute) != 0; }
+		const float* GetBounds() const { return bounds; }
+
+		//@return arrays of attributes (null if the attribute is absent)
+		const float* GetPositions() const { return positions; }
+		const float* GetNormals() const { return normals; }
+		const float* GetDensities() const { return densities; }
+		const uint32_t* GetSeeds() const { return seeds; }
+
+	private:
+		size_t count = 0;
+		uint32_t attributes = 0;
+		float bounds[4] = { 0, 0, 0, 0 };
+		const float* positions = nullptr;
+		const float* normals = nullptr;
+		const float* densities = nullptr;
+		const uint32_t* seeds = nullptr;
+	};
+
+	//Read only memory mapping of whole file
+	class MappedFile {
+	public:
+		MappedFile() {}
+		~MappedFile() { Close(); }
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		//Maps the file into memory. Returns success of operation
+		int Open(const std::string& fileName);
+		void Close();
+
+		//@return mapped data aligned to page size (null if not open)
+		const void* GetData() const { return data; }
+		size_t GetSize() const { return size; }
+
+	private:
+		const void* data = nullptr;
+		size_t size = 0;
+#ifdef _WIN32
+		void* file = nullptr;
+		void* mapping = nullptr;
+#endif
+	};
+}
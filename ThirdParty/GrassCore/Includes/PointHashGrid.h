@@ -0,0 +1,81 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+// Spatial hash of 2D points for fast radius queries
+//
+// Points are stored in one array and referenced by their index. Removal moves the last point into the removed slot
+// (swap and pop), so indices of the grid can be kept aligned with other arrays removed the same way.
+namespace grassSampling {
+
+	class PointHashGrid {
+	public:
+		//@param cellSize - width of one cell of the grid, radius queries are fastest for radius close to cellSize
+		explicit PointHashGrid(float cellSize = 50.f);
+
+		//Removes all points and sets new cell size
+		void Reset(float newCellSize);
+
+		//Adds point and returns its index
+		int Add(float x, float y);
+
+		//Removes point on given index, last point is moved onto the index
+		void RemoveAtSwap(int index);
+
+		//Reverse of RemoveAtSwap, point on given index is moved to the end and the new point takes the index
+		//(index equal to Num appends)
+		void InsertAtSwap(int index, float x, float y);
+
+		//Appends indices of all points within radius from given position
+		//@return param result - indices of found points
+		void QueryRadius(float x, float y, float radius, std::vector<int>& result) const;
+
+		//Checks if there is any point within radius from given position
+		bool HasPointWithin(float x, float y, float radius) const;
+
+		int Num() const { return (int)points.size() / 2; }
+		float GetX(int index) const { return points[2 * index]; }
+		float GetY(int index) const { return points[2 * index + 1]; }
+		float GetCellSize() const { return cellSize; }
+
+	private:
+		float cellSize;
+		//x,y pairs
+		std::vector<float> points;
+		std::unordered_map<uint64_t, std::vector<int>> buckets;
+
+		uint64_t CellKey(int cellX, int cellY) const;
+		uint64_t CellKeyOfPosition(float x, float y) const;
+		//Replaces index within bucket of the point on position x,y
+		void ReplaceInBucket(float x, float y, int oldIndex, int newIndex);
+	};
+}
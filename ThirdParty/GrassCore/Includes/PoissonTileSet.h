@@ -0,0 +1,93 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// Precomputed set of seamlessly tileable poisson disk tiles for constant radius sampling
+//
+// Every tile variant shares the same border band (points closer than radius to any edge of the tile), which is taken
+// from one periodic (toroidal) base tile. Only interior of the variants differs, therefore any two variants can be
+// placed next to each other without breaking the minimal distance between points.
+// Layout of tiles over the bounds is chosen by hash of tile coordinates, so the result is deterministic for given seed
+// and generation cost is reduced to copy of the tile points with an offset.
+namespace grassSampling {
+
+	class PoissonTileSet {
+	public:
+		PoissonTileSet();
+
+		//Generates new set of tiles. Returns success of operation (radius has to be positive, the set is left empty otherwise)
+		//@param radius - minimal distance between positions
+		//@param tileSizeInRadii - width of the tile expressed in multiples of radius
+		//@param variants - amount of different tiles in the set
+		//@param maxTries - max amount of attempts in dart throwing in poisson disk sampling
+		//@param seed - seed of the random generator
+		int Generate(float radius, int tileSizeInRadii, int variants, int maxTries, uint32_t seed);
+
+		//Fills given bounds with tiles and appends resulting positions (x,y pairs) into positions
+		//@return param positions - array of positions
+		//@param bounds - borders for sampling
+		//@param seed - seed for hashing of tile selection
+		void FillBounds(std::vector<float>& positions, const float bounds[], uint32_t seed) const;
+
+		//Saves the tile set into binary file. Returns success of operation
+		int SaveToFile(const std::string& fileName) const;
+
+		//Loads the tile set from binary file. Returns success of operation
+		int LoadFromFile(const std::string& fileName);
+
+		//Checks if tile set was generated with given parameters (clamped the same way as by Generate)
+		bool Matches(float radius, int tileSizeInRadii, int variants, uint32_t seed) const;
+
+		bool IsEmpty() const { return tiles.empty(); }
+		float GetTileSize() const { return tileSize; }
+		int GetAmountOfVariants() const { return (int)tiles.size(); }
+		const std::vector<float>& GetTile(int index) const { return tiles[index]; }
+
+		//Picks tile variant for tile on given tile coordinates
+		int SelectTile(int tileX, int tileY, uint32_t seed) const;
+
+	private:
+		float radius;
+		float tileSize;
+		int tileSizeInRadii;
+		uint32_t seed;
+		std::vector<std::vector<float>> tiles;
+
+		//Dart throwing on torus of size tileSize x tileSize. Points already present within tile are kept
+		//and new ones are generated only within [minCoord, maxCoord) square
+		void SampleTile(std::vector<float>& tile, float minCoord, float maxCoord, int maxTries, uint32_t seed) const;
+	};
+
+	//Hash of 2D integer coordinates combined with seed (used for deterministic per cell/tile decisions)
+	uint32_t HashCoordinates(int x, int y, uint32_t seed);
+}
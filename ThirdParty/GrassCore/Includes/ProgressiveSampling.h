@@ -0,0 +1,61 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+// Progressive (rank ordered) poisson sampling
+//
+// Positions are reordered so that any prefix of the points of a cell is itself well distributed. The order is given
+// by hierarchical dart throwing over already sampled positions: every level accepts positions that are further than
+// level radius from all already emitted positions, and the level radius shrinks by sqrt(2) with every level until it reaches
+// minimal radius of the sampling.
+namespace grassSampling {
+
+	//Groups positions into world aligned cells and reorders positions of every cell progressively
+	//@return param positions - positions (x,y pairs), reordered so positions of one cell are continuous and ranked
+	//@param cellSize - size of world aligned cell
+	//@param minRadius - minimal distance between positions (finest level of hierarchy)
+	//@param seed - seed of the random generator
+	//@return param cellStarts - index of first position of each cell (in positions, not floats), last value is amount of positions
+	//@return param cellCoords - coordinates of cells (x,y pairs)
+	void ProgressiveOrderByCells(std::vector<float>& positions, float cellSize, float minRadius, uint32_t seed,
+		std::vector<int>& cellStarts, std::vector<int>& cellCoords);
+
+	//Reorders positions of one cell progressively
+	//@return param points - positions (x,y pairs) to be reordered
+	//@param count - amount of positions
+	//@param cellMinX - x coordinate of cell corner
+	//@param cellMinY - y coordinate of cell corner
+	//@param cellSize - size of the cell
+	//@param minRadius - minimal distance between positions (finest level of hierarchy)
+	//@param seed - seed of the random generator
+	void ProgressiveOrder(float* points, int count, float cellMinX, float cellMinY, float cellSize, float minRadius, uint32_t seed);
+}
@@ -0,0 +1,104 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+// Picks segment size and amount of parts of GPU sampling from measured probe segments
+//
+// Probes are sampled segments of different sizes. Time of one segment is modeled as fixed cost of sampler call plus cost
+// per area, peak GPU memory as fixed base plus memory per area and the amount of positions as positions per area.
+// Throughput grows with segment area (fixed cost gets amortized), so the largest segment fitting the GPU memory budget is
+// chosen. Parts split the whole space so that positions of one part fit the instance limit and RAM budget.
+namespace grassSampling {
+
+	struct SamplingProbe {
+		//Width of square segment
+		float width = 0;
+		double seconds = 0;
+		size_t positions = 0;
+		//Peak GPU memory used during sampling of the segment
+		size_t gpuBytes = 0;
+	};
+
+	struct SamplingLimits {
+		float minWidth = 1;
+		float maxWidth = 1;
+		//GPU memory one segment can use
+		size_t gpuBudget = 0;
+		//RAM instances of one part can use
+		size_t ramBudget = 0;
+		//RAM needed by instances spawned for one position
+		size_t bytesPerPosition = 1;
+		size_t maxPositionsPerPart = 1;
+		int cores = 1;
+	};
+
+	struct SamplingPlan {
+		float segmentWidth = 0;
+		int segments = 1;
+		int parts = 1;
+		//Workers of sharded bake whose parts fit the RAM budget together
+		int workers = 1;
+		double predictedSeconds = 0;
+		double predictedPositions = 0;
+		//Fitted models
+		double secondsPerCall = 0;
+		double secondsPerArea = 0;
+		double positionsPerArea = 0;
+		double gpuBaseBytes = 0;
+		double gpuBytesPerArea = 0;
+	};
+
+	class SamplingTuner {
+	public:
+		void Clear() { probes.clear(); };
+
+		void AddProbe(const SamplingProbe& probe) { probes.push_back(probe); };
+
+		const std::vector<SamplingProbe>& GetProbes() const { return probes; };
+
+		//Fits models of the probes and chooses plan for square space of given width
+		//@return 0 if there are not enough probes (at least two different widths are needed)
+		int Plan(float totalWidth, const SamplingLimits& limits, SamplingPlan& plan) const;
+
+		//Probe sampled the first segment of the space split into totalWidth / probe width segments, so its positions can be
+		//kept instead of sampling that segment again. Switches the plan to the width of the probe whose reuse gives the
+		//fastest predicted sampling (only probes with segments not bigger than the planned ones, so the GPU budget holds)
+		//@return index of the reused probe, -1 if no probe matches the split of the space
+		int ReuseProbe(float totalWidth, SamplingPlan& plan) const;
+
+	private:
+		std::vector<SamplingProbe> probes;
+
+		//Least squares fit of value = base + slope * area (both clamped to be non negative)
+		//@return false if all probes have the same area
+		bool FitLinear(const std::vector<double>& values, double& base, double& slope) const;
+	};
+}
@@ -0,0 +1,95 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Changes of an array whose elements get removed by swap and pop (last element moves into the removed slot)
+//
+// Appends are only counted, removals keep the index and the removed value in the order they happened. Reverting replays
+// the changes backwards: removal is undone by moving the element on its index back to the end and putting the removed
+// value onto the index, so the array gets back its exact order. Indices of elements are not stable between changes,
+// but every delta reverted in reverse order (undo) finds the array in the state it left it in.
+namespace grassSampling {
+
+	template<typename T>
+	class SwapArrayDelta {
+	public:
+		void Clear()
+		{
+			events.clear();
+			removed.clear();
+		}
+
+		bool IsEmpty() const { return events.empty(); }
+		size_t NumRemoved() const { return removed.size(); }
+		size_t GetAllocatedSize() const { return events.capacity() * sizeof(int32_t) + removed.capacity() * sizeof(T); }
+
+		//Counts elements appended to the end of the array
+		void RecordAppend(int count)
+		{
+			if (count <= 0)
+				return;
+			if (!events.empty() && events.back() > 0)
+				events.back() += count;
+			else
+				events.push_back(count);
+		}
+
+		//Stores element removed from the index by swap and pop (removals of one batch in the order they happen)
+		void RecordRemoveAtSwap(int index, const T& value)
+		{
+			events.push_back(-index - 1);
+			removed.push_back(value);
+		}
+
+		//Reverts recorded changes of the array, array has to provide:
+		//	RemoveLast(int count) - removes count elements from the end
+		//	InsertAtSwap(int index, const T& value) - moves element on the index to the end and puts the value onto the index
+		//	(appends the value if index is the size of the array)
+		template<typename Array>
+		void Revert(Array& array) const
+		{
+			size_t value = removed.size();
+			for (auto event = events.rbegin(); event != events.rend(); ++event)
+			{
+				if (*event > 0)
+					array.RemoveLast(*event);
+				else
+					array.InsertAtSwap(-*event - 1, removed[--value]);
+			}
+		}
+
+	private:
+		//Positive event is amount of appended elements, negative is removal from index -event - 1
+		std::vector<int32_t> events;
+		std::vector<T> removed;
+	};
+}
@@ -0,0 +1,88 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+
+// Layout of grass blades within turf
+//
+// Blades are spread around turf center (denser towards the center) and placed onto the plane given by the normal of the
+// terrain, so only the turf center has to be traced. Random values come from RandomStream, which gives the same sequence
+// as FRandomStream of the engine, so layouts generated in and outside of the editor match.
+namespace grassSampling {
+
+	//Linear congruential generator with the same sequence as FRandomStream
+	class RandomStream {
+	public:
+		explicit RandomStream(int32_t seed = 0) : seed((uint32_t)seed) {};
+
+		//@return value in <0, 1)
+		float FRand()
+		{
+			seed = seed * 196314165u + 907633515u;
+			uint32_t bits = 0x3F800000u | (seed >> 9);
+			float result;
+			static_assert(sizeof(result) == sizeof(bits), "float has to be 32 bit");
+			std::memcpy(&result, &bits, sizeof(result));
+			return result - 1.f;
+		};
+
+		//@return value in <min, max)
+		float FRandRange(float min, float max) { return min + (max - min) * FRand(); };
+
+		//@return integer in <min, max>
+		int RandRange(int min, int max)
+		{
+			int range = max - min + 1;
+			return min + (range > 0 ? (int)(FRand() * (float)range) : 0);
+		};
+
+		uint32_t GetCurrentSeed() const { return seed; };
+
+	private:
+		uint32_t seed;
+	};
+
+	//Blade of turf (rotation around the normal and height scale are applied by the caller)
+	struct TurfBlade {
+		float x, y, z;
+		//rotation around the normal in degrees <0, 359>
+		int yaw;
+		//height scale of the blade (1 or 2)
+		int height;
+	};
+
+	//Generates blades of turf around center placed onto the plane given by normal
+	//@return param blades - generated blades get appended
+	//@param center - x, y, z of already snapped turf center
+	//@param normal - unit normal of the terrain at the center (blades keep height of the center if normal is horizontal)
+	void GenerateTurfLayout(std::vector<TurfBlade>& blades, RandomStream& stream, int amount, float radius, const float center[3],
+		const float normal[3]);
+}
@@ -0,0 +1,192 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "BlueNoiseSampling.h"
+#include "PoissonTileSet.h"
+
+#include <cmath>
+#include <algorithm>
+#include <random>
+
+namespace grassSampling {
+
+	//Energy of every pixel is sum of gaussians of set pixels around it (toroidal distance)
+	class VoidAndClusterEnergy {
+	public:
+		VoidAndClusterEnergy(int size, float sigma) : size(size), energy((size_t)size * size, 0.f), kernel((size_t)size * size)
+		{
+			for (int y = 0; y < size; y++)
+			{
+				for (int x = 0; x < size; x++)
+				{
+					int dx = std::min(x, size - x);
+					int dy = std::min(y, size - y);
+					kernel[(size_t)y * size + x] = std::exp(-(dx * dx + dy * dy) / (2 * sigma * sigma));
+				}
+			}
+		}
+
+		void Splat(int pixel, float sign)
+		{
+			int px = pixel % size;
+			int py = pixel / size;
+			for (int y = 0; y < size; y++)
+			{
+				const float* kernelRow = kernel.data() + (size_t)((y - py + size) % size) * size;
+				float* energyRow = energy.data() + (size_t)y * size;
+				for (int x = 0; x < size; x++)
+					energyRow[x] += sign * kernelRow[(x - px + size) % size];
+			}
+		}
+
+		//@return set pixel with the highest energy (tightest cluster) or unset pixel with the lowest energy (largest void)
+		int Find(const std::vector<char>& pattern, bool cluster) const
+		{
+			int best = -1;
+			for (int i = 0; i < (int)energy.size(); i++)
+			{
+				if ((pattern[i] != 0) != cluster)
+					continue;
+				if (best < 0 || (cluster ? energy[i] > energy[best] : energy[i] < energy[best]))
+					best = i;
+			}
+			return best;
+		}
+
+	private:
+		int size;
+		std::vector<float> energy;
+		std::vector<float> kernel;
+	};
+
+	void BlueNoiseMask::Generate(int newSize, uint32_t seed)
+	{
+		size = std::max(newSize, 4);
+		int pixels = size * size;
+		std::vector<int> ranks(pixels, 0);
+
+		//initial pattern of random tenth of pixels, relaxed until the tightest cluster is the largest void
+		std::mt19937 generator(seed);
+		std::vector<char> prototype(pixels, 0);
+		VoidAndClusterEnergy prototypeEnergy(size, 1.5f);
+		int ones = std::max(pixels / 10, 1);
+		for (int set = 0; set < ones;)
+		{
+			int pixel = (int)(generator() % pixels);
+			if (prototype[pixel])
+				continue;
+			prototype[pixel] = 1;
+			prototypeEnergy.Splat(pixel, 1);
+			set++;
+		}
+		for (int iteration = 0; iteration < pixels; iteration++)
+		{
+			int cluster = prototypeEnergy.Find(prototype, true);
+			if (cluster < 0)
+				break;
+			prototype[cluster] = 0;
+			prototypeEnergy.Splat(cluster, -1);
+			int largestVoid = prototypeEnergy.Find(prototype, false);
+			prototype[largestVoid] = 1;
+			prototypeEnergy.Splat(largestVoid, 1);
+			if (largestVoid == cluster)
+				break;
+		}
+
+		//pixels of prototype get ranks by removing the tightest clusters
+		std::vector<char> pattern = prototype;
+		VoidAndClusterEnergy energy = prototypeEnergy;
+		for (int rank = ones - 1; rank >= 0; rank--)
+		{
+			int cluster = energy.Find(pattern, true);
+			pattern[cluster] = 0;
+			energy.Splat(cluster, -1);
+			ranks[cluster] = rank;
+		}
+
+		//remaining pixels get ranks by filling the largest voids
+		pattern = prototype;
+		energy = prototypeEnergy;
+		for (int rank = ones; rank < pixels; rank++)
+		{
+			int largestVoid = energy.Find(pattern, false);
+			pattern[largestVoid] = 1;
+			energy.Splat(largestVoid, 1);
+			ranks[largestVoid] = rank;
+		}
+
+		thresholds.resize(pixels);
+		for (int i = 0; i < pixels; i++)
+			thresholds[i] = (ranks[i] + 0.5f) / pixels;
+	}
+
+	float BlueNoiseMask::GetThreshold(int x, int y) const
+	{
+		return thresholds[(size_t)Wrap(y) * size + Wrap(x)];
+	}
+
+	void ThresholdDensity(std::vector<float>& positions, const float* density, int width, int rows, int firstPixelX, int firstPixelY,
+		float spacing, const BlueNoiseMask& mask, uint32_t seed)
+	{
+		int size = mask.GetSize();
+		if (size == 0)
+			return;
+
+		//seed shifts the mask toroidally
+		uint32_t shift = HashCoordinates(0, 0, seed);
+		int shiftX = (int)(shift % size);
+		int shiftY = (int)((shift / size) % size);
+
+		std::vector<int> accepted(width);
+		for (int row = 0; row < rows; row++)
+		{
+			int pixelY = firstPixelY + row;
+			const float* maskRow = mask.GetRow(pixelY + shiftY);
+			const float* densityRow = density + (size_t)row * width;
+
+			//branch free compaction of accepted pixels (comparison runs on whole row)
+			int count = 0;
+			int maskX = (((firstPixelX + shiftX) % size) + size) % size;
+			for (int i = 0; i < width; i++)
+			{
+				accepted[count] = i;
+				count += densityRow[i] > maskRow[maskX] ? 1 : 0;
+				maskX = maskX + 1 == size ? 0 : maskX + 1;
+			}
+
+			for (int k = 0; k < count; k++)
+			{
+				int pixelX = firstPixelX + accepted[k];
+				uint32_t hash = HashCoordinates(pixelX, pixelY, seed);
+				float jitterX = ((hash & 0xFFFF) / 65535.f - 0.5f) * 0.5f;
+				float jitterY = ((hash >> 16) / 65535.f - 0.5f) * 0.5f;
+				positions.push_back((pixelX + 0.5f + jitterX) * spacing);
+				positions.push_back((pixelY + 0.5f + jitterY) * spacing);
+			}
+		}
+	}
+}
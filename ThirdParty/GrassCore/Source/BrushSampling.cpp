@@ -0,0 +1,104 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "BrushSampling.h"
+
+#include <cmath>
+#include <random>
+
+namespace grassSampling {
+
+	void SampleBrushDisk(std::vector<float>& positions, float centerX, float centerY, float brushRadius, float radius, int maxTries,
+		uint32_t seed, const PointHashGrid& existing)
+	{
+		if (brushRadius <= 0 || radius <= 0)
+			return;
+
+		const float pi = 3.14159265f;
+		std::mt19937 generator(seed);
+		std::uniform_real_distribution<float> unit(0.f, 1.f);
+		PointHashGrid sampled(radius);
+		float sqBrushRadius = brushRadius * brushRadius;
+
+		auto isValid = [&](float x, float y) {
+			float dx = x - centerX, dy = y - centerY;
+			return dx * dx + dy * dy <= sqBrushRadius && !existing.HasPointWithin(x, y, radius) && !sampled.HasPointWithin(x, y, radius);
+		};
+
+		//existing points around the brush are the starting active points, so sampling continues the existing pattern
+		std::vector<int> nearby;
+		existing.QueryRadius(centerX, centerY, brushRadius + radius, nearby);
+		std::vector<float> active;
+		for (int index : nearby)
+		{
+			active.push_back(existing.GetX(index));
+			active.push_back(existing.GetY(index));
+		}
+
+		if (active.empty())
+		{
+			float angle = 2 * pi * unit(generator);
+			float distance = brushRadius * std::sqrt(unit(generator));
+			float x = centerX + distance * std::cos(angle), y = centerY + distance * std::sin(angle);
+			sampled.Add(x, y);
+			positions.push_back(x);
+			positions.push_back(y);
+			active.push_back(x);
+			active.push_back(y);
+		}
+
+		while (!active.empty())
+		{
+			int activeIndex = (int)(unit(generator) * (active.size() / 2)) % (int)(active.size() / 2);
+			float activeX = active[2 * activeIndex], activeY = active[2 * activeIndex + 1];
+
+			bool found = false;
+			for (int i = 0; i < maxTries && !found; i++)
+			{
+				float angle = 2 * pi * unit(generator);
+				float distance = radius * (1 + unit(generator));
+				float x = activeX + distance * std::cos(angle), y = activeY + distance * std::sin(angle);
+				if (!isValid(x, y))
+					continue;
+
+				sampled.Add(x, y);
+				positions.push_back(x);
+				positions.push_back(y);
+				active.push_back(x);
+				active.push_back(y);
+				found = true;
+			}
+
+			if (!found)
+			{
+				active[2 * activeIndex] = active[active.size() - 2];
+				active[2 * activeIndex + 1] = active[active.size() - 1];
+				active.resize(active.size() - 2);
+			}
+		}
+	}
+}
@@ -0,0 +1,184 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "CoverageMask.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace grassSampling {
+
+	void CoverageMask::Clear()
+	{
+		polygons.clear();
+		tiles.clear();
+		tileIndices.clear();
+	}
+
+	void CoverageMask::AddPolygon(const std::vector<float>& points)
+	{
+		if (points.size() < 6)
+			return;
+
+		Polygon polygon;
+		polygon.points = points;
+		polygon.points.resize(points.size() / 2 * 2);
+		polygon.minX = polygon.maxX = points[0];
+		polygon.minY = polygon.maxY = points[1];
+		for (size_t i = 2; i + 1 < points.size(); i += 2)
+		{
+			polygon.minX = std::min(polygon.minX, points[i]);
+			polygon.maxX = std::max(polygon.maxX, points[i]);
+			polygon.minY = std::min(polygon.minY, points[i + 1]);
+			polygon.maxY = std::max(polygon.maxY, points[i + 1]);
+		}
+		polygons.push_back(polygon);
+	}
+
+	uint64_t CoverageMask::TileKey(int x, int y) const
+	{
+		return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y;
+	}
+
+	bool CoverageMask::PolygonContains(const Polygon& polygon, float x, float y)
+	{
+		if (x < polygon.minX || x > polygon.maxX || y < polygon.minY || y > polygon.maxY)
+			return false;
+
+		//even-odd rule
+		const std::vector<float>& p = polygon.points;
+		size_t count = p.size() / 2;
+		bool inside = false;
+		for (size_t i = 0, j = count - 1; i < count; j = i++)
+		{
+			float xi = p[2 * i], yi = p[2 * i + 1], xj = p[2 * j], yj = p[2 * j + 1];
+			if ((yi > y) != (yj > y) && x < (xj - xi) * (y - yi) / (yj - yi) + xi)
+				inside = !inside;
+		}
+		return inside;
+	}
+
+	bool CoverageMask::SegmentCrossesBox(float ax, float ay, float bx, float by, float minX, float minY, float maxX, float maxY)
+	{
+		//Liang-Barsky clipping of the segment by the box
+		float t0 = 0, t1 = 1;
+		const float p[4] = { -(bx - ax), bx - ax, -(by - ay), by - ay };
+		const float q[4] = { ax - minX, maxX - ax, ay - minY, maxY - ay };
+		for (int i = 0; i < 4; i++)
+		{
+			if (p[i] == 0)
+			{
+				if (q[i] < 0)
+					return false;
+				continue;
+			}
+			float t = q[i] / p[i];
+			if (p[i] < 0)
+				t0 = std::max(t0, t);
+			else
+				t1 = std::min(t1, t);
+			if (t0 > t1)
+				return false;
+		}
+		return true;
+	}
+
+	void CoverageMask::Build(float newTileSize)
+	{
+		tileSize = newTileSize;
+		tiles.clear();
+		tileIndices.clear();
+
+		//0 - not covered, 1 - partially covered, 2 - fully covered
+		std::unordered_map<uint64_t, int> coverage;
+		for (const Polygon& polygon : polygons)
+		{
+			std::unordered_map<uint64_t, bool> crossed;
+			const std::vector<float>& p = polygon.points;
+			size_t count = p.size() / 2;
+			for (size_t i = 0, j = count - 1; i < count; j = i++)
+			{
+				float ax = p[2 * j], ay = p[2 * j + 1], bx = p[2 * i], by = p[2 * i + 1];
+				int firstX = (int)std::floor(std::min(ax, bx) / tileSize), lastX = (int)std::floor(std::max(ax, bx) / tileSize);
+				int firstY = (int)std::floor(std::min(ay, by) / tileSize), lastY = (int)std::floor(std::max(ay, by) / tileSize);
+				for (int x = firstX; x <= lastX; x++)
+					for (int y = firstY; y <= lastY; y++)
+						if (SegmentCrossesBox(ax, ay, bx, by, x * tileSize, y * tileSize, (x + 1) * tileSize, (y + 1) * tileSize))
+							crossed[TileKey(x, y)] = true;
+			}
+
+			int firstX = (int)std::floor(polygon.minX / tileSize), lastX = (int)std::floor(polygon.maxX / tileSize);
+			int firstY = (int)std::floor(polygon.minY / tileSize), lastY = (int)std::floor(polygon.maxY / tileSize);
+			for (int x = firstX; x <= lastX; x++)
+			{
+				for (int y = firstY; y <= lastY; y++)
+				{
+					uint64_t key = TileKey(x, y);
+					int state = crossed.count(key) ? 1 : (PolygonContains(polygon, (x + 0.5f) * tileSize, (y + 0.5f) * tileSize) ? 2 : 0);
+					if (state > 0)
+						coverage[key] = std::max(coverage[key], state);
+				}
+			}
+		}
+
+		for (const std::pair<const uint64_t, int>& tile : coverage)
+			tiles.push_back({ (int)(int32_t)(uint32_t)(tile.first >> 32), (int)(int32_t)(uint32_t)tile.first, tile.second == 2 });
+		std::sort(tiles.begin(), tiles.end(), [](const Tile& a, const Tile& b) { return a.y != b.y ? a.y < b.y : a.x < b.x; });
+		for (int i = 0; i < (int)tiles.size(); i++)
+			tileIndices[TileKey(tiles[i].x, tiles[i].y)] = i;
+	}
+
+	bool CoverageMask::Contains(float x, float y) const
+	{
+		auto tile = tileIndices.find(TileKey((int)std::floor(x / tileSize), (int)std::floor(y / tileSize)));
+		if (tile == tileIndices.end())
+			return false;
+		if (tiles[tile->second].full)
+			return true;
+
+		for (const Polygon& polygon : polygons)
+			if (PolygonContains(polygon, x, y))
+				return true;
+		return false;
+	}
+
+	int CoverageMask::RemoveOutside(std::vector<float>& positions) const
+	{
+		size_t kept = 0;
+		for (size_t i = 0; i + 1 < positions.size(); i += 2)
+		{
+			if (!Contains(positions[i], positions[i + 1]))
+				continue;
+			positions[kept] = positions[i];
+			positions[kept + 1] = positions[i + 1];
+			kept += 2;
+		}
+		int removed = (int)((positions.size() - kept) / 2);
+		positions.resize(kept);
+		return removed;
+	}
+}
@@ -0,0 +1,194 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "ExclusionBVH.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace grassSampling {
+
+	static const int maxShapesInLeaf = 4;
+
+	void ExclusionBVH::Clear()
+	{
+		shapes.clear();
+		nodes.clear();
+	}
+
+	void ExclusionBVH::AddBox(float centerX, float centerY, float halfX, float halfY, float angle)
+	{
+		Shape shape;
+		shape.isBox = true;
+		float cosA = std::cos(angle), sinA = std::sin(angle);
+		shape.params[0] = centerX;
+		shape.params[1] = centerY;
+		shape.params[2] = std::abs(halfX);
+		shape.params[3] = std::abs(halfY);
+		shape.params[4] = cosA;
+		shape.params[5] = sinA;
+
+		float extentX = std::abs(cosA) * shape.params[2] + std::abs(sinA) * shape.params[3];
+		float extentY = std::abs(sinA) * shape.params[2] + std::abs(cosA) * shape.params[3];
+		shape.minX = centerX - extentX;
+		shape.maxX = centerX + extentX;
+		shape.minY = centerY - extentY;
+		shape.maxY = centerY + extentY;
+		shapes.push_back(shape);
+	}
+
+	void ExclusionBVH::AddCapsule(float ax, float ay, float bx, float by, float radius)
+	{
+		Shape shape;
+		shape.isBox = false;
+		radius = std::abs(radius);
+		shape.params[0] = ax;
+		shape.params[1] = ay;
+		shape.params[2] = bx;
+		shape.params[3] = by;
+		shape.params[4] = radius;
+		shape.params[5] = 0;
+
+		shape.minX = std::min(ax, bx) - radius;
+		shape.maxX = std::max(ax, bx) + radius;
+		shape.minY = std::min(ay, by) - radius;
+		shape.maxY = std::max(ay, by) + radius;
+		shapes.push_back(shape);
+	}
+
+	void ExclusionBVH::Build()
+	{
+		nodes.clear();
+		if (!shapes.empty())
+			BuildNode(0, (int)shapes.size());
+	}
+
+	int ExclusionBVH::BuildNode(int first, int count)
+	{
+		int index = (int)nodes.size();
+		nodes.push_back(Node());
+
+		Node node;
+		node.minX = shapes[first].minX;
+		node.minY = shapes[first].minY;
+		node.maxX = shapes[first].maxX;
+		node.maxY = shapes[first].maxY;
+		for (int i = first + 1; i < first + count; i++)
+		{
+			node.minX = std::min(node.minX, shapes[i].minX);
+			node.minY = std::min(node.minY, shapes[i].minY);
+			node.maxX = std::max(node.maxX, shapes[i].maxX);
+			node.maxY = std::max(node.maxY, shapes[i].maxY);
+		}
+		node.first = first;
+		node.count = count;
+		node.secondChild = -1;
+
+		if (count > maxShapesInLeaf)
+		{
+			//median split of shape centers along the longer side of the node
+			bool splitX = node.maxX - node.minX >= node.maxY - node.minY;
+			int half = count / 2;
+			std::nth_element(shapes.begin() + first, shapes.begin() + first + half, shapes.begin() + first + count,
+				[splitX](const Shape& a, const Shape& b) {
+					return splitX ? a.minX + a.maxX < b.minX + b.maxX : a.minY + a.maxY < b.minY + b.maxY;
+				});
+
+			node.count = 0;
+			BuildNode(first, half);
+			node.secondChild = BuildNode(first + half, count - half);
+		}
+		nodes[index] = node;
+		return index;
+	}
+
+	bool ExclusionBVH::ShapeContains(const Shape& shape, float x, float y)
+	{
+		const float* p = shape.params;
+		if (shape.isBox)
+		{
+			float dx = x - p[0], dy = y - p[1];
+			float localX = dx * p[4] + dy * p[5];
+			float localY = -dx * p[5] + dy * p[4];
+			return std::abs(localX) <= p[2] && std::abs(localY) <= p[3];
+		}
+
+		float segmentX = p[2] - p[0], segmentY = p[3] - p[1];
+		float lengthSquared = segmentX * segmentX + segmentY * segmentY;
+		float t = lengthSquared > 0 ? ((x - p[0]) * segmentX + (y - p[1]) * segmentY) / lengthSquared : 0;
+		t = std::min(std::max(t, 0.f), 1.f);
+		float dx = x - (p[0] + t * segmentX), dy = y - (p[1] + t * segmentY);
+		return dx * dx + dy * dy <= p[4] * p[4];
+	}
+
+	bool ExclusionBVH::Contains(float x, float y) const
+	{
+		if (nodes.empty())
+			return false;
+
+		int stack[64];
+		int stackSize = 0;
+		stack[stackSize++] = 0;
+		while (stackSize > 0)
+		{
+			int index = stack[--stackSize];
+			const Node& node = nodes[index];
+			if (x < node.minX || x > node.maxX || y < node.minY || y > node.maxY)
+				continue;
+
+			if (node.count > 0)
+			{
+				for (int i = node.first; i < node.first + node.count; i++)
+					if (ShapeContains(shapes[i], x, y))
+						return true;
+				continue;
+			}
+			stack[stackSize++] = index + 1;
+			stack[stackSize++] = node.secondChild;
+		}
+		return false;
+	}
+
+	int ExclusionBVH::RemoveContained(std::vector<float>& positions) const
+	{
+		if (nodes.empty())
+			return 0;
+
+		size_t kept = 0;
+		for (size_t i = 0; i + 1 < positions.size(); i += 2)
+		{
+			if (Contains(positions[i], positions[i + 1]))
+				continue;
+			positions[kept] = positions[i];
+			positions[kept + 1] = positions[i + 1];
+			kept += 2;
+		}
+		int removed = (int)((positions.size() - kept) / 2);
+		positions.resize(kept);
+		return removed;
+	}
+}
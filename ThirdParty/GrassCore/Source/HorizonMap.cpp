@@ -0,0 +1,124 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "HorizonMap.h"
+
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+namespace grassSampling {
+
+	static const float pi = 3.14159265358979f;
+
+	void HorizonMap::Reset(float newViewX, float newViewY, float newViewZ, int bins)
+	{
+		viewX = newViewX;
+		viewY = newViewY;
+		viewZ = newViewZ;
+		horizon.assign(std::max(bins, 1), -std::numeric_limits<float>::infinity());
+	}
+
+	float HorizonMap::NearestDistance(float minX, float minY, float maxX, float maxY) const
+	{
+		float dx = std::max(std::max(minX - viewX, viewX - maxX), 0.f);
+		float dy = std::max(std::max(minY - viewY, viewY - maxY), 0.f);
+		return std::sqrt(dx * dx + dy * dy);
+	}
+
+	float HorizonMap::FarthestDistance(float minX, float minY, float maxX, float maxY) const
+	{
+		float dx = std::max(std::abs(minX - viewX), std::abs(maxX - viewX));
+		float dy = std::max(std::abs(minY - viewY), std::abs(maxY - viewY));
+		return std::sqrt(dx * dx + dy * dy);
+	}
+
+	bool HorizonMap::GetAzimuthRange(float minX, float minY, float maxX, float maxY, float& first, float& last) const
+	{
+		if (viewX >= minX && viewX <= maxX && viewY >= minY && viewY <= maxY)
+			return false;
+
+		//corners are measured relative to the direction of the center, so the range does not break at -pi/pi
+		float center = std::atan2((minY + maxY) * 0.5f - viewY, (minX + maxX) * 0.5f - viewX);
+		const float corners[8] = { minX, minY, maxX, minY, maxX, maxY, minX, maxY };
+		float low = 0, high = 0;
+		for (int i = 0; i < 4; i++)
+		{
+			float delta = std::atan2(corners[2 * i + 1] - viewY, corners[2 * i] - viewX) - center;
+			if (delta > pi)
+				delta -= 2 * pi;
+			else if (delta < -pi)
+				delta += 2 * pi;
+			low = std::min(low, delta);
+			high = std::max(high, delta);
+		}
+
+		float binsPerRadian = horizon.size() / (2 * pi);
+		first = (center + low + 2 * pi) * binsPerRadian;
+		last = (center + high + 2 * pi) * binsPerRadian;
+		return true;
+	}
+
+	bool HorizonMap::IsOccluded(float minX, float minY, float maxX, float maxY, float topZ) const
+	{
+		float first, last;
+		if (!GetAzimuthRange(minX, minY, maxX, maxY, first, last))
+			return false;
+
+		//highest elevation any point of the box can be seen under
+		float height = topZ - viewZ;
+		float distance = height >= 0 ? NearestDistance(minX, minY, maxX, maxY) : FarthestDistance(minX, minY, maxX, maxY);
+		if (distance <= 0)
+			return false;
+		float elevation = height / distance;
+
+		int bins = (int)horizon.size();
+		for (int bin = (int)std::floor(first); bin <= (int)std::floor(last); bin++)
+			if (horizon[bin % bins] <= elevation)
+				return false;
+		return true;
+	}
+
+	void HorizonMap::AddOccluder(float minX, float minY, float maxX, float maxY, float height)
+	{
+		float first, last;
+		if (!GetAzimuthRange(minX, minY, maxX, maxY, first, last))
+			return;
+
+		//lowest elevation of the occluder along any ray crossing it
+		float relativeHeight = height - viewZ;
+		float distance = relativeHeight >= 0 ? FarthestDistance(minX, minY, maxX, maxY) : NearestDistance(minX, minY, maxX, maxY);
+		if (distance <= 0)
+			return;
+		float elevation = relativeHeight / distance;
+
+		//bins are raised if the footprint covers their center, so neighbouring footprints cover the bin between them
+		int bins = (int)horizon.size();
+		for (int bin = (int)std::ceil(first - 0.5f); bin + 0.5f <= last; bin++)
+			horizon[bin % bins] = std::max(horizon[bin % bins], elevation);
+	}
+}
@@ -0,0 +1,109 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "JitteredGrid.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace grassSampling {
+
+	//Same mixing as HashCoordinates, kept inline so the column loop gets vectorized
+	static inline uint32_t HashCell(uint32_t x, uint32_t y, uint32_t seed)
+	{
+		uint32_t h = x * 0x8da6b343u ^ y * 0xd8163841u ^ seed * 0xcb1ab31fu;
+		h ^= h >> 16;
+		h *= 0x85ebca6bu;
+		h ^= h >> 13;
+		h *= 0xc2b2ae35u;
+		h ^= h >> 16;
+		return h;
+	}
+
+	JitteredGridCells GetJitteredGridCells(const float bounds[4], float spacing)
+	{
+		JitteredGridCells cells;
+		if (spacing <= 0)
+			return cells;
+
+		float minX = std::min(bounds[0], bounds[2]);
+		float maxX = std::max(bounds[0], bounds[2]);
+		float minY = std::min(bounds[1], bounds[3]);
+		float maxY = std::max(bounds[1], bounds[3]);
+
+		cells.firstX = (int)std::floor(minX / spacing);
+		cells.firstY = (int)std::floor(minY / spacing);
+		cells.columns = std::max(0, (int)std::ceil(maxX / spacing) - cells.firstX);
+		cells.rows = std::max(0, (int)std::ceil(maxY / spacing) - cells.firstY);
+		return cells;
+	}
+
+	void JitteredGridRows(std::vector<float>& positions, const float bounds[4], float spacing, float jitter, uint32_t seed,
+		int firstRow, int lastRow)
+	{
+		JitteredGridCells cells = GetJitteredGridCells(bounds, spacing);
+		firstRow = std::max(firstRow, cells.firstY);
+		lastRow = std::min(lastRow, cells.firstY + cells.rows);
+		if (cells.columns == 0 || firstRow >= lastRow)
+			return;
+
+		float minX = std::min(bounds[0], bounds[2]);
+		float maxX = std::max(bounds[0], bounds[2]);
+		float minY = std::min(bounds[1], bounds[3]);
+		float maxY = std::max(bounds[1], bounds[3]);
+		jitter = std::min(std::max(jitter, 0.f), 1.f);
+		//16 bit hash halves mapped to offsets in <-jitter/2, jitter/2> of spacing
+		float offsetScale = jitter * spacing / 65535.f;
+		float offsetBase = -0.5f * jitter * spacing;
+
+		int columns = cells.columns;
+		std::vector<float> rowX(columns), rowY(columns);
+		for (int row = firstRow; row < lastRow; row++)
+		{
+			//whole row is computed without branches, positions outside bounds are dropped by compaction afterwards
+			float centerY = (row + 0.5f) * spacing + offsetBase;
+			for (int i = 0; i < columns; i++)
+			{
+				uint32_t hash = HashCell((uint32_t)(cells.firstX + i), (uint32_t)row, seed);
+				rowX[i] = (cells.firstX + i + 0.5f) * spacing + offsetBase + (float)(hash & 0xFFFF) * offsetScale;
+				rowY[i] = centerY + (float)(hash >> 16) * offsetScale;
+			}
+
+			size_t count = positions.size();
+			positions.resize(count + 2 * (size_t)columns);
+			float* out = positions.data() + count;
+			size_t accepted = 0;
+			for (int i = 0; i < columns; i++)
+			{
+				out[2 * accepted] = rowX[i];
+				out[2 * accepted + 1] = rowY[i];
+				accepted += (rowX[i] >= minX) & (rowX[i] < maxX) & (rowY[i] >= minY) & (rowY[i] < maxY);
+			}
+			positions.resize(count + 2 * accepted);
+		}
+	}
+}
@@ -0,0 +1,262 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "PointCloud.h"
+
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <limits>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace grassSampling {
+
+	static const uint32_t pointCloudFileMagic = 0x4C435047; //"GPCL"
+	static const uint32_t pointCloudFileVersion = 1;
+	static const uint32_t pointCloudAttributes = PointCloudHeight | PointCloudNormal | PointCloudDensity | PointCloudSeed;
+
+	static_assert(sizeof(PointCloudHeader) == 64, "point cloud header has to keep its file size");
+
+	static size_t AlignSection(size_t offset)
+	{
+		return (offset + 15) & ~(size_t)15;
+	}
+
+	//Offsets of sections in serialized point cloud, absent sections have offset 0
+	struct PointCloudLayout {
+		size_t positions = 0;
+		size_t normals = 0;
+		size_t densities = 0;
+		size_t seeds = 0;
+		size_t size = 0;
+
+		PointCloudLayout(uint64_t count, uint32_t attributes)
+		{
+			size_t offset = sizeof(PointCloudHeader);
+			positions = offset;
+			offset = AlignSection(offset + count * 3 * sizeof(float));
+			if (attributes & PointCloudNormal)
+			{
+				normals = offset;
+				offset = AlignSection(offset + count * 3 * sizeof(float));
+			}
+			if (attributes & PointCloudDensity)
+			{
+				densities = offset;
+				offset = AlignSection(offset + count * sizeof(float));
+			}
+			if (attributes & PointCloudSeed)
+			{
+				seeds = offset;
+				offset = AlignSection(offset + count * sizeof(uint32_t));
+			}
+			size = offset;
+		}
+	};
+
+	void PointCloud::AddPositions(const std::vector<float>& positions2D)
+	{
+		positions.reserve(positions.size() + positions2D.size() / 2 * 3);
+		for (size_t i = 0; i + 1 < positions2D.size(); i += 2)
+		{
+			positions.push_back(positions2D[i]);
+			positions.push_back(positions2D[i + 1]);
+			positions.push_back(0);
+		}
+	}
+
+	size_t GetPointCloudSize(uint64_t count, uint32_t attributes)
+	{
+		return PointCloudLayout(count, attributes).size;
+	}
+
+	int SerializePointCloud(const PointCloud& cloud, std::vector<uint8_t>& data)
+	{
+		size_t count = cloud.Num();
+		uint32_t attributes = cloud.attributes & pointCloudAttributes;
+		if (cloud.positions.size() != count * 3 ||
+			((attributes & PointCloudNormal) && cloud.normals.size() != count * 3) ||
+			((attributes & PointCloudDensity) && cloud.densities.size() != count) ||
+			((attributes & PointCloudSeed) && cloud.seeds.size() != count))
+			return 0;
+
+		PointCloudHeader header;
+		std::memset(&header, 0, sizeof(header));
+		header.magic = pointCloudFileMagic;
+		header.version = pointCloudFileVersion;
+		header.attributes = attributes;
+		header.count = count;
+		if (count > 0)
+		{
+			header.bounds[0] = header.bounds[1] = std::numeric_limits<float>::max();
+			header.bounds[2] = header.bounds[3] = std::numeric_limits<float>::lowest();
+		}
+		for (size_t i = 0; i < count; i++)
+		{
+			header.bounds[0] = std::min(header.bounds[0], cloud.positions[3 * i]);
+			header.bounds[1] = std::min(header.bounds[1], cloud.positions[3 * i + 1]);
+			header.bounds[2] = std::max(header.bounds[2], cloud.positions[3 * i]);
+			header.bounds[3] = std::max(header.bounds[3], cloud.positions[3 * i + 1]);
+		}
+
+		//padding between sections stays zeroed, so the same cloud always gives the same bytes
+		PointCloudLayout layout(count, attributes);
+		data.assign(layout.size, 0);
+		std::memcpy(data.data(), &header, sizeof(header));
+		if (count == 0)
+			return 1;
+		std::memcpy(data.data() + layout.positions, cloud.positions.data(), count * 3 * sizeof(float));
+		if (layout.normals)
+			std::memcpy(data.data() + layout.normals, cloud.normals.data(), count * 3 * sizeof(float));
+		if (layout.densities)
+			std::memcpy(data.data() + layout.densities, cloud.densities.data(), count * sizeof(float));
+		if (layout.seeds)
+			std::memcpy(data.data() + layout.seeds, cloud.seeds.data(), count * sizeof(uint32_t));
+		return 1;
+	}
+
+	int WritePointCloud(const std::string& fileName, const PointCloud& cloud)
+	{
+		std::vector<uint8_t> data;
+		if (!SerializePointCloud(cloud, data))
+			return 0;
+
+		std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+		if (!file)
+			return 0;
+		file.write((const char*)data.data(), data.size());
+		return file.good() ? 1 : 0;
+	}
+
+	int PointCloudView::Open(const void* data, size_t size)
+	{
+		*this = PointCloudView();
+		if (data == nullptr || size < sizeof(PointCloudHeader) || ((uintptr_t)data & 15) != 0)
+			return 0;
+
+		PointCloudHeader header;
+		std::memcpy(&header, data, sizeof(header));
+		if (header.magic != pointCloudFileMagic || header.version != pointCloudFileVersion ||
+			(header.attributes & ~pointCloudAttributes) != 0)
+			return 0;
+
+		//count is checked before the layout is computed, so offsets cannot overflow
+		if (header.count > (size - sizeof(PointCloudHeader)) / (3 * sizeof(float)))
+			return 0;
+		PointCloudLayout layout(header.count, header.attributes);
+		if (layout.size > size)
+			return 0;
+
+		const uint8_t* bytes = (const uint8_t*)data;
+		count = (size_t)header.count;
+		attributes = header.attributes;
+		std::memcpy(bounds, header.bounds, sizeof(bounds));
+		positions = (const float*)(bytes + layout.positions);
+		normals = layout.normals ? (const float*)(bytes + layout.normals) : nullptr;
+		densities = layout.densities ? (const float*)(bytes + layout.densities) : nullptr;
+		seeds = layout.seeds ? (const uint32_t*)(bytes + layout.seeds) : nullptr;
+		return 1;
+	}
+
+	int MappedFile::Open(const std::string& fileName)
+	{
+		Close();
+#ifdef _WIN32
+		HANDLE fileHandle = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (fileHandle == INVALID_HANDLE_VALUE)
+			return 0;
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+		{
+			CloseHandle(fileHandle);
+			return 0;
+		}
+		HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		const void* view = mappingHandle != nullptr ? MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+		if (view == nullptr)
+		{
+			if (mappingHandle != nullptr)
+				CloseHandle(mappingHandle);
+			CloseHandle(fileHandle);
+			return 0;
+		}
+		file = fileHandle;
+		mapping = mappingHandle;
+		data = view;
+		size = (size_t)fileSize.QuadPart;
+#else
+		int descriptor = open(fileName.c_str(), O_RDONLY);
+		if (descriptor < 0)
+			return 0;
+		struct stat status;
+		if (fstat(descriptor, &status) != 0 || status.st_size == 0)
+		{
+			close(descriptor);
+			return 0;
+		}
+		void* view = mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+		//mapping stays valid after the descriptor gets closed
+		close(descriptor);
+		if (view == MAP_FAILED)
+			return 0;
+		data = view;
+		size = (size_t)status.st_size;
+#endif
+		return 1;
+	}
+
+	void MappedFile::Close()
+	{
+		if (data == nullptr)
+			return;
+#ifdef _WIN32
+		UnmapViewOfFile(data);
+		CloseHandle(mapping);
+		CloseHandle(file);
+		file = nullptr;
+		mapping = nullptr;
+#else
+		munmap(const_cast<void*>(data), size);
+#endif
+		data = nullptr;
+		size = 0;
+	}
+}
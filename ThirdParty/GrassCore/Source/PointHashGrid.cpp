@@ -0,0 +1,195 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "PointHashGrid.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace grassSampling {
+
+	PointHashGrid::PointHashGrid(float cellSize) : cellSize(cellSize)
+	{
+	}
+
+	void PointHashGrid::Reset(float newCellSize)
+	{
+		cellSize = newCellSize;
+		points.clear();
+		buckets.clear();
+	}
+
+	uint64_t PointHashGrid::CellKey(int cellX, int cellY) const
+	{
+		return ((uint64_t)(uint32_t)cellX << 32) | (uint32_t)cellY;
+	}
+
+	uint64_t PointHashGrid::CellKeyOfPosition(float x, float y) const
+	{
+		return CellKey((int)std::floor(x / cellSize), (int)std::floor(y / cellSize));
+	}
+
+	int PointHashGrid::Add(float x, float y)
+	{
+		int index = Num();
+		points.push_back(x);
+		points.push_back(y);
+		buckets[CellKeyOfPosition(x, y)].push_back(index);
+		return index;
+	}
+
+	void PointHashGrid::ReplaceInBucket(float x, float y, int oldIndex, int newIndex)
+	{
+		auto bucket = buckets.find(CellKeyOfPosition(x, y));
+		if (bucket == buckets.end())
+			return;
+
+		std::vector<int>& indices = bucket->second;
+		auto it = std::find(indices.begin(), indices.end(), oldIndex);
+		if (it == indices.end())
+			return;
+
+		if (newIndex >= 0)
+		{
+			*it = newIndex;
+			return;
+		}
+		*it = indices.back();
+		indices.pop_back();
+		if (indices.empty())
+			buckets.erase(bucket);
+	}
+
+	void PointHashGrid::RemoveAtSwap(int index)
+	{
+		if (index < 0 || index >= Num())
+			return;
+
+		int last = Num() - 1;
+		ReplaceInBucket(GetX(index), GetY(index), index, -1);
+		if (index != last)
+		{
+			ReplaceInBucket(GetX(last), GetY(last), last, index);
+			points[2 * index] = points[2 * last];
+			points[2 * index + 1] = points[2 * last + 1];
+		}
+		points.resize(2 * last);
+	}
+
+	void PointHashGrid::InsertAtSwap(int index, float x, float y)
+	{
+		if (index < 0 || index > Num())
+			return;
+
+		if (index < Num())
+		{
+			int last = Num();
+			float movedX = GetX(index), movedY = GetY(index);
+			ReplaceInBucket(movedX, movedY, index, last);
+			points.push_back(movedX);
+			points.push_back(movedY);
+			points[2 * index] = x;
+			points[2 * index + 1] = y;
+		}
+		else
+		{
+			points.push_back(x);
+			points.push_back(y);
+		}
+		buckets[CellKeyOfPosition(x, y)].push_back(index);
+	}
+
+	void PointHashGrid::QueryRadius(float x, float y, float radius, std::vector<int>& result) const
+	{
+		int minX = (int)std::floor((x - radius) / cellSize), maxX = (int)std::floor((x + radius) / cellSize);
+		int minY = (int)std::floor((y - radius) / cellSize), maxY = (int)std::floor((y + radius) / cellSize);
+		float sqRadius = radius * radius;
+
+		//radius covering more cells than there are buckets is faster to answer by going through all points
+		if ((int64_t)(maxX - minX + 1) * (maxY - minY + 1) > (int64_t)buckets.size())
+		{
+			for (int index = 0; index < Num(); index++)
+			{
+				float dx = GetX(index) - x, dy = GetY(index) - y;
+				if (dx * dx + dy * dy <= sqRadius)
+					result.push_back(index);
+			}
+			return;
+		}
+
+		for (int cellX = minX; cellX <= maxX; cellX++)
+		{
+			for (int cellY = minY; cellY <= maxY; cellY++)
+			{
+				auto bucket = buckets.find(CellKey(cellX, cellY));
+				if (bucket == buckets.end())
+					continue;
+				for (int index : bucket->second)
+				{
+					float dx = GetX(index) - x, dy = GetY(index) - y;
+					if (dx * dx + dy * dy <= sqRadius)
+						result.push_back(index);
+				}
+			}
+		}
+	}
+
+	bool PointHashGrid::HasPointWithin(float x, float y, float radius) const
+	{
+		int minX = (int)std::floor((x - radius) / cellSize), maxX = (int)std::floor((x + radius) / cellSize);
+		int minY = (int)std::floor((y - radius) / cellSize), maxY = (int)std::floor((y + radius) / cellSize);
+		float sqRadius = radius * radius;
+
+		if ((int64_t)(maxX - minX + 1) * (maxY - minY + 1) > (int64_t)buckets.size())
+		{
+			for (int index = 0; index < Num(); index++)
+			{
+				float dx = GetX(index) - x, dy = GetY(index) - y;
+				if (dx * dx + dy * dy < sqRadius)
+					return true;
+			}
+			return false;
+		}
+
+		for (int cellX = minX; cellX <= maxX; cellX++)
+		{
+			for (int cellY = minY; cellY <= maxY; cellY++)
+			{
+				auto bucket = buckets.find(CellKey(cellX, cellY));
+				if (bucket == buckets.end())
+					continue;
+				for (int index : bucket->second)
+				{
+					float dx = GetX(index) - x, dy = GetY(index) - y;
+					if (dx * dx + dy * dy < sqRadius)
+						return true;
+				}
+			}
+		}
+		return false;
+	}
+}
@@ -0,0 +1,312 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include "PoissonTileSet.h"
+
+#include <cmath>
+#include <random>
+#include <fstream>
+#include <algorithm>
+
+namespace grassSampling {
+
+	static const uint32_t tileSetFileMagic = 0x53545047; //"GPTS"
+	static const uint32_t tileSetFileVersion = 2;
+
+	uint32_t HashCoordinates(int x, int y, uint32_t seed)
+	{
+		uint32_t h = (uint32_t)x * 0x8da6b343u ^ (uint32_t)y * 0xd8163841u ^ seed * 0xcb1ab31fu;
+		//murmur3 finalizer
+		h ^= h >> 16;
+		h *= 0x85ebca6bu;
+		h ^= h >> 13;
+		h *= 0xc2b2ae35u;
+		h ^= h >> 16;
+		return h;
+	}
+
+	PoissonTileSet::PoissonTileSet() : radius(0), tileSize(0), tileSizeInRadii(0), seed(0)
+	{
+	}
+
+	int PoissonTileSet::Generate(float radius, int tileSizeInRadii, int variants, int maxTries, uint32_t seed)
+	{
+		tiles.clear();
+		//background grid of dart throwing and tile lookup both divide by the radius (NaN fails the check as well)
+		if (!(radius > 0))
+		{
+			this->radius = 0;
+			tileSize = 0;
+			return 0;
+		}
+
+		this->radius = radius;
+		this->tileSizeInRadii = tileSizeInRadii < 2 ? 2 : tileSizeInRadii;
+		this->seed = seed;
+		tileSize = radius * this->tileSizeInRadii;
+		if (variants < 1)
+			variants = 1;
+
+		//periodic base tile, its border band is shared by all variants
+		std::vector<float> base;
+		SampleTile(base, 0, tileSize, maxTries, seed);
+		tiles.push_back(base);
+
+		std::vector<float> band;
+		for (size_t i = 0; i < base.size(); i += 2)
+		{
+			float x = base[i], y = base[i + 1];
+			float edgeDistance = std::min(std::min(x, y), std::min(tileSize - x, tileSize - y));
+			if (edgeDistance < radius)
+			{
+				band.push_back(x);
+				band.push_back(y);
+			}
+		}
+
+		for (int v = 1; v < variants; v++)
+		{
+			std::vector<float> tile = band;
+			SampleTile(tile, radius, tileSize - radius, maxTries, seed + v);
+			tiles.push_back(tile);
+		}
+		return 1;
+	}
+
+	void PoissonTileSet::SampleTile(std::vector<float>& tile, float minCoord, float maxCoord, int maxTries, uint32_t seed) const
+	{
+		std::mt19937 generator(seed);
+		std::uniform_real_distribution<float> unit(0.f, 1.f);
+
+		//background grid with at most one point per cell, wrapped around the tile
+		int gridWidth = (int)std::ceil(tileSize * 1.41421356f / radius);
+		float cellSize = tileSize / gridWidth;
+		std::vector<int> grid(gridWidth * gridWidth, -1);
+		int searchRange = (int)std::ceil(radius / cellSize);
+
+		auto cellOf = [&](float coord) { return std::min((int)(coord / cellSize), gridWidth - 1); };
+		auto wrap = [&](float coord) { return coord < 0 ? coord + tileSize : (coord >= tileSize ? coord - tileSize : coord); };
+		auto isValid = [&](float x, float y) {
+			int cx = cellOf(x), cy = cellOf(y);
+			for (int i = -searchRange; i <= searchRange; i++)
+				for (int j = -searchRange; j <= searchRange; j++)
+				{
+					int gx = (cx + i + gridWidth) % gridWidth;
+					int gy = (cy + j + gridWidth) % gridWidth;
+					int p = grid[gx + gy * gridWidth];
+					if (p < 0)
+						continue;
+					float dx = std::fabs(tile[2 * p] - x);
+					float dy = std::fabs(tile[2 * p + 1] - y);
+					dx = std::min(dx, tileSize - dx);
+					dy = std::min(dy, tileSize - dy);
+					if (dx * dx + dy * dy < radius * radius)
+						return false;
+				}
+			return true;
+		};
+		auto insert = [&](float x, float y) {
+			int index = (int)tile.size() / 2;
+			tile.push_back(x);
+			tile.push_back(y);
+			grid[cellOf(x) + cellOf(y) * gridWidth] = index;
+			return index;
+		};
+
+		std::vector<int> active;
+		int existing = (int)tile.size() / 2;
+		for (int p = 0; p < existing; p++)
+		{
+			grid[cellOf(tile[2 * p]) + cellOf(tile[2 * p + 1]) * gridWidth] = p;
+			active.push_back(p);
+		}
+
+		//initial point within the sampled area
+		float areaSize = maxCoord - minCoord;
+		for (int tries = 0; tries < maxTries; tries++)
+		{
+			float x = minCoord + unit(generator) * areaSize;
+			float y = minCoord + unit(generator) * areaSize;
+			if (isValid(x, y))
+			{
+				active.push_back(insert(x, y));
+				break;
+			}
+		}
+
+		while (!active.empty())
+		{
+			int activeIdx = (int)(unit(generator) * active.size()) % active.size();
+			int p = active[activeIdx];
+			bool found = false;
+			for (int tries = 0; tries < maxTries; tries++)
+			{
+				float theta = unit(generator) * 6.28318531f;
+				float dist = radius * (1.f + unit(generator));
+				float x = wrap(tile[2 * p] + dist * std::cos(theta));
+				float y = wrap(tile[2 * p + 1] + dist * std::sin(theta));
+				if (x < minCoord || x >= maxCoord || y < minCoord || y >= maxCoord)
+					continue;
+				if (isValid(x, y))
+				{
+					active.push_back(insert(x, y));
+					found = true;
+				}
+			}
+			if (!found)
+			{
+				active[activeIdx] = active.back();
+				active.pop_back();
+			}
+		}
+	}
+
+	int PoissonTileSet::SelectTile(int tileX, int tileY, uint32_t seed) const
+	{
+		return (int)(HashCoordinates(tileX, tileY, seed) % tiles.size());
+	}
+
+	void PoissonTileSet::FillBounds(std::vector<float>& positions, const float bounds[], uint32_t seed) const
+	{
+		if (tiles.empty() || !(tileSize > 0))
+			return;
+
+		float minX = std::min(bounds[0], bounds[2]);
+		float maxX = std::max(bounds[0], bounds[2]);
+		float minY = std::min(bounds[1], bounds[3]);
+		float maxY = std::max(bounds[1], bounds[3]);
+
+		int firstTileX = (int)std::floor(minX / tileSize);
+		int lastTileX = (int)std::floor(maxX / tileSize);
+		int firstTileY = (int)std::floor(minY / tileSize);
+		int lastTileY = (int)std::floor(maxY / tileSize);
+
+		for (int tx = firstTileX; tx <= lastTileX; tx++)
+		{
+			for (int ty = firstTileY; ty <= lastTileY; ty++)
+			{
+				const std::vector<float>& tile = tiles[SelectTile(tx, ty, seed)];
+				float offsetX = tx * tileSize;
+				float offsetY = ty * tileSize;
+				bool fullyInside = offsetX >= minX && offsetX + tileSize <= maxX && offsetY >= minY &&
+					offsetY + tileSize <= maxY;
+
+				if (fullyInside)
+				{
+					size_t start = positions.size();
+					positions.insert(positions.end(), tile.begin(), tile.end());
+					for (size_t i = start; i < positions.size(); i += 2)
+					{
+						positions[i] += offsetX;
+						positions[i + 1] += offsetY;
+					}
+					continue;
+				}
+
+				for (size_t i = 0; i < tile.size(); i += 2)
+				{
+					float x = tile[i] + offsetX;
+					float y = tile[i + 1] + offsetY;
+					if (x < minX || x >= maxX || y < minY || y >= maxY)
+						continue;
+					positions.push_back(x);
+					positions.push_back(y);
+				}
+			}
+		}
+	}
+
+	bool PoissonTileSet::Matches(float radius, int tileSizeInRadii, int variants, uint32_t seed) const
+	{
+		return !tiles.empty() && this->radius == radius && this->tileSizeInRadii == (tileSizeInRadii < 2 ? 2 : tileSizeInRadii) &&
+			(int)tiles.size() == (variants < 1 ? 1 : variants) && this->seed == seed;
+	}
+
+	int PoissonTileSet::SaveToFile(const std::string& fileName) const
+	{
+		std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+		if (!file)
+			return 0;
+
+		uint32_t header[2] = { tileSetFileMagic, tileSetFileVersion };
+		int32_t variants = (int32_t)tiles.size();
+		file.write((const char*)header, sizeof(header));
+		file.write((const char*)&radius, sizeof(radius));
+		file.write((const char*)&tileSizeInRadii, sizeof(tileSizeInRadii));
+		file.write((const char*)&variants, sizeof(variants));
+		file.write((const char*)&seed, sizeof(seed));
+		for (const std::vector<float>& tile : tiles)
+		{
+			uint32_t count = (uint32_t)tile.size();
+			file.write((const char*)&count, sizeof(count));
+			file.write((const char*)tile.data(), count * sizeof(float));
+		}
+		return file.good() ? 1 : 0;
+	}
+
+	int PoissonTileSet::LoadFromFile(const std::string& fileName)
+	{
+		std::ifstream file(fileName, std::ios::binary);
+		if (!file)
+			return 0;
+
+		uint32_t header[2];
+		int32_t variants = 0;
+		float loadedRadius = 0;
+		int32_t loadedTileSizeInRadii = 0;
+		uint32_t loadedSeed = 0;
+		file.read((char*)header, sizeof(header));
+		file.read((char*)&loadedRadius, sizeof(loadedRadius));
+		file.read((char*)&loadedTileSizeInRadii, sizeof(loadedTileSizeInRadii));
+		file.read((char*)&variants, sizeof(variants));
+		file.read((char*)&loadedSeed, sizeof(loadedSeed));
+		if (!file || header[0] != tileSetFileMagic || header[1] != tileSetFileVersion || variants < 1 || !(loadedRadius > 0) ||
+			loadedTileSizeInRadii < 2)
+			return 0;
+
+		std::vector<std::vector<float>> loadedTiles(variants);
+		for (std::vector<float>& tile : loadedTiles)
+		{
+			uint32_t count = 0;
+			file.read((char*)&count, sizeof(count));
+			if (!file || count % 2 != 0)
+				return 0;
+			tile.resize(count);
+			file.read((char*)tile.data(), count * sizeof(float));
+		}
+		if (!file)
+			return 0;
+
+		radius = loadedRadius;
+		tileSizeInRadii = loadedTileSizeInRadii;
+		seed = loadedSeed;
+		tileSize = radius * tileSizeInRadii;
+		tiles.swap(loadedTiles);
+		return 1;
+	}
+}
@@ -0,0 +1,167 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include "ProgressiveSampling.h"
+#include "PoissonTileSet.h"
+
+#include <cmath>
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+
+namespace grassSampling {
+
+	static const int maxProgressiveLevels = 24;
+
+	static uint64_t PackCellKey(int x, int y)
+	{
+		return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y;
+	}
+
+	void ProgressiveOrder(float* points, int count, float cellMinX, float cellMinY, float cellSize, float minRadius, uint32_t seed)
+	{
+		if (count < 2)
+			return;
+
+		std::vector<int> remaining(count);
+		std::iota(remaining.begin(), remaining.end(), 0);
+		std::mt19937 generator(seed);
+		std::shuffle(remaining.begin(), remaining.end(), generator);
+
+		std::vector<int> order;
+		order.reserve(count);
+		std::unordered_map<uint64_t, std::vector<int>> grid;
+
+		//every level accepts positions further than levelRadius from all emitted ones, levelRadius shrinks by sqrt(2) with every level
+		//once it gets under minRadius, all remaining positions are accepted
+		float levelRadius = cellSize * 0.5f;
+		for (int level = 0; level < maxProgressiveLevels && !remaining.empty() && levelRadius > minRadius; level++)
+		{
+			grid.clear();
+			auto keyOf = [&](float x, float y) {
+				return PackCellKey((int)std::floor((x - cellMinX) / levelRadius), (int)std::floor((y - cellMinY) / levelRadius));
+			};
+			for (int p : order)
+				grid[keyOf(points[2 * p], points[2 * p + 1])].push_back(p);
+
+			std::vector<int> notEmitted;
+			for (int p : remaining)
+			{
+				float x = points[2 * p], y = points[2 * p + 1];
+				int gx = (int)std::floor((x - cellMinX) / levelRadius);
+				int gy = (int)std::floor((y - cellMinY) / levelRadius);
+				bool valid = true;
+				for (int i = -1; i <= 1 && valid; i++)
+					for (int j = -1; j <= 1 && valid; j++)
+					{
+						auto square = grid.find(PackCellKey(gx + i, gy + j));
+						if (square == grid.end())
+							continue;
+						for (int q : square->second)
+						{
+							float dx = points[2 * q] - x, dy = points[2 * q + 1] - y;
+							if (dx * dx + dy * dy < levelRadius * levelRadius)
+							{
+								valid = false;
+								break;
+							}
+						}
+					}
+
+				if (valid)
+				{
+					order.push_back(p);
+					grid[keyOf(x, y)].push_back(p);
+				}
+				else
+					notEmitted.push_back(p);
+			}
+			remaining.swap(notEmitted);
+			levelRadius *= 0.70710678f;
+		}
+		order.insert(order.end(), remaining.begin(), remaining.end());
+
+		std::vector<float> ordered(2 * count);
+		for (int i = 0; i < count; i++)
+		{
+			ordered[2 * i] = points[2 * order[i]];
+			ordered[2 * i + 1] = points[2 * order[i] + 1];
+		}
+		std::copy(ordered.begin(), ordered.end(), points);
+	}
+
+	void ProgressiveOrderByCells(std::vector<float>& positions, float cellSize, float minRadius, uint32_t seed,
+		std::vector<int>& cellStarts, std::vector<int>& cellCoords)
+	{
+		cellStarts.clear();
+		cellCoords.clear();
+		int count = (int)positions.size() / 2;
+
+		//counting sort of positions into cells
+		std::unordered_map<uint64_t, int> cellIndices;
+		std::vector<int> cellOfPoint(count);
+		std::vector<int> cellCounts;
+		for (int i = 0; i < count; i++)
+		{
+			int cx = (int)std::floor(positions[2 * i] / cellSize);
+			int cy = (int)std::floor(positions[2 * i + 1] / cellSize);
+			auto inserted = cellIndices.insert({ PackCellKey(cx, cy), (int)cellCounts.size() });
+			if (inserted.second)
+			{
+				cellCounts.push_back(0);
+				cellCoords.push_back(cx);
+				cellCoords.push_back(cy);
+			}
+			cellOfPoint[i] = inserted.first->second;
+			cellCounts[cellOfPoint[i]]++;
+		}
+
+		cellStarts.resize(cellCounts.size() + 1);
+		cellStarts[0] = 0;
+		for (size_t c = 0; c < cellCounts.size(); c++)
+			cellStarts[c + 1] = cellStarts[c] + cellCounts[c];
+
+		std::vector<int> fill(cellStarts.begin(), cellStarts.end() - 1);
+		std::vector<float> sorted(positions.size());
+		for (int i = 0; i < count; i++)
+		{
+			int target = fill[cellOfPoint[i]]++;
+			sorted[2 * target] = positions[2 * i];
+			sorted[2 * target + 1] = positions[2 * i + 1];
+		}
+		positions.swap(sorted);
+
+		for (size_t c = 0; c < cellCounts.size(); c++)
+		{
+			int cx = cellCoords[2 * c], cy = cellCoords[2 * c + 1];
+			ProgressiveOrder(&positions[2 * cellStarts[c]], cellCounts[c], cx * cellSize, cy * cellSize, cellSize,
+				minRadius, HashCoordinates(cx, cy, seed));
+		}
+	}
+}
@@ -0,0 +1,128 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "SamplingTuner.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace grassSampling {
+
+	bool SamplingTuner::FitLinear(const std::vector<double>& values, double& base, double& slope) const
+	{
+		double n = (double)probes.size();
+		double sumA = 0, sumV = 0, sumAA = 0, sumAV = 0;
+		for (size_t i = 0; i < probes.size(); i++)
+		{
+			double area = (double)probes[i].width * probes[i].width;
+			sumA += area;
+			sumV += values[i];
+			sumAA += area * area;
+			sumAV += area * values[i];
+		}
+		double denominator = n * sumAA - sumA * sumA;
+		if (denominator <= 1e-9 * sumAA * n)
+			return false;
+
+		slope = std::max((n * sumAV - sumA * sumV) / denominator, 0.0);
+		base = std::max((sumV - slope * sumA) / n, 0.0);
+		return true;
+	}
+
+	int SamplingTuner::Plan(float totalWidth, const SamplingLimits& limits, SamplingPlan& plan) const
+	{
+		if (probes.size() < 2)
+			return 0;
+
+		std::vector<double> seconds, positions, gpuBytes;
+		for (const SamplingProbe& probe : probes)
+		{
+			seconds.push_back(probe.seconds);
+			positions.push_back((double)probe.positions);
+			gpuBytes.push_back((double)probe.gpuBytes);
+		}
+		double positionsBase;
+		if (!FitLinear(seconds, plan.secondsPerCall, plan.secondsPerArea) ||
+			!FitLinear(gpuBytes, plan.gpuBaseBytes, plan.gpuBytesPerArea) ||
+			!FitLinear(positions, positionsBase, plan.positionsPerArea))
+			return 0;
+
+		//largest segment whose predicted peak fits the budget
+		float width = limits.maxWidth;
+		if (plan.gpuBytesPerArea > 0)
+		{
+			double fittingArea = ((double)limits.gpuBudget - plan.gpuBaseBytes) / plan.gpuBytesPerArea;
+			width = fittingArea > 0 ? (float)std::min(std::sqrt(fittingArea), (double)limits.maxWidth) : limits.minWidth;
+		}
+		width = std::max(width, limits.minWidth);
+		plan.segments = std::max((int)std::ceil(totalWidth / width - 1e-4f), 1);
+		plan.segmentWidth = totalWidth / plan.segments;
+
+		double totalArea = (double)totalWidth * totalWidth;
+		plan.predictedSeconds = (double)plan.segments * plan.segments * plan.secondsPerCall + totalArea * plan.secondsPerArea;
+		plan.predictedPositions = totalArea * plan.positionsPerArea;
+
+		double partsForLimit = plan.predictedPositions / (double)std::max(limits.maxPositionsPerPart, (size_t)1);
+		double partBytesTotal = plan.predictedPositions * limits.bytesPerPosition;
+		double partsForRam = limits.ramBudget > 0 ? partBytesTotal / (double)limits.ramBudget : partsForLimit;
+		plan.parts = std::max((int)std::ceil(std::max(partsForLimit, partsForRam)), 1);
+		//part can not be smaller than one segment
+		plan.parts = std::min(plan.parts, plan.segments * plan.segments);
+
+		double partBytes = partBytesTotal / plan.parts;
+		int fittingWorkers = partBytes > 0 ? (int)((double)limits.ramBudget / partBytes) : limits.cores;
+		plan.workers = std::max(std::min(std::min(fittingWorkers, limits.cores), plan.parts), 1);
+		return 1;
+	}
+
+	int SamplingTuner::ReuseProbe(float totalWidth, SamplingPlan& plan) const
+	{
+		double totalArea = (double)totalWidth * totalWidth;
+		int reused = -1;
+		double bestSeconds = plan.predictedSeconds;
+		for (size_t i = 0; i < probes.size(); i++)
+		{
+			int segments = (int)std::lround(totalWidth / probes[i].width);
+			if (segments < plan.segments || std::fabs(totalWidth / segments - probes[i].width) > 1e-3f * probes[i].width)
+				continue;
+
+			double seconds = (double)segments * segments * plan.secondsPerCall + totalArea * plan.secondsPerArea - probes[i].seconds;
+			if (seconds < bestSeconds)
+			{
+				bestSeconds = seconds;
+				reused = (int)i;
+			}
+		}
+		if (reused == -1)
+			return -1;
+
+		plan.segments = (int)std::lround(totalWidth / probes[reused].width);
+		plan.segmentWidth = totalWidth / plan.segments;
+		plan.predictedSeconds = bestSeconds;
+		return reused;
+	}
+}
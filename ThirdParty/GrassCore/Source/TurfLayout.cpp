@@ -0,0 +1,58 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "TurfLayout.h"
+
+#include <cmath>
+
+namespace grassSampling {
+
+	void GenerateTurfLayout(std::vector<TurfBlade>& blades, RandomStream& stream, int amount, float radius, const float center[3],
+		const float normal[3])
+	{
+		const float pi = 3.1415926535897932f;
+		const float smallNumber = 1.e-4f;
+
+		for (int i = 0; i < amount; i++)
+		{
+			//square of uniform value pulls the blades towards the center
+			float t = 2 * pi * stream.FRand();
+			float r = stream.FRandRange(-radius, radius);
+			r = radius * r * r;
+
+			TurfBlade blade;
+			blade.x = r * std::cos(t) + center[0];
+			blade.y = r * std::sin(t) + center[1];
+			blade.z = center[2];
+			if (normal[2] > smallNumber)
+				blade.z = center[2] - (normal[0] * (blade.x - center[0]) + normal[1] * (blade.y - center[1])) / normal[2];
+			blade.yaw = stream.RandRange(0, 359);
+			blade.height = stream.RandRange(1, 2);
+			blades.push_back(blade);
+		}
+	}
+}
@@ -0,0 +1,92 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "GrassCoreTest.h"
+#include "BlueNoiseSampling.h"
+
+#include <algorithm>
+
+GRASS_TEST(BlueNoiseSamplingMaskIsPermutation)
+{
+	grassSampling::BlueNoiseMask mask;
+	mask.Generate(16, 1);
+	GRASS_CHECK(mask.GetSize() == 16);
+
+	std::vector<float> thresholds;
+	for (int y = 0; y < 16; y++)
+		for (int x = 0; x < 16; x++)
+			thresholds.push_back(mask.GetThreshold(x, y));
+	std::sort(thresholds.begin(), thresholds.end());
+	for (int i = 0; i < 256; i++)
+		GRASS_CHECK(std::fabs(thresholds[i] - (i + 0.5f) / 256) < 1e-6f);
+
+	//coordinates wrap around
+	GRASS_CHECK(mask.GetThreshold(-1, 17) == mask.GetThreshold(15, 1));
+}
+
+GRASS_TEST(BlueNoiseSamplingMatchesDensity)
+{
+	grassSampling::BlueNoiseMask mask;
+	mask.Generate(32, 2);
+
+	int width = 128, rows = 128;
+	std::vector<float> density((size_t)width * rows, 0.25f);
+	std::vector<float> positions;
+	grassSampling::ThresholdDensity(positions, density.data(), width, rows, 0, 0, 10, mask, 3);
+	float accepted = positions.size() / 2.f / (width * rows);
+	GRASS_CHECK(std::fabs(accepted - 0.25f) < 0.01f);
+
+	//blue noise keeps accepted pixels apart, white noise would accept right neighbour of quarter of accepted pixels
+	std::vector<char> acceptedPixels((size_t)width * rows, 0);
+	for (size_t i = 0; i < positions.size(); i += 2)
+		acceptedPixels[(size_t)std::floor(positions[i + 1] / 10) * width + (size_t)std::floor(positions[i] / 10)] = 1;
+	int neighbours = 0, total = 0;
+	for (int y = 0; y < rows; y++)
+		for (int x = 0; x + 1 < width; x++)
+			if (acceptedPixels[(size_t)y * width + x])
+			{
+				total++;
+				neighbours += acceptedPixels[(size_t)y * width + x + 1];
+			}
+	GRASS_CHECK(neighbours < total / 8);
+}
+
+GRASS_TEST(BlueNoiseSamplingSplitsRows)
+{
+	grassSampling::BlueNoiseMask mask;
+	mask.Generate(16, 4);
+	int width = 40, rows = 30;
+	std::vector<float> density((size_t)width * rows);
+	for (size_t i = 0; i < density.size(); i++)
+		density[i] = (i % 7) / 7.f;
+
+	std::vector<float> whole, split;
+	grassSampling::ThresholdDensity(whole, density.data(), width, rows, -5, 3, 20, mask, 9);
+	grassSampling::ThresholdDensity(split, density.data(), width, 11, -5, 3, 20, mask, 9);
+	grassSampling::ThresholdDensity(split, density.data() + 11 * width, width, rows - 11, -5, 14, 20, mask, 9);
+	GRASS_CHECK(whole == split);
+}
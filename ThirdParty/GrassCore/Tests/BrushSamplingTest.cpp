@@ -0,0 +1,57 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "GrassCoreTest.h"
+#include "BrushSampling.h"
+
+GRASS_TEST(BrushSamplingKeepsDistanceToExisting)
+{
+	grassSampling::PointHashGrid existing(10);
+	for (int i = 0; i < 10; i++)
+		existing.Add(i * 10.f, 0);
+
+	std::vector<float> positions;
+	grassSampling::SampleBrushDisk(positions, 50, 0, 60, 10, 30, 1, existing);
+	GRASS_CHECK(positions.size() > 20);
+	GRASS_CHECK(grassCoreTest::MinDistance(positions) >= 10 * 0.999f);
+
+	for (size_t i = 0; i < positions.size(); i += 2)
+	{
+		float dx = positions[i] - 50, dy = positions[i + 1];
+		GRASS_CHECK(dx * dx + dy * dy <= 60 * 60 * 1.001f);
+		GRASS_CHECK(!existing.HasPointWithin(positions[i], positions[i + 1], 10 * 0.999f));
+	}
+}
+
+GRASS_TEST(BrushSamplingIsDeterministic)
+{
+	grassSampling::PointHashGrid existing(10);
+	std::vector<float> first, second;
+	grassSampling::SampleBrushDisk(first, 0, 0, 40, 8, 30, 5, existing);
+	grassSampling::SampleBrushDisk(second, 0, 0, 40, 8, 30, 5, existing);
+	GRASS_CHECK(first == second);
+}
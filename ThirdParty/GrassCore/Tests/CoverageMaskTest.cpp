@@ -0,0 +1,69 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "GrassCoreTest.h"
+#include "CoverageMask.h"
+
+GRASS_TEST(CoverageMaskCoversPolygon)
+{
+	grassSampling::CoverageMask mask;
+	//triangle covering half of 0 - 1000 square
+	mask.AddPolygon({ 0, 0, 1000, 0, 0, 1000 });
+	mask.Build(100);
+
+	int full = 0, partial = 0;
+	for (const grassSampling::CoverageMask::Tile& tile : mask.GetTiles())
+	{
+		//tiles touched by edges on the border of the square are partially covered
+		GRASS_CHECK(tile.x >= 0 && tile.x <= 10 && tile.y >= 0 && tile.y <= 10);
+		if (tile.full)
+		{
+			full++;
+			//fully covered tile lies below the diagonal
+			GRASS_CHECK(tile.x + tile.y + 2 <= 10);
+		}
+		else
+			partial++;
+	}
+	GRASS_CHECK(full > 0 && partial > 0);
+
+	GRASS_CHECK(mask.Contains(100, 100));
+	GRASS_CHECK(!mask.Contains(600, 600));
+	GRASS_CHECK(!mask.Contains(-10, 10));
+}
+
+GRASS_TEST(CoverageMaskRemovesOutside)
+{
+	grassSampling::CoverageMask mask;
+	mask.AddPolygon({ 0, 0, 100, 0, 100, 100, 0, 100 });
+	mask.AddPolygon({ 300, 0, 400, 0, 400, 100, 300, 100 });
+	mask.Build(50);
+
+	std::vector<float> positions = { 50, 50, 200, 50, 350, 50, 500, 50 };
+	GRASS_CHECK(mask.RemoveOutside(positions) == 2);
+	GRASS_CHECK((positions == std::vector<float>{ 50, 50, 350, 50 }));
+}
@@ -0,0 +1,60 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "GrassCoreTest.h"
+#include "ExclusionBVH.h"
+
+GRASS_TEST(ExclusionBVHContainsShapes)
+{
+	grassSampling::ExclusionBVH exclusions;
+	//box rotated by 45 degrees and capsule along x axis
+	exclusions.AddBox(0, 0, 10, 10, 3.14159265f / 4);
+	exclusions.AddCapsule(100, 0, 200, 0, 5);
+	exclusions.Build();
+	GRASS_CHECK(exclusions.Num() == 2);
+
+	GRASS_CHECK(exclusions.Contains(0, 0));
+	GRASS_CHECK(exclusions.Contains(0, 13));
+	//corner of not rotated box is outside of rotated one
+	GRASS_CHECK(!exclusions.Contains(9.5f, 9.5f));
+	GRASS_CHECK(exclusions.Contains(150, 4));
+	GRASS_CHECK(exclusions.Contains(203, 0));
+	GRASS_CHECK(!exclusions.Contains(150, 6));
+	GRASS_CHECK(!exclusions.Contains(206, 0));
+}
+
+GRASS_TEST(ExclusionBVHRemovesContainedInOrder)
+{
+	grassSampling::ExclusionBVH exclusions;
+	for (int i = 0; i < 100; i++)
+		exclusions.AddBox(i * 100.f, 0, 10, 10, 0);
+	exclusions.Build();
+
+	std::vector<float> positions = { 0, 0, 50, 0, 5000, 5, 5050, 0, 9900, -9 };
+	GRASS_CHECK(exclusions.RemoveContained(positions) == 3);
+	GRASS_CHECK((positions == std::vector<float>{ 50, 0, 5050, 0 }));
+}
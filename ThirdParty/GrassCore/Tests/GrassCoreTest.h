@@ -0,0 +1,77 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <vector>
+#include <cstdio>
+#include <cmath>
+
+// Minimal test harness of GrassCore (no dependencies, so the tests build wherever the library does)
+//
+// GRASS_TEST registers test function, GRASS_CHECK reports failed condition and marks the running test as failed.
+// Test runner executes tests whose name starts with the prefix given on command line (all tests without argument).
+namespace grassCoreTest {
+
+	struct TestCase {
+		const char* name;
+		void (*function)();
+	};
+
+	std::vector<TestCase>& GetTests();
+
+	//Marks running test as failed
+	void Fail(const char* file, int line, const char* condition);
+
+	struct TestRegistrar {
+		TestRegistrar(const char* name, void (*function)()) { GetTests().push_back({ name, function }); };
+	};
+
+	//@return smallest distance between any two positions (x,y pairs)
+	inline float MinDistance(const std::vector<float>& positions)
+	{
+		float minDistance = INFINITY;
+		for (size_t i = 0; i < positions.size(); i += 2)
+		{
+			for (size_t j = i + 2; j < positions.size(); j += 2)
+			{
+				float dx = positions[i] - positions[j];
+				float dy = positions[i + 1] - positions[j + 1];
+				minDistance = std::fmin(minDistance, std::sqrt(dx * dx + dy * dy));
+			}
+		}
+		return minDistance;
+	}
+}
+
+#define GRASS_TEST(name) \
+	static void name(); \
+	static grassCoreTest::TestRegistrar name##Registrar(#name, name); \
+	static void name()
+
+#define GRASS_CHECK(condition) \
+	do { if (!(condition)) grassCoreTest::Fail(__FILE__, __LINE__, #condition); } while (0)
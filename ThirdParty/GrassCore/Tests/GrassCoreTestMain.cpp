@@ -0,0 +1,69 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "GrassCoreTest.h"
+
+#include <cstring>
+
+namespace grassCoreTest {
+
+	static bool testFailed = false;
+
+	std::vector<TestCase>& GetTests()
+	{
+		static std::vector<TestCase> tests;
+		return tests;
+	}
+
+	void Fail(const char* file, int line, const char* condition)
+	{
+		std::printf("  %s(%i): check failed: %s\n", file, line, condition);
+		testFailed = true;
+	}
+}
+
+//Runs tests whose name starts with the first argument (all tests without argument)
+//@return amount of failed tests
+int main(int argc, char** argv)
+{
+	const char* prefix = argc > 1 ? argv[1] : "";
+	int run = 0, failed = 0;
+	for (const grassCoreTest::TestCase& test : grassCoreTest::GetTests())
+	{
+		if (std::strncmp(test.name, prefix, std::strlen(prefix)) != 0)
+			continue;
+
+		grassCoreTest::testFailed = false;
+		test.function();
+		std::printf("%s %s\n", grassCoreTest::testFailed ? "FAILED" : "passed", test.name);
+		run++;
+		failed += grassCoreTest::testFailed ? 1 : 0;
+	}
+
+	std::printf("%i of %i tests passed\n", run - failed, run);
+	return run == 0 ? 1 : failed;
+}
@@ -0,0 +1,62 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "GrassCoreTest.h"
+#include "HorizonMap.h"
+
+GRASS_TEST(HorizonMapOccludesBoxesBehindHill)
+{
+	grassSampling::HorizonMap horizon;
+	horizon.Reset(0, 0, 10, 256);
+
+	//wall of height 100 surrounding the view point in distance 100 - 120
+	for (int y = -12; y < 12; y++)
+	{
+		for (int x = -12; x < 12; x++)
+		{
+			float minX = x * 10.f, minY = y * 10.f;
+			float distance = horizon.NearestDistance(minX, minY, minX + 10, minY + 10);
+			if (distance >= 100)
+				horizon.AddOccluder(minX, minY, minX + 10, minY + 10, 100);
+		}
+	}
+
+	//low box far behind the wall is hidden, high one is visible
+	GRASS_CHECK(horizon.IsOccluded(500, -10, 510, 10, 20));
+	GRASS_CHECK(!horizon.IsOccluded(500, -10, 510, 10, 2000));
+	//box containing the view point is never occluded
+	GRASS_CHECK(!horizon.IsOccluded(-5, -5, 5, 5, 0));
+}
+
+GRASS_TEST(HorizonMapMeasuresDistances)
+{
+	grassSampling::HorizonMap horizon;
+	horizon.Reset(0, 0, 0, 64);
+	GRASS_CHECK(horizon.NearestDistance(-5, -5, 5, 5) == 0);
+	GRASS_CHECK(std::fabs(horizon.NearestDistance(30, -5, 40, 5) - 30) < 1e-3f);
+	GRASS_CHECK(std::fabs(horizon.FarthestDistance(30, 0, 40, 30) - 50) < 1e-3f);
+}
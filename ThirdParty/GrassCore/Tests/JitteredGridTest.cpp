@@ -0,0 +1,71 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "GrassCoreTest.h"
+#include "JitteredGrid.h"
+
+GRASS_TEST(JitteredGridPlacesOnePositionPerCell)
+{
+	const float bounds[4] = { -100, 100, 100, -100 };
+	grassSampling::JitteredGridCells cells = grassSampling::GetJitteredGridCells(bounds, 10);
+	GRASS_CHECK(cells.firstX == -10 && cells.firstY == -10 && cells.columns == 20 && cells.rows == 20);
+
+	std::vector<float> positions;
+	grassSampling::JitteredGridRows(positions, bounds, 10, 1, 1, cells.firstY, cells.firstY + cells.rows);
+	GRASS_CHECK(positions.size() == 2 * 400);
+	for (size_t i = 0; i < positions.size(); i += 2)
+	{
+		int cellX = (int)std::floor(positions[i] / 10), cellY = (int)std::floor(positions[i + 1] / 10);
+		GRASS_CHECK(cellX == cells.firstX + (int)(i / 2) % 20);
+		GRASS_CHECK(cellY == cells.firstY + (int)(i / 2) / 20);
+	}
+}
+
+GRASS_TEST(JitteredGridWithoutJitterIsRegular)
+{
+	const float bounds[4] = { 0, 0, 50, 50 };
+	std::vector<float> positions;
+	grassSampling::JitteredGridRows(positions, bounds, 10, 0, 1, 0, 5);
+	GRASS_CHECK(positions.size() == 2 * 25);
+	GRASS_CHECK(positions[0] == 5 && positions[1] == 5);
+	GRASS_CHECK(std::fabs(grassCoreTest::MinDistance(positions) - 10) < 1e-4f);
+}
+
+GRASS_TEST(JitteredGridClipsToHalfOpenBounds)
+{
+	//neighbouring bounds together give the same positions as the bounds covering both
+	const float whole[4] = { 3, 7, 197, 93 };
+	const float left[4] = { 3, 7, 101, 93 };
+	const float right[4] = { 101, 7, 197, 93 };
+	std::vector<float> wholePositions, splitPositions;
+	grassSampling::JitteredGridRows(wholePositions, whole, 10, 1, 2, 0, 10);
+	grassSampling::JitteredGridRows(splitPositions, left, 10, 1, 2, 0, 10);
+	grassSampling::JitteredGridRows(splitPositions, right, 10, 1, 2, 0, 10);
+	GRASS_CHECK(wholePositions.size() == splitPositions.size());
+	for (size_t i = 0; i < wholePositions.size(); i += 2)
+		GRASS_CHECK(wholePositions[i] >= 3 && wholePositions[i] < 197 && wholePositions[i + 1] >= 7 && wholePositions[i + 1] < 93);
+}
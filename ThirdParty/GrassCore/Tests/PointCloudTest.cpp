@@ -0,0 +1,126 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "GrassCoreTest.h"
+#include "PointCloud.h"
+
+#include <cstdio>
+#include <cstring>
+
+static grassSampling::PointCloud MakeTestCloud(size_t count, uint32_t attributes)
+{
+	grassSampling::PointCloud cloud;
+	cloud.attributes = attributes;
+	for (size_t i = 0; i < count; i++)
+	{
+		cloud.positions.insert(cloud.positions.end(), { (float)i * 10 - 50, (float)i * -3 + 7, (float)i });
+		if (attributes & grassSampling::PointCloudNormal)
+			cloud.normals.insert(cloud.normals.end(), { 0, 0.6f, 0.8f });
+		if (attributes & grassSampling::PointCloudDensity)
+			cloud.densities.push_back((float)i / count);
+		if (attributes & grassSampling::PointCloudSeed)
+			cloud.seeds.push_back((uint32_t)i * 2654435761u);
+	}
+	return cloud;
+}
+
+GRASS_TEST(PointCloudRoundTripsThroughMappedFile)
+{
+	const uint32_t attributes = grassSampling::PointCloudHeight | grassSampling::PointCloudNormal |
+		grassSampling::PointCloudDensity | grassSampling::PointCloudSeed;
+	grassSampling::PointCloud cloud = MakeTestCloud(101, attributes);
+	const std::string fileName = "PointCloudTest.gpcl";
+	GRASS_CHECK(grassSampling::WritePointCloud(fileName, cloud));
+
+	grassSampling::MappedFile file;
+	GRASS_CHECK(file.Open(fileName));
+	GRASS_CHECK(file.GetSize() == grassSampling::GetPointCloudSize(101, attributes));
+	grassSampling::PointCloudView view;
+	GRASS_CHECK(view.Open(file.GetData(), file.GetSize()));
+	GRASS_CHECK(view.Num() == 101 && view.GetAttributes() == attributes);
+	GRASS_CHECK(view.GetBounds()[0] == -50 && view.GetBounds()[2] == 950);
+	GRASS_CHECK(view.GetBounds()[1] == -293 && view.GetBounds()[3] == 7);
+	for (size_t i = 0; i < 101; i++)
+	{
+		GRASS_CHECK(view.GetPositions()[3 * i] == cloud.positions[3 * i]);
+		GRASS_CHECK(view.GetPositions()[3 * i + 2] == cloud.positions[3 * i + 2]);
+		GRASS_CHECK(view.GetNormals()[3 * i + 1] == cloud.normals[3 * i + 1]);
+		GRASS_CHECK(view.GetDensities()[i] == cloud.densities[i]);
+		GRASS_CHECK(view.GetSeeds()[i] == cloud.seeds[i]);
+	}
+	file.Close();
+	std::remove(fileName.c_str());
+}
+
+GRASS_TEST(PointCloudOmitsAbsentAttributes)
+{
+	grassSampling::PointCloud cloud;
+	cloud.attributes = grassSampling::PointCloudSeed;
+	cloud.AddPositions({ 1, 2, 3, 4, 5, 6 });
+	cloud.seeds = { 7, 8, 9 };
+	GRASS_CHECK(cloud.Num() == 3 && cloud.positions[5] == 0);
+
+	std::vector<uint8_t> data;
+	GRASS_CHECK(grassSampling::SerializePointCloud(cloud, data));
+	GRASS_CHECK(data.size() == grassSampling::GetPointCloudSize(3, grassSampling::PointCloudSeed));
+	GRASS_CHECK(data.size() < grassSampling::GetPointCloudSize(3, grassSampling::PointCloudSeed | grassSampling::PointCloudNormal));
+
+	//vector storage is aligned for any fundamental type, which covers the 16 byte sections on the tested platforms
+	grassSampling::PointCloudView view;
+	GRASS_CHECK(view.Open(data.data(), data.size()));
+	GRASS_CHECK(view.GetNormals() == nullptr && view.GetDensities() == nullptr);
+	GRASS_CHECK(view.GetSeeds()[2] == 9 && view.GetPositions()[3] == 3);
+}
+
+GRASS_TEST(PointCloudRejectsInvalidData)
+{
+	//arrays not matching the attributes
+	grassSampling::PointCloud cloud = MakeTestCloud(10, grassSampling::PointCloudDensity);
+	cloud.densities.pop_back();
+	std::vector<uint8_t> data;
+	GRASS_CHECK(!grassSampling::SerializePointCloud(cloud, data));
+
+	cloud = MakeTestCloud(10, grassSampling::PointCloudDensity);
+	GRASS_CHECK(grassSampling::SerializePointCloud(cloud, data));
+	grassSampling::PointCloudView view;
+	GRASS_CHECK(!view.Open(data.data(), data.size() - 1));
+	GRASS_CHECK(!view.Open(data.data(), 32));
+
+	std::vector<uint8_t> corrupted = data;
+	corrupted[0] ^= 1;
+	GRASS_CHECK(!view.Open(corrupted.data(), corrupted.size()));
+
+	//count claiming more points than the data hold
+	corrupted = data;
+	uint64_t hugeCount = ~0ull;
+	std::memcpy(corrupted.data() + 16, &hugeCount, sizeof(hugeCount));
+	GRASS_CHECK(!view.Open(corrupted.data(), corrupted.size()));
+	GRASS_CHECK(view.Num() == 0 && view.GetPositions() == nullptr);
+
+	grassSampling::MappedFile file;
+	GRASS_CHECK(!file.Open("PointCloudTestMissing.gpcl"));
+}
@@ -0,0 +1,96 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "GrassCoreTest.h"
+#include "PointHashGrid.h"
+
+#include <algorithm>
+
+GRASS_TEST(PointHashGridQueriesRadius)
+{
+	grassSampling::PointHashGrid grid(10);
+	for (int y = 0; y < 20; y++)
+		for (int x = 0; x < 20; x++)
+			grid.Add(x * 5.f, y * 5.f);
+	GRASS_CHECK(grid.Num() == 400);
+
+	std::vector<int> found;
+	grid.QueryRadius(50, 50, 7, found);
+	//center, 4 neighbours in distance 5 (diagonal ones are 7.07 away)
+	GRASS_CHECK(found.size() == 5);
+	for (int index : found)
+	{
+		float dx = grid.GetX(index) - 50, dy = grid.GetY(index) - 50;
+		GRASS_CHECK(dx * dx + dy * dy <= 49);
+	}
+
+	GRASS_CHECK(grid.HasPointWithin(51, 51, 2));
+	GRASS_CHECK(!grid.HasPointWithin(52.5f, 52.5f, 3));
+	GRASS_CHECK(!grid.HasPointWithin(-20, -20, 5));
+}
+
+GRASS_TEST(PointHashGridRemovesAtSwap)
+{
+	grassSampling::PointHashGrid grid(10);
+	grid.Add(0, 0);
+	grid.Add(100, 100);
+	grid.Add(200, 200);
+
+	//last point moves into the removed slot
+	grid.RemoveAtSwap(0);
+	GRASS_CHECK(grid.Num() == 2);
+	GRASS_CHECK(grid.GetX(0) == 200 && grid.GetY(0) == 200);
+	GRASS_CHECK(!grid.HasPointWithin(0, 0, 1));
+
+	std::vector<int> found;
+	grid.QueryRadius(200, 200, 1, found);
+	GRASS_CHECK(found.size() == 1 && found[0] == 0);
+}
+
+GRASS_TEST(PointHashGridInsertsAtSwap)
+{
+	grassSampling::PointHashGrid grid(10);
+	for (int i = 0; i < 5; i++)
+		grid.Add(i * 100.f, 0);
+
+	//insertion reverts removal exactly
+	grid.RemoveAtSwap(1);
+	grid.InsertAtSwap(1, 100, 0);
+	GRASS_CHECK(grid.Num() == 5);
+	for (int i = 0; i < 5; i++)
+		GRASS_CHECK(grid.GetX(i) == i * 100.f);
+
+	std::vector<int> found;
+	grid.QueryRadius(400, 0, 1, found);
+	GRASS_CHECK(found.size() == 1 && found[0] == 4);
+	found.clear();
+	grid.QueryRadius(100, 0, 1, found);
+	GRASS_CHECK(found.size() == 1 && found[0] == 1);
+
+	grid.InsertAtSwap(5, 500, 0);
+	GRASS_CHECK(grid.Num() == 6 && grid.GetX(5) == 500);
+}
@@ -0,0 +1,111 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "GrassCoreTest.h"
+#include "PoissonTileSet.h"
+
+#include <cstdio>
+
+GRASS_TEST(PoissonTileSetKeepsRadiusAcrossTiles)
+{
+	grassSampling::PoissonTileSet tileSet;
+	tileSet.Generate(10, 8, 4, 30, 1);
+	GRASS_CHECK(tileSet.Matches(10, 8, 4, 1));
+	GRASS_CHECK(tileSet.GetAmountOfVariants() == 4);
+
+	//bounds span several tiles, so borders of different variants meet
+	const float bounds[4] = { -200, 200, 200, -200 };
+	std::vector<float> positions;
+	tileSet.FillBounds(positions, bounds, 7);
+	GRASS_CHECK(positions.size() > 1000);
+	GRASS_CHECK(grassCoreTest::MinDistance(positions) >= 10 * 0.999f);
+	for (size_t i = 0; i < positions.size(); i++)
+		GRASS_CHECK(positions[i] >= -200 && positions[i] < 200);
+}
+
+GRASS_TEST(PoissonTileSetFillsNeighbouringBoundsSeamlessly)
+{
+	grassSampling::PoissonTileSet tileSet;
+	tileSet.Generate(10, 8, 4, 30, 2);
+
+	const float whole[4] = { 0, 0, 300, 100 };
+	const float left[4] = { 0, 0, 130, 100 };
+	const float right[4] = { 130, 0, 300, 100 };
+	std::vector<float> wholePositions, splitPositions;
+	tileSet.FillBounds(wholePositions, whole, 3);
+	tileSet.FillBounds(splitPositions, left, 3);
+	tileSet.FillBounds(splitPositions, right, 3);
+	GRASS_CHECK(wholePositions.size() == splitPositions.size());
+	GRASS_CHECK(grassCoreTest::MinDistance(splitPositions) >= 10 * 0.999f);
+}
+
+GRASS_TEST(PoissonTileSetSavesAndLoads)
+{
+	grassSampling::PoissonTileSet tileSet, loaded;
+	tileSet.Generate(15, 6, 3, 30, 4);
+	std::string fileName = "GrassCoreTest_PoissonTiles.bin";
+	GRASS_CHECK(tileSet.SaveToFile(fileName));
+	GRASS_CHECK(loaded.LoadFromFile(fileName));
+	std::remove(fileName.c_str());
+
+	GRASS_CHECK(loaded.Matches(15, 6, 3, 4));
+	for (int i = 0; i < tileSet.GetAmountOfVariants(); i++)
+		GRASS_CHECK(loaded.GetTile(i) == tileSet.GetTile(i));
+}
+
+GRASS_TEST(PoissonTileSetMatchesClampedParametersAndSeed)
+{
+	grassSampling::PoissonTileSet tileSet;
+	tileSet.Generate(10, 1, 0, 30, 5);
+	GRASS_CHECK(tileSet.GetTileSize() == 20);
+	GRASS_CHECK(tileSet.Matches(10, 1, 0, 5));
+	GRASS_CHECK(tileSet.Matches(10, 2, 1, 5));
+	GRASS_CHECK(!tileSet.Matches(10, 2, 1, 6));
+	GRASS_CHECK(!tileSet.Matches(10, 3, 1, 5));
+}
+
+GRASS_TEST(PoissonTileSetRejectsNonPositiveRadius)
+{
+	grassSampling::PoissonTileSet tileSet;
+	GRASS_CHECK(tileSet.Generate(10, 4, 2, 30, 1) == 1);
+	GRASS_CHECK(tileSet.Generate(0, 4, 2, 30, 1) == 0);
+	GRASS_CHECK(tileSet.IsEmpty());
+	GRASS_CHECK(tileSet.Generate(-5, 4, 2, 30, 1) == 0);
+	GRASS_CHECK(!tileSet.Matches(-5, 4, 2, 1));
+
+	const float bounds[4] = { -50, -50, 50, 50 };
+	std::vector<float> positions;
+	tileSet.FillBounds(positions, bounds, 1);
+	GRASS_CHECK(positions.empty());
+}
+
+GRASS_TEST(PoissonTileSetHashIsDeterministic)
+{
+	GRASS_CHECK(grassSampling::HashCoordinates(3, -5, 9) == grassSampling::HashCoordinates(3, -5, 9));
+	GRASS_CHECK(grassSampling::HashCoordinates(3, -5, 9) != grassSampling::HashCoordinates(-5, 3, 9));
+	GRASS_CHECK(grassSampling::HashCoordinates(3, -5, 9) != grassSampling::HashCoordinates(3, -5, 10));
+}
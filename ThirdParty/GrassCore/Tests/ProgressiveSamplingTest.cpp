@@ -0,0 +1,86 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "GrassCoreTest.h"
+#include "ProgressiveSampling.h"
+#include "PoissonTileSet.h"
+
+#include <algorithm>
+
+GRASS_TEST(ProgressiveSamplingKeepsPositions)
+{
+	grassSampling::PoissonTileSet tileSet;
+	tileSet.Generate(10, 8, 2, 30, 1);
+	const float bounds[4] = { 0, 0, 400, 400 };
+	std::vector<float> positions;
+	tileSet.FillBounds(positions, bounds, 1);
+
+	std::vector<float> ordered = positions;
+	std::vector<int> cellStarts, cellCoords;
+	grassSampling::ProgressiveOrderByCells(ordered, 200, 10, 5, cellStarts, cellCoords);
+
+	GRASS_CHECK(cellCoords.size() == 2 * 4);
+	GRASS_CHECK(cellStarts.size() == 4 + 1);
+	GRASS_CHECK(cellStarts.back() == (int)positions.size() / 2);
+
+	//reordering is a permutation
+	std::vector<std::pair<float, float>> before, after;
+	for (size_t i = 0; i < positions.size(); i += 2)
+	{
+		before.push_back({ positions[i], positions[i + 1] });
+		after.push_back({ ordered[i], ordered[i + 1] });
+	}
+	std::sort(before.begin(), before.end());
+	std::sort(after.begin(), after.end());
+	GRASS_CHECK(before == after);
+
+	//positions of every cell are within the cell
+	for (size_t cell = 0; cell + 1 < cellStarts.size(); cell++)
+	{
+		for (int i = cellStarts[cell]; i < cellStarts[cell + 1]; i++)
+		{
+			GRASS_CHECK(std::floor(ordered[2 * i] / 200) == cellCoords[2 * cell]);
+			GRASS_CHECK(std::floor(ordered[2 * i + 1] / 200) == cellCoords[2 * cell + 1]);
+		}
+	}
+}
+
+GRASS_TEST(ProgressiveSamplingPrefixIsSpread)
+{
+	grassSampling::PoissonTileSet tileSet;
+	tileSet.Generate(5, 8, 2, 30, 3);
+	const float bounds[4] = { 0, 0, 200, 200 };
+	std::vector<float> positions;
+	tileSet.FillBounds(positions, bounds, 3);
+	int count = (int)positions.size() / 2;
+
+	grassSampling::ProgressiveOrder(positions.data(), count, 0, 0, 200, 5, 8);
+
+	//quarter of the points keeps roughly twice the minimal distance (level radius shrinks by sqrt(2) per level)
+	std::vector<float> prefix(positions.begin(), positions.begin() + 2 * (count / 4));
+	GRASS_CHECK(grassCoreTest::MinDistance(prefix) >= 5 * 1.4f);
+}
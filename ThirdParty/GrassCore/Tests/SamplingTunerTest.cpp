@@ -0,0 +1,118 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "GrassCoreTest.h"
+#include "SamplingTuner.h"
+
+GRASS_TEST(SamplingTunerFitsProbes)
+{
+	//segment costs 0.01 s per call and 1e-6 s per unit of area, 1 MB + 100 B per unit of area of GPU memory
+	grassSampling::SamplingTuner tuner;
+	for (float width : { 250.f, 500.f, 1000.f })
+	{
+		grassSampling::SamplingProbe probe;
+		probe.width = width;
+		probe.seconds = 0.01 + 1e-6 * width * width;
+		probe.positions = (size_t)(0.01 * width * width);
+		probe.gpuBytes = (size_t)(1e6 + 100 * width * width);
+		tuner.AddProbe(probe);
+	}
+
+	grassSampling::SamplingLimits limits;
+	limits.minWidth = 100;
+	limits.maxWidth = 8000;
+	limits.gpuBudget = (size_t)(1e6 + 100 * 4000.0 * 4000.0);
+	limits.ramBudget = (size_t)1 << 40;
+	limits.bytesPerPosition = 100;
+	limits.maxPositionsPerPart = 1000000;
+	limits.cores = 4;
+
+	grassSampling::SamplingPlan plan;
+	GRASS_CHECK(tuner.Plan(10000, limits, plan));
+	GRASS_CHECK(std::fabs(plan.secondsPerCall - 0.01) < 1e-4);
+	GRASS_CHECK(std::fabs(plan.positionsPerArea - 0.01) < 1e-4);
+	//largest segment fitting the GPU budget
+	GRASS_CHECK(plan.segmentWidth <= 4000 * 1.001f && plan.segmentWidth >= 3000);
+	//1e6 positions in total fit one part only just
+	GRASS_CHECK(plan.parts >= 1);
+	GRASS_CHECK(plan.predictedPositions > 0.9e6 && plan.predictedPositions < 1.1e6);
+}
+
+GRASS_TEST(SamplingTunerNeedsTwoWidths)
+{
+	grassSampling::SamplingTuner tuner;
+	grassSampling::SamplingProbe probe;
+	probe.width = 500;
+	probe.seconds = 1;
+	tuner.AddProbe(probe);
+	tuner.AddProbe(probe);
+
+	grassSampling::SamplingPlan plan;
+	GRASS_CHECK(!tuner.Plan(1000, grassSampling::SamplingLimits(), plan));
+}
+
+GRASS_TEST(SamplingTunerReusesMatchingProbe)
+{
+	//probes are first segments of 10000 wide space split into 40, 20 and 10 segments
+	grassSampling::SamplingTuner tuner;
+	for (float width : { 250.f, 500.f, 1000.f })
+	{
+		grassSampling::SamplingProbe probe;
+		probe.width = width;
+		probe.seconds = 0.01 + 1e-6 * width * width;
+		probe.gpuBytes = (size_t)(1e6 + 100 * width * width);
+		tuner.AddProbe(probe);
+	}
+
+	grassSampling::SamplingPlan plan;
+	plan.segments = 8;
+	plan.segmentWidth = 1250;
+	plan.secondsPerCall = 0.01;
+	plan.secondsPerArea = 1e-6;
+	plan.predictedSeconds = 64 * 0.01 + 1e-6 * 1e8;
+	//10 segments cost 0.36 s more calls but save the 1.01 s of the reused probe
+	GRASS_CHECK(tuner.ReuseProbe(10000, plan) == 2);
+	GRASS_CHECK(plan.segments == 10);
+	GRASS_CHECK(std::fabs(plan.segmentWidth - 1000) < 0.1f);
+
+	//probes bigger than planned segments would not fit the GPU budget, 20 segments cost more calls than the probe saves
+	plan.segments = 12;
+	plan.segmentWidth = 10000.f / 12;
+	plan.predictedSeconds = 144 * 0.01 + 1e-6 * 1e8;
+	GRASS_CHECK(tuner.ReuseProbe(10000, plan) == -1);
+	GRASS_CHECK(plan.segments == 12);
+
+	//probe that does not split the space evenly is not the first segment of any split
+	grassSampling::SamplingTuner uneven;
+	grassSampling::SamplingProbe probe;
+	probe.width = 3000;
+	probe.seconds = 1;
+	uneven.AddProbe(probe);
+	plan.segments = 2;
+	GRASS_CHECK(uneven.ReuseProbe(10000, plan) == -1);
+	GRASS_CHECK(plan.segments == 2);
+}
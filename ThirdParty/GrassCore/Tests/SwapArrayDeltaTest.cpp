@@ -0,0 +1,152 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "GrassCoreTest.h"
+#include "SwapArrayDelta.h"
+
+#include <algorithm>
+#include <functional>
+#include <random>
+
+namespace {
+
+	//Array removing by swap and pop the same way as instance managers
+	struct TestArray {
+		std::vector<int> elements;
+
+		void Append(int value, grassSampling::SwapArrayDelta<int>* delta)
+		{
+			elements.push_back(value);
+			if (delta != nullptr)
+				delta->RecordAppend(1);
+		}
+
+		//@param indices - get removed from the highest
+		void Remove(std::vector<int> indices, grassSampling::SwapArrayDelta<int>* delta)
+		{
+			std::sort(indices.begin(), indices.end(), std::greater<int>());
+			for (int index : indices)
+			{
+				if (delta != nullptr)
+					delta->RecordRemoveAtSwap(index, elements[index]);
+				elements[index] = elements.back();
+				elements.pop_back();
+			}
+		}
+
+		void RemoveLast(int count) { elements.resize(elements.size() - count); }
+
+		void InsertAtSwap(int index, const int& value)
+		{
+			if (index == (int)elements.size())
+			{
+				elements.push_back(value);
+				return;
+			}
+			elements.push_back(elements[index]);
+			elements[index] = value;
+		}
+	};
+}
+
+GRASS_TEST(SwapArrayDeltaRevertsPaintAndEraseInReverseOrder)
+{
+	TestArray array;
+	for (int i = 0; i < 20; i++)
+		array.Append(i, nullptr);
+	std::vector<int> initial = array.elements;
+
+	//paint appends, erase removes old and painted elements, so painted elements get swapped away from the end
+	grassSampling::SwapArrayDelta<int> paint, erase;
+	for (int i = 100; i < 110; i++)
+		array.Append(i, &paint);
+	std::vector<int> painted = array.elements;
+	array.Remove({ 2, 5, 6, 21, 29, 13 }, &erase);
+	GRASS_CHECK(array.elements.size() == 24);
+
+	erase.Revert(array);
+	GRASS_CHECK(array.elements == painted);
+	paint.Revert(array);
+	GRASS_CHECK(array.elements == initial);
+}
+
+GRASS_TEST(SwapArrayDeltaRevertsMixedChangesOfOneDelta)
+{
+	std::mt19937 random(5);
+	for (int round = 0; round < 50; round++)
+	{
+		TestArray array;
+		for (int i = 0; i < 30; i++)
+			array.Append(i, nullptr);
+
+		//several operations, every one of them removes and appends in several batches
+		std::vector<std::vector<int>> states;
+		std::vector<grassSampling::SwapArrayDelta<int>> deltas(5);
+		for (grassSampling::SwapArrayDelta<int>& delta : deltas)
+		{
+			states.push_back(array.elements);
+			for (int batch = 0; batch < 4; batch++)
+			{
+				std::vector<int> indices;
+				for (int i = 0; i < (int)array.elements.size(); i++)
+					if (random() % 4 == 0)
+						indices.push_back(i);
+				array.Remove(indices, &delta);
+				for (int i = 0, count = random() % 10; i < count; i++)
+					array.Append(1000 + (int)(random() % 1000), &delta);
+			}
+		}
+
+		for (int i = (int)deltas.size() - 1; i >= 0; i--)
+		{
+			deltas[i].Revert(array);
+			GRASS_CHECK(array.elements == states[i]);
+		}
+	}
+}
+
+GRASS_TEST(SwapArrayDeltaRevertsClear)
+{
+	TestArray array;
+	for (int i = 0; i < 10; i++)
+		array.Append(i, nullptr);
+	std::vector<int> initial = array.elements;
+
+	//clear removes from the end, so no element gets swapped
+	grassSampling::SwapArrayDelta<int> clear;
+	std::vector<int> all;
+	for (int i = 0; i < 10; i++)
+		all.push_back(i);
+	array.Remove(all, &clear);
+	array.Append(7, &clear);
+	GRASS_CHECK(clear.NumRemoved() == 10 && !clear.IsEmpty());
+
+	clear.Revert(array);
+	GRASS_CHECK(array.elements == initial);
+	clear.Clear();
+	GRASS_CHECK(clear.IsEmpty() && clear.NumRemoved() == 0);
+}
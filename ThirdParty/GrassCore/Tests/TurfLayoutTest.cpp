@@ -0,0 +1,81 @@
+// Copyright 2020 Matous Prochazka, Bohemia Interactive, a.s.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+//   3. Neither the name of the copyright holder nor the names of its contributors
+//      may be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "GrassCoreTest.h"
+#include "TurfLayout.h"
+
+GRASS_TEST(TurfLayoutRandomStreamMatchesEngine)
+{
+	//first values of FRandomStream with seed 0
+	grassSampling::RandomStream stream(0);
+	uint32_t seed = 907633515u;
+	GRASS_CHECK(std::fabs(stream.FRand() - (seed >> 9) / 8388608.f) < 1e-6f);
+	GRASS_CHECK(stream.GetCurrentSeed() == seed);
+
+	for (int i = 0; i < 1000; i++)
+	{
+		int value = stream.RandRange(1, 2);
+		GRASS_CHECK(value == 1 || value == 2);
+		float fraction = stream.FRandRange(-3, 3);
+		GRASS_CHECK(fraction >= -3 && fraction < 3);
+	}
+}
+
+GRASS_TEST(TurfLayoutPlacesBladesOntoPlane)
+{
+	grassSampling::RandomStream stream(5);
+	const float center[3] = { 100, 200, 50 };
+	//plane rising along x by 1 unit per unit
+	float length = std::sqrt(2.f);
+	const float normal[3] = { -1 / length, 0, 1 / length };
+
+	std::vector<grassSampling::TurfBlade> blades;
+	grassSampling::GenerateTurfLayout(blades, stream, 200, 3, center, normal);
+	GRASS_CHECK(blades.size() == 200);
+	for (const grassSampling::TurfBlade& blade : blades)
+	{
+		float dx = blade.x - center[0], dy = blade.y - center[1];
+		//square of value in <-radius, radius) times radius
+		GRASS_CHECK(dx * dx + dy * dy <= 27 * 27 * 1.001f);
+		GRASS_CHECK(std::fabs(blade.z - (center[2] + dx)) < 1e-2f);
+		GRASS_CHECK(blade.yaw >= 0 && blade.yaw <= 359);
+		GRASS_CHECK(blade.height == 1 || blade.height == 2);
+	}
+}
+
+GRASS_TEST(TurfLayoutIsDeterministic)
+{
+	const float center[3] = { 0, 0, 0 };
+	const float normal[3] = { 0, 0, 1 };
+	std::vector<grassSampling::TurfBlade> first, second;
+	grassSampling::RandomStream firstStream(11), secondStream(11);
+	grassSampling::GenerateTurfLayout(first, firstStream, 50, 4, center, normal);
+	grassSampling::GenerateTurfLayout(second, secondStream, 50, 4, center, normal);
+	GRASS_CHECK(first.size() == second.size());
+	for (size_t i = 0; i < first.size(); i++)
+		GRASS_CHECK(first[i].x == second[i].x && first[i].y == second[i].y && first[i].yaw == second[i].yaw);
+}